@@ -0,0 +1,477 @@
+/**************************************************************************//**
+ * @file     asset_bank.c
+ * @brief    A/B asset partitions in the code-free APROM bank with background programming.
+ *
+ *           Both asset partitions sit in APROM bank 1 and the firmware runs
+ *           from bank 0, so erasing and programming never hold up an
+ *           instruction fetch. Page erases are started and left running
+ *           between polls, and programming is done in chunks timed against
+ *           the idle budget of the caller. A new pack is hashed in place by
+ *           the SHA engine, a run per poll, before its header is written; the
+ *           header, with a sequence number one above the active bank, is
+ *           the single commit point. At boot the newest bank with a valid
+ *           header and digest wins.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "asset_bank.h"
+#include "asset_verify.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_BANK_NUM             2
+#define DEF_BANK_PACK_MAX        (CONFIG_ASSET_BANK_SIZE - ASSET_BANK_HDR_SIZE)
+
+#if (CONFIG_ASSET_BANK_OFFSET + (DEF_BANK_NUM * CONFIG_ASSET_BANK_SIZE)) > FMC_APROM_BANK_SIZE
+    #error "Both asset partitions must fit in APROM bank 1."
+#endif
+
+#if (CONFIG_ASSET_BANK_OFFSET % FMC_FLASH_PAGE_SIZE) || (CONFIG_ASSET_BANK_SIZE % FMC_FLASH_PAGE_SIZE)
+    #error "The asset partition must be page aligned."
+#endif
+
+#if (CONFIG_ASSET_BANK_CHUNK_SIZE % 8) || (ASSET_BANK_HDR_SIZE % CONFIG_ASSET_BANK_CHUNK_SIZE)
+    #error "CONFIG_ASSET_BANK_CHUNK_SIZE must be a multiple of 8 dividing ASSET_BANK_HDR_SIZE."
+#endif
+
+typedef enum
+{
+    evBankIdle,              /*!< No update */
+    evBankErase,             /*!< Erasing the pages of the new pack */
+    evBankProgram,           /*!< Programming the pack */
+    evBankVerify,            /*!< Hashing the programmed pack */
+    evBankReady,             /*!< Committed, waiting for asset_bank_activate */
+    evBankFailed,            /*!< Failed, reported once by asset_bank_poll */
+} E_BANK_STATE;
+
+/* Written last, the commit point of a bank. */
+typedef struct
+{
+    uint32_t m_u32Magic;            // ASSET_BANK_MAGIC
+    uint32_t m_u32Seq;              // Higher is newer
+    uint32_t m_u32Len;              // Pack bytes after ASSET_BANK_HDR_SIZE
+    uint32_t m_u32SeqInv;           // ~m_u32Seq, an erased or torn header fails it
+    uint32_t m_au32Digest[8];       // SHA-256 of the pack
+} S_BANK_HDR;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static const uint32_t s_au32BankBase[DEF_BANK_NUM] =
+{
+    FMC_APROM_BANK1_BASE + CONFIG_ASSET_BANK_OFFSET,
+    FMC_APROM_BANK1_BASE + CONFIG_ASSET_BANK_OFFSET + CONFIG_ASSET_BANK_SIZE
+};
+
+static int s_i32Active = -1;                 // Bank the assets are read from, -1 if none
+static uint32_t s_u32ActiveSeq = 0;
+
+static E_BANK_STATE s_evState = evBankIdle;
+static int s_i32Target;                      // Bank being updated
+static S_BANK_HDR s_sNewHdr;
+static ASSET_BANK_READ s_pfnRead;
+static void *s_pvReadUserData;
+static uint32_t s_u32EraseAddr;              // Next page to erase
+static uint32_t s_u32EraseEnd;
+static int s_i32Erasing = 0;                 // A page erase was started and not yet checked
+static int s_i32Hashing = 0;                 // An in-place hash of the pack was started
+static uint32_t s_u32Offset;                 // Pack bytes programmed
+static uint32_t s_u32StartCycles;
+static uint32_t s_u32ChunkCycles = 0;        // Cycles of the last chunk, the estimate for the next one
+
+static uint32_t s_au32Chunk[CONFIG_ASSET_BANK_CHUNK_SIZE / sizeof(uint32_t)];
+
+static S_ASSET_BANK_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to start a page erase without waiting, the ISP runs on while the CPU continues
+NVT_ITCM static void asset_bank_erase_start(uint32_t u32PageAddr)
+{
+    FMC->ISPCMD  = FMC_ISPCMD_PAGE_ERASE;
+    FMC->ISPADDR = u32PageAddr;
+    FMC->ISPTRG  = FMC_ISPTRG_ISPGO_Msk;
+}
+
+// Function to program double words from ITCM, so no code is fetched from flash meanwhile, returns 0 or -1
+NVT_ITCM static int asset_bank_program(uint32_t u32Addr, const uint32_t *pu32Buf, uint32_t u32Len)
+{
+    uint32_t i;
+
+    for (i = 0; i < (u32Len / sizeof(uint32_t)); i += 2)
+    {
+        /* Erased flash already reads all ones. */
+        if ((pu32Buf[i] == 0xFFFFFFFFUL) && (pu32Buf[i + 1] == 0xFFFFFFFFUL))
+            continue;
+
+        FMC->ISPCMD  = FMC_ISPCMD_PROGRAM_64;
+        FMC->ISPADDR = u32Addr + (i * sizeof(uint32_t));
+        FMC->MPDAT0  = pu32Buf[i];
+        FMC->MPDAT1  = pu32Buf[i + 1];
+        FMC->ISPTRG  = FMC_ISPTRG_ISPGO_Msk;
+
+        while (FMC->ISPSTS & FMC_ISPSTS_ISPBUSY_Msk)
+            ;
+
+        if (FMC->ISPSTS & FMC_ISPSTS_ISPFF_Msk)
+        {
+            FMC->ISPSTS |= FMC_ISPSTS_ISPFF_Msk;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Function to check the header of a bank, returns 0 if it holds a committed pack
+static int asset_bank_hdr_check(int i32Bank, const S_BANK_HDR **ppsHdr)
+{
+    const S_BANK_HDR *psHdr = (const S_BANK_HDR *)s_au32BankBase[i32Bank];
+
+    *ppsHdr = psHdr;
+
+    if ((psHdr->m_u32Magic != ASSET_BANK_MAGIC) || (psHdr->m_u32SeqInv != ~psHdr->m_u32Seq) ||
+            !psHdr->m_u32Len || (psHdr->m_u32Len > DEF_BANK_PACK_MAX))
+        return -1;
+
+    return 0;
+}
+
+// Function to get the cycles per microsecond of the core clock
+static uint32_t asset_bank_cycles_per_us(void)
+{
+    return (SystemCoreClock / 1000000UL) ? (SystemCoreClock / 1000000UL) : 1;
+}
+
+// Function to end the update and leave the ISP
+static void asset_bank_finish(E_BANK_STATE evState)
+{
+    uint32_t u32RegLocked = SYS_IsRegLocked();
+
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    FMC_DISABLE_AP_UPDATE();
+    FMC_DISABLE_ISP();
+
+    if (u32RegLocked)
+        SYS_LockReg();
+
+    /* Lines of the target partition cached before the update are stale now. */
+    SCB_InvalidateDCache_by_Addr((void *)s_au32BankBase[s_i32Target], CONFIG_ASSET_BANK_SIZE);
+
+    if (evState == evBankFailed)
+        s_sStats.m_u32Failures++;
+
+    s_evState = evState;
+}
+
+// Function to advance the update by one step, returns 1 to go on or 0 to give the time back
+static int asset_bank_step(uint32_t u32Start, uint32_t u32Budget, uint32_t *pu32Bytes)
+{
+    uint32_t u32Base = s_au32BankBase[s_i32Target];
+    uint32_t u32Len, u32ChunkStart, u32Us;
+    int i32Ret;
+
+    switch (s_evState)
+    {
+    case evBankErase:
+        if (s_i32Erasing)
+        {
+            /* The erase runs in the background, check back on the next poll. */
+            if (FMC->ISPTRG & FMC_ISPTRG_ISPGO_Msk)
+                return 0;
+
+            s_i32Erasing = 0;
+
+            if (FMC->ISPCTL & FMC_ISPCTL_ISPFF_Msk)
+            {
+                FMC->ISPCTL |= FMC_ISPCTL_ISPFF_Msk;
+                asset_bank_finish(evBankFailed);
+                return 0;
+            }
+
+            s_sStats.m_u32Pages++;
+            s_u32EraseAddr += FMC_FLASH_PAGE_SIZE;
+        }
+
+        if (s_u32EraseAddr < s_u32EraseEnd)
+        {
+            asset_bank_erase_start(s_u32EraseAddr);
+            s_i32Erasing = 1;
+            return 0;
+        }
+
+        s_evState = evBankProgram;
+        return 1;
+
+    case evBankProgram:
+        if (s_u32Offset == s_sNewHdr.m_u32Len)
+        {
+            s_evState = evBankVerify;
+            return 0;
+        }
+
+        /* Rate limit, and start a chunk only if it fits what is left of the budget. */
+        if ((*pu32Bytes >= CONFIG_ASSET_BANK_POLL_BYTES) ||
+                (((DWT->CYCCNT - u32Start) + s_u32ChunkCycles) > u32Budget))
+            return 0;
+
+        u32Len = s_sNewHdr.m_u32Len - s_u32Offset;
+
+        if (u32Len > CONFIG_ASSET_BANK_CHUNK_SIZE)
+            u32Len = CONFIG_ASSET_BANK_CHUNK_SIZE;
+
+        u32ChunkStart = DWT->CYCCNT;
+
+        /* The tail of the last chunk is padded with erased bytes. */
+        memset(s_au32Chunk, 0xFF, sizeof(s_au32Chunk));
+
+        if (s_pfnRead(s_pvReadUserData, s_u32Offset, s_au32Chunk, u32Len) ||
+                asset_bank_program(u32Base + ASSET_BANK_HDR_SIZE + s_u32Offset, s_au32Chunk, NVT_ALIGN(u32Len, 8)))
+        {
+            asset_bank_finish(evBankFailed);
+            return 0;
+        }
+
+        s_u32ChunkCycles = DWT->CYCCNT - u32ChunkStart;
+
+        s_u32Offset += u32Len;
+        s_sStats.m_u32Bytes += u32Len;
+        *pu32Bytes += u32Len;
+
+        return 1;
+
+    case evBankVerify:
+        /* Hash what the flash holds, not what was sent, a run per poll while the CPU goes on. */
+        if (!s_i32Hashing)
+        {
+            if (asset_verify_hash_start((const void *)(u32Base + ASSET_BANK_HDR_SIZE), s_sNewHdr.m_u32Len,
+                                        s_sNewHdr.m_au32Digest) < 0)
+                return 0;
+
+            s_i32Hashing = 1;
+        }
+
+        i32Ret = asset_verify_hash_poll(CONFIG_ASSET_BANK_VERIFY_BYTES);
+
+        if (i32Ret > 0)
+            return 0;
+
+        s_i32Hashing = 0;
+
+        if (i32Ret < 0)
+        {
+            asset_bank_finish(evBankFailed);
+            return 0;
+        }
+
+        if (asset_bank_program(u32Base, (const uint32_t *)&s_sNewHdr, sizeof(s_sNewHdr)) < 0)
+        {
+            asset_bank_finish(evBankFailed);
+            return 0;
+        }
+
+        u32Us = (DWT->CYCCNT - s_u32StartCycles) / asset_bank_cycles_per_us();
+        s_sStats.m_u32LastKBps = u32Us ? (uint32_t)(((uint64_t)s_sNewHdr.m_u32Len * 1000ULL) / u32Us) : 0;
+
+        s_sStats.m_u32Updates++;
+        asset_bank_finish(evBankReady);
+
+        return 0;
+
+    default:
+        return 0;
+    }
+}
+
+// Function to get the active asset pack
+const void *asset_bank_get(uint32_t *pu32Len)
+{
+    const S_BANK_HDR *psHdr;
+
+    if (s_i32Active < 0)
+        return NULL;
+
+    asset_bank_hdr_check(s_i32Active, &psHdr);
+
+    if (pu32Len)
+        *pu32Len = psHdr->m_u32Len;
+
+    return (const void *)(s_au32BankBase[s_i32Active] + ASSET_BANK_HDR_SIZE);
+}
+
+// Function to start programming a new pack into the inactive bank
+int asset_bank_update(uint32_t u32Len, const uint32_t *pu32Digest, ASSET_BANK_READ pfnRead, void *pvUserData)
+{
+    uint32_t u32RegLocked;
+
+    if (((s_evState != evBankIdle) && (s_evState != evBankReady)) || !u32Len ||
+            (u32Len > DEF_BANK_PACK_MAX) || !pu32Digest || !pfnRead)
+        return -1;
+
+    s_i32Target = (s_i32Active == 0) ? 1 : 0;
+
+    s_sNewHdr.m_u32Magic = ASSET_BANK_MAGIC;
+    s_sNewHdr.m_u32Seq = s_u32ActiveSeq + 1;
+    s_sNewHdr.m_u32Len = u32Len;
+    s_sNewHdr.m_u32SeqInv = ~s_sNewHdr.m_u32Seq;
+    memcpy(s_sNewHdr.m_au32Digest, pu32Digest, sizeof(s_sNewHdr.m_au32Digest));
+
+    s_pfnRead = pfnRead;
+    s_pvReadUserData = pvUserData;
+    s_u32EraseAddr = s_au32BankBase[s_i32Target];
+    s_u32EraseEnd = s_u32EraseAddr + NVT_ALIGN(ASSET_BANK_HDR_SIZE + u32Len, FMC_FLASH_PAGE_SIZE);
+    s_i32Erasing = 0;
+    s_i32Hashing = 0;
+    s_u32Offset = 0;
+    s_u32StartCycles = DWT->CYCCNT;
+
+    u32RegLocked = SYS_IsRegLocked();
+
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    FMC_ENABLE_ISP();
+    FMC_ENABLE_AP_UPDATE();
+
+    if (u32RegLocked)
+        SYS_LockReg();
+
+    s_evState = evBankErase;
+
+    return 0;
+}
+
+// Function to advance the update within u32BudgetUs
+int asset_bank_poll(uint32_t u32BudgetUs)
+{
+    uint32_t u32Start = DWT->CYCCNT;
+    uint32_t u32CyclesPerUs = asset_bank_cycles_per_us();
+    uint32_t u32Budget = (u32BudgetUs > (0xFFFFFFFFUL / u32CyclesPerUs)) ? 0xFFFFFFFFUL : (u32BudgetUs * u32CyclesPerUs);
+    uint32_t u32Bytes = 0;
+    uint32_t u32RegLocked, u32StallUs;
+
+    if (s_evState == evBankFailed)
+    {
+        s_evState = evBankIdle;
+        return -1;
+    }
+
+    if ((s_evState == evBankIdle) || (s_evState == evBankReady))
+        return 0;
+
+    /* ISPTRG is write protected. */
+    u32RegLocked = SYS_IsRegLocked();
+
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    while (asset_bank_step(u32Start, u32Budget, &u32Bytes))
+        ;
+
+    if (u32RegLocked)
+        SYS_LockReg();
+
+    u32StallUs = (DWT->CYCCNT - u32Start) / u32CyclesPerUs;
+
+    if (u32StallUs > s_sStats.m_u32MaxStallUs)
+        s_sStats.m_u32MaxStallUs = u32StallUs;
+
+    if (s_evState == evBankFailed)
+    {
+        s_evState = evBankIdle;
+        return -1;
+    }
+
+    return (s_evState != evBankIdle) && (s_evState != evBankReady);
+}
+
+// Function to switch to the committed new bank
+int asset_bank_activate(void)
+{
+    if (s_evState != evBankReady)
+        return -1;
+
+    s_i32Active = s_i32Target;
+    s_u32ActiveSeq = s_sNewHdr.m_u32Seq;
+    s_evState = evBankIdle;
+
+    return 0;
+}
+
+// Function to get the asset bank statistics
+void asset_bank_get_stats(S_ASSET_BANK_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to initialize the asset banks and select the newest valid one
+static int asset_bank_init(void)
+{
+    const S_BANK_HDR *apsHdr[DEF_BANK_NUM];
+    int ai32Valid[DEF_BANK_NUM];
+    int i, i32First;
+
+    memset(&s_sStats, 0, sizeof(s_sStats));
+
+    /* Programming time and stalls are counted in core cycles. */
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    s_i32Active = -1;
+    s_u32ActiveSeq = 0;
+
+    for (i = 0; i < DEF_BANK_NUM; i++)
+        ai32Valid[i] = (asset_bank_hdr_check(i, &apsHdr[i]) == 0);
+
+    /* Newest bank first, fall back to the other one if its pack does not match its digest. */
+    i32First = (ai32Valid[1] && (!ai32Valid[0] || (apsHdr[1]->m_u32Seq > apsHdr[0]->m_u32Seq))) ? 1 : 0;
+
+    for (i = 0; i < DEF_BANK_NUM; i++)
+    {
+        int i32Bank = (i32First + i) % DEF_BANK_NUM;
+
+        if (!ai32Valid[i32Bank])
+            continue;
+
+        if (asset_verify_copy(ASSET_BANK_MAGIC, NULL, (const void *)(s_au32BankBase[i32Bank] + ASSET_BANK_HDR_SIZE),
+                              apsHdr[i32Bank]->m_u32Len, apsHdr[i32Bank]->m_au32Digest) == 0)
+        {
+            s_i32Active = i32Bank;
+            s_u32ActiveSeq = apsHdr[i32Bank]->m_u32Seq;
+            break;
+        }
+    }
+
+    s_evState = evBankIdle;
+
+    return 0;
+}
+
+// Function to deinitialize the asset banks, a running update is dropped uncommitted
+static int asset_bank_fini(void)
+{
+    if ((s_evState == evBankErase) || (s_evState == evBankProgram) || (s_evState == evBankVerify))
+    {
+        while (s_i32Erasing && (FMC->ISPTRG & FMC_ISPTRG_ISPGO_Msk))
+            ;
+
+        while (s_i32Hashing && (asset_verify_hash_poll(0xFFFFFFFFUL) > 0))
+            ;
+
+        s_i32Hashing = 0;
+
+        asset_bank_finish(evBankIdle);
+    }
+
+    return 0;
+}
+
+COMPONENT_EXPORT("ASSET_BANK", asset_bank_init, asset_bank_fini);
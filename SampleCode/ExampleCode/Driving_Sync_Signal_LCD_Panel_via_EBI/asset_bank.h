@@ -0,0 +1,56 @@
+/**************************************************************************//**
+ * @file     asset_bank.h
+ * @brief    A/B asset partitions in the code-free APROM bank with background programming.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __ASSET_BANK_H__
+#define __ASSET_BANK_H__
+
+#include "NuMicro.h"
+#include "component.h"
+
+#define CONFIG_ASSET_BANK_OFFSET               0   /*!< First partition offset in APROM bank 1, the firmware stays in bank 0, see M55M1.scatter */
+#define CONFIG_ASSET_BANK_SIZE           0x40000   /*!< Size of each of the two adjacent partitions including its header, multiple of FMC_FLASH_PAGE_SIZE */
+#define CONFIG_ASSET_BANK_CHUNK_SIZE         512   /*!< Bytes read and programmed per step, multiple of 8 */
+#define CONFIG_ASSET_BANK_POLL_BYTES        4096   /*!< Rate limit, most bytes programmed per asset_bank_poll */
+#define CONFIG_ASSET_BANK_VERIFY_BYTES     16384   /*!< Bytes hashed in the background per asset_bank_poll */
+
+#define ASSET_BANK_MAGIC                0x4B4E4241UL   /*!< "ABNK" */
+#define ASSET_BANK_HDR_SIZE                   512UL    /*!< Header space in front of the pack */
+
+/* Reads u32Len bytes at u32Offset of the new pack into pvBuf, returns 0 or -1. */
+typedef int (*ASSET_BANK_READ)(void *pvUserData, uint32_t u32Offset, void *pvBuf, uint32_t u32Len);
+
+typedef struct
+{
+    uint32_t m_u32Updates;          /*!< Packs programmed, verified and committed */
+    uint32_t m_u32Failures;         /*!< Updates failed on read, program or digest */
+    uint32_t m_u32Pages;            /*!< Pages erased */
+    uint32_t m_u32Bytes;            /*!< Bytes programmed */
+    uint32_t m_u32LastKBps;         /*!< Throughput of the last update, from start to commit */
+    uint32_t m_u32MaxStallUs;       /*!< Longest single asset_bank_poll, the worst the caller was held */
+} S_ASSET_BANK_STATS;
+
+// Function to get the active asset pack, returns its base address in flash or NULL without a valid bank
+const void *asset_bank_get(uint32_t *pu32Len);
+
+// Function to start programming a new pack of u32Len bytes into the inactive bank, returns 0 or -1
+// pu32Digest is the SHA-256 of the pack, see asset_verify.h. The pack is erased, programmed and
+// verified from asset_bank_poll, then committed; the active bank is untouched until asset_bank_activate.
+int asset_bank_update(uint32_t u32Len, const uint32_t *pu32Digest, ASSET_BANK_READ pfnRead, void *pvUserData);
+
+// Function to advance the update within u32BudgetUs, returns 1 while updating, 0 when idle or -1 once on failure
+// Call from the idle part of the frame loop. Page erases and hash runs go on in the background between
+// polls. Code never waits on them, but a read of the active pack waits while a page erase is running.
+int asset_bank_poll(uint32_t u32BudgetUs);
+
+// Function to switch to the committed new bank, returns 0 or -1 without one
+// Call at a frame boundary and fetch asset_bank_get again; the old bank stays intact until the next update.
+int asset_bank_activate(void);
+
+// Function to get the asset bank statistics
+void asset_bank_get_stats(S_ASSET_BANK_STATS *psStats);
+
+#endif /* __ASSET_BANK_H__ */
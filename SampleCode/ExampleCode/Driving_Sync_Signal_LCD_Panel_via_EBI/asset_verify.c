@@ -0,0 +1,599 @@
+/**************************************************************************//**
+ * @file     asset_verify.c
+ * @brief    SHA-256 verified asset loading through the SHA DMA engine.
+ *
+ *           A load reads the asset in chunks through spim_async or
+ *           sdh_async. Each chunk that lands is handed to the SHA engine in
+ *           DMA cascade mode while the next chunk is still on the bus, so
+ *           only the hash of the last chunk is left when the read is done.
+ *           Digests that matched are remembered by asset ID, and a later
+ *           load of the same asset from the same place skips the hash.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "asset_verify.h"
+#include "spim_async.h"
+#include "sdh_async.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_ASSET_QUEUE_MASK     (CONFIG_ASSET_VERIFY_QUEUE_NUM - 1)
+#define DEF_ASSET_SHA_BLOCK      64UL           /*!< Cascade runs other than the last are whole SHA-256 blocks */
+#define DEF_ASSET_DEV_MEM        evBlkDevCNT    /*!< Cache key of assets verified by asset_verify_copy */
+
+#if (CONFIG_ASSET_VERIFY_CHUNK_SIZE % SDH_BLOCK_SIZE) || (CONFIG_ASSET_VERIFY_CHUNK_SIZE % DEF_ASSET_SHA_BLOCK)
+    #error "CONFIG_ASSET_VERIFY_CHUNK_SIZE must be a multiple of SDH_BLOCK_SIZE and the SHA block."
+#endif
+
+typedef struct
+{
+    S_ASSET_DESC      m_sDesc;
+    uint8_t          *m_pu8Dst;
+    ASSET_VERIFY_CB   m_pfnCb;
+    void             *m_pvUserData;
+    int               m_i32Started;
+    int               m_i32Hash;           // 0 on a cached digest, the data is only read
+    int               m_i32SpimId;
+    uint32_t          m_u32Issued;         // Bytes with SD reads queued
+    volatile uint32_t m_u32Landed;         // Bytes in pvDst, advanced by read callbacks
+    uint32_t          m_u32Hashed;         // Bytes through the SHA engine
+    uint32_t          m_u32HashRun;        // Bytes of the SHA run in flight, 0 if none
+    uint32_t          m_u32LandedCycles;   // DWT cycles when the last byte was seen landed
+    volatile int      m_i32Error;
+} S_ASSET_REQ;
+
+typedef struct
+{
+    uint32_t m_u32Id;
+    uint32_t m_u32Dev;
+    uint32_t m_u32Offset;
+    uint32_t m_u32Len;              // 0 for an unused entry
+    uint32_t m_au32Digest[8];
+} S_ASSET_CACHE;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_ASSET_REQ s_asReq[CONFIG_ASSET_VERIFY_QUEUE_NUM];
+static uint32_t s_u32Head = 0;      // Next request to queue
+static uint32_t s_u32Tail = 0;      // Request being loaded
+
+static S_ASSET_CACHE s_asCache[CONFIG_ASSET_VERIFY_CACHE_NUM];
+static uint32_t s_u32CacheNext = 0; // Entry replaced by the next new asset
+
+/* In-place hash of asset_verify_hash_start, it owns the SHA engine until its result is taken. */
+static const uint8_t *s_pu8HashSrc = NULL;
+static uint32_t s_u32HashLen, s_u32HashDone, s_u32HashRun;
+static uint32_t s_au32HashDigest[8];
+
+static S_ASSET_VERIFY_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to find the verified digest of an asset at a place, returns entry index or -1
+static int asset_cache_find(uint32_t u32Id, uint32_t u32Dev, uint32_t u32Offset, uint32_t u32Len, const uint32_t *pu32Digest)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_ASSET_VERIFY_CACHE_NUM; i++)
+    {
+        S_ASSET_CACHE *psEntry = &s_asCache[i];
+
+        if (psEntry->m_u32Len && (psEntry->m_u32Id == u32Id) && (psEntry->m_u32Dev == u32Dev) &&
+                (psEntry->m_u32Offset == u32Offset) && (psEntry->m_u32Len == u32Len) &&
+                !memcmp(psEntry->m_au32Digest, pu32Digest, sizeof(psEntry->m_au32Digest)))
+            return i;
+    }
+
+    return -1;
+}
+
+// Function to remember a verified digest, replacing an older entry of the same asset ID
+static void asset_cache_insert(uint32_t u32Id, uint32_t u32Dev, uint32_t u32Offset, uint32_t u32Len, const uint32_t *pu32Digest)
+{
+    S_ASSET_CACHE *psEntry = NULL;
+    int i;
+
+    for (i = 0; i < CONFIG_ASSET_VERIFY_CACHE_NUM; i++)
+    {
+        if (s_asCache[i].m_u32Len && (s_asCache[i].m_u32Id == u32Id))
+        {
+            psEntry = &s_asCache[i];
+            break;
+        }
+    }
+
+    if (!psEntry)
+    {
+        psEntry = &s_asCache[s_u32CacheNext];
+        s_u32CacheNext = (s_u32CacheNext + 1) % CONFIG_ASSET_VERIFY_CACHE_NUM;
+    }
+
+    psEntry->m_u32Id = u32Id;
+    psEntry->m_u32Dev = u32Dev;
+    psEntry->m_u32Offset = u32Offset;
+    psEntry->m_u32Len = u32Len;
+    memcpy(psEntry->m_au32Digest, pu32Digest, sizeof(psEntry->m_au32Digest));
+}
+
+// Function to compare the digest of the SHA engine with the expected one, returns 0 on a match
+static int asset_sha_compare(const uint32_t *pu32Digest)
+{
+    uint32_t au32Digest[8];
+
+    SHA_Read(CONFIG_ASSET_VERIFY_CRYPTO, au32Digest);
+
+    return memcmp(au32Digest, pu32Digest, sizeof(au32Digest)) ? -1 : 0;
+}
+
+// Function to get the cycles per microsecond of the core clock
+static uint32_t asset_cycles_per_us(void)
+{
+    return (SystemCoreClock / 1000000UL) ? (SystemCoreClock / 1000000UL) : 1;
+}
+
+// Callback function for SPIM chunks of the loading asset
+static void asset_spim_cb(void *pvUserData, uint8_t *pu8Chunk, uint32_t u32Offset, uint32_t u32Len, int i32Status)
+{
+    S_ASSET_REQ *psReq = (S_ASSET_REQ *)pvUserData;
+
+    (void)pu8Chunk;
+
+    if (i32Status)
+        psReq->m_i32Error = 1;
+    else
+        psReq->m_u32Landed = u32Offset + u32Len;
+}
+
+// Callback function for SD chunk reads of the loading asset, reads retire in order
+static void asset_sd_cb(void *pvUserData, int i32Status)
+{
+    S_ASSET_REQ *psReq = (S_ASSET_REQ *)pvUserData;
+    uint32_t u32Len = psReq->m_sDesc.m_u32Len - psReq->m_u32Landed;
+
+    if (u32Len > CONFIG_ASSET_VERIFY_CHUNK_SIZE)
+        u32Len = CONFIG_ASSET_VERIFY_CHUNK_SIZE;
+
+    if (i32Status)
+        psReq->m_i32Error = 1;
+
+    psReq->m_u32Landed += u32Len;
+}
+
+// Function to queue SD chunk reads up to CONFIG_ASSET_VERIFY_SD_DEPTH ahead of the landed data
+static void asset_sd_issue(S_ASSET_REQ *psReq)
+{
+    uint32_t u32Len;
+    int i32Id;
+
+    while (!psReq->m_i32Error && (psReq->m_u32Issued < psReq->m_sDesc.m_u32Len) &&
+            ((psReq->m_u32Issued - psReq->m_u32Landed) < (CONFIG_ASSET_VERIFY_SD_DEPTH * CONFIG_ASSET_VERIFY_CHUNK_SIZE)))
+    {
+        u32Len = psReq->m_sDesc.m_u32Len - psReq->m_u32Issued;
+
+        if (u32Len > CONFIG_ASSET_VERIFY_CHUNK_SIZE)
+            u32Len = CONFIG_ASSET_VERIFY_CHUNK_SIZE;
+
+        i32Id = sdh_async_read((psReq->m_sDesc.m_u32Offset + psReq->m_u32Issued) / SDH_BLOCK_SIZE,
+                               &psReq->m_pu8Dst[psReq->m_u32Issued], NVT_ALIGN(u32Len, SDH_BLOCK_SIZE) / SDH_BLOCK_SIZE,
+                               asset_sd_cb, psReq);
+
+        /* A full SDH queue is retried on the next poll. */
+        if (i32Id < 0)
+            break;
+
+        psReq->m_u32Issued += u32Len;
+    }
+}
+
+// Function to start reading the loading asset, returns 0 or -1
+static int asset_load_start(S_ASSET_REQ *psReq)
+{
+    psReq->m_i32Started = 1;
+
+    if (psReq->m_i32Hash)
+    {
+        SHA_CLR_INT_FLAG(CONFIG_ASSET_VERIFY_CRYPTO);
+        SHA_Open(CONFIG_ASSET_VERIFY_CRYPTO, SHA_MODE_SHA256, SHA_IN_SWAP, 0);
+    }
+
+    if (psReq->m_sDesc.m_evDev == evBlkDevSpim)
+    {
+        psReq->m_i32SpimId = spim_async_read(psReq->m_sDesc.m_u32Offset, psReq->m_pu8Dst, psReq->m_sDesc.m_u32Len,
+                                             CONFIG_ASSET_VERIFY_CHUNK_SIZE, asset_spim_cb, psReq);
+
+        /* The SPIM queue is full, try again on the next poll. */
+        if (psReq->m_i32SpimId < 0)
+            psReq->m_i32Started = 0;
+    }
+    else
+    {
+        asset_sd_issue(psReq);
+    }
+
+    return psReq->m_i32Started ? 0 : -1;
+}
+
+// Function to check whether reads of the loading asset are still running
+static int asset_load_reading(S_ASSET_REQ *psReq)
+{
+    if (psReq->m_sDesc.m_evDev == evBlkDevSpim)
+        return spim_async_pending(psReq->m_i32SpimId);
+
+    return psReq->m_u32Landed < psReq->m_u32Issued;
+}
+
+// Function to feed landed data to the SHA engine, returns 1 while a run is in flight
+static int asset_load_hash(S_ASSET_REQ *psReq)
+{
+    CRYPTO_T *crypto = CONFIG_ASSET_VERIFY_CRYPTO;
+    uint32_t u32Len = psReq->m_sDesc.m_u32Len;
+    uint32_t u32Run, u32DMAMode;
+
+    if (psReq->m_u32HashRun)
+    {
+        uint32_t u32IntSts = SHA_GET_INT_FLAG(crypto);
+
+        if (!u32IntSts)
+            return 1;
+
+        SHA_CLR_INT_FLAG(crypto);
+
+        if (u32IntSts & CRYPTO_INTSTS_HMACEIF_Msk)
+            psReq->m_i32Error = 1;
+
+        psReq->m_u32Hashed += psReq->m_u32HashRun;
+        s_sStats.m_u32Bytes += psReq->m_u32HashRun;
+        psReq->m_u32HashRun = 0;
+    }
+
+    if (psReq->m_i32Error)
+        return 0;
+
+    u32Run = psReq->m_u32Landed - psReq->m_u32Hashed;
+
+    if ((psReq->m_u32Hashed + u32Run) < u32Len)
+        u32Run &= ~(DEF_ASSET_SHA_BLOCK - 1);
+
+    if (!u32Run)
+        return 0;
+
+    if (psReq->m_u32Hashed == 0)
+        u32DMAMode = (u32Run == u32Len) ? CRYPTO_DMA_ONE_SHOT : CRYPTO_DMA_FIRST;
+    else
+        u32DMAMode = ((psReq->m_u32Hashed + u32Run) == u32Len) ? CRYPTO_DMA_LAST : CRYPTO_DMA_CONTINUE;
+
+    SHA_SetDMATransfer(crypto, (uint32_t)&psReq->m_pu8Dst[psReq->m_u32Hashed], u32Run);
+    SHA_Start(crypto, u32DMAMode);
+
+    psReq->m_u32HashRun = u32Run;
+
+    return 1;
+}
+
+// Function to queue a verified load of an asset into pvDst
+int asset_verify_load(const S_ASSET_DESC *psDesc, void *pvDst, ASSET_VERIFY_CB pfnCb, void *pvUserData)
+{
+    S_ASSET_REQ *psReq;
+
+    if (!psDesc || !psDesc->m_u32Len || (psDesc->m_evDev >= evBlkDevCNT) ||
+            ((uint32_t)pvDst & (DCACHE_LINE_SIZE - 1)))
+        return -1;
+
+    if ((psDesc->m_evDev == evBlkDevSd) && (psDesc->m_u32Offset % SDH_BLOCK_SIZE))
+        return -1;
+
+    if ((s_u32Head - s_u32Tail) >= CONFIG_ASSET_VERIFY_QUEUE_NUM)
+        return -1;
+
+    psReq = &s_asReq[s_u32Head & DEF_ASSET_QUEUE_MASK];
+
+    psReq->m_sDesc = *psDesc;
+    psReq->m_pu8Dst = (uint8_t *)pvDst;
+    psReq->m_pfnCb = pfnCb;
+    psReq->m_pvUserData = pvUserData;
+    psReq->m_i32Started = 0;
+    psReq->m_i32Hash = (asset_cache_find(psDesc->m_u32Id, psDesc->m_evDev, psDesc->m_u32Offset,
+                                         psDesc->m_u32Len, psDesc->m_au32Digest) < 0);
+    psReq->m_i32SpimId = -1;
+    psReq->m_u32Issued = 0;
+    psReq->m_u32Landed = 0;
+    psReq->m_u32Hashed = 0;
+    psReq->m_u32HashRun = 0;
+    psReq->m_u32LandedCycles = 0;
+    psReq->m_i32Error = 0;
+
+    s_u32Head++;
+
+    return 0;
+}
+
+// Function to advance the loads and run the callbacks of finished ones
+int asset_verify_poll(void)
+{
+    while (s_u32Head != s_u32Tail)
+    {
+        S_ASSET_REQ *psReq = &s_asReq[s_u32Tail & DEF_ASSET_QUEUE_MASK];
+        int i32Status;
+
+        if (!psReq->m_i32Started && (s_pu8HashSrc || (asset_load_start(psReq) < 0)))
+            break;
+
+        /* Read callbacks run from here and advance m_u32Landed. */
+        if (psReq->m_sDesc.m_evDev == evBlkDevSpim)
+        {
+            spim_async_poll();
+        }
+        else
+        {
+            sdh_async_poll();
+            asset_sd_issue(psReq);
+        }
+
+        /* Stamp the moment all data is in, what follows is the cost of verification. */
+        if (!psReq->m_u32LandedCycles && (psReq->m_u32Landed == psReq->m_sDesc.m_u32Len))
+            psReq->m_u32LandedCycles = DWT->CYCCNT;
+
+        if (psReq->m_i32Hash && asset_load_hash(psReq))
+            break;
+
+        if (asset_load_reading(psReq))
+            break;
+
+        /* SD reads left unissued after an error are never sent. */
+        if (!psReq->m_i32Error && (psReq->m_u32Landed < psReq->m_sDesc.m_u32Len))
+            break;
+
+        if (psReq->m_i32Error)
+        {
+            i32Status = -1;
+            s_sStats.m_u32Errors++;
+        }
+        else if (!psReq->m_i32Hash)
+        {
+            i32Status = 0;
+            s_sStats.m_u32CacheHits++;
+        }
+        else
+        {
+            uint32_t u32TailUs;
+
+            i32Status = asset_sha_compare(psReq->m_sDesc.m_au32Digest);
+
+            u32TailUs = (DWT->CYCCNT - psReq->m_u32LandedCycles) / asset_cycles_per_us();
+            s_sStats.m_u32LastTailUs = u32TailUs;
+
+            if (u32TailUs > s_sStats.m_u32MaxTailUs)
+                s_sStats.m_u32MaxTailUs = u32TailUs;
+
+            if (i32Status == 0)
+            {
+                s_sStats.m_u32Verified++;
+                asset_cache_insert(psReq->m_sDesc.m_u32Id, psReq->m_sDesc.m_evDev, psReq->m_sDesc.m_u32Offset,
+                                   psReq->m_sDesc.m_u32Len, psReq->m_sDesc.m_au32Digest);
+            }
+            else
+            {
+                s_sStats.m_u32Mismatches++;
+            }
+        }
+
+        s_u32Tail++;
+
+        if (psReq->m_pfnCb)
+            psReq->m_pfnCb(psReq->m_pvUserData, &psReq->m_sDesc, i32Status);
+    }
+
+    return (int)(s_u32Head - s_u32Tail);
+}
+
+// Function to copy an asset already in memory and verify it
+int asset_verify_copy(uint32_t u32Id, void *pvDst, const void *pvSrc, uint32_t u32Len, const uint32_t *pu32Digest)
+{
+    CRYPTO_T *crypto = CONFIG_ASSET_VERIFY_CRYPTO;
+    uint32_t u32IntSts;
+    int i32Status;
+
+    if (!pvSrc || !u32Len || !pu32Digest || s_pu8HashSrc)
+        return -1;
+
+    if (pvDst && asset_cache_find(u32Id, DEF_ASSET_DEV_MEM, (uint32_t)pvSrc, u32Len, pu32Digest) >= 0)
+    {
+        memcpy(pvDst, pvSrc, u32Len);
+        s_sStats.m_u32CacheHits++;
+        return 0;
+    }
+
+    /* The cascade of a queued load cannot be interleaved with this hash. */
+    while (asset_verify_poll())
+        ;
+
+    /* The engine reads memory, not the D-cache. */
+    SCB_CleanDCache_by_Addr((void *)pvSrc, (int32_t)u32Len);
+
+    SHA_CLR_INT_FLAG(crypto);
+    SHA_Open(crypto, SHA_MODE_SHA256, SHA_IN_SWAP, 0);
+    SHA_SetDMATransfer(crypto, (uint32_t)pvSrc, u32Len);
+    SHA_Start(crypto, CRYPTO_DMA_ONE_SHOT);
+
+    if (pvDst)
+        memcpy(pvDst, pvSrc, u32Len);
+
+    while (!(u32IntSts = SHA_GET_INT_FLAG(crypto)))
+        ;
+
+    SHA_CLR_INT_FLAG(crypto);
+
+    s_sStats.m_u32Bytes += u32Len;
+
+    if (u32IntSts & CRYPTO_INTSTS_HMACEIF_Msk)
+    {
+        s_sStats.m_u32Errors++;
+        return -1;
+    }
+
+    i32Status = asset_sha_compare(pu32Digest);
+
+    if (i32Status == 0)
+    {
+        s_sStats.m_u32Verified++;
+
+        if (pvDst)
+            asset_cache_insert(u32Id, DEF_ASSET_DEV_MEM, (uint32_t)pvSrc, u32Len, pu32Digest);
+    }
+    else
+    {
+        s_sStats.m_u32Mismatches++;
+    }
+
+    return i32Status;
+}
+
+// Function to start hashing memory in place over several polls
+int asset_verify_hash_start(const void *pvSrc, uint32_t u32Len, const uint32_t *pu32Digest)
+{
+    if (!pvSrc || !u32Len || !pu32Digest || s_pu8HashSrc)
+        return -1;
+
+    /* A load already started keeps its cascade on the engine. */
+    if ((s_u32Head != s_u32Tail) && s_asReq[s_u32Tail & DEF_ASSET_QUEUE_MASK].m_i32Started)
+        return -1;
+
+    /* The engine reads memory, not the D-cache. */
+    SCB_CleanDCache_by_Addr((void *)pvSrc, (int32_t)u32Len);
+
+    SHA_CLR_INT_FLAG(CONFIG_ASSET_VERIFY_CRYPTO);
+    SHA_Open(CONFIG_ASSET_VERIFY_CRYPTO, SHA_MODE_SHA256, SHA_IN_SWAP, 0);
+
+    s_pu8HashSrc = (const uint8_t *)pvSrc;
+    s_u32HashLen = u32Len;
+    s_u32HashDone = 0;
+    s_u32HashRun = 0;
+    memcpy(s_au32HashDigest, pu32Digest, sizeof(s_au32HashDigest));
+
+    return 0;
+}
+
+// Function to hash the next run of at most u32MaxBytes in the background
+int asset_verify_hash_poll(uint32_t u32MaxBytes)
+{
+    CRYPTO_T *crypto = CONFIG_ASSET_VERIFY_CRYPTO;
+    uint32_t u32Run, u32DMAMode;
+    int i32Status;
+
+    if (!s_pu8HashSrc)
+        return -1;
+
+    if (s_u32HashRun)
+    {
+        uint32_t u32IntSts = SHA_GET_INT_FLAG(crypto);
+
+        if (!u32IntSts)
+            return 1;
+
+        SHA_CLR_INT_FLAG(crypto);
+
+        s_u32HashDone += s_u32HashRun;
+        s_sStats.m_u32Bytes += s_u32HashRun;
+        s_u32HashRun = 0;
+
+        if (u32IntSts & CRYPTO_INTSTS_HMACEIF_Msk)
+        {
+            s_pu8HashSrc = NULL;
+            s_sStats.m_u32Errors++;
+            return -1;
+        }
+    }
+
+    if (s_u32HashDone == s_u32HashLen)
+    {
+        i32Status = asset_sha_compare(s_au32HashDigest);
+        s_pu8HashSrc = NULL;
+
+        if (i32Status == 0)
+            s_sStats.m_u32Verified++;
+        else
+            s_sStats.m_u32Mismatches++;
+
+        return i32Status;
+    }
+
+    /* Runs other than the last are whole SHA blocks, at least one. */
+    u32Run = s_u32HashLen - s_u32HashDone;
+
+    if (u32Run > u32MaxBytes)
+    {
+        u32Run = u32MaxBytes & ~(DEF_ASSET_SHA_BLOCK - 1);
+
+        if (!u32Run)
+            u32Run = DEF_ASSET_SHA_BLOCK;
+
+        if (u32Run > (s_u32HashLen - s_u32HashDone))
+            u32Run = s_u32HashLen - s_u32HashDone;
+    }
+
+    if (s_u32HashDone == 0)
+        u32DMAMode = (u32Run == s_u32HashLen) ? CRYPTO_DMA_ONE_SHOT : CRYPTO_DMA_FIRST;
+    else
+        u32DMAMode = ((s_u32HashDone + u32Run) == s_u32HashLen) ? CRYPTO_DMA_LAST : CRYPTO_DMA_CONTINUE;
+
+    SHA_SetDMATransfer(crypto, (uint32_t)&s_pu8HashSrc[s_u32HashDone], u32Run);
+    SHA_Start(crypto, u32DMAMode);
+
+    s_u32HashRun = u32Run;
+
+    return 1;
+}
+
+// Function to forget the verified digests of a device
+void asset_verify_invalidate(E_BLK_DEV evDev)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_ASSET_VERIFY_CACHE_NUM; i++)
+    {
+        if (s_asCache[i].m_u32Dev == (uint32_t)evDev)
+            s_asCache[i].m_u32Len = 0;
+    }
+}
+
+// Function to get the verification statistics
+void asset_verify_get_stats(S_ASSET_VERIFY_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to initialize asset verification
+static int asset_verify_init(void)
+{
+    memset(&s_sStats, 0, sizeof(s_sStats));
+    memset(s_asCache, 0, sizeof(s_asCache));
+    s_u32CacheNext = 0;
+
+    /* Tail times are counted in core cycles. */
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return 0;
+}
+
+// Function to deinitialize asset verification
+static int asset_verify_fini(void)
+{
+    /* Queued loads wait for an in-place hash to end. */
+    while (asset_verify_hash_poll(0xFFFFFFFFUL) > 0)
+        ;
+
+    while (asset_verify_poll())
+        ;
+
+    return 0;
+}
+
+COMPONENT_EXPORT("ASSET_VERIFY", asset_verify_init, asset_verify_fini);
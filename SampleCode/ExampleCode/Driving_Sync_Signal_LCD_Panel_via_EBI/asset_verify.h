@@ -0,0 +1,74 @@
+/**************************************************************************//**
+ * @file     asset_verify.h
+ * @brief    SHA-256 verified asset loading through the SHA DMA engine.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __ASSET_VERIFY_H__
+#define __ASSET_VERIFY_H__
+
+#include "NuMicro.h"
+#include "component.h"
+#include "blk_cache.h"
+
+#define CONFIG_ASSET_VERIFY_CRYPTO          CRYPTO   /*!< Crypto engine running the SHA DMA */
+#define CONFIG_ASSET_VERIFY_QUEUE_NUM            4   /*!< Outstanding loads, power of 2 */
+#define CONFIG_ASSET_VERIFY_CHUNK_SIZE        8192   /*!< Bytes per read, multiple of SDH_BLOCK_SIZE and the SHA block */
+#define CONFIG_ASSET_VERIFY_SD_DEPTH             2   /*!< SD chunk reads kept queued ahead of the hash */
+#define CONFIG_ASSET_VERIFY_CACHE_NUM           32   /*!< Verified digests remembered */
+
+/* Entry of a signed pack manifest. m_au32Digest[i] holds bytes 4i..4i+3 of the SHA-256 digest as a
+   big-endian word. The manifest itself is authenticated by the caller. */
+typedef struct
+{
+    uint32_t  m_u32Id;              /*!< Asset ID */
+    E_BLK_DEV m_evDev;              /*!< Device holding the asset */
+    uint32_t  m_u32Offset;          /*!< Flash address, or SD byte address on a sector boundary */
+    uint32_t  m_u32Len;             /*!< Asset size in bytes */
+    uint32_t  m_au32Digest[8];      /*!< Expected SHA-256 digest */
+} S_ASSET_DESC;
+
+/* Called once per load. i32Status is 0 when the data in pvDst matches the digest, or -1 on a
+   mismatch or read error; the data must not be shown then. */
+typedef void (*ASSET_VERIFY_CB)(void *pvUserData, const S_ASSET_DESC *psDesc, int i32Status);
+
+typedef struct
+{
+    uint32_t m_u32Verified;         /*!< Loads hashed and matched */
+    uint32_t m_u32CacheHits;        /*!< Loads that skipped hashing on a cached digest */
+    uint32_t m_u32Mismatches;       /*!< Loads failed on the digest */
+    uint32_t m_u32Errors;           /*!< Loads failed by the device */
+    uint32_t m_u32Bytes;            /*!< Bytes hashed */
+    uint32_t m_u32LastTailUs;       /*!< Time from the last byte landing to the verdict of the last load */
+    uint32_t m_u32MaxTailUs;        /*!< Worst tail time */
+} S_ASSET_VERIFY_STATS;
+
+// Function to queue a verified load of an asset into pvDst, returns 0 or -1 on a full queue
+// pvDst must be DCACHE_LINE_SIZE aligned and hold m_u32Len rounded up to SDH_BLOCK_SIZE. Every chunk
+// is hashed as soon as it lands, while the next one is read.
+int asset_verify_load(const S_ASSET_DESC *psDesc, void *pvDst, ASSET_VERIFY_CB pfnCb, void *pvUserData);
+
+// Function to advance the loads and run the callbacks of finished ones, returns the loads outstanding
+int asset_verify_poll(void);
+
+// Function to copy an asset already in memory, e.g. an INCBIN, and verify it, returns 0 or -1
+// The SHA engine hashes pvSrc while the CPU copies it. Queued loads are finished first. pvDst NULL
+// only hashes pvSrc in place and bypasses the digest cache, for memory that may be rewritten.
+int asset_verify_copy(uint32_t u32Id, void *pvDst, const void *pvSrc, uint32_t u32Len, const uint32_t *pu32Digest);
+
+// Function to start hashing memory in place over several polls, returns 0 or -1 while the engine is busy
+// Loads queued meanwhile wait, and asset_verify_copy fails, until asset_verify_hash_poll reports the result.
+int asset_verify_hash_start(const void *pvSrc, uint32_t u32Len, const uint32_t *pu32Digest);
+
+// Function to hash the next run of at most u32MaxBytes in the background, returns 1 while hashing,
+// 0 on a match or -1 on a mismatch or without a hash started
+int asset_verify_hash_poll(uint32_t u32MaxBytes);
+
+// Function to forget the verified digests of a device, e.g. after its content was rewritten
+void asset_verify_invalidate(E_BLK_DEV evDev);
+
+// Function to get the verification statistics
+void asset_verify_get_stats(S_ASSET_VERIFY_STATS *psStats);
+
+#endif /* __ASSET_VERIFY_H__ */
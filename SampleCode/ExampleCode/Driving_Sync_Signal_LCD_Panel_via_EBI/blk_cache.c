@@ -0,0 +1,463 @@
+/**************************************************************************//**
+ * @file     blk_cache.c
+ * @brief    Read-ahead block cache for SD card and SPIM flash assets.
+ *
+ *           Blocks are found through a chained hash table and kept in an
+ *           LRU list, both indexed by entry number so lookup, touch and
+ *           eviction are O(1). Loads go through spim_async and sdh_async;
+ *           a block being loaded is off the LRU list and cannot be evicted.
+ *           A reader walking blocks in order triggers read-ahead of the
+ *           next CONFIG_BLK_CACHE_READ_AHEAD blocks.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "blk_cache.h"
+#include "spim_async.h"
+#include "sdh_async.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_BLK_HASH_NUM         (2 * CONFIG_BLK_CACHE_BLOCK_MAX)   /*!< Power of 2 */
+#define DEF_BLK_NIL              (-1)
+#define DEF_BLK_SECTORS          (CONFIG_BLK_CACHE_BLOCK_SIZE / SDH_BLOCK_SIZE)
+
+typedef enum
+{
+    evBlkFree,
+    evBlkLoading,
+    evBlkValid,
+} E_BLK_STATE;
+
+typedef struct
+{
+    uint32_t  m_u32Blk;
+    uint8_t   m_u8Dev;
+    uint8_t   m_u8State;
+    uint8_t   m_u8Prefetched;      // Loaded ahead and not used yet
+    int16_t   m_i16HashNext;
+    int16_t   m_i16Prev;           // LRU neighbours, toward LRU head
+    int16_t   m_i16Next;           // LRU neighbours, toward MRU tail
+    uint8_t  *m_pu8Data;
+} S_BLK_ENTRY;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static uint8_t s_au8Pool[CONFIG_BLK_CACHE_POOL_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE)));
+
+static S_BLK_ENTRY s_asEntry[CONFIG_BLK_CACHE_BLOCK_MAX];
+static int16_t s_ai16Hash[DEF_BLK_HASH_NUM];
+static int s_i32EntryNum = 0;
+
+static int16_t s_i16LruHead = DEF_BLK_NIL;     // Least recently used
+static int16_t s_i16LruTail = DEF_BLK_NIL;     // Most recently used
+static volatile int s_i32Loading = 0;
+
+static uint32_t s_au32LastBlk[evBlkDevCNT];    // Block of the previous read per device
+static int s_ai32SeqRun[evBlkDevCNT];          // Consecutive blocks read in order
+
+static S_BLK_CACHE_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to hash a device block to a bucket
+static uint32_t blk_cache_hash(E_BLK_DEV evDev, uint32_t u32Blk)
+{
+    return ((u32Blk * 2654435761UL) ^ ((uint32_t)evDev << 7)) & (DEF_BLK_HASH_NUM - 1);
+}
+
+// Function to find the entry of a device block
+static int blk_cache_find(E_BLK_DEV evDev, uint32_t u32Blk)
+{
+    int16_t i16Idx = s_ai16Hash[blk_cache_hash(evDev, u32Blk)];
+
+    while (i16Idx != DEF_BLK_NIL)
+    {
+        S_BLK_ENTRY *psEntry = &s_asEntry[i16Idx];
+
+        if ((psEntry->m_u32Blk == u32Blk) && (psEntry->m_u8Dev == evDev))
+            return i16Idx;
+
+        i16Idx = psEntry->m_i16HashNext;
+    }
+
+    return DEF_BLK_NIL;
+}
+
+// Function to link an entry into its hash bucket
+static void blk_cache_hash_insert(int i32Idx)
+{
+    S_BLK_ENTRY *psEntry = &s_asEntry[i32Idx];
+    uint32_t u32Bucket = blk_cache_hash((E_BLK_DEV)psEntry->m_u8Dev, psEntry->m_u32Blk);
+
+    psEntry->m_i16HashNext = s_ai16Hash[u32Bucket];
+    s_ai16Hash[u32Bucket] = (int16_t)i32Idx;
+}
+
+// Function to unlink an entry from its hash bucket
+static void blk_cache_hash_remove(int i32Idx)
+{
+    S_BLK_ENTRY *psEntry = &s_asEntry[i32Idx];
+    int16_t *pi16Link = &s_ai16Hash[blk_cache_hash((E_BLK_DEV)psEntry->m_u8Dev, psEntry->m_u32Blk)];
+
+    /* Chains stay about one entry long, the walk is constant time. */
+    while (*pi16Link != DEF_BLK_NIL)
+    {
+        if (*pi16Link == i32Idx)
+        {
+            *pi16Link = psEntry->m_i16HashNext;
+            break;
+        }
+
+        pi16Link = &s_asEntry[*pi16Link].m_i16HashNext;
+    }
+}
+
+// Function to unlink an entry from the LRU list
+static void blk_cache_lru_remove(int i32Idx)
+{
+    S_BLK_ENTRY *psEntry = &s_asEntry[i32Idx];
+
+    if (psEntry->m_i16Prev != DEF_BLK_NIL)
+        s_asEntry[psEntry->m_i16Prev].m_i16Next = psEntry->m_i16Next;
+    else
+        s_i16LruHead = psEntry->m_i16Next;
+
+    if (psEntry->m_i16Next != DEF_BLK_NIL)
+        s_asEntry[psEntry->m_i16Next].m_i16Prev = psEntry->m_i16Prev;
+    else
+        s_i16LruTail = psEntry->m_i16Prev;
+
+    psEntry->m_i16Prev = psEntry->m_i16Next = DEF_BLK_NIL;
+}
+
+// Function to append an entry at the MRU end, free entries go to the LRU end
+static void blk_cache_lru_insert(int i32Idx)
+{
+    S_BLK_ENTRY *psEntry = &s_asEntry[i32Idx];
+
+    if (psEntry->m_u8State == evBlkFree)
+    {
+        psEntry->m_i16Prev = DEF_BLK_NIL;
+        psEntry->m_i16Next = s_i16LruHead;
+
+        if (s_i16LruHead != DEF_BLK_NIL)
+            s_asEntry[s_i16LruHead].m_i16Prev = (int16_t)i32Idx;
+        else
+            s_i16LruTail = (int16_t)i32Idx;
+
+        s_i16LruHead = (int16_t)i32Idx;
+    }
+    else
+    {
+        psEntry->m_i16Next = DEF_BLK_NIL;
+        psEntry->m_i16Prev = s_i16LruTail;
+
+        if (s_i16LruTail != DEF_BLK_NIL)
+            s_asEntry[s_i16LruTail].m_i16Next = (int16_t)i32Idx;
+        else
+            s_i16LruHead = (int16_t)i32Idx;
+
+        s_i16LruTail = (int16_t)i32Idx;
+    }
+}
+
+// Function to finish the load of an entry, i32Status 0 makes it valid
+static void blk_cache_load_done(S_BLK_ENTRY *psEntry, int i32Status)
+{
+    int i32Idx = psEntry - s_asEntry;
+
+    if (i32Status == 0)
+    {
+        psEntry->m_u8State = evBlkValid;
+    }
+    else
+    {
+        s_sStats.m_u32Errors++;
+        blk_cache_hash_remove(i32Idx);
+        psEntry->m_u8State = evBlkFree;
+    }
+
+    blk_cache_lru_insert(i32Idx);
+    s_i32Loading--;
+}
+
+// SPIM chunk callback, the chunk size is one block
+static void blk_cache_spim_done(void *pvUserData, uint8_t *pu8Chunk, uint32_t u32Offset, uint32_t u32Len, int i32Status)
+{
+    blk_cache_load_done((S_BLK_ENTRY *)pvUserData, i32Status);
+}
+
+// SDH request callback
+static void blk_cache_sdh_done(void *pvUserData, int i32Status)
+{
+    blk_cache_load_done((S_BLK_ENTRY *)pvUserData, i32Status);
+}
+
+// Function to claim the least recently used entry and start loading a block into it, returns entry or -1
+static int blk_cache_load(E_BLK_DEV evDev, uint32_t u32Blk, int i32Prefetch)
+{
+    int i32Idx = s_i16LruHead;
+    S_BLK_ENTRY *psEntry;
+    int i32Ret;
+
+    /* Every entry is loading. */
+    if (i32Idx == DEF_BLK_NIL)
+        return -1;
+
+    psEntry = &s_asEntry[i32Idx];
+
+    blk_cache_lru_remove(i32Idx);
+
+    if (psEntry->m_u8State == evBlkValid)
+    {
+        blk_cache_hash_remove(i32Idx);
+        s_sStats.m_u32Evictions++;
+    }
+
+    psEntry->m_u32Blk = u32Blk;
+    psEntry->m_u8Dev = (uint8_t)evDev;
+    psEntry->m_u8State = evBlkLoading;
+    psEntry->m_u8Prefetched = (uint8_t)i32Prefetch;
+    blk_cache_hash_insert(i32Idx);
+    s_i32Loading++;
+
+    if (evDev == evBlkDevSpim)
+        i32Ret = spim_async_read(u32Blk * CONFIG_BLK_CACHE_BLOCK_SIZE, psEntry->m_pu8Data, CONFIG_BLK_CACHE_BLOCK_SIZE,
+                                 CONFIG_BLK_CACHE_BLOCK_SIZE, blk_cache_spim_done, psEntry);
+    else
+        i32Ret = sdh_async_read(u32Blk * DEF_BLK_SECTORS, psEntry->m_pu8Data, DEF_BLK_SECTORS, blk_cache_sdh_done, psEntry);
+
+    /* Device queue full, hand the entry back. */
+    if (i32Ret < 0)
+    {
+        blk_cache_hash_remove(i32Idx);
+        psEntry->m_u8State = evBlkFree;
+        blk_cache_lru_insert(i32Idx);
+        s_i32Loading--;
+        return -1;
+    }
+
+    if (i32Prefetch)
+        s_sStats.m_u32Prefetches++;
+
+    return i32Idx;
+}
+
+// Function to complete finished loads, call from the main loop while prefetches run
+void blk_cache_poll(void)
+{
+    spim_async_poll();
+    sdh_async_poll();
+}
+
+// Function to get a valid block, loading it on a miss, returns entry or -1
+static int blk_cache_get(E_BLK_DEV evDev, uint32_t u32Blk)
+{
+    int i32Idx = blk_cache_find(evDev, u32Blk);
+
+    if (i32Idx != DEF_BLK_NIL)
+    {
+        S_BLK_ENTRY *psEntry = &s_asEntry[i32Idx];
+
+        s_sStats.m_u32Hits++;
+
+        if (psEntry->m_u8Prefetched)
+        {
+            s_sStats.m_u32PrefetchHits++;
+            psEntry->m_u8Prefetched = 0;
+        }
+    }
+    else
+    {
+        s_sStats.m_u32Misses++;
+
+        while ((i32Idx = blk_cache_load(evDev, u32Blk, 0)) < 0)
+        {
+            /* Nothing to evict and no load running to wait for. */
+            if (!s_i32Loading)
+                return -1;
+
+            blk_cache_poll();
+        }
+    }
+
+    /* A prefetch or the load above may still be on the bus. */
+    while (s_asEntry[i32Idx].m_u8State == evBlkLoading)
+        blk_cache_poll();
+
+    if ((s_asEntry[i32Idx].m_u8State != evBlkValid) || (s_asEntry[i32Idx].m_u32Blk != u32Blk))
+        return -1;
+
+    blk_cache_lru_remove(i32Idx);
+    blk_cache_lru_insert(i32Idx);
+
+    return i32Idx;
+}
+
+// Function to read u32Len bytes at u32Offset of a device through the cache, returns 0 or -1
+int blk_cache_read(E_BLK_DEV evDev, uint32_t u32Offset, void *pvDst, uint32_t u32Len)
+{
+    uint8_t *pu8Dst = (uint8_t *)pvDst;
+
+    if ((evDev >= evBlkDevCNT) || !pvDst || !s_i32EntryNum)
+        return -1;
+
+    while (u32Len)
+    {
+        uint32_t u32Blk = u32Offset / CONFIG_BLK_CACHE_BLOCK_SIZE;
+        uint32_t u32InBlk = u32Offset % CONFIG_BLK_CACHE_BLOCK_SIZE;
+        uint32_t u32Copy = CONFIG_BLK_CACHE_BLOCK_SIZE - u32InBlk;
+        int i32Idx;
+
+        if (u32Copy > u32Len)
+            u32Copy = u32Len;
+
+        /* Sequential reader, keep the next blocks on the way. */
+        if (u32Blk == s_au32LastBlk[evDev] + 1)
+        {
+            if (++s_ai32SeqRun[evDev] >= 2)
+                blk_cache_prefetch(evDev, (u32Blk + 1) * CONFIG_BLK_CACHE_BLOCK_SIZE, CONFIG_BLK_CACHE_READ_AHEAD * CONFIG_BLK_CACHE_BLOCK_SIZE);
+        }
+        else if (u32Blk != s_au32LastBlk[evDev])
+        {
+            s_ai32SeqRun[evDev] = 0;
+        }
+
+        s_au32LastBlk[evDev] = u32Blk;
+
+        if ((i32Idx = blk_cache_get(evDev, u32Blk)) < 0)
+            return -1;
+
+        memcpy(pu8Dst, s_asEntry[i32Idx].m_pu8Data + u32InBlk, u32Copy);
+
+        pu8Dst += u32Copy;
+        u32Offset += u32Copy;
+        u32Len -= u32Copy;
+    }
+
+    return 0;
+}
+
+// Function to start loading the blocks of a range without waiting, returns the number of loads started
+int blk_cache_prefetch(E_BLK_DEV evDev, uint32_t u32Offset, uint32_t u32Len)
+{
+    uint32_t u32Blk, u32BlkEnd;
+    int i32Count = 0;
+
+    if ((evDev >= evBlkDevCNT) || !u32Len || !s_i32EntryNum)
+        return 0;
+
+    u32BlkEnd = (u32Offset + u32Len - 1) / CONFIG_BLK_CACHE_BLOCK_SIZE;
+
+    for (u32Blk = u32Offset / CONFIG_BLK_CACHE_BLOCK_SIZE; u32Blk <= u32BlkEnd; u32Blk++)
+    {
+        if (blk_cache_find(evDev, u32Blk) != DEF_BLK_NIL)
+            continue;
+
+        /* Never let hints push out more than half of the cache. */
+        if ((s_i32Loading * 2) >= s_i32EntryNum)
+            break;
+
+        if (blk_cache_load(evDev, u32Blk, 1) < 0)
+            break;
+
+        i32Count++;
+    }
+
+    return i32Count;
+}
+
+// Function to drop all blocks of a device, e.g. after its content was rewritten
+void blk_cache_invalidate(E_BLK_DEV evDev)
+{
+    int i;
+
+    for (i = 0; i < s_i32EntryNum; i++)
+    {
+        S_BLK_ENTRY *psEntry = &s_asEntry[i];
+
+        if ((psEntry->m_u8State != evBlkValid) || (psEntry->m_u8Dev != evDev))
+            continue;
+
+        blk_cache_hash_remove(i);
+        blk_cache_lru_remove(i);
+        psEntry->m_u8State = evBlkFree;
+        blk_cache_lru_insert(i);
+    }
+
+    s_au32LastBlk[evDev] = 0;
+    s_ai32SeqRun[evDev] = 0;
+}
+
+// Function to move the cache onto another SRAM region, returns 0 or -1 while loads are running
+int blk_cache_set_region(void *pvBase, uint32_t u32Size)
+{
+    uint32_t u32Base = NVT_ALIGN((uint32_t)pvBase, DCACHE_LINE_SIZE);
+    int i;
+
+    if (s_i32Loading || !pvBase)
+        return -1;
+
+    u32Size -= (u32Base - (uint32_t)pvBase);
+
+    s_i32EntryNum = u32Size / CONFIG_BLK_CACHE_BLOCK_SIZE;
+
+    if (s_i32EntryNum > CONFIG_BLK_CACHE_BLOCK_MAX)
+        s_i32EntryNum = CONFIG_BLK_CACHE_BLOCK_MAX;
+
+    for (i = 0; i < DEF_BLK_HASH_NUM; i++)
+        s_ai16Hash[i] = DEF_BLK_NIL;
+
+    s_i16LruHead = s_i16LruTail = DEF_BLK_NIL;
+
+    for (i = 0; i < s_i32EntryNum; i++)
+    {
+        s_asEntry[i].m_u8State = evBlkFree;
+        s_asEntry[i].m_u8Prefetched = 0;
+        s_asEntry[i].m_i16HashNext = DEF_BLK_NIL;
+        s_asEntry[i].m_pu8Data = (uint8_t *)(u32Base + i * CONFIG_BLK_CACHE_BLOCK_SIZE);
+        blk_cache_lru_insert(i);
+    }
+
+    for (i = 0; i < evBlkDevCNT; i++)
+    {
+        s_au32LastBlk[i] = 0;
+        s_ai32SeqRun[i] = 0;
+    }
+
+    return (s_i32EntryNum > 0) ? 0 : -1;
+}
+
+// Function to get the cache statistics
+void blk_cache_get_stats(S_BLK_CACHE_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to initialize the block cache on the default region
+static int blk_cache_init(void)
+{
+    memset(&s_sStats, 0, sizeof(s_sStats));
+
+    return blk_cache_set_region(s_au8Pool, sizeof(s_au8Pool));
+}
+
+// Function to deinitialize the block cache
+static int blk_cache_fini(void)
+{
+    while (s_i32Loading)
+        blk_cache_poll();
+
+    s_i32EntryNum = 0;
+
+    return 0;
+}
+
+COMPONENT_EXPORT("BLK_CACHE", blk_cache_init, blk_cache_fini);
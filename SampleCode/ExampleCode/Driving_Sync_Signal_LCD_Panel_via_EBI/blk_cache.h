@@ -0,0 +1,55 @@
+/**************************************************************************//**
+ * @file     blk_cache.h
+ * @brief    Read-ahead block cache for SD card and SPIM flash assets.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __BLK_CACHE_H__
+#define __BLK_CACHE_H__
+
+#include "NuMicro.h"
+#include "component.h"
+
+#define CONFIG_BLK_CACHE_BLOCK_SIZE         4096   /*!< Bytes per block, multiple of SDH_BLOCK_SIZE and DCACHE_LINE_SIZE */
+#define CONFIG_BLK_CACHE_BLOCK_MAX            64   /*!< Most blocks a region can be cut into */
+#define CONFIG_BLK_CACHE_POOL_SIZE     (32*CONFIG_BLK_CACHE_BLOCK_SIZE)   /*!< Default region, see blk_cache_set_region */
+#define CONFIG_BLK_CACHE_READ_AHEAD            2   /*!< Blocks fetched ahead of a sequential reader */
+
+typedef enum
+{
+    evBlkDevSpim,            /*!< SPIM flash, offset is the flash address */
+    evBlkDevSd,              /*!< SD card, offset is the byte address on card */
+    evBlkDevCNT              /*!< Number of devices */
+} E_BLK_DEV;
+
+typedef struct
+{
+    uint32_t m_u32Hits;             /*!< Block lookups found in cache */
+    uint32_t m_u32Misses;           /*!< Block lookups that waited for a load */
+    uint32_t m_u32Prefetches;       /*!< Loads started by read-ahead or hints */
+    uint32_t m_u32PrefetchHits;     /*!< Prefetched blocks used before eviction */
+    uint32_t m_u32Evictions;        /*!< Valid blocks dropped for a new one */
+    uint32_t m_u32Errors;           /*!< Loads failed by the device */
+} S_BLK_CACHE_STATS;
+
+// Function to read u32Len bytes at u32Offset of a device through the cache, returns 0 or -1
+int blk_cache_read(E_BLK_DEV evDev, uint32_t u32Offset, void *pvDst, uint32_t u32Len);
+
+// Function to start loading the blocks of a range without waiting, returns the number of loads started
+// The UI issues this for the assets of the next screen.
+int blk_cache_prefetch(E_BLK_DEV evDev, uint32_t u32Offset, uint32_t u32Len);
+
+// Function to complete finished loads, call from the main loop while prefetches run
+void blk_cache_poll(void);
+
+// Function to drop all blocks of a device, e.g. after its content was rewritten
+void blk_cache_invalidate(E_BLK_DEV evDev);
+
+// Function to move the cache onto another SRAM region, returns 0 or -1 while loads are running
+int blk_cache_set_region(void *pvBase, uint32_t u32Size);
+
+// Function to get the cache statistics
+void blk_cache_get_stats(S_BLK_CACHE_STATS *psStats);
+
+#endif /* __BLK_CACHE_H__ */
@@ -117,6 +117,116 @@ static void ebi_fini(void)
     CLK_DisableModuleClock(GPIOJ_MODULE);
 }
 
+// Initialize backlight EPWM module clock and output pin
+static void bl_init(void)
+{
+    /* Enable EPWM0 module clock and set EPWM0_CH0 pin multi-function. */
+    CLK_SetModuleClock(EPWM0_MODULE, CLK_EPWMSEL_EPWM0SEL_HCLK0, 0);
+    CLK_EnableModuleClock(EPWM0_MODULE);
+    SYS_ResetModule(SYS_EPWM0RST);
+
+    SET_EPWM0_CH0_PE7();
+}
+
+// Deinitialize backlight EPWM module clock and output pin
+static void bl_fini(void)
+{
+    SET_GPIO_PE7();
+
+    CLK_DisableModuleClock(EPWM0_MODULE);
+}
+
+// Initialize SPIM module clock and asset flash pins
+static void spim_init(void)
+{
+    /* Enable SPIM0 module clock and set SPIM0 pin multi-function. */
+    CLK_EnableModuleClock(SPIM0_MODULE);
+    SYS_ResetModule(SYS_SPIM0RST);
+
+    SET_SPIM0_CLK_PH13();
+    SET_SPIM0_SS_PJ7();
+    SET_SPIM0_MOSI_PJ3();
+    SET_SPIM0_MISO_PJ4();
+    SET_SPIM0_D2_PJ5();
+    SET_SPIM0_D3_PJ6();
+
+    // Set slew rate to high for SPIM pins
+    GPIO_SetSlewCtl(PH, BIT13, GPIO_SLEWCTL_HIGH);
+    GPIO_SetSlewCtl(PJ, (BIT3 | BIT4 | BIT5 | BIT6 | BIT7), GPIO_SLEWCTL_HIGH);
+}
+
+// Deinitialize SPIM module clock and asset flash pins
+static void spim_fini(void)
+{
+    SET_GPIO_PH13();
+    SET_GPIO_PJ7();
+    SET_GPIO_PJ3();
+    SET_GPIO_PJ4();
+    SET_GPIO_PJ5();
+    SET_GPIO_PJ6();
+
+    GPIO_SetSlewCtl(PH, BIT13, GPIO_SLEWCTL_NORMAL);
+    GPIO_SetSlewCtl(PJ, (BIT3 | BIT4 | BIT5 | BIT6 | BIT7), GPIO_SLEWCTL_NORMAL);
+
+    CLK_DisableModuleClock(SPIM0_MODULE);
+}
+
+// Initialize SDH module clock and SD card pins
+static void sdh_init(void)
+{
+    /* Enable SDH0 module clock and set SD0 pin multi-function. */
+    CLK_SetModuleClock(SDH0_MODULE, CLK_SDHSEL_SDH0SEL_HCLK0, CLK_SDHDIV_SDH0DIV(4));
+    CLK_EnableModuleClock(SDH0_MODULE);
+    CLK_EnableModuleClock(GPIOB_MODULE);
+    SYS_ResetModule(SYS_SDH0RST);
+
+    SET_SD0_CLK_PB1();
+    SET_SD0_CMD_PB0();
+    SET_SD0_DAT0_PB2();
+    SET_SD0_DAT1_PB3();
+    SET_SD0_DAT2_PB4();
+    SET_SD0_DAT3_PB5();
+    SET_SD0_nCD_PD13();
+
+    // Set slew rate to high for SD pins
+    GPIO_SetSlewCtl(PB, (BIT0 | BIT1 | BIT2 | BIT3 | BIT4 | BIT5), GPIO_SLEWCTL_HIGH);
+}
+
+// Deinitialize SDH module clock and SD card pins
+static void sdh_fini(void)
+{
+    SET_GPIO_PB1();
+    SET_GPIO_PB0();
+    SET_GPIO_PB2();
+    SET_GPIO_PB3();
+    SET_GPIO_PB4();
+    SET_GPIO_PB5();
+    SET_GPIO_PD13();
+
+    GPIO_SetSlewCtl(PB, (BIT0 | BIT1 | BIT2 | BIT3 | BIT4 | BIT5), GPIO_SLEWCTL_NORMAL);
+
+    CLK_DisableModuleClock(SDH0_MODULE);
+    CLK_DisableModuleClock(GPIOB_MODULE);
+}
+
+// Initialize crypto engine module clock
+static void crypto_init(void)
+{
+    /* Enable CRYPTO0 module clock for the AES and SHA DMA engines. */
+    CLK_EnableModuleClock(CRYPTO0_MODULE);
+    SYS_ResetModule(SYS_CRYPTO0RST);
+
+    /* TRNG0 seeds the PRNG drawing the screenshot nonces. */
+    CLK_EnableModuleClock(TRNG0_MODULE);
+}
+
+// Deinitialize crypto engine module clock
+static void crypto_fini(void)
+{
+    CLK_DisableModuleClock(TRNG0_MODULE);
+    CLK_DisableModuleClock(CRYPTO0_MODULE);
+}
+
 // Initialize board
 void board_init(void)
 {
@@ -129,6 +239,18 @@ void board_init(void)
     // Enable EBI module clock and set EBI function pins
     ebi_init();
 
+    // Enable backlight EPWM module clock and set EPWM function pin
+    bl_init();
+
+    // Enable SPIM module clock and set SPIM function pins
+    spim_init();
+
+    // Enable SDH module clock and set SD function pins
+    sdh_init();
+
+    // Enable crypto engine module clock
+    crypto_init();
+
     /* Lock protected registers */
     if (u32RegLocked)
         SYS_LockReg();
@@ -146,7 +268,19 @@ void board_fini(void)
     // Disable EBI module clock and reset EBI function pins
     ebi_fini();
 
+    // Disable backlight EPWM module clock and reset EPWM function pin
+    bl_fini();
+
+    // Disable SPIM module clock and reset SPIM function pins
+    spim_fini();
+
+    // Disable SDH module clock and reset SD function pins
+    sdh_fini();
+
+    // Disable crypto engine module clock
+    crypto_fini();
+
     /* Lock protected registers */
     if (u32RegLocked)
         SYS_LockReg();
-}
\ No newline at end of file
+}
\ No newline at end of file
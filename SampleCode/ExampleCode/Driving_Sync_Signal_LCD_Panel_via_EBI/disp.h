@@ -15,6 +15,7 @@
 #define CONFIG_DISP_EBI               EBI_BANK0   /*!< SET EBI Bank */
 
 #define CONFIG_LCD_PANEL_USE_DE_ONLY              /*!< LCD supports DE-only mode, without HSync and VSync. */
+//#define CONFIG_LCD_PANEL_USE_I80                /*!< MCU-interface (i80) panel with internal GRAM instead of sync-type. */
 #define CONFIG_DISP_DE_ACTIVE_LOW             0   /*!< Disable DE active low */
 #define CONFIG_DISP_VPW_ACTIVE_LOW            1   /*!< Enable VPW active low */
 #define CONFIG_DISP_HPW_ACTIVE_LOW            1   /*!< Enable HPW active low */
@@ -22,17 +23,47 @@
 #define CONFIG_DISP_VSYNC_BITIDX              1   /*!< Implies SET_EBI_ADR0_PH7 */
 #define CONFIG_DISP_HSYNC_BITIDX              2   /*!< Implies SET_EBI_ADR1_PH6 */
 
-#define CONFIG_TIMING_HACT                  480   /*!< Specify XRES */
-#define CONFIG_TIMING_VACT                  272   /*!< Specify YRES */
-#define CONFIG_TIMING_HBP                    30   /*!< Specify HBP (Horizontal Back Porch) */
-#define CONFIG_TIMING_HFP                     5   /*!< Specify HFP (Horizontal Front Porch) */
-#define CONFIG_TIMING_HPW                    41   /*!< Specify HPW (HSYNC plus width) */
-#define CONFIG_TIMING_VBP                     2   /*!< Specify VBP (Vertical Back Porch) */
-#define CONFIG_TIMING_VFP                    27   /*!< Specify VFP (Vertical Front Porch) */
-#define CONFIG_TIMING_VPW                    10   /*!< Specify VPW (VSYNC width) */
+#define CONFIG_DISP_I80_RS_BITIDX  CONFIG_DISP_DE_BITIDX   /*!< i80 D/CX on the DE address pin */
+//#define CONFIG_DISP_I80_USE_TE                  /*!< i80 flush starts on the panel tearing-effect output */
+#define CONFIG_DISP_I80_TE_PORT              PB   /*!< i80 TE input port */
+#define CONFIG_DISP_I80_TE_PIN                6   /*!< i80 TE input pin, PB0~PB5 carry SD0 */
+#define CONFIG_DISP_I80_TE_IRQn        GPB_IRQn   /*!< i80 TE input interrupt */
+#define CONFIG_DISP_I80_TE_IRQHandler  GPB_IRQHandler   /*!< i80 TE input interrupt handler */
+#define CONFIG_DISP_I80_REFRESH_HZ           60   /*!< i80 panel refresh rate, blanks are timed by a timer without TE */
+#define CONFIG_DISP_I80_BLANK_TIMER      TIMER2   /*!< i80 blank timer without TE */
+#define CONFIG_DISP_I80_BLANK_TIMER_MODULE  TMR2_MODULE
+#define CONFIG_DISP_I80_BLANK_TIMER_CLKSEL  CLK_TMRSEL_TMR2SEL_HIRC
+#define CONFIG_DISP_I80_BLANK_TIMER_IRQn  TIMER2_IRQn
+#define CONFIG_DISP_I80_BLANK_TIMER_IRQHandler  TIMER2_IRQHandler
+
+/* Panel timing, a build for another panel may give all eight on the command line. */
+#if !defined(CONFIG_TIMING_HACT)
+    #define CONFIG_TIMING_HACT              480   /*!< Specify XRES */
+    #define CONFIG_TIMING_VACT              272   /*!< Specify YRES */
+    #define CONFIG_TIMING_HBP                30   /*!< Specify HBP (Horizontal Back Porch) */
+    #define CONFIG_TIMING_HFP                 5   /*!< Specify HFP (Horizontal Front Porch) */
+    #define CONFIG_TIMING_HPW                41   /*!< Specify HPW (HSYNC plus width) */
+    #define CONFIG_TIMING_VBP                 2   /*!< Specify VBP (Vertical Back Porch) */
+    #define CONFIG_TIMING_VFP                27   /*!< Specify VFP (Vertical Front Porch) */
+    #define CONFIG_TIMING_VPW                10   /*!< Specify VPW (VSYNC width) */
+#endif
+
+/* Upper bounds for disp_set_timing. CONFIG_TIMING_HACT/VACT are also the maximum resolution. */
+#define CONFIG_TIMING_HPORCH_MAX             (CONFIG_TIMING_HFP+CONFIG_TIMING_HPW+CONFIG_TIMING_HBP)   /*!< Maximum HFP+HPW+HBP */
+#define CONFIG_TIMING_VPORCH_MAX             (CONFIG_TIMING_VFP+CONFIG_TIMING_VPW+CONFIG_TIMING_VBP)   /*!< Maximum VFP+VPW+VBP */
+
+#define CONFIG_DISP_BL_EPWM                EPWM0   /*!< EPWM driving the backlight, pin is set in board.c */
+#define CONFIG_DISP_BL_EPWM_CH                 0   /*!< EPWM channel driving the backlight */
+#define CONFIG_DISP_BL_FREQ                20000   /*!< Backlight PWM frequency in Hz, above the audible band */
+#define CONFIG_DISP_CABC_DUTY_MIN             30   /*!< Lowest backlight duty in percent CABC may select */
+#define CONFIG_DISP_CABC_CLIP_PERMILLE         4   /*!< Pixels in per-mille allowed to clip after compensation */
+
+#define CONFIG_DISP_MEM_IDLE_FRAMES          120   /*!< Frames an unused VRAM buffer stays powered before retention */
 
 #define PATH_IMAGE1_BIN        "..//WQVGA1.bin"   /*!< Specify image1 path */
 #define PATH_IMAGE2_BIN        "..//WQVGA2.bin"   /*!< Specify image2 path */
+#define DIGEST_IMAGE1_BIN      { 0x4a35b4d9UL, 0x66766600UL, 0x2c084fcbUL, 0x120d98f0UL, 0x09146e65UL, 0xc614027fUL, 0x8c81ea3cUL, 0x52eccb4fUL }   /*!< SHA-256 of image1 */
+#define DIGEST_IMAGE2_BIN      { 0x247a388aUL, 0x73f1de64UL, 0xf5fcadd8UL, 0x301bd37eUL, 0xd1421310UL, 0xcdb1be44UL, 0x531c83ffUL, 0x2ef1a359UL }   /*!< SHA-256 of image2 */
 
 /* Don't touch. */
 #define CONFIG_DISP_DE_BITMASK               (1<<CONFIG_DISP_DE_BITIDX)      /*!< Bit mask for DE */
@@ -55,13 +86,14 @@
     #define DEF_TOTAL_VLINES   (CONFIG_TIMING_VACT)
     #define DEF_VACT_INDEX     (0)
 #else
-    #define DEF_TOTAL_VLINES   (CONFIG_TIMING_VPW+CONFIG_TIMING_VBP+CONFIG_TIMING_VACT+CONFIG_TIMING_VFP)
+    #define DEF_TOTAL_VLINES   (CONFIG_TIMING_VPORCH_MAX+CONFIG_TIMING_VACT)
     #define DEF_VACT_INDEX     (CONFIG_TIMING_VFP+CONFIG_TIMING_VPW+CONFIG_TIMING_VBP)
 #endif
 
 #define DEF_HACT_INDEX   (CONFIG_TIMING_HFP+CONFIG_TIMING_HPW+CONFIG_TIMING_HBP)
 #define DEF_HACT_ALL     (CONFIG_TIMING_HFP+CONFIG_TIMING_HPW+CONFIG_TIMING_HBP+CONFIG_TIMING_HACT)
 #define DEF_VACT_ALL     (CONFIG_TIMING_VFP+CONFIG_TIMING_VPW+CONFIG_TIMING_VBP+CONFIG_TIMING_VACT)
+#define DEF_VPORCH_ALL   (CONFIG_TIMING_VFP+CONFIG_TIMING_VPW+CONFIG_TIMING_VBP)
 
 typedef enum
 {
@@ -89,6 +121,30 @@ typedef enum
     evVStageCNT              /*!< Number of Vertical stages */
 } E_VSTAGE;
 
+typedef struct
+{
+    uint32_t m_u32X;        /*!< Left column */
+    uint32_t m_u32Y;        /*!< Top line */
+    uint32_t m_u32W;        /*!< Width in pixels */
+    uint32_t m_u32H;        /*!< Height in lines */
+} S_DISP_RECT;
+
+typedef struct
+{
+    uint32_t m_u32HACT;     /*!< XRES */
+    uint32_t m_u32VACT;     /*!< YRES */
+    uint32_t m_u32HBP;      /*!< Horizontal Back Porch */
+    uint32_t m_u32HFP;      /*!< Horizontal Front Porch */
+    uint32_t m_u32HPW;      /*!< HSYNC plus width */
+    uint32_t m_u32VBP;      /*!< Vertical Back Porch */
+    uint32_t m_u32VFP;      /*!< Vertical Front Porch */
+    uint32_t m_u32VPW;      /*!< VSYNC width */
+} S_DISP_TIMING;
+
+#define DEF_DISP_TIMING_DEFAULT    { CONFIG_TIMING_HACT, CONFIG_TIMING_VACT, \
+                                     CONFIG_TIMING_HBP, CONFIG_TIMING_HFP, CONFIG_TIMING_HPW, \
+                                     CONFIG_TIMING_VBP, CONFIG_TIMING_VFP, CONFIG_TIMING_VPW }
+
 // Function to set the VRAM buffer address
 void disp_set_vrambufaddr(void *pvBufAddr);
 
@@ -99,6 +155,37 @@ void *disp_get_vrambufaddr(void);
 typedef void(*DispBlankCb)(void *p);
 void disp_set_blankcb(DispBlankCb f);
 
+// Function to set the per-line source address table
+// Entry i is the HACT source of active line i from the next blank on, NULL restores the linear VRAM mapping.
+void disp_set_linetbl(const uint32_t *pu32LineAddr);
+
+// Function to push a changed rectangle of VRAM to the panel, NULL means the full screen
+// Sync panels scan VRAM continuously, only the DCache of the rectangle is cleaned.
+int disp_flush(const S_DISP_RECT *psRect);
+
+// Function to fill a rectangle of a buffer with an RGB565 color by DMA, NULL rectangle means the whole buffer
+// A NULL buffer is the current VRAM buffer. The fill runs in the background, call disp_fill_wait before the CPU touches the rectangle.
+int disp_fill(void *pvBuf, const S_DISP_RECT *psRect, uint16_t u16Color);
+
+// Function to wait for the last disp_fill to finish
+void disp_fill_wait(void);
+
+// Function to copy an RGB565 area into a rectangle of a buffer by DMA, pfnDone runs in the DMA interrupt
+// A NULL buffer is the current VRAM buffer. pvSrc holds psRect->m_u32W x m_u32H pixels, u32SrcStride pixels
+// apart, and must be cleaned to memory. The copy shares the engine with disp_fill, disp_fill_wait waits for both.
+typedef void(*DispCopyCb)(void *p);
+int disp_copy(void *pvBuf, const S_DISP_RECT *psRect, const void *pvSrc, uint32_t u32SrcStride, DispCopyCb pfnDone, void *pvUserData);
+
+// Function to switch the panel timing at a frame boundary without stopping the scanout
+int disp_set_timing(const S_DISP_TIMING *psTiming);
+
+// Function to get the panel timing being scanned out
+void disp_get_timing(S_DISP_TIMING *psTiming);
+
+// Function to re-derive the front porches so a frame lasts u32Num/u32Den of psRef within u32TolPermille, returns 0 or -1
+// Sync and back porches are kept, front porches stay within CONFIG_TIMING_HPORCH_MAX/VPORCH_MAX.
+int disp_timing_scale(const S_DISP_TIMING *psRef, uint32_t u32Num, uint32_t u32Den, uint32_t u32TolPermille, S_DISP_TIMING *psOut);
+
 extern uint8_t g_au8FrameBuf[CONFIG_VRAM_TOTAL_ALLOCATED_SIZE];
 
 #endif /* __DISP_H__ */
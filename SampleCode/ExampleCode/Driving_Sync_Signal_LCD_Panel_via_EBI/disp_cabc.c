@@ -0,0 +1,362 @@
+/**************************************************************************//**
+ * @file     disp_cabc.c
+ * @brief    Content-adaptive backlight control with pixel compensation.
+ *
+ *           A histogram of the pixel value max(R,G,B) is kept per band of
+ *           lines, and only bands touched by a dirty rectangle are counted
+ *           again. The backlight is dimmed to the level that clips at most
+ *           CONFIG_DISP_CABC_CLIP_PERMILLE of the pixels, and the pixels are
+ *           brightened by the inverse gain through per-channel LUTs.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "disp_cabc.h"
+#include "disp_mem.h"
+#include "disp_calib.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_CABC_BINS            64     /*!< Pixel value is max(R<<1, G, B<<1) in 0~63 */
+#define DEF_CABC_BAND_LINES      16     /*!< Lines sharing one histogram */
+#define DEF_CABC_BAND_NUM        ((CONFIG_TIMING_VACT + DEF_CABC_BAND_LINES - 1) / DEF_CABC_BAND_LINES)
+
+#define DEF_CABC_LEVEL_ONE       0x10000u                           /*!< Backlight level 100% in Q16 */
+#define DEF_CABC_LEVEL_STEP      (DEF_CABC_LEVEL_ONE / DEF_CABC_BINS) /*!< Applied level granularity */
+#define DEF_CABC_LEVEL_MIN       ((CONFIG_DISP_CABC_DUTY_MIN * DEF_CABC_LEVEL_ONE) / 100)
+
+#define DEF_CABC_RISE_SHIFT      1      /*!< Brighten quickly to limit clipping */
+#define DEF_CABC_FALL_SHIFT      4      /*!< Dim slowly to hide the change */
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static uint16_t s_au16BandHist[DEF_CABC_BAND_NUM][DEF_CABC_BINS];
+
+static uint16_t s_au16LutR[32];
+static uint16_t s_au16LutG[64];
+static uint16_t s_au16LutB[32];
+
+static uint32_t s_u32LevelFilt = DEF_CABC_LEVEL_ONE;     // Smoothed target level
+static uint32_t s_u32LevelLut = 0;                       // Level the LUTs are built for
+static uint32_t s_u32CalibGen = 0;                       // Calibration the LUTs are built with
+static volatile uint32_t s_u32LevelPending = DEF_CABC_LEVEL_ONE;
+static volatile uint32_t s_u32LevelApplied = 0;
+
+static S_DISP_CABC_STATS s_sStats;
+static uint32_t s_u32AvgDutyQ8;                          // 256 times the average duty in per-mille
+static int s_i32Inited = 0;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to count the pixel values of a run into a histogram
+static void disp_cabc_hist_accumulate(uint16_t *pu16Hist, const uint16_t *pu16Src, uint32_t u32Pixels)
+{
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    int32_t n = (int32_t)u32Pixels;
+    uint16_t au16Val[8];
+
+    while (n > 0)
+    {
+        mve_pred16_t p = vctp16q(n);
+        uint16x8_t px = vld1q_z_u16(pu16Src, p);
+        uint16x8_t r = vshlq_n_u16(vshrq_n_u16(px, 11), 1);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(px, 5), vdupq_n_u16(0x3F));
+        uint16x8_t b = vshlq_n_u16(vandq_u16(px, vdupq_n_u16(0x1F)), 1);
+        int i, cnt = (n > 8) ? 8 : n;
+
+        vst1q_u16(au16Val, vmaxq_u16(vmaxq_u16(r, g), b));
+
+        for (i = 0; i < cnt; i++)
+            pu16Hist[au16Val[i]]++;
+
+        pu16Src += 8;
+        n -= 8;
+    }
+
+#else
+    uint32_t i;
+
+    for (i = 0; i < u32Pixels; i++)
+    {
+        uint32_t px = pu16Src[i];
+        uint32_t r = (px >> 11) << 1;
+        uint32_t g = (px >> 5) & 0x3F;
+        uint32_t b = (px & 0x1F) << 1;
+        uint32_t v = (r > g) ? r : g;
+
+        pu16Hist[(v > b) ? v : b]++;
+    }
+
+#endif
+}
+
+// Function to apply the gain LUTs to a run of pixels
+static void disp_cabc_lut_apply(uint16_t *pu16Dst, const uint16_t *pu16Src, uint32_t u32Pixels)
+{
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    int32_t n = (int32_t)u32Pixels;
+
+    while (n > 0)
+    {
+        mve_pred16_t p = vctp16q(n);
+        uint16x8_t px = vld1q_z_u16(pu16Src, p);
+        uint16x8_t r = vldrhq_gather_shifted_offset_z_u16(s_au16LutR, vshrq_n_u16(px, 11), p);
+        uint16x8_t g = vldrhq_gather_shifted_offset_z_u16(s_au16LutG, vandq_u16(vshrq_n_u16(px, 5), vdupq_n_u16(0x3F)), p);
+        uint16x8_t b = vldrhq_gather_shifted_offset_z_u16(s_au16LutB, vandq_u16(px, vdupq_n_u16(0x1F)), p);
+
+        vst1q_p_u16(pu16Dst, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b), p);
+
+        pu16Src += 8;
+        pu16Dst += 8;
+        n -= 8;
+    }
+
+#else
+    uint32_t i;
+
+    for (i = 0; i < u32Pixels; i++)
+    {
+        uint32_t px = pu16Src[i];
+
+        pu16Dst[i] = (uint16_t)((s_au16LutR[px >> 11] << 11) | (s_au16LutG[(px >> 5) & 0x3F] << 5) | s_au16LutB[px & 0x1F]);
+    }
+
+#endif
+}
+
+// Function to build the gain LUTs compensating a backlight level, with the panel calibration folded in
+static void disp_cabc_lut_build(uint32_t u32Level)
+{
+    const S_DISP_CALIB_LUT *psCalib = disp_calib_get_lut();
+    uint32_t i;
+    uint32_t u32Gain = (DEF_CABC_LEVEL_ONE << 8) / u32Level;   // Q8
+
+    for (i = 0; i < 64; i++)
+    {
+        uint32_t v = (i * u32Gain + 128) >> 8;
+
+        if (i < 32)
+        {
+            s_au16LutR[i] = psCalib->m_au8LutR[(v > 31) ? 31 : v];
+            s_au16LutB[i] = psCalib->m_au8LutB[(v > 31) ? 31 : v];
+        }
+
+        s_au16LutG[i] = psCalib->m_au8LutG[(v > 63) ? 63 : v];
+    }
+
+    s_u32LevelLut = u32Level;
+    s_u32CalibGen = psCalib->m_u32Gen;
+}
+
+// Function to count the histograms of the bands between two lines again
+static void disp_cabc_band_update(const uint16_t *pu16Src, uint32_t u32HACT, uint32_t u32VACT, uint32_t u32Y0, uint32_t u32Y1)
+{
+    uint32_t u32Band;
+
+    for (u32Band = u32Y0 / DEF_CABC_BAND_LINES; (u32Band * DEF_CABC_BAND_LINES) < u32Y1; u32Band++)
+    {
+        uint32_t y = u32Band * DEF_CABC_BAND_LINES;
+        uint32_t u32Lines = ((y + DEF_CABC_BAND_LINES) > u32VACT) ? (u32VACT - y) : DEF_CABC_BAND_LINES;
+
+        memset(s_au16BandHist[u32Band], 0, sizeof(s_au16BandHist[u32Band]));
+        disp_cabc_hist_accumulate(s_au16BandHist[u32Band], &pu16Src[y * u32HACT], u32Lines * u32HACT);
+    }
+}
+
+// Function to pick the backlight level from the frame histogram
+static uint32_t disp_cabc_target_level(uint32_t u32VACT, uint32_t u32Total, uint32_t *pu32Hist)
+{
+    uint32_t u32Band, i;
+    uint32_t u32Allowed = (u32Total * CONFIG_DISP_CABC_CLIP_PERMILLE) / 1000;
+    uint32_t u32Above = 0;
+    uint32_t u32Level;
+
+    for (i = 0; i < DEF_CABC_BINS; i++)
+        pu32Hist[i] = 0;
+
+    for (u32Band = 0; (u32Band * DEF_CABC_BAND_LINES) < u32VACT; u32Band++)
+        for (i = 0; i < DEF_CABC_BINS; i++)
+            pu32Hist[i] += s_au16BandHist[u32Band][i];
+
+    /* Walk down from the brightest bin until the clip budget is used up. */
+    for (i = DEF_CABC_BINS - 1; i > 0; i--)
+    {
+        if ((u32Above + pu32Hist[i]) > u32Allowed)
+            break;
+
+        u32Above += pu32Hist[i];
+    }
+
+    u32Level = (i + 1) * DEF_CABC_LEVEL_STEP;
+
+    return (u32Level < DEF_CABC_LEVEL_MIN) ? DEF_CABC_LEVEL_MIN : u32Level;
+}
+
+// Function to compensate the dirty rectangle of pvSrc into pvDst and pick the next backlight level
+int disp_cabc_present(void *pvDst, const void *pvSrc, const S_DISP_RECT *psDirty)
+{
+    S_DISP_TIMING sTiming;
+    S_DISP_RECT sRect;
+    uint32_t au32Hist[DEF_CABC_BINS];
+    uint32_t u32Target, u32Level, u32Gain, u32Clip, y, i;
+    const uint16_t *pu16Src = (const uint16_t *)pvSrc;
+    uint16_t *pu16Dst = (uint16_t *)pvDst;
+
+    if (!s_i32Inited || !pvDst || !pvSrc)
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    disp_mem_acquire(pvDst);
+
+    if (psDirty)
+    {
+        if (((psDirty->m_u32X + psDirty->m_u32W) > sTiming.m_u32HACT) ||
+                ((psDirty->m_u32Y + psDirty->m_u32H) > sTiming.m_u32VACT))
+            return -1;
+
+        sRect = *psDirty;
+    }
+    else
+    {
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = sTiming.m_u32HACT;
+        sRect.m_u32H = sTiming.m_u32VACT;
+    }
+
+    /* Only bands under the dirty rectangle change their histograms. */
+    disp_cabc_band_update(pu16Src, sTiming.m_u32HACT, sTiming.m_u32VACT, sRect.m_u32Y, sRect.m_u32Y + sRect.m_u32H);
+
+    u32Target = disp_cabc_target_level(sTiming.m_u32VACT, sTiming.m_u32HACT * sTiming.m_u32VACT, au32Hist);
+
+    /* Asymmetric first-order filter against flicker. */
+    if (u32Target > s_u32LevelFilt)
+        s_u32LevelFilt += (u32Target - s_u32LevelFilt + (1u << DEF_CABC_RISE_SHIFT) - 1) >> DEF_CABC_RISE_SHIFT;
+    else
+        s_u32LevelFilt -= (s_u32LevelFilt - u32Target) >> DEF_CABC_FALL_SHIFT;
+
+    /* Applied level moves in whole steps, so the LUT is not rebuilt for sub-step changes. */
+    u32Level = ((s_u32LevelFilt + DEF_CABC_LEVEL_STEP / 2) / DEF_CABC_LEVEL_STEP) * DEF_CABC_LEVEL_STEP;
+
+    if (u32Level < DEF_CABC_LEVEL_MIN)
+        u32Level = DEF_CABC_LEVEL_MIN;
+    else if (u32Level > DEF_CABC_LEVEL_ONE)
+        u32Level = DEF_CABC_LEVEL_ONE;
+
+    if ((u32Level != s_u32LevelLut) || (s_u32CalibGen != disp_calib_get_lut()->m_u32Gen))
+    {
+        /* Gain or calibration changes, pixels outside the dirty rectangle are compensated again too. */
+        disp_cabc_lut_build(u32Level);
+
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = sTiming.m_u32HACT;
+        sRect.m_u32H = sTiming.m_u32VACT;
+
+        s_sStats.m_u32Recompensates++;
+    }
+
+    for (y = sRect.m_u32Y; y < (sRect.m_u32Y + sRect.m_u32H); y++)
+    {
+        uint32_t u32Offset = y * sTiming.m_u32HACT + sRect.m_u32X;
+
+        disp_cabc_lut_apply(&pu16Dst[u32Offset], &pu16Src[u32Offset], sRect.m_u32W);
+
+        /* Flush pixel data in DCache to memory for DMA. */
+        SCB_CleanDCache_by_Addr(&pu16Dst[u32Offset], sRect.m_u32W * sizeof(uint16_t));
+    }
+
+    /* Pixels above 63/gain saturate. */
+    u32Gain = (DEF_CABC_LEVEL_ONE << 8) / u32Level;
+    u32Clip = 0;
+
+    for (i = ((63u << 8) / u32Gain) + 1; i < DEF_CABC_BINS; i++)
+        u32Clip += au32Hist[i];
+
+    s_sStats.m_u32ClipPermille = (u32Clip * 1000) / (sTiming.m_u32HACT * sTiming.m_u32VACT);
+    s_sStats.m_u32Presents++;
+
+    /* Backlight follows at the blank that shows these pixels. */
+    s_u32LevelPending = u32Level;
+
+    return 0;
+}
+
+// Function to apply the backlight level of the last present, called from the blank callback
+void disp_cabc_tick(void)
+{
+    uint32_t u32Level = s_u32LevelPending;
+    uint32_t u32DutyPermille;
+
+    if (!s_i32Inited)
+        return;
+
+    if (u32Level != s_u32LevelApplied)
+    {
+        uint32_t u32CNR = EPWM_GET_CNR(CONFIG_DISP_BL_EPWM, CONFIG_DISP_BL_EPWM_CH);
+
+        /* Finer than the percent step of EPWM_ConfigOutputChannel. */
+        EPWM_SET_CMR(CONFIG_DISP_BL_EPWM, CONFIG_DISP_BL_EPWM_CH, (uint32_t)(((uint64_t)u32Level * (u32CNR + 1)) >> 16));
+
+        s_u32LevelApplied = u32Level;
+    }
+
+    u32DutyPermille = (u32Level * 1000) >> 16;
+    s_sStats.m_u32DutyPermille = u32DutyPermille;
+
+    /* Average over about 256 frames. */
+    s_u32AvgDutyQ8 = s_u32AvgDutyQ8 - (s_u32AvgDutyQ8 >> 8) + u32DutyPermille;
+    s_sStats.m_u32AvgDutyPermille = s_u32AvgDutyQ8 >> 8;
+}
+
+// Function to get the CABC statistics
+void disp_cabc_get_stats(S_DISP_CABC_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to initialize the CABC backlight
+static int disp_cabc_init(void)
+{
+    memset(s_au16BandHist, 0, sizeof(s_au16BandHist));
+    memset(&s_sStats, 0, sizeof(s_sStats));
+
+    /* Start from full backlight with identity LUTs. */
+    disp_cabc_lut_build(DEF_CABC_LEVEL_ONE);
+    s_u32LevelFilt = DEF_CABC_LEVEL_ONE;
+    s_u32LevelPending = DEF_CABC_LEVEL_ONE;
+    s_u32LevelApplied = DEF_CABC_LEVEL_ONE;
+    s_sStats.m_u32DutyPermille = 1000;
+    s_sStats.m_u32AvgDutyPermille = 1000;
+    s_u32AvgDutyQ8 = 1000 << 8;
+
+    EPWM_ConfigOutputChannel(CONFIG_DISP_BL_EPWM, CONFIG_DISP_BL_EPWM_CH, CONFIG_DISP_BL_FREQ, 100);
+    EPWM_EnableOutput(CONFIG_DISP_BL_EPWM, 1 << CONFIG_DISP_BL_EPWM_CH);
+    EPWM_Start(CONFIG_DISP_BL_EPWM, 1 << CONFIG_DISP_BL_EPWM_CH);
+
+    s_i32Inited = 1;
+
+    return 0;
+}
+
+// Function to deinitialize the CABC backlight
+static int disp_cabc_fini(void)
+{
+    s_i32Inited = 0;
+
+    /* Leave the backlight fully on. */
+    EPWM_SET_CMR(CONFIG_DISP_BL_EPWM, CONFIG_DISP_BL_EPWM_CH, EPWM_GET_CNR(CONFIG_DISP_BL_EPWM, CONFIG_DISP_BL_EPWM_CH) + 1);
+
+    return 0;
+}
+
+COMPONENT_EXPORT("DISP_CABC", disp_cabc_init, disp_cabc_fini);
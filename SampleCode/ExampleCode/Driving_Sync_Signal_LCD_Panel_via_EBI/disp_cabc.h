@@ -0,0 +1,33 @@
+/**************************************************************************//**
+ * @file     disp_cabc.h
+ * @brief    Content-adaptive backlight control with pixel compensation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_CABC_H__
+#define __DISP_CABC_H__
+
+#include "disp.h"
+
+typedef struct
+{
+    uint32_t m_u32DutyPermille;      /*!< Backlight duty on screen */
+    uint32_t m_u32AvgDutyPermille;   /*!< Long-run average duty, 1000 minus it is the saved backlight power */
+    uint32_t m_u32ClipPermille;      /*!< Pixels saturated by compensation in the last present */
+    uint32_t m_u32Presents;          /*!< Number of presents */
+    uint32_t m_u32Recompensates;     /*!< Presents that rewrote the full frame due to a gain change */
+} S_DISP_CABC_STATS;
+
+// Function to compensate the dirty rectangle of pvSrc into pvDst and pick the next backlight level
+// pvSrc is the full uncompensated frame, psDirty NULL means the full frame. pvDst also carries the disp_calib
+// correction, so it is not run over these pixels again.
+int disp_cabc_present(void *pvDst, const void *pvSrc, const S_DISP_RECT *psDirty);
+
+// Function to apply the backlight level of the last present, called from the blank callback
+void disp_cabc_tick(void);
+
+// Function to get the CABC statistics
+void disp_cabc_get_stats(S_DISP_CABC_STATS *psStats);
+
+#endif /* __DISP_CABC_H__ */
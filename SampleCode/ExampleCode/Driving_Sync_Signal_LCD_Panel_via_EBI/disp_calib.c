@@ -0,0 +1,303 @@
+/**************************************************************************//**
+ * @file     disp_calib.c
+ * @brief    Per-panel gamma and white-balance calibration LUTs.
+ *
+ *           A calibration record measured on the panel holds one LUT per
+ *           RGB565 channel. It is read once from OTP or flash and checked
+ *           by CRC; without a good record the LUTs stay identity and
+ *           correcting costs nothing. Pixels are corrected where they are
+ *           produced: GUI draw buffers before their flush, dirty rectangles
+ *           of a frame on present, and CABC folds the LUTs into its own.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "disp_calib.h"
+#include "disp_mem.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_CALIB_CRC_POLY        0xEDB88320UL   /*!< CRC-32 reflected polynomial, as zlib.crc32 */
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_DISP_CALIB_LUT s_sLut;
+static S_DISP_CALIB_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to calculate the CRC-32 of a buffer, run once per load so no table is kept
+static uint32_t disp_calib_crc32(const uint8_t *pu8Buf, uint32_t u32Len)
+{
+    uint32_t u32Crc = 0xFFFFFFFFUL;
+    uint32_t i, j;
+
+    for (i = 0; i < u32Len; i++)
+    {
+        u32Crc ^= pu8Buf[i];
+
+        for (j = 0; j < 8; j++)
+            u32Crc = (u32Crc >> 1) ^ (DEF_CALIB_CRC_POLY & (0UL - (u32Crc & 1)));
+    }
+
+    return ~u32Crc;
+}
+
+// Function to set the LUTs to identity
+static void disp_calib_identity(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < 64; i++)
+    {
+        if (i < 32)
+        {
+            s_sLut.m_au8LutR[i] = (uint8_t)i;
+            s_sLut.m_au8LutB[i] = (uint8_t)i;
+        }
+
+        s_sLut.m_au8LutG[i] = (uint8_t)i;
+    }
+
+    s_sLut.m_i32Identity = 1;
+    s_sLut.m_u32Gen++;
+}
+
+// Function to read the record from OTP entries, returns 0 or -1
+static int disp_calib_read_otp(S_DISP_CALIB_RECORD *psRecord)
+{
+    uint32_t *pu32Dst = (uint32_t *)psRecord;
+    uint32_t u32RegLocked = SYS_IsRegLocked();
+    uint32_t i;
+    int i32Ret = 0;
+
+    /* Unlock protected registers */
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    FMC_Open();
+
+    for (i = 0; i < DISP_CALIB_OTP_ENTRIES; i++)
+    {
+        if (FMC_ReadOTP(CONFIG_DISP_CALIB_OTP_FIRST + i, &pu32Dst[i * 2], &pu32Dst[i * 2 + 1]) != 0)
+        {
+            i32Ret = -1;
+            break;
+        }
+    }
+
+    FMC_Close();
+
+    /* Lock protected registers */
+    if (u32RegLocked)
+        SYS_LockReg();
+
+    return i32Ret;
+}
+
+int disp_calib_set(const S_DISP_CALIB_RECORD *psRecord)
+{
+    uint32_t i;
+
+    if (!psRecord)
+    {
+        disp_calib_identity();
+        s_sStats.m_u32Source = DISP_CALIB_SRC_NONE;
+        s_sStats.m_u32PanelId = 0;
+
+        return 0;
+    }
+
+    if ((psRecord->m_u32Magic != DISP_CALIB_MAGIC) || (psRecord->m_u16Version != DISP_CALIB_VERSION) ||
+            (psRecord->m_u32Crc != disp_calib_crc32((const uint8_t *)psRecord, offsetof(S_DISP_CALIB_RECORD, m_u32Crc))))
+    {
+        s_sStats.m_u32Rejected++;
+        return -1;
+    }
+
+    /* Entries out of range would index past the packed fields. */
+    for (i = 0; i < 64; i++)
+    {
+        if ((psRecord->m_au8LutG[i] > 63) || ((i < 32) && ((psRecord->m_au8LutR[i] > 31) || (psRecord->m_au8LutB[i] > 31))))
+        {
+            s_sStats.m_u32Rejected++;
+            return -1;
+        }
+    }
+
+    memcpy(s_sLut.m_au8LutR, psRecord->m_au8LutR, sizeof(s_sLut.m_au8LutR));
+    memcpy(s_sLut.m_au8LutG, psRecord->m_au8LutG, sizeof(s_sLut.m_au8LutG));
+    memcpy(s_sLut.m_au8LutB, psRecord->m_au8LutB, sizeof(s_sLut.m_au8LutB));
+
+    s_sLut.m_i32Identity = 1;
+
+    for (i = 0; i < 64; i++)
+    {
+        if ((s_sLut.m_au8LutG[i] != i) || ((i < 32) && ((s_sLut.m_au8LutR[i] != i) || (s_sLut.m_au8LutB[i] != i))))
+        {
+            s_sLut.m_i32Identity = 0;
+            break;
+        }
+    }
+
+    s_sLut.m_u32Gen++;
+    s_sStats.m_u32PanelId = psRecord->m_u16PanelId;
+
+    return 0;
+}
+
+int disp_calib_load(void)
+{
+#if (CONFIG_DISP_CALIB_SRC == DISP_CALIB_SRC_OTP)
+    S_DISP_CALIB_RECORD sRecord;
+
+    if ((disp_calib_read_otp(&sRecord) != 0) || (disp_calib_set(&sRecord) != 0))
+        return -1;
+
+#elif (CONFIG_DISP_CALIB_SRC == DISP_CALIB_SRC_FLASH)
+    S_DISP_CALIB_RECORD sRecord;
+
+    memcpy(&sRecord, (const void *)CONFIG_DISP_CALIB_FLASH_ADDR, sizeof(sRecord));
+
+    if (disp_calib_set(&sRecord) != 0)
+        return -1;
+
+#else
+    return -1;
+#endif
+
+    s_sStats.m_u32Source = CONFIG_DISP_CALIB_SRC;
+
+    return 0;
+}
+
+const S_DISP_CALIB_LUT *disp_calib_get_lut(void)
+{
+    return &s_sLut;
+}
+
+void disp_calib_apply(uint16_t *pu16Dst, const uint16_t *pu16Src, uint32_t u32Pixels)
+{
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    int32_t n = (int32_t)u32Pixels;
+#else
+    uint32_t i;
+#endif
+
+    if (s_sLut.m_i32Identity)
+    {
+        if (pu16Dst != pu16Src)
+            memcpy(pu16Dst, pu16Src, u32Pixels * sizeof(uint16_t));
+
+        return;
+    }
+
+    s_sStats.m_u32Pixels += u32Pixels;
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+
+    /* Byte gathers widen the 8-bit LUT entries straight into 16-bit lanes. */
+    while (n > 0)
+    {
+        mve_pred16_t p = vctp16q(n);
+        uint16x8_t px = vld1q_z_u16(pu16Src, p);
+        uint16x8_t r = vldrbq_gather_offset_z_u16(s_sLut.m_au8LutR, vshrq_n_u16(px, 11), p);
+        uint16x8_t g = vldrbq_gather_offset_z_u16(s_sLut.m_au8LutG, vandq_u16(vshrq_n_u16(px, 5), vdupq_n_u16(0x3F)), p);
+        uint16x8_t b = vldrbq_gather_offset_z_u16(s_sLut.m_au8LutB, vandq_u16(px, vdupq_n_u16(0x1F)), p);
+
+        vst1q_p_u16(pu16Dst, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b), p);
+
+        pu16Src += 8;
+        pu16Dst += 8;
+        n -= 8;
+    }
+
+#else
+
+    for (i = 0; i < u32Pixels; i++)
+    {
+        uint32_t px = pu16Src[i];
+
+        pu16Dst[i] = (uint16_t)((s_sLut.m_au8LutR[px >> 11] << 11) | (s_sLut.m_au8LutG[(px >> 5) & 0x3F] << 5) | s_sLut.m_au8LutB[px & 0x1F]);
+    }
+
+#endif
+}
+
+int disp_calib_present(void *pvDst, const void *pvSrc, const S_DISP_RECT *psDirty)
+{
+    S_DISP_TIMING sTiming;
+    S_DISP_RECT sRect;
+    const uint16_t *pu16Src = (const uint16_t *)pvSrc;
+    uint16_t *pu16Dst = (uint16_t *)pvDst;
+    uint32_t y;
+
+    if (!pvDst || !pvSrc)
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (psDirty)
+    {
+        if (((psDirty->m_u32X + psDirty->m_u32W) > sTiming.m_u32HACT) ||
+                ((psDirty->m_u32Y + psDirty->m_u32H) > sTiming.m_u32VACT))
+            return -1;
+
+        sRect = *psDirty;
+    }
+    else
+    {
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = sTiming.m_u32HACT;
+        sRect.m_u32H = sTiming.m_u32VACT;
+    }
+
+    disp_mem_acquire(pvDst);
+
+    for (y = sRect.m_u32Y; y < (sRect.m_u32Y + sRect.m_u32H); y++)
+    {
+        uint32_t u32Offset = y * sTiming.m_u32HACT + sRect.m_u32X;
+
+        disp_calib_apply(&pu16Dst[u32Offset], &pu16Src[u32Offset], sRect.m_u32W);
+
+        /* Flush pixel data in DCache to memory for DMA. */
+        SCB_CleanDCache_by_Addr(&pu16Dst[u32Offset], sRect.m_u32W * sizeof(uint16_t));
+    }
+
+    return 0;
+}
+
+void disp_calib_get_stats(S_DISP_CALIB_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to initialize the calibration, identity LUTs stay on a missing or bad record
+static int disp_calib_init(void)
+{
+    memset(&s_sStats, 0, sizeof(s_sStats));
+
+    disp_calib_identity();
+    disp_calib_load();
+
+    return 0;
+}
+
+// Function to deinitialize the calibration
+static int disp_calib_fini(void)
+{
+    return disp_calib_set(NULL);
+}
+
+COMPONENT_EXPORT("DISP_CALIB", disp_calib_init, disp_calib_fini);
@@ -0,0 +1,76 @@
+/**************************************************************************//**
+ * @file     disp_calib.h
+ * @brief    Per-panel gamma and white-balance calibration LUTs.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_CALIB_H__
+#define __DISP_CALIB_H__
+
+#include "disp.h"
+
+#define DISP_CALIB_SRC_NONE                  0   /*!< Identity LUTs until disp_calib_set */
+#define DISP_CALIB_SRC_OTP                   1   /*!< Record in consecutive OTP entries, read by FMC_ReadOTP */
+#define DISP_CALIB_SRC_FLASH                 2   /*!< Record at a flash address mapped for reading */
+
+#define CONFIG_DISP_CALIB_SRC                DISP_CALIB_SRC_OTP   /*!< Where disp_calib_load finds the record */
+#define CONFIG_DISP_CALIB_OTP_FIRST          0   /*!< First OTP entry of the record, it spans DISP_CALIB_OTP_ENTRIES */
+#define CONFIG_DISP_CALIB_FLASH_ADDR         (FMC_APROM_END - FMC_FLASH_PAGE_SIZE)   /*!< Record address, the last APROM page */
+
+#define DISP_CALIB_MAGIC                     0x424C4143UL   /*!< "CALB" */
+#define DISP_CALIB_VERSION                   1
+
+/* Written by tools/calib_gen.py from panel measurements, little endian with no padding. */
+typedef struct
+{
+    uint32_t m_u32Magic;            /*!< DISP_CALIB_MAGIC */
+    uint16_t m_u16Version;          /*!< DISP_CALIB_VERSION */
+    uint16_t m_u16PanelId;          /*!< Free for the panel batch, not checked */
+    uint8_t  m_au8LutR[32];         /*!< R5 out for each R5 in */
+    uint8_t  m_au8LutG[64];         /*!< G6 out for each G6 in */
+    uint8_t  m_au8LutB[32];         /*!< B5 out for each B5 in */
+    uint32_t m_u32Reserved;         /*!< 0, pads the record to whole OTP entries */
+    uint32_t m_u32Crc;              /*!< CRC-32 (IEEE 802.3) of the fields above */
+} S_DISP_CALIB_RECORD;
+
+#define DISP_CALIB_OTP_ENTRIES               (sizeof(S_DISP_CALIB_RECORD) / 8)
+
+/* LUTs in effect. m_u32Gen changes whenever they do, so derived tables know to rebuild. */
+typedef struct
+{
+    uint8_t  m_au8LutR[32];
+    uint8_t  m_au8LutG[64];
+    uint8_t  m_au8LutB[32];
+    uint32_t m_u32Gen;
+    int      m_i32Identity;
+} S_DISP_CALIB_LUT;
+
+typedef struct
+{
+    uint32_t m_u32Source;           /*!< DISP_CALIB_SRC_x the LUTs came from, NONE for identity */
+    uint32_t m_u32PanelId;          /*!< m_u16PanelId of the record in effect */
+    uint32_t m_u32Rejected;         /*!< Records refused for magic, version or CRC */
+    uint32_t m_u32Pixels;           /*!< Pixels corrected */
+} S_DISP_CALIB_STATS;
+
+// Function to load the record from CONFIG_DISP_CALIB_SRC, returns 0 or -1 with the LUTs left as they were
+int disp_calib_load(void);
+
+// Function to put a record in effect, NULL restores identity LUTs, returns 0 or -1 on a bad record
+int disp_calib_set(const S_DISP_CALIB_RECORD *psRecord);
+
+// Function to get the LUTs in effect, for tables folding the calibration into their own mapping
+const S_DISP_CALIB_LUT *disp_calib_get_lut(void);
+
+// Function to correct a run of RGB565 pixels, pu16Dst may equal pu16Src
+// Pixels must be corrected once, call it on freshly rendered pixels, e.g. a GUI draw buffer before its flush.
+void disp_calib_apply(uint16_t *pu16Dst, const uint16_t *pu16Src, uint32_t u32Pixels);
+
+// Function to correct the dirty rectangle of the full frame pvSrc into pvDst, psDirty NULL means the full frame
+int disp_calib_present(void *pvDst, const void *pvSrc, const S_DISP_RECT *psDirty);
+
+// Function to get the calibration statistics
+void disp_calib_get_stats(S_DISP_CALIB_STATS *psStats);
+
+#endif /* __DISP_CALIB_H__ */
@@ -0,0 +1,318 @@
+/**************************************************************************//**
+ * @file     disp_dvfs.c
+ * @brief    Performance levels switched at frame boundaries with the refresh rate kept.
+ *
+ *           Each level divides SCLK and sets a matching power level. The
+ *           EBI clock that paces the scanout follows HCLK, so every level
+ *           gets its own EBI divider, and where that cannot bring MCLK back
+ *           to the boot value, front porches are re-derived so a frame still
+ *           takes as long. A level with new porches is switched in two steps:
+ *           the timing is queued first, and the clocks change at the blank
+ *           where that timing starts, so only blanking lines see the change.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "disp_dvfs.h"
+#include "disp_idle.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_EBI_CTL(bank)         (*(volatile uint32_t *)((uint32_t)&EBI->CTL0 + ((bank) * 0x10UL)))
+#define DEF_EBI_TCTL(bank)        (*(volatile uint32_t *)((uint32_t)&EBI->TCTL0 + ((bank) * 0x10UL)))
+
+typedef struct
+{
+    uint32_t m_u32SclkDiv;          /*!< SCLK divider, 1~16 */
+    uint32_t m_u32PowerLevel;       /*!< PMC_PLCTL_PLSEL_PLx */
+} S_DVFS_LEVEL_CFG;
+
+typedef struct
+{
+    int32_t  m_i32Valid;
+    uint32_t m_u32HclkHz;
+    uint32_t m_u32MclkDiv;          /*!< EBI_MCLKDIV_x */
+    S_DISP_TIMING m_sTiming;        /*!< Porches keeping the boot refresh rate */
+} S_DVFS_LEVEL;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static const S_DVFS_LEVEL_CFG s_asLevelCfg[CONFIG_DISP_DVFS_LEVEL_NUM] = CONFIG_DISP_DVFS_LEVELS;
+static S_DVFS_LEVEL s_asLevel[CONFIG_DISP_DVFS_LEVEL_NUM];
+
+static volatile int s_i32Ready = 0;             // 1 derived, -1 boot clock matches no level
+static volatile int32_t s_i32Forced = DISP_DVFS_AUTO;
+static int32_t s_i32Cur = 0;
+static int32_t s_i32Boot = 0;
+static int32_t s_i32Pending = -1;               // Level waiting for its timing to be scanned out
+static uint32_t s_u32EbiTctl;
+static uint32_t s_u32Hold = 0;
+static uint32_t s_u32IdleFrames = 0;
+static S_DISP_DVFS_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to derive the EBI divider and porches of every level from the boot clock and timing
+static int disp_dvfs_derive(void)
+{
+    S_DISP_TIMING sRef;
+    uint32_t u32SclkDiv = ((CLK->SCLKDIV & CLK_SCLKDIV_SCLKDIV_Msk) >> CLK_SCLKDIV_SCLKDIV_Pos) + 1;
+    uint32_t u32RefMclk, u32SrcHz, u32Div;
+    int32_t i;
+
+    SystemCoreClockUpdate();
+    disp_get_timing(&sRef);
+
+    s_u32EbiTctl = DEF_EBI_TCTL(CONFIG_DISP_EBI);
+    u32SrcHz = SystemCoreClock * u32SclkDiv;
+    u32RefMclk = SystemCoreClock >> ((DEF_EBI_CTL(CONFIG_DISP_EBI) & EBI_CTL_MCLKDIV_Msk) >> EBI_CTL_MCLKDIV_Pos);
+
+    s_i32Ready = -1;
+    s_sStats.m_u32LevelMask = 0;
+
+    for (i = 0; i < CONFIG_DISP_DVFS_LEVEL_NUM; i++)
+    {
+        S_DVFS_LEVEL *psLevel = &s_asLevel[i];
+
+        psLevel->m_i32Valid = 0;
+        psLevel->m_u32HclkHz = u32SrcHz / s_asLevelCfg[i].m_u32SclkDiv;
+
+        /* Fastest EBI clock not above the boot one, the panel and wiring are only known to work up to it. */
+        for (u32Div = CONFIG_DISP_DVFS_MCLKDIV_MIN; u32Div <= EBI_MCLKDIV_128; u32Div++)
+        {
+            if ((psLevel->m_u32HclkHz >> u32Div) <= u32RefMclk)
+                break;
+        }
+
+        if (u32Div > EBI_MCLKDIV_128)
+            continue;
+
+#if defined(CONFIG_LCD_PANEL_USE_I80)
+        /* The panel refreshes from its own GRAM, only the write clock has to stay within the boot one. */
+        psLevel->m_sTiming = sRef;
+#else
+
+        if (disp_timing_scale(&sRef, psLevel->m_u32HclkHz >> u32Div, u32RefMclk, CONFIG_DISP_DVFS_REFRESH_TOL, &psLevel->m_sTiming) < 0)
+            continue;
+
+#endif
+
+        psLevel->m_u32MclkDiv = u32Div;
+        psLevel->m_i32Valid = 1;
+        s_sStats.m_u32LevelMask |= (1UL << i);
+
+        if (s_asLevelCfg[i].m_u32SclkDiv == u32SclkDiv)
+        {
+            s_i32Cur = i;
+            s_i32Boot = i;
+            s_i32Ready = 1;
+        }
+    }
+
+    s_sStats.m_i32Level = s_i32Cur;
+    s_sStats.m_u32HclkHz = SystemCoreClock;
+
+    return (s_i32Ready > 0) ? 0 : -1;
+}
+
+// Function to switch clocks, EBI divider and power level, called at a blank
+static void disp_dvfs_apply(int32_t i32Level)
+{
+    const S_DVFS_LEVEL_CFG *psCfg = &s_asLevelCfg[i32Level];
+    uint32_t u32RegLocked = SYS_IsRegLocked();
+
+    /* Unlock protected registers */
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    /* Voltage before speed going up, after it going down. MCLK never passes the boot value in between. */
+    if (psCfg->m_u32SclkDiv < s_asLevelCfg[s_i32Cur].m_u32SclkDiv)
+    {
+        PMC_SetPowerLevel(psCfg->m_u32PowerLevel);
+        EBI_SetBusTiming(CONFIG_DISP_EBI, s_u32EbiTctl, s_asLevel[i32Level].m_u32MclkDiv);
+        CLK_SET_SCLKDIV(psCfg->m_u32SclkDiv);
+    }
+    else
+    {
+        CLK_SET_SCLKDIV(psCfg->m_u32SclkDiv);
+        EBI_SetBusTiming(CONFIG_DISP_EBI, s_u32EbiTctl, s_asLevel[i32Level].m_u32MclkDiv);
+        PMC_SetPowerLevel(psCfg->m_u32PowerLevel);
+    }
+
+    /* Lock protected registers */
+    if (u32RegLocked)
+        SYS_LockReg();
+
+    SystemCoreClockUpdate();
+
+    s_i32Cur = i32Level;
+    s_sStats.m_i32Level = i32Level;
+    s_sStats.m_u32HclkHz = SystemCoreClock;
+    s_sStats.m_u32Switches++;
+}
+
+// Function to pick the level for the workload of the last frame
+static int32_t disp_dvfs_pick(void)
+{
+    S_DISP_IDLE_STATS sIdle;
+    uint32_t u32Busy, u32Predicted;
+    int32_t i;
+
+    disp_idle_get_stats(&sIdle);
+
+    /* Nothing measured since the last pick. */
+    if (sIdle.m_u32Frames == s_u32IdleFrames)
+        return s_i32Cur;
+
+    s_u32IdleFrames = sIdle.m_u32Frames;
+    u32Busy = 1000 - sIdle.m_u32LastResidency;
+
+    if (u32Busy >= CONFIG_DISP_DVFS_UP_BUSY)
+    {
+        s_u32Hold = 0;
+
+        for (i = s_i32Cur - 1; i >= 0; i--)
+        {
+            if (s_asLevel[i].m_i32Valid)
+                return i;
+        }
+
+        return s_i32Cur;
+    }
+
+    for (i = s_i32Cur + 1; i < CONFIG_DISP_DVFS_LEVEL_NUM; i++)
+    {
+        if (s_asLevel[i].m_i32Valid)
+            break;
+    }
+
+    if (i >= CONFIG_DISP_DVFS_LEVEL_NUM)
+        return s_i32Cur;
+
+    /* The same work takes longer in proportion to the slower clock. */
+    u32Predicted = (uint32_t)(((uint64_t)u32Busy * s_asLevel[s_i32Cur].m_u32HclkHz) / s_asLevel[i].m_u32HclkHz);
+
+    if (u32Predicted > CONFIG_DISP_DVFS_DOWN_BUSY)
+    {
+        s_u32Hold = 0;
+        return s_i32Cur;
+    }
+
+    if (++s_u32Hold < CONFIG_DISP_DVFS_HOLD_FRAMES)
+        return s_i32Cur;
+
+    s_u32Hold = 0;
+
+    return i;
+}
+
+int disp_dvfs_set_level(int32_t i32Level)
+{
+    uint32_t u32PriMask = __get_PRIMASK();
+    int i32Ret = 0;
+
+    __disable_irq();
+
+    if (!s_i32Ready)
+        disp_dvfs_derive();
+
+    if ((s_i32Ready < 0) ||
+            ((i32Level != DISP_DVFS_AUTO) &&
+             ((i32Level < 0) || (i32Level >= CONFIG_DISP_DVFS_LEVEL_NUM) || !s_asLevel[i32Level].m_i32Valid)))
+        i32Ret = -1;
+    else
+        s_i32Forced = i32Level;
+
+    __set_PRIMASK(u32PriMask);
+
+    return i32Ret;
+}
+
+int32_t disp_dvfs_get_level(void)
+{
+    return s_i32Cur;
+}
+
+void disp_dvfs_blank(void)
+{
+    S_DISP_TIMING sNow;
+    int32_t i32Target;
+
+    if (!s_i32Ready)
+        disp_dvfs_derive();
+
+    if (s_i32Ready < 0)
+        return;
+
+    s_sStats.m_au32Frames[s_i32Cur]++;
+
+    disp_get_timing(&sNow);
+
+    /* Second step of a switch, the porches of the level are now on the panel. */
+    if (s_i32Pending >= 0)
+    {
+        if (memcmp(&sNow, &s_asLevel[s_i32Pending].m_sTiming, sizeof(S_DISP_TIMING)) == 0)
+        {
+            disp_dvfs_apply(s_i32Pending);
+            s_i32Pending = -1;
+        }
+
+        return;
+    }
+
+    i32Target = (s_i32Forced != DISP_DVFS_AUTO) ? s_i32Forced : disp_dvfs_pick();
+
+    if (i32Target == s_i32Cur)
+        return;
+
+    if (memcmp(&sNow, &s_asLevel[i32Target].m_sTiming, sizeof(S_DISP_TIMING)) == 0)
+        disp_dvfs_apply(i32Target);
+    else if (disp_set_timing(&s_asLevel[i32Target].m_sTiming) == 0)
+        s_i32Pending = i32Target;
+}
+
+void disp_dvfs_get_stats(S_DISP_DVFS_STATS *psStats)
+{
+    *psStats = s_sStats;
+}
+
+// Function to initialize the performance levels, derived at the first blank once the display runs
+static int disp_dvfs_init(void)
+{
+    memset(&s_sStats, 0, sizeof(s_sStats));
+
+    s_i32Forced = DISP_DVFS_AUTO;
+    s_i32Pending = -1;
+    s_u32Hold = 0;
+    s_i32Ready = 0;
+
+    return 0;
+}
+
+// Function to deinitialize the performance levels, going back to the boot clock
+static int disp_dvfs_fini(void)
+{
+    uint32_t u32PriMask = __get_PRIMASK();
+
+    __disable_irq();
+
+    if ((s_i32Ready > 0) && (s_i32Cur != s_i32Boot))
+    {
+        disp_dvfs_apply(s_i32Boot);
+        disp_set_timing(&s_asLevel[s_i32Boot].m_sTiming);
+    }
+
+    s_i32Pending = -1;
+    s_i32Ready = 0;
+
+    __set_PRIMASK(u32PriMask);
+
+    return 0;
+}
+
+COMPONENT_EXPORT("DISP_DVFS", disp_dvfs_init, disp_dvfs_fini);
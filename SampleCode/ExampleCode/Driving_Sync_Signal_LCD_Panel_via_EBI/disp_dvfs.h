@@ -0,0 +1,48 @@
+/**************************************************************************//**
+ * @file     disp_dvfs.h
+ * @brief    Performance levels switched at frame boundaries with the refresh rate kept.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_DVFS_H__
+#define __DISP_DVFS_H__
+
+#include "disp.h"
+
+/* SCLK divider and power level of each performance level, fastest first. The boot clock is level 0. */
+#define CONFIG_DISP_DVFS_LEVELS             { { 1, PMC_PLCTL_PLSEL_PL0 }, { 2, PMC_PLCTL_PLSEL_PL1 }, { 4, PMC_PLCTL_PLSEL_PL1 } }
+#define CONFIG_DISP_DVFS_LEVEL_NUM           3
+#define CONFIG_DISP_DVFS_MCLKDIV_MIN         EBI_MCLKDIV_1   /*!< Smallest EBI divider allowed, raise it if DMA cannot feed the EBI at low HCLK */
+#define CONFIG_DISP_DVFS_REFRESH_TOL         5   /*!< Refresh rate error accepted from rounded porches, in 1/1000 */
+#define CONFIG_DISP_DVFS_UP_BUSY           850   /*!< Busy share of a frame stepping up at once, in 1/1000 */
+#define CONFIG_DISP_DVFS_DOWN_BUSY         600   /*!< Busy share predicted at the next lower level allowing a step down, in 1/1000 */
+#define CONFIG_DISP_DVFS_HOLD_FRAMES        30   /*!< Frames a step down must stay allowed before it is taken */
+
+#define DISP_DVFS_AUTO                      (-1) /*!< Level chosen from the workload */
+
+typedef struct
+{
+    int32_t  m_i32Level;            /*!< Level running */
+    uint32_t m_u32HclkHz;           /*!< HCLK of the level running */
+    uint32_t m_u32LevelMask;        /*!< Levels the display timing can be kept at, bit per level */
+    uint32_t m_u32Switches;         /*!< Level switches done */
+    uint32_t m_au32Frames[CONFIG_DISP_DVFS_LEVEL_NUM];  /*!< Frames spent at each level */
+} S_DISP_DVFS_STATS;
+
+// Function to pin a level or, with DISP_DVFS_AUTO, follow the workload, returns 0 or -1
+// The switch happens at a following blank, once the porches of the level are being scanned out.
+int disp_dvfs_set_level(int32_t i32Level);
+
+// Function to get the level running
+int32_t disp_dvfs_get_level(void);
+
+// Function to step levels at frame boundaries, called from the blank callback after disp_idle_blank
+// The busy share of each frame comes from disp_idle. HCLK scaled peripherals other than the display,
+// e.g. the backlight EPWM and SPIM, run slower at lower levels.
+void disp_dvfs_blank(void);
+
+// Function to get the level statistics
+void disp_dvfs_get_stats(S_DISP_DVFS_STATS *psStats);
+
+#endif /* __DISP_DVFS_H__ */
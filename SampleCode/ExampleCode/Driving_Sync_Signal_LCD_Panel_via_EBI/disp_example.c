@@ -9,6 +9,10 @@
 
 #include "NuMicro.h"
 #include "disp.h"
+#include "disp_transition.h"
+#include "disp_idle.h"
+#include "disp_dvfs.h"
+#include "asset_verify.h"
 #include "string.h"
 
 /*---------------------------------------------------------------------------*/
@@ -17,6 +21,11 @@
 
 #define STR2(x) #x  // Convert the macro argument 'x' into a string literal.
 #define STR(x) STR2(x)  // Call STR2 to ensure that the argument is converted into a string.
+#define DEF_TRANSITION_FRAMES    32   /*!< Frames of each transition */
+#define DEF_TRANSITION_HOLD      64   /*!< Frames between transitions */
+#define DEF_ASSET_IMAGE1          1   /*!< Asset ID of image1 */
+#define DEF_ASSET_IMAGE2          2   /*!< Asset ID of image2 */
+
 #define INCBIN(name, file) \
     __asm__(".section .rodata\n" \
             ".global incbin_" STR(name) "_start\n" \
@@ -38,6 +47,9 @@
 INCBIN(image1, PATH_IMAGE1_BIN);  // Include binary data for image1 from the specified path.
 INCBIN(image2, PATH_IMAGE2_BIN);  // Include binary data for image2 from the specified path.
 
+static const uint32_t s_au32Image1Digest[8] = DIGEST_IMAGE1_BIN;
+static const uint32_t s_au32Image2Digest[8] = DIGEST_IMAGE2_BIN;
+
 /*---------------------------------------------------------------------------*/
 /* Functions                                                                 */
 /*---------------------------------------------------------------------------*/
@@ -46,24 +58,30 @@ INCBIN(image2, PATH_IMAGE2_BIN);  // Include binary data for image2 from the spe
 void disp_example_blankcb(void *p)
 {
     static uint32_t u32Counter = 0;
+    static E_DISP_TRANSITION evType = evTransWipeDown;
+    void *pvImage1 = (void *)g_au8FrameBuf;
+    void *pvImage2 = (void *)&g_au8FrameBuf[CONFIG_VRAM_BUF_SIZE];
 
-    /* Toggle different image showing after getting 16 event for avoid visual persistence ghosting. */
-#define DEF_TOGGLE_COND    (u32Counter & 0x10u)
+    disp_idle_blank();
+    disp_dvfs_blank();
+    disp_transition_tick();
 
-    /* Toggle between image1 and image2 display based on u32Counter's value. */
-    if (DEF_TOGGLE_COND)
-    {
-        /* If the condition is true, set VRAM buffer to image2 buffer address. */
-        disp_set_vrambufaddr((void *)&g_au8FrameBuf[CONFIG_VRAM_BUF_SIZE]);
-    }
-    else
+    if (disp_transition_busy())
+        return;
+
+    /* Move between image1 and image2 with a different transition every DEF_TRANSITION_HOLD frames. */
+    if (++u32Counter >= DEF_TRANSITION_HOLD)
     {
-        /* If the condition is false, set VRAM buffer to image1 buffer address. */
-        disp_set_vrambufaddr((void *)g_au8FrameBuf);
-    }
+        void *pvFrom = disp_get_vrambufaddr();
+        void *pvTo = (pvFrom == pvImage1) ? pvImage2 : pvImage1;
+
+        /* Crossfade is skipped without a scratch buffer. */
+        while (disp_transition_start(evType, pvFrom, pvTo, DEF_TRANSITION_FRAMES) < 0)
+            evType = (E_DISP_TRANSITION)((evType + 1) % evTransCNT);
 
-    // Increment the counter to alternate the display in the next callback
-    u32Counter++;
+        evType = (E_DISP_TRANSITION)((evType + 1) % evTransCNT);
+        u32Counter = 0;
+    }
 }
 
 
@@ -73,9 +91,14 @@ static int disp_example_init(void)
     /* Set blank event callback function. */
     disp_set_blankcb(disp_example_blankcb);
 
-    /* Copy image1 and image2 pixel data to VRAM buffer. */
-    memcpy(g_au8FrameBuf, (const uint8_t *)&incbin_image1_start, CONFIG_VRAM_BUF_SIZE);
-    memcpy(&g_au8FrameBuf[CONFIG_VRAM_BUF_SIZE], (const uint8_t *)&incbin_image2_start, CONFIG_VRAM_BUF_SIZE);
+    /* Copy image1 and image2 pixel data to VRAM buffer, an image failing verification is shown black. */
+    if (asset_verify_copy(DEF_ASSET_IMAGE1, g_au8FrameBuf, (const uint8_t *)&incbin_image1_start,
+                          CONFIG_VRAM_BUF_SIZE, s_au32Image1Digest) < 0)
+        memset(g_au8FrameBuf, 0, CONFIG_VRAM_BUF_SIZE);
+
+    if (asset_verify_copy(DEF_ASSET_IMAGE2, &g_au8FrameBuf[CONFIG_VRAM_BUF_SIZE], (const uint8_t *)&incbin_image2_start,
+                          CONFIG_VRAM_BUF_SIZE, s_au32Image2Digest) < 0)
+        memset(&g_au8FrameBuf[CONFIG_VRAM_BUF_SIZE], 0, CONFIG_VRAM_BUF_SIZE);
 
     /* Flush all pixel data in DCache to memory. */
     SCB_CleanDCache_by_Addr(g_au8FrameBuf, 2 * CONFIG_VRAM_BUF_SIZE);
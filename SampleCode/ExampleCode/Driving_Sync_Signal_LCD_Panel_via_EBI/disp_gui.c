@@ -0,0 +1,329 @@
+/**************************************************************************//**
+ * @file     disp_gui.c
+ * @brief    Display port for GUI libraries rendering into partial draw buffers.
+ *
+ *           Each flushed area is copied into VRAM by disp_copy, a single
+ *           stride-aware 2D command on DMA350 or one descriptor per line on
+ *           PDMA, and the GUI is told from the DMA interrupt that its draw
+ *           buffer is free. With two draw buffers the GUI renders the next
+ *           area while the previous one is copied. Double-buffered VRAM is
+ *           flipped at blanking, then the areas of the presented frame are
+ *           copied into the new back buffer so partial updates stay whole.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "disp_gui.h"
+#include "disp_calib.h"
+#include "disp_idle.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+/* The address is latched at the next blank, and the frame then starting may still read the old buffer. */
+#define DEF_GUI_FLIP_BLANKS       2
+
+typedef enum
+{
+    evGuiClosed,             /*!< Port is not open */
+    evGuiRun,                /*!< Copies run as they are queued */
+    evGuiFlipWait,           /*!< Frame complete, back buffer is scanned from the next blank */
+    evGuiFlipSettle,         /*!< Waiting for the scanout to leave the old front buffer */
+    evGuiCNT                 /*!< Number of states */
+} E_GUI_STATE;
+
+typedef struct
+{
+    S_DISP_RECT m_sRect;
+    const void *m_pvPixels;
+    int32_t     m_i32Last;
+} S_GUI_JOB;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static volatile E_GUI_STATE s_evState = evGuiClosed;
+static volatile int s_i32Busy = 0;          // A copy is in flight
+static volatile uint32_t s_u32Head = 0;     // Next job to copy
+static volatile uint32_t s_u32Tail = 0;     // Next free job
+static S_GUI_JOB s_asJob[CONFIG_DISP_GUI_QUEUE_NUM];
+static uint32_t s_u32FlipBlanks;
+
+static void *s_pvFront = NULL;
+static void *s_pvBack = NULL;
+static DISP_GUI_READY s_pfnReady = NULL;
+static void *s_pvUserData = NULL;
+
+/* Areas written into the back buffer this frame, and those still to replay after the last flip. */
+static S_DISP_RECT s_asDamage[CONFIG_DISP_GUI_DAMAGE_NUM];
+static uint32_t s_u32DamageNum;
+static int s_i32DamageAll;
+static S_DISP_RECT s_asSync[CONFIG_DISP_GUI_DAMAGE_NUM];
+static uint32_t s_u32SyncNum;
+static uint32_t s_u32SyncIdx;
+
+static S_DISP_GUI_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+static void disp_gui_kick(void);
+
+// Function to get the full screen rectangle
+static void disp_gui_screen(S_DISP_RECT *psRect)
+{
+    S_DISP_TIMING sTiming;
+
+    disp_get_timing(&sTiming);
+
+    psRect->m_u32X = 0;
+    psRect->m_u32Y = 0;
+    psRect->m_u32W = sTiming.m_u32HACT;
+    psRect->m_u32H = sTiming.m_u32VACT;
+}
+
+// Function to record an area written into the back buffer
+static void disp_gui_damage(const S_DISP_RECT *psRect)
+{
+    uint32_t i;
+
+    if (s_i32DamageAll)
+        return;
+
+    for (i = 0; i < s_u32DamageNum; i++)
+    {
+        const S_DISP_RECT *psOld = &s_asDamage[i];
+
+        if ((psRect->m_u32X >= psOld->m_u32X) && (psRect->m_u32Y >= psOld->m_u32Y) &&
+                ((psRect->m_u32X + psRect->m_u32W) <= (psOld->m_u32X + psOld->m_u32W)) &&
+                ((psRect->m_u32Y + psRect->m_u32H) <= (psOld->m_u32Y + psOld->m_u32H)))
+            return;
+    }
+
+    if (s_u32DamageNum < CONFIG_DISP_GUI_DAMAGE_NUM)
+        s_asDamage[s_u32DamageNum++] = *psRect;
+    else
+        s_i32DamageAll = 1;
+}
+
+// Callback function for disp_copy completion, in the DMA interrupt
+static void disp_gui_copy_done(void *pvUserData)
+{
+    S_GUI_JOB *psJob = (S_GUI_JOB *)pvUserData;
+
+    s_i32Busy = 0;
+
+    if (psJob)
+    {
+        s_u32Head++;
+        s_sStats.m_u32Flushes++;
+        s_sStats.m_u32Pixels += psJob->m_sRect.m_u32W * psJob->m_sRect.m_u32H;
+
+#if defined(CONFIG_LCD_PANEL_USE_I80)
+
+        /* GRAM only sees what is pushed, a flipped buffer is pushed whole by disp_set_vrambufaddr. */
+        if (!s_pvBack)
+            disp_flush(&psJob->m_sRect);
+
+#endif
+
+        if (s_pfnReady)
+            s_pfnReady(s_pvUserData);
+
+        /* The main loop may render into the freed draw buffer, do not let it sleep past this. */
+        disp_idle_post();
+
+        /* Hold the next frame until the back buffer is on screen and the old front is free. */
+        if (psJob->m_i32Last && s_pvBack)
+        {
+            s_evState = evGuiFlipWait;
+            return;
+        }
+    }
+
+    disp_gui_kick();
+}
+
+// Function to start the next copy if the engine is idle, called with interrupts masked or from the DMA interrupt
+static void disp_gui_kick(void)
+{
+    S_DISP_TIMING sTiming;
+    S_GUI_JOB *psJob;
+
+    if (s_i32Busy || (s_evState != evGuiRun))
+        return;
+
+    disp_get_timing(&sTiming);
+
+    /* Replay the presented frame into the new back buffer before anything is drawn over it. */
+    if (s_u32SyncIdx < s_u32SyncNum)
+    {
+        const S_DISP_RECT *psRect = &s_asSync[s_u32SyncIdx++];
+        const uint16_t *pu16Front = (const uint16_t *)s_pvFront;
+
+        s_i32Busy = 1;
+        s_sStats.m_u32SyncPixels += psRect->m_u32W * psRect->m_u32H;
+
+        if (disp_copy(s_pvBack, psRect, &pu16Front[psRect->m_u32Y * sTiming.m_u32HACT + psRect->m_u32X],
+                      sTiming.m_u32HACT, disp_gui_copy_done, NULL) != 0)
+            s_i32Busy = 0;
+
+        return;
+    }
+
+    if (s_u32Head == s_u32Tail)
+        return;
+
+    psJob = &s_asJob[s_u32Head & (CONFIG_DISP_GUI_QUEUE_NUM - 1)];
+
+    if (s_pvBack)
+        disp_gui_damage(&psJob->m_sRect);
+
+    s_i32Busy = 1;
+
+    if (disp_copy(s_pvBack ? s_pvBack : s_pvFront, &psJob->m_sRect, psJob->m_pvPixels,
+                  psJob->m_sRect.m_u32W, disp_gui_copy_done, psJob) != 0)
+    {
+        /* Drop the area rather than stall the GUI waiting for it. */
+        s_i32Busy = 0;
+        disp_gui_copy_done(psJob);
+    }
+}
+
+int disp_gui_open(void *pvFront, void *pvBack, DISP_GUI_READY pfnReady, void *pvUserData)
+{
+    if (!pvFront || (pvFront == pvBack) || (s_evState != evGuiClosed))
+        return -1;
+
+    s_pvFront = pvFront;
+    s_pvBack = pvBack;
+    s_pfnReady = pfnReady;
+    s_pvUserData = pvUserData;
+    s_u32Head = s_u32Tail = 0;
+    s_u32DamageNum = 0;
+    s_i32DamageAll = 0;
+    s_u32SyncNum = s_u32SyncIdx = 0;
+    s_i32Busy = 0;
+
+    disp_set_vrambufaddr(pvFront);
+
+    /* The back buffer starts as a copy of the front one. */
+    if (pvBack)
+    {
+        disp_gui_screen(&s_asSync[0]);
+        s_u32SyncNum = 1;
+    }
+
+    s_evState = evGuiRun;
+
+    return 0;
+}
+
+int disp_gui_flush(const S_DISP_RECT *psArea, const void *pvPixels, int i32Last)
+{
+    S_DISP_RECT sScreen;
+    S_GUI_JOB *psJob;
+    uint32_t u32PriMask;
+
+    if ((s_evState == evGuiClosed) || !psArea || !pvPixels)
+        return -1;
+
+    disp_gui_screen(&sScreen);
+
+    if (((psArea->m_u32X + psArea->m_u32W) > sScreen.m_u32W) || ((psArea->m_u32Y + psArea->m_u32H) > sScreen.m_u32H))
+        return -1;
+
+    if ((s_u32Tail - s_u32Head) >= CONFIG_DISP_GUI_QUEUE_NUM)
+    {
+        s_sStats.m_u32QueueFull++;
+        return -1;
+    }
+
+    /* Corrected in place, the GUI renders the next area over it anyway. */
+    disp_calib_apply((uint16_t *)pvPixels, (const uint16_t *)pvPixels, psArea->m_u32W * psArea->m_u32H);
+
+    /* The DMA reads the draw buffer from memory. */
+    SCB_CleanDCache_by_Addr((void *)pvPixels, (int32_t)(psArea->m_u32W * psArea->m_u32H * sizeof(uint16_t)));
+
+    psJob = &s_asJob[s_u32Tail & (CONFIG_DISP_GUI_QUEUE_NUM - 1)];
+    psJob->m_sRect = *psArea;
+    psJob->m_pvPixels = pvPixels;
+    psJob->m_i32Last = i32Last;
+
+    u32PriMask = __get_PRIMASK();
+    __disable_irq();
+
+    s_u32Tail++;
+    disp_gui_kick();
+
+    __set_PRIMASK(u32PriMask);
+
+    return 0;
+}
+
+void disp_gui_blank(void)
+{
+    void *pvOld;
+
+    if (s_evState == evGuiFlipWait)
+    {
+        disp_set_vrambufaddr(s_pvBack);
+        s_u32FlipBlanks = DEF_GUI_FLIP_BLANKS;
+        s_evState = evGuiFlipSettle;
+    }
+    else if ((s_evState == evGuiFlipSettle) && (--s_u32FlipBlanks == 0))
+    {
+        pvOld = s_pvFront;
+        s_pvFront = s_pvBack;
+        s_pvBack = pvOld;
+        s_sStats.m_u32Flips++;
+
+        /* What the frame drew now has to be drawn into the old front buffer as well. */
+        if (s_i32DamageAll)
+        {
+            disp_gui_screen(&s_asSync[0]);
+            s_u32SyncNum = 1;
+        }
+        else
+        {
+            memcpy(s_asSync, s_asDamage, s_u32DamageNum * sizeof(S_DISP_RECT));
+            s_u32SyncNum = s_u32DamageNum;
+        }
+
+        s_u32SyncIdx = 0;
+        s_u32DamageNum = 0;
+        s_i32DamageAll = 0;
+        s_evState = evGuiRun;
+
+        disp_gui_kick();
+    }
+}
+
+void disp_gui_wait(void)
+{
+    while ((s_evState != evGuiClosed) &&
+            (s_i32Busy || (s_evState != evGuiRun) || (s_u32Head != s_u32Tail) || (s_u32SyncIdx < s_u32SyncNum)))
+    {
+        uint32_t u32PriMask = __get_PRIMASK();
+
+        /* A sync left behind by the flip is started here if no flush followed. */
+        __disable_irq();
+        disp_gui_kick();
+        __set_PRIMASK(u32PriMask);
+    }
+}
+
+void disp_gui_close(void)
+{
+    disp_gui_wait();
+
+    s_evState = evGuiClosed;
+    s_pfnReady = NULL;
+}
+
+void disp_gui_get_stats(S_DISP_GUI_STATS *psStats)
+{
+    *psStats = s_sStats;
+}
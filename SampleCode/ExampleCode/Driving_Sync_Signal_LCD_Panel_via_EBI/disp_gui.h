@@ -0,0 +1,53 @@
+/**************************************************************************//**
+ * @file     disp_gui.h
+ * @brief    Display port for GUI libraries rendering into partial draw buffers.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_GUI_H__
+#define __DISP_GUI_H__
+
+#include "disp.h"
+
+#define CONFIG_DISP_GUI_QUEUE_NUM            4   /*!< Flushes queued behind the one being copied, power of 2 */
+#define CONFIG_DISP_GUI_DAMAGE_NUM          16   /*!< Areas of a frame replayed into the other buffer after a flip, more sync the whole screen */
+
+/* Called from the DMA interrupt once the draw buffer of a flush is copied and may be rendered
+   into again, e.g. lv_display_flush_ready. */
+typedef void (*DISP_GUI_READY)(void *pvUserData);
+
+typedef struct
+{
+    uint32_t m_u32Flushes;          /*!< Areas copied from draw buffers */
+    uint32_t m_u32Pixels;           /*!< Pixels copied from draw buffers */
+    uint32_t m_u32Flips;            /*!< Buffers flipped */
+    uint32_t m_u32SyncPixels;       /*!< Pixels copied from the new front to the new back buffer after flips */
+    uint32_t m_u32QueueFull;        /*!< Flushes refused on a full queue */
+} S_DISP_GUI_STATS;
+
+// Function to open the port on VRAM buffers pvFront and pvBack, returns 0 or -1
+// pvFront is scanned out at once. With pvBack, flushes land in the back buffer and the last area of a
+// frame flips it at the next blank; the areas of that frame are then copied into the other buffer before
+// the next frame's flushes. Without pvBack, flushes go straight into the scanned buffer. While open, the
+// display DMA engine belongs to the port, do not call disp_fill or disp_copy.
+int disp_gui_open(void *pvFront, void *pvBack, DISP_GUI_READY pfnReady, void *pvUserData);
+
+// Function to queue the copy of a rendered area into VRAM, returns 0 or -1 on a full queue
+// pvPixels holds psArea->m_u32W x m_u32H RGB565 pixels; it is corrected by disp_calib in place, cleaned here
+// and must not be rendered into until pfnReady is called. i32Last marks the last area of a frame. Call from the GUI flush callback.
+int disp_gui_flush(const S_DISP_RECT *psArea, const void *pvPixels, int i32Last);
+
+// Function to advance buffer flips, called from the blank callback
+void disp_gui_blank(void);
+
+// Function to wait until every queued flush is copied and flipped
+void disp_gui_wait(void);
+
+// Function to close the port, the scanned buffer stays on screen
+void disp_gui_close(void);
+
+// Function to get the port statistics
+void disp_gui_get_stats(S_DISP_GUI_STATS *psStats);
+
+#endif /* __DISP_GUI_H__ */
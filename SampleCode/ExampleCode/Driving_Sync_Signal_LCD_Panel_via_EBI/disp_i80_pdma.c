@@ -0,0 +1,740 @@
+/**************************************************************************//**
+ * @file     disp_i80_pdma.c
+ * @brief    Use EBI-16 with PDMA-M2M to update an i80 command-mode LCD panel.
+ *
+ *           The panel refreshes itself from its internal GRAM, so only dirty
+ *           rectangles are sent: a CASET/RASET window, RAMWR, then one PDMA
+ *           descriptor per line of the rectangle to the EBI data address.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "pdma_lib.h"
+#include "disp.h"
+#include "disp_mem.h"
+#include "nu_os.h"
+
+#if defined(CONFIG_LCD_PANEL_USE_I80)
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_I80_CMD_ADDR         (EBI_BANK0_BASE_ADDR + (CONFIG_DISP_EBI * EBI_MAX_SIZE))   /*!< D/CX low */
+#define DEF_I80_DATA_ADDR        (DEF_I80_CMD_ADDR + (1 << CONFIG_DISP_I80_RS_BITIDX))     /*!< D/CX high */
+#define DEF_PDMA_EV_FILL_DONE    (1UL << 0)
+
+#define DEF_I80_CMD_SWRESET      0x01
+#define DEF_I80_CMD_SLPOUT       0x11
+#define DEF_I80_CMD_DISPON       0x29
+#define DEF_I80_CMD_CASET        0x2A
+#define DEF_I80_CMD_RASET        0x2B
+#define DEF_I80_CMD_RAMWR        0x2C
+#define DEF_I80_CMD_TEON         0x35
+#define DEF_I80_CMD_MADCTL       0x36
+#define DEF_I80_CMD_COLMOD       0x3A
+
+#define DEF_I80_COLMOD_RGB565    0x55
+
+/* disp_fill takes one descriptor per line, or a few for a contiguous full-width fill. */
+#if (((CONFIG_TIMING_HACT * CONFIG_TIMING_VACT / 2) + NU_PDMA_MAX_TXCNT - 1) / NU_PDMA_MAX_TXCNT) > CONFIG_TIMING_VACT
+    #error "s_asDscFill is too small for a full-screen fill."
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+#if defined(NVT_NONCACHEABLE)
+    NVT_NONCACHEABLE static DSCT_T s_asDsc[CONFIG_TIMING_VACT];
+    NVT_NONCACHEABLE static DSCT_T s_asDscFill[CONFIG_TIMING_VACT];
+    NVT_NONCACHEABLE static uint32_t s_u32FillData;     // Fixed source of disp_fill, two RGB565 pixels
+#else
+    static DSCT_T s_asDsc[CONFIG_TIMING_VACT];
+    static DSCT_T s_asDscFill[CONFIG_TIMING_VACT];
+    static uint32_t s_u32FillData;
+#endif
+
+uint8_t g_au8FrameBuf[CONFIG_VRAM_TOTAL_ALLOCATED_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE))); // Declare VRAM instance.
+static volatile uint16_t *s_pu16BufAddr = NULL;
+static DispBlankCb s_DispBlankCb = NULL;
+
+static const S_DISP_TIMING s_sTimingDefault = DEF_DISP_TIMING_DEFAULT;
+
+static S_DISP_RECT s_sRectPending;          // Union of rectangles waiting for the bus
+static volatile int s_i32Pending = 0;
+static volatile int s_i32Busy = 0;
+static volatile int s_i32BlankPending = 0;  // Refresh came while the buffer was being sent
+
+static int s_i32Channel = -1;
+static int s_i32FillChannel = -1;
+static volatile int s_i32FillBusy = 0;
+static DispCopyCb s_pfnCopyDone = NULL;        // Completion of the disp_copy in flight
+static void *s_pvCopyUserData = NULL;
+static nu_os_event_t s_sEvFill;                // Set when a disp_fill or disp_copy ends
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to write a command to the panel
+static void disp_i80_write_cmd(uint16_t u16Cmd)
+{
+    *((volatile uint16_t *)DEF_I80_CMD_ADDR) = u16Cmd;
+}
+
+// Function to write a parameter to the panel
+static void disp_i80_write_data(uint16_t u16Data)
+{
+    *((volatile uint16_t *)DEF_I80_DATA_ADDR) = u16Data;
+}
+
+// Function to delay in milliseconds
+static void disp_i80_delay_ms(uint32_t u32Ms)
+{
+    CLK_SysTickLongDelay(u32Ms * 1000);
+}
+
+// Function to set the GRAM window and open it for writing
+static void disp_i80_set_window(const S_DISP_RECT *psRect)
+{
+    uint32_t u32X1 = psRect->m_u32X + psRect->m_u32W - 1;
+    uint32_t u32Y1 = psRect->m_u32Y + psRect->m_u32H - 1;
+
+    disp_i80_write_cmd(DEF_I80_CMD_CASET);
+    disp_i80_write_data(psRect->m_u32X >> 8);
+    disp_i80_write_data(psRect->m_u32X & 0xFF);
+    disp_i80_write_data(u32X1 >> 8);
+    disp_i80_write_data(u32X1 & 0xFF);
+
+    disp_i80_write_cmd(DEF_I80_CMD_RASET);
+    disp_i80_write_data(psRect->m_u32Y >> 8);
+    disp_i80_write_data(psRect->m_u32Y & 0xFF);
+    disp_i80_write_data(u32Y1 >> 8);
+    disp_i80_write_data(u32Y1 & 0xFF);
+
+    disp_i80_write_cmd(DEF_I80_CMD_RAMWR);
+}
+
+// Function to send the generic power-on sequence to the panel
+static void disp_i80_panel_init(void)
+{
+    disp_i80_write_cmd(DEF_I80_CMD_SWRESET);
+    disp_i80_delay_ms(120);
+
+    disp_i80_write_cmd(DEF_I80_CMD_SLPOUT);
+    disp_i80_delay_ms(120);
+
+    disp_i80_write_cmd(DEF_I80_CMD_COLMOD);
+    disp_i80_write_data(DEF_I80_COLMOD_RGB565);
+
+    disp_i80_write_cmd(DEF_I80_CMD_MADCTL);
+    disp_i80_write_data(0x00);
+
+#if defined(CONFIG_DISP_I80_USE_TE)
+    /* TE output on V-blanking only. */
+    disp_i80_write_cmd(DEF_I80_CMD_TEON);
+    disp_i80_write_data(0x00);
+#endif
+
+    disp_i80_write_cmd(DEF_I80_CMD_DISPON);
+}
+
+// Function to merge a rectangle into the pending one
+static void disp_i80_rect_union(S_DISP_RECT *psDst, const S_DISP_RECT *psSrc)
+{
+    uint32_t u32X0 = (psDst->m_u32X < psSrc->m_u32X) ? psDst->m_u32X : psSrc->m_u32X;
+    uint32_t u32Y0 = (psDst->m_u32Y < psSrc->m_u32Y) ? psDst->m_u32Y : psSrc->m_u32Y;
+    uint32_t u32X1 = ((psDst->m_u32X + psDst->m_u32W) > (psSrc->m_u32X + psSrc->m_u32W)) ? (psDst->m_u32X + psDst->m_u32W) : (psSrc->m_u32X + psSrc->m_u32W);
+    uint32_t u32Y1 = ((psDst->m_u32Y + psDst->m_u32H) > (psSrc->m_u32Y + psSrc->m_u32H)) ? (psDst->m_u32Y + psDst->m_u32H) : (psSrc->m_u32Y + psSrc->m_u32H);
+
+    psDst->m_u32X = u32X0;
+    psDst->m_u32Y = u32Y0;
+    psDst->m_u32W = u32X1 - u32X0;
+    psDst->m_u32H = u32Y1 - u32Y0;
+}
+
+// Function to start sending the pending rectangle
+static void disp_i80_kick(void)
+{
+    S_DISP_RECT sRect;
+    uint16_t *pu16Buf = (uint16_t *)s_pu16BufAddr;
+    nu_pdma_desc_t next = &s_asDsc[0];
+    uint32_t y;
+
+    sRect = s_sRectPending;
+    s_i32Pending = 0;
+    s_i32Busy = 1;
+
+    disp_i80_set_window(&sRect);
+
+    if (sRect.m_u32W == CONFIG_TIMING_HACT)
+    {
+        /* Full-width lines are contiguous, split only at NU_PDMA_MAX_TXCNT. */
+        uint32_t u32Addr = (uint32_t)&pu16Buf[sRect.m_u32Y * CONFIG_TIMING_HACT];
+        uint32_t u32Count = sRect.m_u32H * CONFIG_TIMING_HACT;
+
+        while (u32Count > 0)
+        {
+            uint32_t u32TxCnt = (u32Count > NU_PDMA_MAX_TXCNT) ? NU_PDMA_MAX_TXCNT : u32Count;
+
+            nu_pdma_m2m_desc_setup(next, 16, u32Addr, DEF_I80_DATA_ADDR, u32TxCnt, eMemCtl_SrcInc_DstFix, next + 1, 1);
+
+            u32Addr += u32TxCnt * sizeof(uint16_t);
+            u32Count -= u32TxCnt;
+            next++;
+        }
+    }
+    else
+    {
+        for (y = sRect.m_u32Y; y < (sRect.m_u32Y + sRect.m_u32H); y++)
+        {
+            nu_pdma_m2m_desc_setup(next,
+                                   16,
+                                   (uint32_t)&pu16Buf[y * CONFIG_TIMING_HACT + sRect.m_u32X],
+                                   DEF_I80_DATA_ADDR,
+                                   sRect.m_u32W,
+                                   eMemCtl_SrcInc_DstFix,
+                                   next + 1,
+                                   1);
+            next++;
+        }
+    }
+
+    /* Window commands must reach the panel before pixel data. */
+    __DSB();
+
+    if (next == &s_asDsc[1])
+    {
+        /* A single run is done in basic mode, the channel does not fetch a lone descriptor. */
+        nu_pdma_channel_memctrl_set(s_i32Channel, eMemCtl_SrcInc_DstFix);
+
+        nu_pdma_transfer(s_i32Channel, 16, s_asDsc[0].SA, s_asDsc[0].DA,
+                         ((s_asDsc[0].CTL & PDMA_DSCT_CTL_TXCNT_Msk) >> PDMA_DSCT_CTL_TXCNT_Pos) + 1, 0);
+        return;
+    }
+
+    /* Last descriptor stops the chain and raises the done event. */
+    (next - 1)->CTL = ((next - 1)->CTL & ~PDMA_DSCT_CTL_OPMODE_Msk & ~PDMA_DSCT_CTL_TBINTDIS_Msk) | PDMA_OP_BASIC;
+    (next - 1)->NEXT = 0;
+
+    nu_pdma_sg_transfer(s_i32Channel, &s_asDsc[0], 0);
+}
+
+// Function to run the blank work of one panel refresh
+static void disp_i80_blank(void)
+{
+    s_i32BlankPending = 0;
+
+    disp_mem_tick((void *)s_pu16BufAddr);
+
+    if (s_DispBlankCb)
+        s_DispBlankCb((void *)s_pu16BufAddr);
+}
+
+// Function to signal a panel refresh, deferred to the end of a transfer reading the buffer
+static void disp_i80_refresh(void)
+{
+    if (s_i32Busy)
+        s_i32BlankPending = 1;
+    else
+        disp_i80_blank();
+}
+
+// Callback function for PDMA transfer completion
+static void nu_pdma_i80_cb(void *pvUserData, uint32_t u32Events)
+{
+    if ((u32Events == NU_PDMA_EVENT_TRANSFER_DONE))
+    {
+        s_i32Busy = 0;
+
+        if (s_i32BlankPending)
+            disp_i80_blank();
+
+#if !defined(CONFIG_DISP_I80_USE_TE)
+
+        if (s_i32Pending && !s_i32Busy)
+            disp_i80_kick();
+
+#endif
+    }
+}
+
+#if defined(CONFIG_DISP_I80_USE_TE)
+// TE input interrupt handler
+NVT_ITCM void CONFIG_DISP_I80_TE_IRQHandler(void)
+{
+    if (GPIO_GET_INT_FLAG(CONFIG_DISP_I80_TE_PORT, 1 << CONFIG_DISP_I80_TE_PIN))
+    {
+        GPIO_CLR_INT_FLAG(CONFIG_DISP_I80_TE_PORT, 1 << CONFIG_DISP_I80_TE_PIN);
+
+        disp_i80_refresh();
+
+        /* Panel has just left its scan of GRAM, writing now does not tear. */
+        if (s_i32Pending && !s_i32Busy)
+            disp_i80_kick();
+    }
+}
+#else
+// Blank timer interrupt handler, stands in for TE at the panel refresh rate
+NVT_ITCM void CONFIG_DISP_I80_BLANK_TIMER_IRQHandler(void)
+{
+    if (TIMER_GetIntFlag(CONFIG_DISP_I80_BLANK_TIMER))
+    {
+        TIMER_ClearIntFlag(CONFIG_DISP_I80_BLANK_TIMER);
+
+        disp_i80_refresh();
+    }
+}
+#endif
+
+// Callback function for disp_fill and disp_copy completion
+static void nu_pdma_fill_cb(void *pvUserData, uint32_t u32Events)
+{
+    DispCopyCb pfnDone = s_pfnCopyDone;
+
+    s_pfnCopyDone = NULL;
+    s_i32FillBusy = 0;
+
+    nu_os_event_set(&s_sEvFill, DEF_PDMA_EV_FILL_DONE);
+
+    if (pfnDone)
+        pfnDone(s_pvCopyUserData);
+}
+
+// Function to initialize the PDMA module
+static void pdma_init(void)
+{
+    uint32_t u32RegLocked = SYS_IsRegLocked();
+
+    /* Unlock protected registers */
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    /* Enable PDMA0/PDMA1 clock source. */
+    CLK_EnableModuleClock(PDMA0_MODULE);
+    CLK_EnableModuleClock(PDMA1_MODULE);
+
+    /* Reset PDMA0/PDMA1 modules. */
+    SYS_ResetModule(SYS_PDMA0RST);
+    SYS_ResetModule(SYS_PDMA1RST);
+
+#if defined(CONFIG_DISP_I80_USE_TE)
+    /* TE input on rising edge. */
+    CLK_EnableModuleClock(GPIOB_MODULE);
+    GPIO_SetMode(CONFIG_DISP_I80_TE_PORT, 1 << CONFIG_DISP_I80_TE_PIN, GPIO_MODE_INPUT);
+    GPIO_EnableInt(CONFIG_DISP_I80_TE_PORT, CONFIG_DISP_I80_TE_PIN, GPIO_INT_RISING);
+    NVIC_EnableIRQ(CONFIG_DISP_I80_TE_IRQn);
+#else
+    /* Blank work keeps running at the refresh rate whether or not anything is sent. */
+    CLK_SetModuleClock(CONFIG_DISP_I80_BLANK_TIMER_MODULE, CONFIG_DISP_I80_BLANK_TIMER_CLKSEL, 0);
+    CLK_EnableModuleClock(CONFIG_DISP_I80_BLANK_TIMER_MODULE);
+    TIMER_Open(CONFIG_DISP_I80_BLANK_TIMER, TIMER_PERIODIC_MODE, CONFIG_DISP_I80_REFRESH_HZ);
+    TIMER_EnableInt(CONFIG_DISP_I80_BLANK_TIMER);
+    NVIC_EnableIRQ(CONFIG_DISP_I80_BLANK_TIMER_IRQn);
+#endif
+
+    /* Lock protected registers */
+    if (u32RegLocked)
+        SYS_LockReg();
+}
+
+// Function to deinitialize the PDMA module
+static void pdma_fini(void)
+{
+    uint32_t u32RegLocked = SYS_IsRegLocked();
+
+    /* Unlock protected registers */
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+#if defined(CONFIG_DISP_I80_USE_TE)
+    NVIC_DisableIRQ(CONFIG_DISP_I80_TE_IRQn);
+    GPIO_DisableInt(CONFIG_DISP_I80_TE_PORT, CONFIG_DISP_I80_TE_PIN);
+#else
+    NVIC_DisableIRQ(CONFIG_DISP_I80_BLANK_TIMER_IRQn);
+    TIMER_Close(CONFIG_DISP_I80_BLANK_TIMER);
+    CLK_DisableModuleClock(CONFIG_DISP_I80_BLANK_TIMER_MODULE);
+#endif
+
+    /* Reset PDMA0/PDMA1 modules. */
+    SYS_ResetModule(SYS_PDMA0RST);
+    SYS_ResetModule(SYS_PDMA1RST);
+
+    /* Disable PDMA0/PDMA1 clock source. */
+    CLK_DisableModuleClock(PDMA0_MODULE);
+    CLK_DisableModuleClock(PDMA1_MODULE);
+
+    /* Lock protected registers */
+    if (u32RegLocked)
+        SYS_LockReg();
+}
+
+// Function to initialize the EBI i80 PDMA
+static int disp_i80_pdma_init(void)
+{
+    /* Set the VRAM address by default. */
+    s_pu16BufAddr = (uint16_t *)g_au8FrameBuf;
+
+    pdma_init();
+
+    /* The NEXT field is a 16-bit offset, a fill chain must stay in one 64KB window. */
+    PDMA_ASSERT(((uint32_t)&s_asDscFill[0] & ~(NU_PDMA_SG_LIMITED_DISTANCE - 1)) ==
+                (((uint32_t)&s_asDscFill[CONFIG_TIMING_VACT] - 1) & ~(NU_PDMA_SG_LIMITED_DISTANCE - 1)));
+
+    if (s_i32Channel < 0)
+    {
+        /* Allocate a PDMA channel resource. */
+        s_i32Channel = nu_pdma_channel_allocate(PDMA_MEM);
+
+        if (s_i32Channel < 0)
+            return -1;
+    }
+
+    /* Register a direct vector, the blanking work starts right from the PDMA ISR. */
+    nu_pdma_vector_register(s_i32Channel, nu_pdma_i80_cb, NULL);
+
+    if (s_i32FillChannel < 0)
+    {
+        /* Second channel for disp_fill, so fills never wait for the scanout chain. */
+        s_i32FillChannel = nu_pdma_channel_allocate(PDMA_MEM);
+
+        if (s_i32FillChannel < 0)
+            return -1;
+
+        nu_pdma_channel_memctrl_set(s_i32FillChannel, eMemCtl_SrcFix_DstInc);
+        nu_pdma_vector_register(s_i32FillChannel, nu_pdma_fill_cb, NULL);
+    }
+
+    s_i32FillBusy = 0;
+    nu_os_event_init(&s_sEvFill);
+
+    disp_i80_panel_init();
+
+    s_i32Busy = 0;
+    s_i32Pending = 0;
+    s_i32BlankPending = 0;
+
+    /* Fill the GRAM once. */
+    return disp_flush(NULL);
+}
+
+// Function to deinitialize the EBI i80 PDMA
+static int disp_i80_pdma_fini(void)
+{
+    if (s_i32Channel >= 0)
+    {
+        /* Free allocated PDMA channel resource. */
+        nu_pdma_channel_free(s_i32Channel);
+
+        s_i32Channel = -1;
+    }
+
+    if (s_i32FillChannel >= 0)
+    {
+        nu_pdma_channel_free(s_i32FillChannel);
+
+        s_i32FillChannel = -1;
+    }
+
+    pdma_fini();
+
+    return 0;
+}
+
+// Function to set the VRAM buffer address
+void disp_set_vrambufaddr(void *pvBufAddr)
+{
+    /* Buffer must be powered before it is sent. */
+    disp_mem_acquire(pvBufAddr);
+
+    s_pu16BufAddr = (volatile uint16_t *)pvBufAddr;
+
+    /* GRAM keeps the old content, send the new buffer in full. */
+    if (pvBufAddr && (s_i32Channel >= 0))
+        disp_flush(NULL);
+}
+
+// Function to get the VRAM buffer address
+void *disp_get_vrambufaddr(void)
+{
+    return (void *)s_pu16BufAddr;
+}
+
+// Function to set the blank callback function
+void disp_set_blankcb(DispBlankCb f)
+{
+    s_DispBlankCb = f;
+}
+
+// Function to set the per-line source address table
+void disp_set_linetbl(const uint32_t *pu32LineAddr)
+{
+    /* GRAM is written by window, there is no per-line scanout to redirect. */
+    (void)pu32LineAddr;
+}
+
+// Function to push a changed rectangle of VRAM to the panel, NULL means the full screen
+int disp_flush(const S_DISP_RECT *psRect)
+{
+    S_DISP_RECT sRect;
+    uint32_t u32PriMask;
+    uint32_t y;
+    uint16_t *pu16Buf = (uint16_t *)s_pu16BufAddr;
+
+    if ((s_i32Channel < 0) || !pu16Buf)
+        return -1;
+
+    if (psRect)
+    {
+        if (!psRect->m_u32W || !psRect->m_u32H ||
+                ((psRect->m_u32X + psRect->m_u32W) > CONFIG_TIMING_HACT) ||
+                ((psRect->m_u32Y + psRect->m_u32H) > CONFIG_TIMING_VACT))
+            return -1;
+
+        sRect = *psRect;
+    }
+    else
+    {
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = CONFIG_TIMING_HACT;
+        sRect.m_u32H = CONFIG_TIMING_VACT;
+    }
+
+    /* Flush pixel data in DCache to memory for DMA. */
+    for (y = sRect.m_u32Y; y < (sRect.m_u32Y + sRect.m_u32H); y++)
+        SCB_CleanDCache_by_Addr(&pu16Buf[y * CONFIG_TIMING_HACT + sRect.m_u32X], sRect.m_u32W * sizeof(uint16_t));
+
+    u32PriMask = __get_PRIMASK();
+    __disable_irq();
+
+    /* Rectangles arriving while the bus is busy are merged into one window. */
+    if (s_i32Pending)
+        disp_i80_rect_union(&s_sRectPending, &sRect);
+    else
+        s_sRectPending = sRect;
+
+    s_i32Pending = 1;
+
+#if !defined(CONFIG_DISP_I80_USE_TE)
+
+    if (!s_i32Busy)
+        disp_i80_kick();
+
+#endif
+
+    __set_PRIMASK(u32PriMask);
+
+    return 0;
+}
+
+// Function to queue one run of disp_fill, odd pixels at either end are written by CPU
+static nu_pdma_desc_t disp_fill_run(nu_pdma_desc_t next, uint16_t *pu16Dst, uint32_t u32Pixels, uint16_t u16Color)
+{
+    uint32_t u32Words;
+
+    if (((uint32_t)pu16Dst & 0x2) && u32Pixels)
+    {
+        *pu16Dst = u16Color;
+        SCB_CleanDCache_by_Addr(pu16Dst, sizeof(uint16_t));
+        pu16Dst++;
+        u32Pixels--;
+    }
+
+    if (u32Pixels & 1)
+    {
+        u32Pixels--;
+        pu16Dst[u32Pixels] = u16Color;
+        SCB_CleanDCache_by_Addr(&pu16Dst[u32Pixels], sizeof(uint16_t));
+    }
+
+    /* The rest goes as 32-bit beats of the doubled pattern. */
+    u32Words = u32Pixels / 2;
+
+    while (u32Words > 0)
+    {
+        uint32_t u32TxCnt = (u32Words > NU_PDMA_MAX_TXCNT) ? NU_PDMA_MAX_TXCNT : u32Words;
+
+        nu_pdma_m2m_desc_setup(next, 32, (uint32_t)&s_u32FillData, (uint32_t)pu16Dst, u32TxCnt, eMemCtl_SrcFix_DstInc, next + 1, 1);
+
+        pu16Dst += u32TxCnt * 2;
+        u32Words -= u32TxCnt;
+        next++;
+    }
+
+    return next;
+}
+
+// Function to fill a rectangle of a buffer with an RGB565 color, NULL rectangle means the whole buffer
+int disp_fill(void *pvBuf, const S_DISP_RECT *psRect, uint16_t u16Color)
+{
+    S_DISP_TIMING sTiming;
+    S_DISP_RECT sRect;
+    uint16_t *pu16Buf = pvBuf ? (uint16_t *)pvBuf : (uint16_t *)s_pu16BufAddr;
+    nu_pdma_desc_t next = &s_asDscFill[0];
+    uint32_t y;
+
+    if ((s_i32FillChannel < 0) || !pu16Buf)
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (psRect)
+    {
+        if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+                ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+            return -1;
+
+        sRect = *psRect;
+    }
+    else
+    {
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = sTiming.m_u32HACT;
+        sRect.m_u32H = sTiming.m_u32VACT;
+    }
+
+    /* Descriptors and pattern are shared with the previous fill. */
+    disp_fill_wait();
+
+    if (!sRect.m_u32W || !sRect.m_u32H)
+        return 0;
+
+    disp_mem_acquire(pu16Buf);
+
+    s_u32FillData = ((uint32_t)u16Color << 16) | u16Color;
+
+    if (sRect.m_u32W == sTiming.m_u32HACT)
+    {
+        /* Full-width lines are contiguous, split only at NU_PDMA_MAX_TXCNT. */
+        next = disp_fill_run(next, &pu16Buf[sRect.m_u32Y * sTiming.m_u32HACT], sRect.m_u32H * sTiming.m_u32HACT, u16Color);
+    }
+    else
+    {
+        for (y = sRect.m_u32Y; y < (sRect.m_u32Y + sRect.m_u32H); y++)
+            next = disp_fill_run(next, &pu16Buf[y * sTiming.m_u32HACT + sRect.m_u32X], sRect.m_u32W, u16Color);
+    }
+
+    if (next == &s_asDscFill[0])
+        return 0;   // CPU wrote the odd pixels, nothing left for DMA.
+
+    s_i32FillBusy = 1;
+
+    if (next == &s_asDscFill[1])
+    {
+        /* A single run is done in basic mode, the channel does not fetch a lone descriptor. */
+        nu_pdma_channel_memctrl_set(s_i32FillChannel, eMemCtl_SrcFix_DstInc);
+
+        return nu_pdma_transfer(s_i32FillChannel, 32, s_asDscFill[0].SA, s_asDscFill[0].DA,
+                                ((s_asDscFill[0].CTL & PDMA_DSCT_CTL_TXCNT_Msk) >> PDMA_DSCT_CTL_TXCNT_Pos) + 1, 0);
+    }
+
+    /* Last descriptor stops the chain and raises the done event. */
+    (next - 1)->CTL = ((next - 1)->CTL & ~PDMA_DSCT_CTL_OPMODE_Msk & ~PDMA_DSCT_CTL_TBINTDIS_Msk) | PDMA_OP_BASIC;
+    (next - 1)->NEXT = 0;
+
+    return nu_pdma_sg_transfer(s_i32FillChannel, &s_asDscFill[0], 0);
+}
+
+// Function to wait for the last disp_fill to finish
+void disp_fill_wait(void)
+{
+    while (s_i32FillBusy)
+    {
+        /* Masked or in an interrupt the done interrupt cannot run, poll instead. */
+        if (!__get_PRIMASK() && !__get_IPSR())
+            nu_os_event_wait(&s_sEvFill, DEF_PDMA_EV_FILL_DONE, 0, NU_OS_WAIT_FOREVER);
+    }
+}
+
+// Function to copy an RGB565 area into a rectangle of a buffer by DMA, pfnDone runs in the DMA interrupt
+int disp_copy(void *pvBuf, const S_DISP_RECT *psRect, const void *pvSrc, uint32_t u32SrcStride, DispCopyCb pfnDone, void *pvUserData)
+{
+    S_DISP_TIMING sTiming;
+    uint16_t *pu16Buf = pvBuf ? (uint16_t *)pvBuf : (uint16_t *)s_pu16BufAddr;
+    const uint16_t *pu16Src = (const uint16_t *)pvSrc;
+    uint16_t *pu16Dst;
+    nu_pdma_desc_t next = &s_asDscFill[0];
+    uint32_t u32DataWidth, u32Count, y;
+
+    if ((s_i32FillChannel < 0) || !pu16Buf || !psRect || !pu16Src || (u32SrcStride < psRect->m_u32W))
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+            ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+        return -1;
+
+    /* Descriptors and channel are shared with disp_fill. */
+    disp_fill_wait();
+
+    if (!psRect->m_u32W || !psRect->m_u32H)
+    {
+        if (pfnDone)
+            pfnDone(pvUserData);
+
+        return 0;
+    }
+
+    disp_mem_acquire(pu16Buf);
+
+    pu16Dst = &pu16Buf[psRect->m_u32Y * sTiming.m_u32HACT + psRect->m_u32X];
+
+    /* Two pixels per 32-bit beat when every line starts and ends on a word. */
+    if (!(((uint32_t)pu16Src | (uint32_t)pu16Dst) & 0x3) && !((psRect->m_u32W | u32SrcStride | sTiming.m_u32HACT) & 1))
+    {
+        u32DataWidth = 32;
+        u32Count = psRect->m_u32W / 2;
+    }
+    else
+    {
+        u32DataWidth = 16;
+        u32Count = psRect->m_u32W;
+    }
+
+    for (y = 0; y < psRect->m_u32H; y++, next++)
+    {
+        /* Dirty lines in the rectangle must not be written back over the copy. */
+        SCB_CleanInvalidateDCache_by_Addr(&pu16Dst[y * sTiming.m_u32HACT], psRect->m_u32W * sizeof(uint16_t));
+
+        nu_pdma_m2m_desc_setup(next, u32DataWidth, (uint32_t)&pu16Src[y * u32SrcStride], (uint32_t)&pu16Dst[y * sTiming.m_u32HACT],
+                               u32Count, eMemCtl_SrcInc_DstInc, next + 1, 1);
+    }
+
+    s_pfnCopyDone = pfnDone;
+    s_pvCopyUserData = pvUserData;
+    s_i32FillBusy = 1;
+
+    if (psRect->m_u32H == 1)
+    {
+        /* A single line is done in basic mode, the channel does not fetch a lone descriptor. */
+        nu_pdma_channel_memctrl_set(s_i32FillChannel, eMemCtl_SrcInc_DstInc);
+
+        return nu_pdma_transfer(s_i32FillChannel, u32DataWidth, s_asDscFill[0].SA, s_asDscFill[0].DA, u32Count, 0);
+    }
+
+    /* Last descriptor stops the chain and raises the done event. */
+    (next - 1)->CTL = ((next - 1)->CTL & ~PDMA_DSCT_CTL_OPMODE_Msk & ~PDMA_DSCT_CTL_TBINTDIS_Msk) | PDMA_OP_BASIC;
+    (next - 1)->NEXT = 0;
+
+    return nu_pdma_sg_transfer(s_i32FillChannel, &s_asDscFill[0], 0);
+}
+
+// Function to switch the panel timing at a frame boundary without stopping the scanout
+int disp_set_timing(const S_DISP_TIMING *psTiming)
+{
+    /* Panel generates its own timing. */
+    (void)psTiming;
+
+    return -1;
+}
+
+// Function to get the panel timing being scanned out
+void disp_get_timing(S_DISP_TIMING *psTiming)
+{
+    if (psTiming)
+        *psTiming = s_sTimingDefault;
+}
+
+COMPONENT_EXPORT("DISP_I80_PDMA", disp_i80_pdma_init, disp_i80_pdma_fini);
+
+#endif /* defined(CONFIG_LCD_PANEL_USE_I80) */
@@ -0,0 +1,219 @@
+/**************************************************************************//**
+ * @file     disp_idle.c
+ * @brief    Idle manager sleeping the CPU between blanking intervals.
+ *
+ *           The main loop hands the CPU over once its work is done. Unless
+ *           work was posted meanwhile, the core sleeps until the next
+ *           interrupt, with the SysTick interrupt suppressed when the next
+ *           blank is far enough away for it to be the only wake-up needed.
+ *           A free-running timer, which keeps counting while the core
+ *           sleeps, times the frames and the sleep in each of them.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "disp_idle.h"
+#include "nu_os.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_IDLE_TIMER_MASK       DISP_IDLE_TIME_MASK   /* 24-bit counter, wraps after 16s at 1MHz */
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static volatile int s_i32Posted = 0;
+static int s_i32Open = 0;
+static int s_i32BlankSeen = 0;
+static volatile uint32_t s_u32LastBlank = 0;    // Timer value at the last blank
+static uint32_t s_u32SleepUs = 0;               // Asleep since the last blank
+static S_DISP_IDLE_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to get the microseconds elapsed since a timer value
+static uint32_t disp_idle_elapsed(uint32_t u32Start)
+{
+    return (TIMER_GetCounter(CONFIG_DISP_IDLE_TIMER) - u32Start) & DEF_IDLE_TIMER_MASK;
+}
+
+uint32_t disp_idle_time_us(void)
+{
+    return TIMER_GetCounter(CONFIG_DISP_IDLE_TIMER) & DEF_IDLE_TIMER_MASK;
+}
+
+void disp_idle_post(void)
+{
+    s_i32Posted = 1;
+}
+
+uint32_t disp_idle_next_blank_us(void)
+{
+    uint32_t u32Elapsed;
+
+    if (!s_i32Open || !s_sStats.m_u32FrameUs)
+        return 0;
+
+    u32Elapsed = disp_idle_elapsed(s_u32LastBlank);
+
+    return (u32Elapsed < s_sStats.m_u32FrameUs) ? (s_sStats.m_u32FrameUs - u32Elapsed) : 0;
+}
+
+E_DISP_IDLE_STATE disp_idle_enter(void)
+{
+    E_DISP_IDLE_STATE evState = evIdleSleep;
+    uint32_t u32PriMask = __get_PRIMASK();
+    uint32_t u32Start, u32Slept, u32TickVal = 0, u32Ticks;
+
+    /* WFI wakes on a pending interrupt even when masked, so a post or a blank landing after the
+       check below cannot be slept through. The handler runs once PRIMASK is restored. */
+    __disable_irq();
+
+    if (s_i32Posted)
+    {
+        s_i32Posted = 0;
+        __set_PRIMASK(u32PriMask);
+
+        return evIdleRun;
+    }
+
+    /* Without the timebase there is no frame accounting, but the main loop must still not spin. */
+    if (!s_i32Open)
+    {
+        __WFI();
+        __set_PRIMASK(u32PriMask);
+
+        return evIdleSleep;
+    }
+
+    /* The blank interrupt wakes the CPU in time by itself, a tick before it is wasted. Reading CTRL
+       clears COUNTFLAG, so it is set afterwards only by a period ending during the sleep. */
+    if ((CONFIG_NU_OS != NU_OS_FREERTOS) && (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) &&
+            (disp_idle_next_blank_us() >= CONFIG_DISP_IDLE_MIN_US))
+    {
+        SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+        u32TickVal = SysTick->VAL;
+        evState = evIdleSleepTickless;
+    }
+
+    u32Start = TIMER_GetCounter(CONFIG_DISP_IDLE_TIMER);
+
+    PMC_Idle();
+
+    u32Slept = disp_idle_elapsed(u32Start);
+
+    if (evState == evIdleSleepTickless)
+    {
+        /* Periods ended from the count already run at the start, plus the sleep. */
+        u32Ticks = (uint32_t)(((uint64_t)(SysTick->LOAD - u32TickVal) + (uint64_t)u32Slept * (SystemCoreClock / 1000000UL)) /
+                              (SysTick->LOAD + 1));
+        s_sStats.m_u32TicksSuppressed += u32Ticks;
+
+        /* The counter kept running, the last period that ended is delivered late and the others
+           are credited to the SysTick owner. */
+        if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+        {
+            SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+
+            if (u32Ticks > 1)
+                disp_idle_tick_advance(u32Ticks - 1);
+        }
+
+        SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+    }
+
+    /* Counted before the waking handler runs, so a blank closes the frame with this sleep in it. */
+    s_u32SleepUs += u32Slept;
+    s_sStats.m_u32Wakeups++;
+
+    __set_PRIMASK(u32PriMask);
+
+    return evState;
+}
+
+void disp_idle_blank(void)
+{
+    uint32_t u32Now, u32FrameUs, u32Residency;
+
+    if (!s_i32Open)
+        return;
+
+    u32Now = TIMER_GetCounter(CONFIG_DISP_IDLE_TIMER);
+
+    if (s_i32BlankSeen)
+    {
+        u32FrameUs = (u32Now - s_u32LastBlank) & DEF_IDLE_TIMER_MASK;
+        u32Residency = u32FrameUs ? (uint32_t)(((uint64_t)s_u32SleepUs * 1000) / u32FrameUs) : 0;
+
+        s_sStats.m_u32FrameUs = u32FrameUs;
+        s_sStats.m_u32LastSleepUs = s_u32SleepUs;
+        s_sStats.m_u32LastResidency = (u32Residency > 1000) ? 1000 : u32Residency;
+        s_sStats.m_u32AvgResidency = (s_sStats.m_u32AvgResidency * 7 + s_sStats.m_u32LastResidency) / 8;
+        s_sStats.m_u32Frames++;
+    }
+
+    s_u32LastBlank = u32Now;
+    s_u32SleepUs = 0;
+    s_i32BlankSeen = 1;
+}
+
+void disp_idle_get_stats(S_DISP_IDLE_STATS *psStats)
+{
+    *psStats = s_sStats;
+}
+
+__WEAK void disp_idle_tick_advance(uint32_t u32Ticks)
+{
+    (void)u32Ticks;
+}
+
+// Function to initialize the idle manager
+static int disp_idle_init(void)
+{
+    uint32_t u32RegLocked = SYS_IsRegLocked();
+    uint32_t u32Clk;
+
+    /* Unlock protected registers */
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    CLK_SetModuleClock(CONFIG_DISP_IDLE_TIMER_MODULE, CONFIG_DISP_IDLE_TIMER_CLKSEL, 0);
+    CLK_EnableModuleClock(CONFIG_DISP_IDLE_TIMER_MODULE);
+
+    /* Lock protected registers */
+    if (u32RegLocked)
+        SYS_LockReg();
+
+    /* Count microseconds up to the full 24-bit range, the compare match never resets it. */
+    u32Clk = TIMER_GetModuleClock(CONFIG_DISP_IDLE_TIMER);
+
+    if (u32Clk < 1000000UL)
+        return -1;
+
+    CONFIG_DISP_IDLE_TIMER->CTL = TIMER_CONTINUOUS_MODE | ((u32Clk / 1000000UL) - 1);
+    CONFIG_DISP_IDLE_TIMER->CMP = DEF_IDLE_TIMER_MASK;
+    TIMER_Start(CONFIG_DISP_IDLE_TIMER);
+
+    s_i32BlankSeen = 0;
+    s_u32SleepUs = 0;
+    s_i32Posted = 0;
+    s_i32Open = 1;
+
+    return 0;
+}
+
+// Function to deinitialize the idle manager
+static int disp_idle_fini(void)
+{
+    s_i32Open = 0;
+
+    TIMER_Close(CONFIG_DISP_IDLE_TIMER);
+    CLK_DisableModuleClock(CONFIG_DISP_IDLE_TIMER_MODULE);
+
+    return 0;
+}
+
+COMPONENT_EXPORT("DISP_IDLE", disp_idle_init, disp_idle_fini);
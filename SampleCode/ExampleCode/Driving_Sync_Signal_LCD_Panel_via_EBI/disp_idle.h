@@ -0,0 +1,68 @@
+/**************************************************************************//**
+ * @file     disp_idle.h
+ * @brief    Idle manager sleeping the CPU between blanking intervals.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_IDLE_H__
+#define __DISP_IDLE_H__
+
+#include "disp.h"
+
+#define CONFIG_DISP_IDLE_TIMER          TIMER3   /*!< Free-running microsecond timebase, keeps counting while the CPU sleeps */
+#define CONFIG_DISP_IDLE_TIMER_MODULE   TMR3_MODULE
+#define CONFIG_DISP_IDLE_TIMER_CLKSEL   CLK_TMRSEL_TMR3SEL_HIRC
+#define CONFIG_DISP_IDLE_MIN_US             50   /*!< Closer to the next blank the CPU sleeps with the tick left running */
+
+#define DISP_IDLE_TIME_MASK           0xFFFFFFUL   /*!< disp_idle_time_us wraps after 16s */
+
+typedef enum
+{
+    evIdleRun,               /*!< Work pending, the CPU did not sleep */
+    evIdleSleep,             /*!< Sleep with SysTick running, the next blank is too close to bother */
+    evIdleSleepTickless,     /*!< Sleep with the SysTick interrupt suppressed until the next wake-up */
+    evIdleCNT                /*!< Number of idle states */
+} E_DISP_IDLE_STATE;
+
+typedef struct
+{
+    uint32_t m_u32Frames;           /*!< Blanking intervals seen */
+    uint32_t m_u32FrameUs;          /*!< Last measured frame period */
+    uint32_t m_u32LastSleepUs;      /*!< Time asleep during the last frame */
+    uint32_t m_u32LastResidency;    /*!< Share of the last frame asleep, in 1/1000 */
+    uint32_t m_u32AvgResidency;     /*!< Running average of m_u32LastResidency, in 1/1000 */
+    uint32_t m_u32Wakeups;          /*!< Sleeps ended by an interrupt */
+    uint32_t m_u32TicksSuppressed;  /*!< SysTick periods slept through with its interrupt suppressed */
+} S_DISP_IDLE_STATS;
+
+// Function to mark work pending, the next disp_idle_enter returns at once; callable from interrupts
+void disp_idle_post(void);
+
+// Function to sleep until the next interrupt unless work is pending, returns the state entered
+// Call it at the end of each pass of the main loop. Sync panels are scanned from VRAM every line, so
+// the core only enters sleep, never a power-down mode that would stop the EBI and DMA clocks; the
+// blank interrupt then wakes it within a fixed number of cycles and frames keep their timing. If the
+// timebase failed to open, it still waits for an interrupt, without the accounting.
+E_DISP_IDLE_STATE disp_idle_enter(void);
+
+// Function to get the free-running microsecond count, differences are taken modulo DISP_IDLE_TIME_MASK
+// It runs from HIRC, so it keeps its rate across HCLK changes and while the CPU sleeps.
+uint32_t disp_idle_time_us(void);
+
+// Function to get the time until the next blanking interval in us, 0 if unknown or already due
+uint32_t disp_idle_next_blank_us(void);
+
+// Function to close the frame accounting, called from the blank callback
+void disp_idle_blank(void);
+
+// Function to get the idle statistics
+void disp_idle_get_stats(S_DISP_IDLE_STATS *psStats);
+
+// Function to credit the SysTick owner with u32Ticks periods slept through without their interrupt
+// Called by disp_idle_enter with interrupts masked, after the last period was pended to arrive late.
+// The default is weak and empty; override it where SysTick keeps time, e.g. a millisecond counter.
+// Under FreeRTOS the tick is never suppressed, the kernel owns SysTick and its tickless idle.
+void disp_idle_tick_advance(uint32_t u32Ticks);
+
+#endif /* __DISP_IDLE_H__ */
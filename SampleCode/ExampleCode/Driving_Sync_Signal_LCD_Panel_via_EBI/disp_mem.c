@@ -0,0 +1,249 @@
+/**************************************************************************//**
+ * @file     disp_mem.c
+ * @brief    Display memory manager with SRAM segment power gating.
+ *
+ *           System SRAM0~2 is power controlled in 64 KiB segments. A segment
+ *           is only gated when registered regions cover it completely, so
+ *           stack, heap and other data sharing a segment keep it powered.
+ *           A segment takes the most powered state among its regions.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "disp_mem.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_SRAM_SEG_BASE        SRAM_BASE
+#define DEF_SRAM_SEG_SIZE        0x10000UL   /*!< Power control granularity */
+#define DEF_SRAM_SEG_NUM         21          /*!< Bank0 8, Bank1 8, Bank2 5 segments */
+#define DEF_SRAM_SEG_PER_BANK    8
+
+#define DEF_DISP_MEM_REGION_NUM  8
+
+typedef struct
+{
+    uint32_t          m_u32Start;
+    uint32_t          m_u32End;
+    E_DISP_MEM_STATE  m_evState;
+    uint32_t          m_u32IdleFrames;
+    int               m_i32Auto;
+} S_DISP_MEM_REGION;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_DISP_MEM_REGION s_asRegion[DEF_DISP_MEM_REGION_NUM];
+static int s_i32RegionNum = 0;
+
+static uint8_t s_au8SegState[DEF_SRAM_SEG_NUM];    // State programmed into PMC, evDispMemActive at reset
+
+/* PMC power mode of each state, the bank number is added per segment. */
+static const uint32_t s_au32PmcMode[evDispMemCNT] =
+{
+    PMC_SRAM_NORMAL,
+    PMC_SRAM_RETENTION,
+    PMC_SRAM_POWER_SHUT_DOWN
+};
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to compute the state a segment is allowed to enter
+static E_DISP_MEM_STATE disp_mem_seg_state(int i32Seg)
+{
+    uint32_t u32SegStart = DEF_SRAM_SEG_BASE + i32Seg * DEF_SRAM_SEG_SIZE;
+    uint32_t u32SegEnd = u32SegStart + DEF_SRAM_SEG_SIZE;
+    uint32_t u32Covered = 0;
+    E_DISP_MEM_STATE evState = evDispMemOff;
+    int i;
+
+    for (i = 0; i < s_i32RegionNum; i++)
+    {
+        S_DISP_MEM_REGION *psRegion = &s_asRegion[i];
+        uint32_t u32Start = (psRegion->m_u32Start > u32SegStart) ? psRegion->m_u32Start : u32SegStart;
+        uint32_t u32End = (psRegion->m_u32End < u32SegEnd) ? psRegion->m_u32End : u32SegEnd;
+
+        if (u32Start >= u32End)
+            continue;
+
+        u32Covered += u32End - u32Start;
+
+        if (psRegion->m_evState < evState)
+            evState = psRegion->m_evState;
+    }
+
+    /* Something unregistered lives in this segment. */
+    return (u32Covered < DEF_SRAM_SEG_SIZE) ? evDispMemActive : evState;
+}
+
+// Function to program changed segment power states into PMC
+static void disp_mem_apply(void)
+{
+    uint32_t u32RegLocked;
+    uint32_t u32PriMask = __get_PRIMASK();
+    int i;
+
+    __disable_irq();
+
+    u32RegLocked = SYS_IsRegLocked();
+
+    /* Unlock protected registers */
+    if (u32RegLocked)
+        SYS_UnlockReg();
+
+    for (i = 0; i < DEF_SRAM_SEG_NUM; i++)
+    {
+        E_DISP_MEM_STATE evState = disp_mem_seg_state(i);
+
+        if (evState != (E_DISP_MEM_STATE)s_au8SegState[i])
+        {
+            uint32_t u32Bank = i / DEF_SRAM_SEG_PER_BANK;
+            uint32_t u32Sel = PMC_SYSRB0PC_SRAM0PMS_Msk << ((i % DEF_SRAM_SEG_PER_BANK) * 2);
+
+            /* Dirty lines evicted after the segment leaves active would be written to inaccessible SRAM. */
+            if (s_au8SegState[i] == evDispMemActive)
+                SCB_CleanInvalidateDCache_by_Addr((void *)(DEF_SRAM_SEG_BASE + i * DEF_SRAM_SEG_SIZE), DEF_SRAM_SEG_SIZE);
+
+            /* PMC_SetSRAMPowerMode waits for PCBUSY, a woken segment is usable on return. */
+            if (PMC_SetSRAMPowerMode(u32Sel, (u32Bank << 28) | s_au32PmcMode[evState]) == PMC_OK)
+                s_au8SegState[i] = (uint8_t)evState;
+        }
+    }
+
+    /* Lock protected registers */
+    if (u32RegLocked)
+        SYS_LockReg();
+
+    __set_PRIMASK(u32PriMask);
+}
+
+// Function to find the region holding an address
+static S_DISP_MEM_REGION *disp_mem_find(uint32_t u32Addr)
+{
+    int i;
+
+    for (i = 0; i < s_i32RegionNum; i++)
+    {
+        if ((u32Addr >= s_asRegion[i].m_u32Start) && (u32Addr < s_asRegion[i].m_u32End))
+            return &s_asRegion[i];
+    }
+
+    return NULL;
+}
+
+// Function to register a memory region, returns region id or -1
+int disp_mem_register(void *pvAddr, uint32_t u32Size, int i32Auto)
+{
+    S_DISP_MEM_REGION *psRegion;
+    uint32_t u32Addr = (uint32_t)pvAddr;
+
+    if ((s_i32RegionNum >= DEF_DISP_MEM_REGION_NUM) || !u32Size)
+        return -1;
+    else if (disp_mem_find(u32Addr) || disp_mem_find(u32Addr + u32Size - 1))
+        return -1;
+
+    psRegion = &s_asRegion[s_i32RegionNum];
+    psRegion->m_u32Start = u32Addr;
+    psRegion->m_u32End = u32Addr + u32Size;
+    psRegion->m_evState = evDispMemActive;
+    psRegion->m_u32IdleFrames = 0;
+    psRegion->m_i32Auto = i32Auto;
+
+    return s_i32RegionNum++;
+}
+
+// Function to set the power state of a registered region
+int disp_mem_set_state(int i32Id, E_DISP_MEM_STATE evState)
+{
+    if ((i32Id < 0) || (i32Id >= s_i32RegionNum) || (evState >= evDispMemCNT))
+        return -1;
+
+    s_asRegion[i32Id].m_evState = evState;
+    s_asRegion[i32Id].m_u32IdleFrames = 0;
+
+    disp_mem_apply();
+
+    return 0;
+}
+
+// Function to power up the region holding pvAddr before it is accessed
+void disp_mem_acquire(const void *pvAddr)
+{
+    S_DISP_MEM_REGION *psRegion = disp_mem_find((uint32_t)pvAddr);
+
+    if (!psRegion)
+        return;
+
+    psRegion->m_u32IdleFrames = 0;
+
+    if (psRegion->m_evState != evDispMemActive)
+    {
+        psRegion->m_evState = evDispMemActive;
+        disp_mem_apply();
+    }
+}
+
+// Function to age auto-managed regions, called at blanking with the scanned buffer address
+void disp_mem_tick(const void *pvScanAddr)
+{
+    int i, i32Changed = 0;
+
+    for (i = 0; i < s_i32RegionNum; i++)
+    {
+        S_DISP_MEM_REGION *psRegion = &s_asRegion[i];
+
+        if (!psRegion->m_i32Auto || (psRegion->m_evState != evDispMemActive))
+            continue;
+
+        if (((uint32_t)pvScanAddr >= psRegion->m_u32Start) && ((uint32_t)pvScanAddr < psRegion->m_u32End))
+        {
+            psRegion->m_u32IdleFrames = 0;
+        }
+        else if (++psRegion->m_u32IdleFrames >= CONFIG_DISP_MEM_IDLE_FRAMES)
+        {
+            psRegion->m_evState = evDispMemRetain;
+            i32Changed = 1;
+        }
+    }
+
+    if (i32Changed)
+        disp_mem_apply();
+}
+
+// Function to initialize the display memory manager
+static int disp_mem_init(void)
+{
+    int i;
+
+    s_i32RegionNum = 0;
+
+    for (i = 0; i < DEF_SRAM_SEG_NUM; i++)
+        s_au8SegState[i] = evDispMemActive;
+
+    /* Every VRAM buffer is an auto-managed region. */
+    for (i = 0; i < CONFIG_VRAM_BUF_NUM; i++)
+        disp_mem_register(&g_au8FrameBuf[i * CONFIG_VRAM_BUF_SIZE], CONFIG_VRAM_BUF_SIZE, 1);
+
+    return 0;
+}
+
+// Function to deinitialize the display memory manager
+static int disp_mem_fini(void)
+{
+    int i;
+
+    /* Leave all segments powered. */
+    for (i = 0; i < s_i32RegionNum; i++)
+        s_asRegion[i].m_evState = evDispMemActive;
+
+    disp_mem_apply();
+
+    s_i32RegionNum = 0;
+
+    return 0;
+}
+
+COMPONENT_EXPORT("DISP_MEM", disp_mem_init, disp_mem_fini);
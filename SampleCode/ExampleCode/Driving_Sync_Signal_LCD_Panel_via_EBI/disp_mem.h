@@ -0,0 +1,34 @@
+/**************************************************************************//**
+ * @file     disp_mem.h
+ * @brief    Display memory manager with SRAM segment power gating.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_MEM_H__
+#define __DISP_MEM_H__
+
+#include "disp.h"
+
+typedef enum
+{
+    evDispMemActive,         /*!< Powered, accessible by CPU and DMA */
+    evDispMemRetain,         /*!< Retention, content kept but not accessible */
+    evDispMemOff,            /*!< Powered down, content lost */
+    evDispMemCNT             /*!< Number of states */
+} E_DISP_MEM_STATE;
+
+// Function to register a memory region, returns region id or -1
+// Auto-managed regions drop to retention after CONFIG_DISP_MEM_IDLE_FRAMES frames without use.
+int disp_mem_register(void *pvAddr, uint32_t u32Size, int i32Auto);
+
+// Function to set the power state of a registered region
+int disp_mem_set_state(int i32Id, E_DISP_MEM_STATE evState);
+
+// Function to power up the region holding pvAddr before it is accessed
+void disp_mem_acquire(const void *pvAddr);
+
+// Function to age auto-managed regions, called at blanking with the scanned buffer address
+void disp_mem_tick(const void *pvScanAddr);
+
+#endif /* __DISP_MEM_H__ */
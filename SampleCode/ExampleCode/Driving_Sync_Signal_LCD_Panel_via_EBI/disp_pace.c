@@ -0,0 +1,343 @@
+/**************************************************************************//**
+ * @file     disp_pace.c
+ * @brief    Video cadence and frame pacing on the measured panel refresh.
+ *
+ *           The refresh period follows from the EBI clock and the porches,
+ *           rarely a round rate, so it is measured: each blank, the DMA done
+ *           of a frame, is stamped by the idle manager's microsecond timer.
+ *           A content clock advances by that period every blank and picks
+ *           the frame due, the error carried over in an accumulator, which
+ *           gives the 3:2 and similar cadences with no drift. Optionally the
+ *           porches are shortened so the refresh becomes a whole or half
+ *           multiple of the content rate and the cadence is exact.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "disp_pace.h"
+#include "disp_idle.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+/* The address is latched at the next blank, and the frame then starting may still read the old buffer. */
+#define DEF_PACE_RELEASE_BLANKS   2
+
+#define DEF_PACE_NS_PER_SEC       1000000000ULL
+
+typedef struct
+{
+    void    *m_pvFrame;
+    uint32_t m_u32Index;
+} S_PACE_JOB;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_PACE_JOB s_asJob[CONFIG_DISP_PACE_QUEUE_NUM];
+static volatile uint32_t s_u32Head = 0;     // Next frame to consider, advanced in the blank
+static volatile uint32_t s_u32Tail = 0;     // Next free slot, advanced by disp_pace_queue
+
+static volatile int s_i32Open = 0;
+static DISP_PACE_RELEASE s_pfnRelease = NULL;
+static void *s_pvUserData = NULL;
+static uint32_t s_u32FpsNum, s_u32FpsDen;
+
+static S_PACE_JOB s_sShown;                 // Frame set for scanout, NULL m_pvFrame before the first
+static void *s_apvRetire[DEF_PACE_RELEASE_BLANKS];   // Frames replaced, by blanks since
+
+static int s_i32Started = 0;
+static uint32_t s_u32Want;                  // Content index due on the coming refresh
+static uint64_t s_u64Acc;                   // Content clock remainder, in ns times s_u32FpsNum
+
+static int s_i32Stamped = 0;
+static int s_i32Measured = 0;               // A whole window was averaged
+static uint32_t s_u32LastUs, s_u32WinUs, s_u32WinFrames;
+
+static S_DISP_TIMING s_sBaseTiming;         // Timing before locking
+static uint32_t s_u32BaseNs;                // Refresh period before locking
+
+static S_DISP_PACE_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to hand a frame back to the decoder
+static void disp_pace_release(void *pvFrame)
+{
+    if (pvFrame && s_pfnRelease)
+    {
+        s_pfnRelease(pvFrame, s_pvUserData);
+
+        /* The decoder in the main loop has a frame to decode into again. */
+        disp_idle_post();
+    }
+}
+
+// Function to measure the refresh period from blank timestamps
+static void disp_pace_measure(uint32_t u32Now)
+{
+    uint32_t u32Delta, u32Period;
+
+    if (!s_i32Stamped)
+    {
+        s_u32LastUs = s_u32WinUs = u32Now;
+        s_u32WinFrames = 0;
+        s_i32Stamped = 1;
+        return;
+    }
+
+    u32Delta = (u32Now - s_u32LastUs) & DISP_IDLE_TIME_MASK;
+    s_u32LastUs = u32Now;
+
+    /* Single frames give a rough period until the first window is averaged. */
+    if (!s_i32Measured)
+        s_sStats.m_u32PeriodNs = u32Delta * 1000;
+
+    if (++s_u32WinFrames < CONFIG_DISP_PACE_MEASURE_FRAMES)
+        return;
+
+    u32Period = (uint32_t)((((uint64_t)((u32Now - s_u32WinUs) & DISP_IDLE_TIME_MASK)) * 1000) / s_u32WinFrames);
+
+    /* Windows are long enough that interrupt latency barely shows, average lightly on top. */
+    s_sStats.m_u32PeriodNs = s_i32Measured ? ((s_sStats.m_u32PeriodNs * 3 + u32Period) / 4) : u32Period;
+    s_i32Measured = 1;
+    s_u32WinUs = u32Now;
+    s_u32WinFrames = 0;
+}
+
+// Function to restart the refresh measurement, keeping u32PeriodNs as the estimate
+static void disp_pace_remeasure(uint32_t u32PeriodNs)
+{
+    s_sStats.m_u32PeriodNs = u32PeriodNs;
+    s_i32Measured = u32PeriodNs ? 1 : 0;
+    s_i32Stamped = 0;
+}
+
+// Function to take the frames due off the queue and put the newest on screen
+static void disp_pace_pick(void)
+{
+    S_PACE_JOB sPick = { NULL, 0 };
+    int i32Picked = 0;
+
+    /* Decoding fell well behind, continue from the next decoded frame rather than skip to catch up. */
+    if ((s_u32Head != s_u32Tail) &&
+            ((int32_t)(s_u32Want - s_asJob[s_u32Head & (CONFIG_DISP_PACE_QUEUE_NUM - 1)].m_u32Index) > CONFIG_DISP_PACE_RESYNC_FRAMES))
+    {
+        s_u32Want = s_asJob[s_u32Head & (CONFIG_DISP_PACE_QUEUE_NUM - 1)].m_u32Index;
+        s_u64Acc = ((uint64_t)s_u32FpsDen * DEF_PACE_NS_PER_SEC) / 2;
+        s_sStats.m_u32Resyncs++;
+    }
+
+    while (s_u32Head != s_u32Tail)
+    {
+        const S_PACE_JOB *psJob = &s_asJob[s_u32Head & (CONFIG_DISP_PACE_QUEUE_NUM - 1)];
+
+        if ((int32_t)(psJob->m_u32Index - s_u32Want) > 0)
+            break;
+
+        /* A newer frame is due as well, this one never reaches the screen. */
+        if (i32Picked)
+        {
+            disp_pace_release(sPick.m_pvFrame);
+            s_sStats.m_u32Dropped++;
+        }
+
+        sPick = *psJob;
+        i32Picked = 1;
+        s_u32Head++;
+    }
+
+    if (!i32Picked)
+    {
+        if (s_sShown.m_pvFrame && ((int32_t)(s_u32Want - s_sShown.m_u32Index) > 0))
+            s_sStats.m_u32Repeated++;
+
+        return;
+    }
+
+    disp_set_vrambufaddr(sPick.m_pvFrame);
+
+    s_apvRetire[0] = s_sShown.m_pvFrame;
+    s_sShown = sPick;
+    s_sStats.m_u32Shown++;
+}
+
+int disp_pace_open(uint32_t u32FpsNum, uint32_t u32FpsDen, DISP_PACE_RELEASE pfnRelease, void *pvUserData)
+{
+    if (s_i32Open || !u32FpsNum || !u32FpsDen)
+        return -1;
+
+    s_u32FpsNum = u32FpsNum;
+    s_u32FpsDen = u32FpsDen;
+    s_pfnRelease = pfnRelease;
+    s_pvUserData = pvUserData;
+
+    memset(&s_sStats, 0, sizeof(s_sStats));
+    memset(s_apvRetire, 0, sizeof(s_apvRetire));
+    memset(&s_sShown, 0, sizeof(s_sShown));
+
+    s_sStats.m_u32ContentNs = (uint32_t)(((uint64_t)u32FpsDen * DEF_PACE_NS_PER_SEC) / u32FpsNum);
+    s_u32Head = s_u32Tail = 0;
+    s_i32Started = 0;
+    disp_pace_remeasure(0);
+
+    s_i32Open = 1;
+
+    return 0;
+}
+
+int disp_pace_queue(void *pvFrame, uint32_t u32Index)
+{
+    S_PACE_JOB *psJob;
+
+    if (!s_i32Open || !pvFrame || ((s_u32Tail - s_u32Head) >= CONFIG_DISP_PACE_QUEUE_NUM))
+        return -1;
+
+    psJob = &s_asJob[s_u32Tail & (CONFIG_DISP_PACE_QUEUE_NUM - 1)];
+    psJob->m_pvFrame = pvFrame;
+    psJob->m_u32Index = u32Index;
+
+    /* The slot is complete before the blank can see it. */
+    __DMB();
+    s_u32Tail++;
+
+    return 0;
+}
+
+int disp_pace_lock(int i32Enable)
+{
+    S_DISP_TIMING sLocked;
+    uint32_t u32PriMask, u32Halves, u32LockedNs;
+    uint64_t u64TwoFramesNs;
+    int i32Ret = 0;
+
+    if (!s_i32Open)
+        return -1;
+
+    u32PriMask = __get_PRIMASK();
+    __disable_irq();
+
+    if (!i32Enable)
+    {
+        if (s_sStats.m_u32Locked && (disp_set_timing(&s_sBaseTiming) == 0))
+        {
+            disp_pace_remeasure(s_u32BaseNs);
+            s_sStats.m_u32Locked = 0;
+        }
+    }
+    else if (!s_i32Measured)
+    {
+        i32Ret = -1;
+    }
+    else
+    {
+        if (!s_sStats.m_u32Locked)
+        {
+            disp_get_timing(&s_sBaseTiming);
+            s_u32BaseNs = s_sStats.m_u32PeriodNs;
+        }
+
+        /* Refreshes per two content frames, rounded up as porches can only shrink a frame. */
+        u64TwoFramesNs = ((uint64_t)s_u32FpsDen * DEF_PACE_NS_PER_SEC * 2) / s_u32FpsNum;
+        u32Halves = (uint32_t)((u64TwoFramesNs + s_u32BaseNs - 1) / s_u32BaseNs);
+        u32LockedNs = (uint32_t)(u64TwoFramesNs / u32Halves);
+
+        if ((disp_timing_scale(&s_sBaseTiming, u32LockedNs, s_u32BaseNs, CONFIG_DISP_PACE_LOCK_TOL, &sLocked) < 0) ||
+                (disp_set_timing(&sLocked) < 0))
+        {
+            i32Ret = -1;
+        }
+        else
+        {
+            disp_pace_remeasure(u32LockedNs);
+            s_sStats.m_u32Locked = u32Halves;
+        }
+    }
+
+    __set_PRIMASK(u32PriMask);
+
+    return i32Ret;
+}
+
+void disp_pace_blank(void)
+{
+    uint64_t u64Unit;
+
+    if (!s_i32Open)
+        return;
+
+    disp_pace_measure(disp_idle_time_us());
+    s_sStats.m_u32Blanks++;
+
+    /* Frames replaced DEF_PACE_RELEASE_BLANKS blanks ago are no longer scanned. */
+    disp_pace_release(s_apvRetire[DEF_PACE_RELEASE_BLANKS - 1]);
+    memmove(&s_apvRetire[1], &s_apvRetire[0], (DEF_PACE_RELEASE_BLANKS - 1) * sizeof(void *));
+    s_apvRetire[0] = NULL;
+
+    if (!s_sStats.m_u32PeriodNs)
+        return;
+
+    u64Unit = (uint64_t)s_u32FpsDen * DEF_PACE_NS_PER_SEC;
+
+    if (!s_i32Started)
+    {
+        if (s_u32Head == s_u32Tail)
+            return;
+
+        /* The content clock starts with the first frame, half a frame in so the error is centred. */
+        s_u32Want = s_asJob[s_u32Head & (CONFIG_DISP_PACE_QUEUE_NUM - 1)].m_u32Index;
+        s_u64Acc = u64Unit / 2;
+        s_i32Started = 1;
+    }
+    else
+    {
+        s_u64Acc += (uint64_t)s_sStats.m_u32PeriodNs * s_u32FpsNum;
+
+        while (s_u64Acc >= u64Unit)
+        {
+            s_u64Acc -= u64Unit;
+            s_u32Want++;
+        }
+    }
+
+    disp_pace_pick();
+}
+
+void disp_pace_close(void)
+{
+    uint32_t u32PriMask;
+    uint32_t i;
+
+    if (!s_i32Open)
+        return;
+
+    disp_pace_lock(0);
+
+    u32PriMask = __get_PRIMASK();
+    __disable_irq();
+
+    s_i32Open = 0;
+
+    for (i = 0; i < DEF_PACE_RELEASE_BLANKS; i++)
+    {
+        disp_pace_release(s_apvRetire[i]);
+        s_apvRetire[i] = NULL;
+    }
+
+    while (s_u32Head != s_u32Tail)
+    {
+        disp_pace_release(s_asJob[s_u32Head & (CONFIG_DISP_PACE_QUEUE_NUM - 1)].m_pvFrame);
+        s_u32Head++;
+    }
+
+    __set_PRIMASK(u32PriMask);
+}
+
+void disp_pace_get_stats(S_DISP_PACE_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
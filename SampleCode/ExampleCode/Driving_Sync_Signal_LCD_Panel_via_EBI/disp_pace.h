@@ -0,0 +1,57 @@
+/**************************************************************************//**
+ * @file     disp_pace.h
+ * @brief    Video cadence and frame pacing on the measured panel refresh.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_PACE_H__
+#define __DISP_PACE_H__
+
+#include "disp.h"
+
+#define CONFIG_DISP_PACE_QUEUE_NUM           4   /*!< Decoded frames waiting for their blank, power of 2 */
+#define CONFIG_DISP_PACE_MEASURE_FRAMES     64   /*!< Blanks averaged for one refresh period measurement */
+#define CONFIG_DISP_PACE_RESYNC_FRAMES       3   /*!< Content frames late before the content clock is restarted */
+#define CONFIG_DISP_PACE_LOCK_TOL            2   /*!< Refresh error accepted from rounded porches when locking, in 1/1000 */
+
+/* Called from the blank callback once a frame is off screen, or skipped, and may be decoded into again. */
+typedef void (*DISP_PACE_RELEASE)(void *pvFrame, void *pvUserData);
+
+typedef struct
+{
+    uint32_t m_u32PeriodNs;         /*!< Measured refresh period, 0 until measured */
+    uint32_t m_u32ContentNs;        /*!< Content frame period */
+    uint32_t m_u32Locked;           /*!< Refreshes per two content frames while locked, 0 if not */
+    uint32_t m_u32Blanks;           /*!< Blanks paced */
+    uint32_t m_u32Shown;            /*!< Frames put on screen */
+    uint32_t m_u32Dropped;          /*!< Frames skipped, a later one was due before they were shown */
+    uint32_t m_u32Repeated;         /*!< Blanks repeating a frame because the next was not decoded in time */
+    uint32_t m_u32Resyncs;          /*!< Content clock restarts after decoding fell behind */
+} S_DISP_PACE_STATS;
+
+// Function to start pacing content at u32FpsNum/u32FpsDen frames per second, e.g. 24000/1001, returns 0 or -1
+// pfnRelease hands every queued frame back, from the blank callback.
+int disp_pace_open(uint32_t u32FpsNum, uint32_t u32FpsDen, DISP_PACE_RELEASE pfnRelease, void *pvUserData);
+
+// Function to queue a decoded frame of content index u32Index, returns 0 or -1 on a full queue
+// pvFrame is a full VRAM buffer, cleaned to memory. Indexes increase, gaps are frames the decoder skipped.
+int disp_pace_queue(void *pvFrame, uint32_t u32Index);
+
+// Function to lock the refresh to a whole or half multiple of the content rate by shortening the porches
+// Returns 0, or -1 before the refresh is measured or when the porches cannot reach it. Locking and
+// DVFS levels with re-derived porches both own the timing, use only one of them.
+int disp_pace_lock(int i32Enable);
+
+// Function to pick the frame for the coming refresh, called from the blank callback
+// A frame set here is scanned from the following blank, so content runs one refresh behind the clock.
+void disp_pace_blank(void);
+
+// Function to stop pacing and hand back every frame but the one on screen, which stays
+// Frames replaced in the last two refreshes may still be read until the next blank.
+void disp_pace_close(void);
+
+// Function to get the pacing statistics
+void disp_pace_get_stats(S_DISP_PACE_STATS *psStats);
+
+#endif /* __DISP_PACE_H__ */
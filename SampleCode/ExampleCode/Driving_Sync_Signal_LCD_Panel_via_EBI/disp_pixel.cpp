@@ -0,0 +1,255 @@
+/**************************************************************************//**
+ * @file     disp_pixel.cpp
+ * @brief    Dispatch table bringing the disp_pixel.hpp pipelines to C.
+ *
+ *           Every format, blend and clip combination is instantiated once
+ *           and looked up by the runtime enums of S_DISP_PIXEL_BLIT. The
+ *           generic path decides everything per pixel from the same format
+ *           helpers, as the reference and baseline of disp_pixel_bench.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "NuMicro.h"
+#include "disp_pixel.hpp"
+
+using namespace disp_pixel;
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+typedef int (*DISP_PIXEL_FN)(const S_DISP_PIXEL_BLIT *psBlit);
+
+#define DEF_BLIT_CLIP(S, D, B)    { &blit<S, D, B, evClipNone>, &blit<S, D, B, evClipRect> }
+#define DEF_BLIT_BLEND(S, D)      { DEF_BLIT_CLIP(S, D, Copy), DEF_BLIT_CLIP(S, D, ConstAlpha), \
+                                    DEF_BLIT_CLIP(S, D, SrcAlpha), DEF_BLIT_CLIP(S, D, ColorKey) }
+#define DEF_BLIT_DST(S)           { DEF_BLIT_BLEND(S, Rgb565), DEF_BLIT_BLEND(S, Argb8888), DEF_BLIT_BLEND(S, L8) }
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+/* Indexed by source format, destination format, blend and clip mode, in the order of the enums. */
+static const DISP_PIXEL_FN s_apfnBlit[evPixelCNT][evPixelCNT][evBlendCNT][evClipCNT] =
+{
+    DEF_BLIT_DST(Rgb565),
+    DEF_BLIT_DST(Argb8888),
+    DEF_BLIT_DST(L8)
+};
+
+static const uint32_t s_au32Bytes[evPixelCNT] = { sizeof(uint16_t), sizeof(uint32_t), sizeof(uint8_t) };
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to check the enums and weights of a blit
+static int disp_pixel_check(const S_DISP_PIXEL_BLIT *psBlit)
+{
+    if (!psBlit || !psBlit->m_pvSrc || !psBlit->m_pvDst ||
+            ((uint32_t)psBlit->m_evSrcFmt >= evPixelCNT) || ((uint32_t)psBlit->m_evDstFmt >= evPixelCNT) ||
+            ((uint32_t)psBlit->m_evBlend >= evBlendCNT) || ((uint32_t)psBlit->m_evClip >= evClipCNT))
+        return -1;
+
+    if ((psBlit->m_evBlend == evBlendConstAlpha) && (psBlit->m_u32Alpha > DISP_PIXEL_ALPHA_MAX))
+        return -1;
+
+    return 0;
+}
+
+// Function to read a pixel of any format
+static uint32_t disp_pixel_load(const void *pv, uint32_t u32Idx, E_DISP_PIXEL_FMT evFmt)
+{
+    switch (evFmt)
+    {
+        case evPixelRGB565:
+            return ((const uint16_t *)pv)[u32Idx];
+
+        case evPixelARGB8888:
+            return ((const uint32_t *)pv)[u32Idx];
+
+        case evPixelL8:
+        default:
+            return ((const uint8_t *)pv)[u32Idx];
+    }
+}
+
+// Function to write a pixel of any format
+static void disp_pixel_store(void *pv, uint32_t u32Idx, E_DISP_PIXEL_FMT evFmt, uint32_t u32Pixel)
+{
+    switch (evFmt)
+    {
+        case evPixelRGB565:
+            ((uint16_t *)pv)[u32Idx] = (uint16_t)u32Pixel;
+            break;
+
+        case evPixelARGB8888:
+            ((uint32_t *)pv)[u32Idx] = u32Pixel;
+            break;
+
+        case evPixelL8:
+        default:
+            ((uint8_t *)pv)[u32Idx] = (uint8_t)u32Pixel;
+            break;
+    }
+}
+
+// Function to convert a pixel between any two formats
+static uint32_t disp_pixel_convert(uint32_t u32Pixel, E_DISP_PIXEL_FMT evSrc, E_DISP_PIXEL_FMT evDst)
+{
+    uint32_t c;
+
+    switch (evSrc)
+    {
+        case evPixelRGB565:
+            c = Rgb565::to_argb((uint16_t)u32Pixel);
+            break;
+
+        case evPixelARGB8888:
+            c = Argb8888::to_argb(u32Pixel);
+            break;
+
+        case evPixelL8:
+        default:
+            c = L8::to_argb((uint8_t)u32Pixel);
+            break;
+    }
+
+    switch (evDst)
+    {
+        case evPixelRGB565:
+            return Rgb565::from_argb(c);
+
+        case evPixelARGB8888:
+            return Argb8888::from_argb(c);
+
+        case evPixelL8:
+        default:
+            return L8::from_argb(c);
+    }
+}
+
+// Function to mix two pixels of any format, u32Alpha is the weight of u32S in 0~32
+static uint32_t disp_pixel_mix(uint32_t u32D, uint32_t u32S, uint32_t u32Alpha, E_DISP_PIXEL_FMT evFmt)
+{
+    switch (evFmt)
+    {
+        case evPixelRGB565:
+            return Rgb565::mix((uint16_t)u32D, (uint16_t)u32S, u32Alpha);
+
+        case evPixelARGB8888:
+            return Argb8888::mix(u32D, u32S, u32Alpha);
+
+        case evPixelL8:
+        default:
+            return L8::mix((uint8_t)u32D, (uint8_t)u32S, u32Alpha);
+    }
+}
+
+extern "C" int disp_pixel_blit(const S_DISP_PIXEL_BLIT *psBlit)
+{
+    if (disp_pixel_check(psBlit) != 0)
+        return -1;
+
+    return s_apfnBlit[psBlit->m_evSrcFmt][psBlit->m_evDstFmt][psBlit->m_evBlend][psBlit->m_evClip](psBlit);
+}
+
+extern "C" int disp_pixel_blit_generic(const S_DISP_PIXEL_BLIT *psBlit)
+{
+    uint32_t u32Mask, u32Src, u32Dst, u32Alpha, i, j;
+    int32_t x, y;
+
+    if (disp_pixel_check(psBlit) != 0)
+        return -1;
+
+    u32Mask = (psBlit->m_evSrcFmt == evPixelARGB8888) ? 0xFFFFFFFFu : ((1u << (s_au32Bytes[psBlit->m_evSrcFmt] * 8)) - 1);
+
+    for (j = 0; j < psBlit->m_u32H; j++)
+    {
+        y = psBlit->m_i32Y + (int32_t)j;
+
+        for (i = 0; i < psBlit->m_u32W; i++)
+        {
+            x = psBlit->m_i32X + (int32_t)i;
+
+            if ((psBlit->m_evClip == evClipRect) &&
+                    ((x < 0) || (y < 0) || (x >= (int32_t)psBlit->m_u32DstW) || (y >= (int32_t)psBlit->m_u32DstH)))
+                continue;
+
+            u32Src = disp_pixel_load(psBlit->m_pvSrc, j * psBlit->m_u32SrcStride + i, psBlit->m_evSrcFmt);
+            u32Dst = (uint32_t)y * psBlit->m_u32DstStride + (uint32_t)x;
+
+            switch (psBlit->m_evBlend)
+            {
+                case evBlendConstAlpha:
+                    u32Alpha = psBlit->m_u32Alpha;
+                    break;
+
+                case evBlendSrcAlpha:
+                    u32Alpha = (psBlit->m_evSrcFmt == evPixelARGB8888) ? Argb8888::alpha(u32Src) : DISP_PIXEL_ALPHA_MAX;
+                    break;
+
+                case evBlendColorKey:
+                    u32Alpha = (u32Src == (psBlit->m_u32Key & u32Mask)) ? 0 : DISP_PIXEL_ALPHA_MAX;
+                    break;
+
+                case evBlendCopy:
+                default:
+                    u32Alpha = DISP_PIXEL_ALPHA_MAX;
+                    break;
+            }
+
+            if (u32Alpha == 0)
+                continue;
+
+            u32Src = disp_pixel_convert(u32Src, psBlit->m_evSrcFmt, psBlit->m_evDstFmt);
+
+            if (u32Alpha < DISP_PIXEL_ALPHA_MAX)
+                u32Src = disp_pixel_mix(disp_pixel_load(psBlit->m_pvDst, u32Dst, psBlit->m_evDstFmt), u32Src, u32Alpha, psBlit->m_evDstFmt);
+
+            disp_pixel_store(psBlit->m_pvDst, u32Dst, psBlit->m_evDstFmt, u32Src);
+        }
+    }
+
+    return 0;
+}
+
+extern "C" int disp_pixel_bench(const S_DISP_PIXEL_BLIT *psBlit, void *pvScratch, S_DISP_PIXEL_BENCH *psBench)
+{
+    S_DISP_PIXEL_BLIT sGeneric;
+    uint32_t u32Bytes, u32Start, j;
+    int i32Ret;
+
+    if ((disp_pixel_check(psBlit) != 0) || !pvScratch || !psBench)
+        return -1;
+
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    sGeneric = *psBlit;
+    sGeneric.m_pvDst = pvScratch;
+
+    u32Start = DWT->CYCCNT;
+    i32Ret = disp_pixel_blit(psBlit);
+    psBench->m_u32SpecCycles = DWT->CYCCNT - u32Start;
+
+    u32Start = DWT->CYCCNT;
+    i32Ret |= disp_pixel_blit_generic(&sGeneric);
+    psBench->m_u32GenericCycles = DWT->CYCCNT - u32Start;
+
+    if (i32Ret != 0)
+        return -1;
+
+    u32Bytes = s_au32Bytes[psBlit->m_evDstFmt];
+    psBench->m_u32Mismatches = 0;
+
+    for (j = 0; j < psBlit->m_u32DstH * psBlit->m_u32DstW; j++)
+    {
+        uint32_t u32Idx = (j / psBlit->m_u32DstW) * psBlit->m_u32DstStride + (j % psBlit->m_u32DstW);
+
+        if (memcmp((const uint8_t *)psBlit->m_pvDst + u32Idx * u32Bytes, (const uint8_t *)pvScratch + u32Idx * u32Bytes, u32Bytes) != 0)
+            psBench->m_u32Mismatches++;
+    }
+
+    return 0;
+}
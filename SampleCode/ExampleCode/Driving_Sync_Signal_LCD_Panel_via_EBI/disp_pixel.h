@@ -0,0 +1,86 @@
+/**************************************************************************//**
+ * @file     disp_pixel.h
+ * @brief    C interface of the specialized pixel pipelines in disp_pixel.hpp.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_PIXEL_H__
+#define __DISP_PIXEL_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DISP_PIXEL_ALPHA_MAX                32   /*!< Constant alpha of an opaque source, see disp_transition_blend */
+
+typedef enum
+{
+    evPixelRGB565,           /*!< 16-bit RGB565 */
+    evPixelARGB8888,         /*!< 32-bit ARGB8888, alpha in the top byte */
+    evPixelL8,               /*!< 8-bit luminance */
+    evPixelCNT               /*!< Number of formats */
+} E_DISP_PIXEL_FMT;
+
+typedef enum
+{
+    evBlendCopy,             /*!< Source replaces the destination */
+    evBlendConstAlpha,       /*!< Source weighted by m_u32Alpha over the destination */
+    evBlendSrcAlpha,         /*!< Source weighted by its own alpha, opaque for formats without one */
+    evBlendColorKey,         /*!< Source pixels equal to m_u32Key are skipped */
+    evBlendCNT               /*!< Number of blend modes */
+} E_DISP_PIXEL_BLEND;
+
+typedef enum
+{
+    evClipNone,              /*!< Caller keeps the source inside the destination, nothing is checked */
+    evClipRect,              /*!< Source is cut to the destination bounds */
+    evClipCNT                /*!< Number of clip modes */
+} E_DISP_PIXEL_CLIP;
+
+typedef struct
+{
+    const void *m_pvSrc;            /*!< Source pixels */
+    uint32_t m_u32SrcStride;        /*!< Source pixels per line */
+    E_DISP_PIXEL_FMT m_evSrcFmt;    /*!< Source format */
+    void *m_pvDst;                  /*!< Destination pixels */
+    uint32_t m_u32DstStride;        /*!< Destination pixels per line */
+    E_DISP_PIXEL_FMT m_evDstFmt;    /*!< Destination format */
+    uint32_t m_u32DstW;             /*!< Destination width, bounds of evClipRect */
+    uint32_t m_u32DstH;             /*!< Destination height, bounds of evClipRect */
+    int32_t m_i32X;                 /*!< Destination column of the source top left pixel */
+    int32_t m_i32Y;                 /*!< Destination line of the source top left pixel */
+    uint32_t m_u32W;                /*!< Source width */
+    uint32_t m_u32H;                /*!< Source height */
+    E_DISP_PIXEL_BLEND m_evBlend;   /*!< Blend mode */
+    E_DISP_PIXEL_CLIP m_evClip;     /*!< Clip mode */
+    uint32_t m_u32Alpha;            /*!< Weight of the source in 0~DISP_PIXEL_ALPHA_MAX for evBlendConstAlpha */
+    uint32_t m_u32Key;              /*!< Source pixel value skipped by evBlendColorKey */
+} S_DISP_PIXEL_BLIT;
+
+typedef struct
+{
+    uint32_t m_u32SpecCycles;       /*!< Cycles of the specialized pipeline */
+    uint32_t m_u32GenericCycles;    /*!< Cycles of the generic per-pixel path */
+    uint32_t m_u32Mismatches;       /*!< Destination pixels the two paths disagree on */
+} S_DISP_PIXEL_BENCH;
+
+// Function to blit through the pipeline specialized for the formats, blend and clip mode, returns 0 or -1
+// The CPU writes the destination, clean it before a DMA or the scanout reads it.
+int disp_pixel_blit(const S_DISP_PIXEL_BLIT *psBlit);
+
+// Function to blit through the generic path deciding formats and blend per pixel, returns 0 or -1
+int disp_pixel_blit_generic(const S_DISP_PIXEL_BLIT *psBlit);
+
+// Function to time both paths on one blit, returns 0 or -1
+// The specialized path writes psBlit->m_pvDst and the generic one pvScratch, laid out the same way and
+// holding the same pixels beforehand; they are then compared over m_u32DstW x m_u32DstH.
+int disp_pixel_bench(const S_DISP_PIXEL_BLIT *psBlit, void *pvScratch, S_DISP_PIXEL_BENCH *psBench);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DISP_PIXEL_H__ */
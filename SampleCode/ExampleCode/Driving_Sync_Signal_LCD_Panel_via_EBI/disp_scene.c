@@ -0,0 +1,897 @@
+/**************************************************************************//**
+ * @file     disp_scene.c
+ * @brief    Retained scene graph redrawing only the damaged part of VRAM.
+ *
+ *           Every node change records the screen area it covered before and
+ *           after as damage. A render only visits the damage rectangles, and
+ *           within each skips nodes hidden under an opaque node above them.
+ *           Opaque fills go to disp_fill, everything else is drawn by the
+ *           CPU, only waiting for a fill it would touch.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "disp_scene.h"
+#include "disp_mem.h"
+#include "disp_transition.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+typedef enum
+{
+    evSceneRect,             /*!< Filled or blended rectangle */
+    evSceneImage,            /*!< RGB565 image */
+    evSceneText,             /*!< 1bpp font text */
+    evSceneClip,             /*!< Clip of the children, not drawn */
+    evSceneCNT               /*!< Number of node types */
+} E_SCENE_NODE;
+
+/* Box in screen pixels, right and bottom exclusive. */
+typedef struct
+{
+    int32_t m_i32X0;
+    int32_t m_i32Y0;
+    int32_t m_i32X1;
+    int32_t m_i32Y1;
+} S_SCENE_BOX;
+
+typedef struct
+{
+    uint8_t  m_u8Used;
+    uint8_t  m_u8Type;              /*!< E_SCENE_NODE */
+    uint8_t  m_u8Visible;
+    uint8_t  m_u8Alpha;             /*!< 0~DISP_SCENE_ALPHA_MAX */
+    int16_t  m_i16Parent;
+    int16_t  m_i16Child;            /*!< First child */
+    int16_t  m_i16Next;             /*!< Next sibling, drawn after this one */
+    uint16_t m_u16Color;
+    int32_t  m_i32X;                /*!< Left column relative to the parent */
+    int32_t  m_i32Y;                /*!< Top line relative to the parent */
+    uint32_t m_u32W;
+    uint32_t m_u32H;
+    uint32_t m_u32Stride;           /*!< Image line length in pixels */
+    const void *m_pvData;           /*!< Image pixels or text string */
+    const S_DISP_FONT *m_psFont;
+} S_SCENE_NODE;
+
+typedef struct
+{
+    void       *m_pvBuf;
+    uint32_t    m_u32Num;
+    S_SCENE_BOX m_asDamage[CONFIG_DISP_SCENE_DAMAGE_NUM];
+} S_SCENE_BUF;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_SCENE_NODE s_asNode[CONFIG_DISP_SCENE_NODE_NUM];
+static int16_t s_i16Top = -1;
+static uint16_t s_u16Background = 0;
+static S_SCENE_BUF s_asBuf[CONFIG_VRAM_BUF_NUM];
+static S_DISP_SCENE_STATS s_sStats;
+
+/* Draw list of the damage rectangle being rendered. */
+static int16_t s_ai16Draw[CONFIG_DISP_SCENE_NODE_NUM];
+static S_SCENE_BOX s_asDrawArea[CONFIG_DISP_SCENE_NODE_NUM];
+
+/* Cache lines covered by the fill in flight, CPU drawing there waits for it. */
+static uint32_t s_u32FillLo = 0;
+static uint32_t s_u32FillHi = 0;
+
+static uint16_t s_au16ColorLine[CONFIG_TIMING_HACT];
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to intersect two boxes, returns 1 when the result is not empty
+static int scene_box_and(const S_SCENE_BOX *psA, const S_SCENE_BOX *psB, S_SCENE_BOX *psOut)
+{
+    psOut->m_i32X0 = (psA->m_i32X0 > psB->m_i32X0) ? psA->m_i32X0 : psB->m_i32X0;
+    psOut->m_i32Y0 = (psA->m_i32Y0 > psB->m_i32Y0) ? psA->m_i32Y0 : psB->m_i32Y0;
+    psOut->m_i32X1 = (psA->m_i32X1 < psB->m_i32X1) ? psA->m_i32X1 : psB->m_i32X1;
+    psOut->m_i32Y1 = (psA->m_i32Y1 < psB->m_i32Y1) ? psA->m_i32Y1 : psB->m_i32Y1;
+
+    return (psOut->m_i32X0 < psOut->m_i32X1) && (psOut->m_i32Y0 < psOut->m_i32Y1);
+}
+
+// Function to check whether psOuter contains psInner
+static int scene_box_contains(const S_SCENE_BOX *psOuter, const S_SCENE_BOX *psInner)
+{
+    return (psOuter->m_i32X0 <= psInner->m_i32X0) && (psOuter->m_i32Y0 <= psInner->m_i32Y0) &&
+           (psOuter->m_i32X1 >= psInner->m_i32X1) && (psOuter->m_i32Y1 >= psInner->m_i32Y1);
+}
+
+// Function to get the area of a box
+static uint32_t scene_box_area(const S_SCENE_BOX *psBox)
+{
+    return (uint32_t)(psBox->m_i32X1 - psBox->m_i32X0) * (uint32_t)(psBox->m_i32Y1 - psBox->m_i32Y0);
+}
+
+// Function to get the bounding box of two boxes
+static S_SCENE_BOX scene_box_union(const S_SCENE_BOX *psA, const S_SCENE_BOX *psB)
+{
+    S_SCENE_BOX sBox;
+
+    sBox.m_i32X0 = (psA->m_i32X0 < psB->m_i32X0) ? psA->m_i32X0 : psB->m_i32X0;
+    sBox.m_i32Y0 = (psA->m_i32Y0 < psB->m_i32Y0) ? psA->m_i32Y0 : psB->m_i32Y0;
+    sBox.m_i32X1 = (psA->m_i32X1 > psB->m_i32X1) ? psA->m_i32X1 : psB->m_i32X1;
+    sBox.m_i32Y1 = (psA->m_i32Y1 > psB->m_i32Y1) ? psA->m_i32Y1 : psB->m_i32Y1;
+
+    return sBox;
+}
+
+// Function to get the box of the screen
+static void scene_screen(S_SCENE_BOX *psBox)
+{
+    S_DISP_TIMING sTiming;
+
+    disp_get_timing(&sTiming);
+
+    psBox->m_i32X0 = 0;
+    psBox->m_i32Y0 = 0;
+    psBox->m_i32X1 = (int32_t)sTiming.m_u32HACT;
+    psBox->m_i32Y1 = (int32_t)sTiming.m_u32VACT;
+}
+
+// Function to get a node by ID, NULL if it does not exist
+static S_SCENE_NODE *scene_node(int i32Node)
+{
+    if ((i32Node < 0) || (i32Node >= CONFIG_DISP_SCENE_NODE_NUM) || !s_asNode[i32Node].m_u8Used)
+        return NULL;
+
+    return &s_asNode[i32Node];
+}
+
+// Function to get the next node in drawing order within the subtree of i32Root, DISP_SCENE_ROOT for all
+static int scene_next(int i32Node, int i32Root)
+{
+    if (s_asNode[i32Node].m_i16Child >= 0)
+        return s_asNode[i32Node].m_i16Child;
+
+    while ((i32Node >= 0) && (i32Node != i32Root))
+    {
+        if (s_asNode[i32Node].m_i16Next >= 0)
+            return s_asNode[i32Node].m_i16Next;
+
+        i32Node = s_asNode[i32Node].m_i16Parent;
+    }
+
+    return -1;
+}
+
+// Function to get the screen position of a node's top-left pixel
+static void scene_origin(int i32Node, int32_t *pi32X, int32_t *pi32Y)
+{
+    *pi32X = 0;
+    *pi32Y = 0;
+
+    for (; i32Node >= 0; i32Node = s_asNode[i32Node].m_i16Parent)
+    {
+        *pi32X += s_asNode[i32Node].m_i32X;
+        *pi32Y += s_asNode[i32Node].m_i32Y;
+    }
+}
+
+// Function to get the size of a node in pixels
+static void scene_size(const S_SCENE_NODE *psNode, uint32_t *pu32W, uint32_t *pu32H)
+{
+    if (psNode->m_u8Type == evSceneText)
+    {
+        *pu32W = psNode->m_pvData ? (uint32_t)strlen((const char *)psNode->m_pvData) * psNode->m_psFont->m_u8W : 0;
+        *pu32H = psNode->m_psFont->m_u8H;
+    }
+    else
+    {
+        *pu32W = psNode->m_u32W;
+        *pu32H = psNode->m_u32H;
+    }
+}
+
+// Function to get the visible screen box of a node after its clips, returns 1 when it is not empty
+static int scene_bounds(int i32Node, S_SCENE_BOX *psBox)
+{
+    const S_SCENE_NODE *psNode = &s_asNode[i32Node];
+    S_SCENE_BOX sScreen;
+    uint32_t u32W, u32H;
+
+    if (!psNode->m_u8Visible)
+        return 0;
+
+    scene_size(psNode, &u32W, &u32H);
+
+    psBox->m_i32X0 = psNode->m_i32X;
+    psBox->m_i32Y0 = psNode->m_i32Y;
+    psBox->m_i32X1 = psNode->m_i32X + (int32_t)u32W;
+    psBox->m_i32Y1 = psNode->m_i32Y + (int32_t)u32H;
+
+    /* Walk up in the coordinates of each parent in turn. */
+    for (i32Node = psNode->m_i16Parent; i32Node >= 0; i32Node = s_asNode[i32Node].m_i16Parent)
+    {
+        const S_SCENE_NODE *psParent = &s_asNode[i32Node];
+
+        if (!psParent->m_u8Visible)
+            return 0;
+
+        if (psParent->m_u8Type == evSceneClip)
+        {
+            S_SCENE_BOX sClip = { 0, 0, (int32_t)psParent->m_u32W, (int32_t)psParent->m_u32H };
+
+            if (!scene_box_and(psBox, &sClip, psBox))
+                return 0;
+        }
+
+        psBox->m_i32X0 += psParent->m_i32X;
+        psBox->m_i32Y0 += psParent->m_i32Y;
+        psBox->m_i32X1 += psParent->m_i32X;
+        psBox->m_i32Y1 += psParent->m_i32Y;
+    }
+
+    scene_screen(&sScreen);
+
+    return scene_box_and(psBox, &sScreen, psBox);
+}
+
+// Function to add a damage box to one buffer, merging it with the boxes it overlaps
+static void scene_buf_damage(S_SCENE_BUF *psBuf, S_SCENE_BOX sBox)
+{
+    uint32_t i, u32Best = 0, u32BestGrowth = 0xFFFFFFFFUL;
+    int i32Merged;
+
+    /* Absorb boxes whose union costs no more than drawing both. */
+    do
+    {
+        i32Merged = 0;
+
+        for (i = 0; i < psBuf->m_u32Num; i++)
+        {
+            S_SCENE_BOX sUnion = scene_box_union(&psBuf->m_asDamage[i], &sBox);
+
+            if (scene_box_area(&sUnion) <= (scene_box_area(&psBuf->m_asDamage[i]) + scene_box_area(&sBox)))
+            {
+                sBox = sUnion;
+                psBuf->m_asDamage[i] = psBuf->m_asDamage[--psBuf->m_u32Num];
+                i32Merged = 1;
+                break;
+            }
+        }
+    } while (i32Merged);
+
+    if (psBuf->m_u32Num < CONFIG_DISP_SCENE_DAMAGE_NUM)
+    {
+        psBuf->m_asDamage[psBuf->m_u32Num++] = sBox;
+        return;
+    }
+
+    /* Full, grow the box that grows least. */
+    for (i = 0; i < psBuf->m_u32Num; i++)
+    {
+        S_SCENE_BOX sUnion = scene_box_union(&psBuf->m_asDamage[i], &sBox);
+        uint32_t u32Growth = scene_box_area(&sUnion) - scene_box_area(&psBuf->m_asDamage[i]);
+
+        if (u32Growth < u32BestGrowth)
+        {
+            u32BestGrowth = u32Growth;
+            u32Best = i;
+        }
+    }
+
+    psBuf->m_asDamage[u32Best] = scene_box_union(&psBuf->m_asDamage[u32Best], &sBox);
+}
+
+// Function to mark the visible area of a node and its children as damaged in every buffer
+static void scene_damage(int i32Node)
+{
+    int i32Cur;
+
+    for (i32Cur = i32Node; i32Cur >= 0; i32Cur = scene_next(i32Cur, i32Node))
+    {
+        S_SCENE_BOX sBox;
+        uint32_t i;
+
+        if ((s_asNode[i32Cur].m_u8Type == evSceneClip) || !scene_bounds(i32Cur, &sBox))
+            continue;
+
+        for (i = 0; i < CONFIG_VRAM_BUF_NUM; i++)
+        {
+            if (s_asBuf[i].m_pvBuf)
+                scene_buf_damage(&s_asBuf[i], sBox);
+        }
+    }
+}
+
+// Function to allocate a node under i32Parent, drawn over its earlier siblings, returns node ID or -1
+static int scene_add(int i32Parent, E_SCENE_NODE evType, int32_t i32X, int32_t i32Y, uint32_t u32W, uint32_t u32H)
+{
+    S_SCENE_NODE *psNode;
+    int16_t *pi16Link;
+    int i;
+
+    if ((i32Parent != DISP_SCENE_ROOT) && !scene_node(i32Parent))
+        return -1;
+
+    for (i = 0; i < CONFIG_DISP_SCENE_NODE_NUM; i++)
+    {
+        if (!s_asNode[i].m_u8Used)
+            break;
+    }
+
+    if (i == CONFIG_DISP_SCENE_NODE_NUM)
+        return -1;
+
+    psNode = &s_asNode[i];
+    memset(psNode, 0, sizeof(S_SCENE_NODE));
+    psNode->m_u8Used = 1;
+    psNode->m_u8Type = (uint8_t)evType;
+    psNode->m_u8Visible = 1;
+    psNode->m_u8Alpha = DISP_SCENE_ALPHA_MAX;
+    psNode->m_i16Parent = (int16_t)i32Parent;
+    psNode->m_i16Child = -1;
+    psNode->m_i16Next = -1;
+    psNode->m_i32X = i32X;
+    psNode->m_i32Y = i32Y;
+    psNode->m_u32W = u32W;
+    psNode->m_u32H = u32H;
+
+    pi16Link = (i32Parent < 0) ? &s_i16Top : &s_asNode[i32Parent].m_i16Child;
+
+    while (*pi16Link >= 0)
+        pi16Link = &s_asNode[*pi16Link].m_i16Next;
+
+    *pi16Link = (int16_t)i;
+
+    return i;
+}
+
+int disp_scene_add_rect(int i32Parent, const S_DISP_RECT *psRect, uint16_t u16Color, uint32_t u32Alpha)
+{
+    int i32Node;
+
+    if (!psRect || (u32Alpha > DISP_SCENE_ALPHA_MAX))
+        return -1;
+
+    i32Node = scene_add(i32Parent, evSceneRect, (int32_t)psRect->m_u32X, (int32_t)psRect->m_u32Y, psRect->m_u32W, psRect->m_u32H);
+
+    if (i32Node >= 0)
+    {
+        s_asNode[i32Node].m_u16Color = u16Color;
+        s_asNode[i32Node].m_u8Alpha = (uint8_t)u32Alpha;
+        scene_damage(i32Node);
+    }
+
+    return i32Node;
+}
+
+int disp_scene_add_image(int i32Parent, const S_DISP_RECT *psRect, const uint16_t *pu16Pixels, uint32_t u32Stride)
+{
+    int i32Node;
+
+    if (!psRect || !pu16Pixels || (u32Stride < psRect->m_u32W))
+        return -1;
+
+    i32Node = scene_add(i32Parent, evSceneImage, (int32_t)psRect->m_u32X, (int32_t)psRect->m_u32Y, psRect->m_u32W, psRect->m_u32H);
+
+    if (i32Node >= 0)
+    {
+        s_asNode[i32Node].m_pvData = pu16Pixels;
+        s_asNode[i32Node].m_u32Stride = u32Stride;
+        scene_damage(i32Node);
+    }
+
+    return i32Node;
+}
+
+int disp_scene_add_text(int i32Parent, uint32_t u32X, uint32_t u32Y, const S_DISP_FONT *psFont, const char *pcText, uint16_t u16Color)
+{
+    int i32Node;
+
+    if (!psFont || !psFont->m_pu8Glyphs)
+        return -1;
+
+    i32Node = scene_add(i32Parent, evSceneText, (int32_t)u32X, (int32_t)u32Y, 0, 0);
+
+    if (i32Node >= 0)
+    {
+        s_asNode[i32Node].m_psFont = psFont;
+        s_asNode[i32Node].m_pvData = pcText;
+        s_asNode[i32Node].m_u16Color = u16Color;
+        scene_damage(i32Node);
+    }
+
+    return i32Node;
+}
+
+int disp_scene_add_clip(int i32Parent, const S_DISP_RECT *psRect)
+{
+    if (!psRect)
+        return -1;
+
+    /* Nothing to damage until children are added. */
+    return scene_add(i32Parent, evSceneClip, (int32_t)psRect->m_u32X, (int32_t)psRect->m_u32Y, psRect->m_u32W, psRect->m_u32H);
+}
+
+int disp_scene_remove(int i32Node)
+{
+    S_SCENE_NODE *psNode = scene_node(i32Node);
+    int16_t *pi16Link;
+    int i32Cur, i32Next;
+
+    if (!psNode)
+        return -1;
+
+    scene_damage(i32Node);
+
+    pi16Link = (psNode->m_i16Parent < 0) ? &s_i16Top : &s_asNode[psNode->m_i16Parent].m_i16Child;
+
+    while (*pi16Link != i32Node)
+        pi16Link = &s_asNode[*pi16Link].m_i16Next;
+
+    *pi16Link = psNode->m_i16Next;
+
+    /* Free the subtree, the next node is found before the current one is released. */
+    psNode->m_i16Next = -1;
+
+    for (i32Cur = i32Node; i32Cur >= 0; i32Cur = i32Next)
+    {
+        i32Next = scene_next(i32Cur, i32Node);
+        s_asNode[i32Cur].m_u8Used = 0;
+    }
+
+    return 0;
+}
+
+int disp_scene_set_pos(int i32Node, int32_t i32X, int32_t i32Y)
+{
+    S_SCENE_NODE *psNode = scene_node(i32Node);
+
+    if (!psNode)
+        return -1;
+    else if ((psNode->m_i32X == i32X) && (psNode->m_i32Y == i32Y))
+        return 0;
+
+    scene_damage(i32Node);
+    psNode->m_i32X = i32X;
+    psNode->m_i32Y = i32Y;
+    scene_damage(i32Node);
+
+    return 0;
+}
+
+int disp_scene_set_size(int i32Node, uint32_t u32W, uint32_t u32H)
+{
+    S_SCENE_NODE *psNode = scene_node(i32Node);
+
+    if (!psNode || (psNode->m_u8Type == evSceneText))
+        return -1;
+    else if ((psNode->m_u8Type == evSceneImage) && (u32W > psNode->m_u32Stride))
+        return -1;
+    else if ((psNode->m_u32W == u32W) && (psNode->m_u32H == u32H))
+        return 0;
+
+    scene_damage(i32Node);
+    psNode->m_u32W = u32W;
+    psNode->m_u32H = u32H;
+    scene_damage(i32Node);
+
+    return 0;
+}
+
+int disp_scene_set_color(int i32Node, uint16_t u16Color, uint32_t u32Alpha)
+{
+    S_SCENE_NODE *psNode = scene_node(i32Node);
+
+    if (!psNode || (u32Alpha > DISP_SCENE_ALPHA_MAX) ||
+            ((psNode->m_u8Type != evSceneRect) && (psNode->m_u8Type != evSceneText)))
+        return -1;
+    else if ((psNode->m_u16Color == u16Color) && (psNode->m_u8Alpha == u32Alpha))
+        return 0;
+
+    psNode->m_u16Color = u16Color;
+    psNode->m_u8Alpha = (uint8_t)u32Alpha;
+
+    /* Same area, damaging it once covers the change. */
+    scene_damage(i32Node);
+
+    return 0;
+}
+
+int disp_scene_set_image(int i32Node, const uint16_t *pu16Pixels)
+{
+    S_SCENE_NODE *psNode = scene_node(i32Node);
+
+    if (!psNode || !pu16Pixels || (psNode->m_u8Type != evSceneImage))
+        return -1;
+
+    psNode->m_pvData = pu16Pixels;
+    scene_damage(i32Node);
+
+    return 0;
+}
+
+int disp_scene_set_text(int i32Node, const char *pcText)
+{
+    S_SCENE_NODE *psNode = scene_node(i32Node);
+
+    if (!psNode || (psNode->m_u8Type != evSceneText))
+        return -1;
+
+    /* The length may change, damage the old and the new extent. */
+    scene_damage(i32Node);
+    psNode->m_pvData = pcText;
+    scene_damage(i32Node);
+
+    return 0;
+}
+
+int disp_scene_set_visible(int i32Node, int i32Visible)
+{
+    S_SCENE_NODE *psNode = scene_node(i32Node);
+
+    if (!psNode)
+        return -1;
+    else if (psNode->m_u8Visible == (i32Visible ? 1 : 0))
+        return 0;
+
+    /* Damage is taken while the subtree is shown. */
+    if (!i32Visible)
+        scene_damage(i32Node);
+
+    psNode->m_u8Visible = i32Visible ? 1 : 0;
+
+    if (i32Visible)
+        scene_damage(i32Node);
+
+    return 0;
+}
+
+int disp_scene_invalidate(int i32Node)
+{
+    if (!scene_node(i32Node))
+        return -1;
+
+    scene_damage(i32Node);
+
+    return 0;
+}
+
+void disp_scene_set_background(uint16_t u16Color)
+{
+    S_SCENE_BOX sBox;
+    uint32_t i;
+
+    if (u16Color == s_u16Background)
+        return;
+
+    s_u16Background = u16Color;
+    scene_screen(&sBox);
+
+    for (i = 0; i < CONFIG_VRAM_BUF_NUM; i++)
+    {
+        if (s_asBuf[i].m_pvBuf)
+            scene_buf_damage(&s_asBuf[i], sBox);
+    }
+}
+
+// Function to get the cache line range of a box in a buffer
+static void scene_box_lines(const uint16_t *pu16Buf, uint32_t u32Stride, const S_SCENE_BOX *psBox, uint32_t *pu32Lo, uint32_t *pu32Hi)
+{
+    *pu32Lo = (uint32_t)&pu16Buf[psBox->m_i32Y0 * u32Stride + psBox->m_i32X0] & ~(DCACHE_LINE_SIZE - 1);
+    *pu32Hi = NVT_ALIGN((uint32_t)&pu16Buf[(psBox->m_i32Y1 - 1) * u32Stride + psBox->m_i32X1], DCACHE_LINE_SIZE);
+}
+
+// Function to wait for the fill in flight before the CPU draws into psBox
+static void scene_cpu_wait(const uint16_t *pu16Buf, uint32_t u32Stride, const S_SCENE_BOX *psBox)
+{
+    uint32_t u32Lo, u32Hi;
+
+    if (s_u32FillHi == 0)
+        return;
+
+    scene_box_lines(pu16Buf, u32Stride, psBox, &u32Lo, &u32Hi);
+
+    /* Cache lines shared with the fill would be written back over it. */
+    if ((u32Lo < s_u32FillHi) && (u32Hi > s_u32FillLo))
+    {
+        disp_fill_wait();
+        s_u32FillHi = 0;
+    }
+}
+
+// Function to fill a box with a color, by DMA when it is large enough
+static void scene_fill(uint16_t *pu16Buf, uint32_t u32Stride, const S_SCENE_BOX *psBox, uint16_t u16Color)
+{
+    uint32_t u32W = (uint32_t)(psBox->m_i32X1 - psBox->m_i32X0);
+    int32_t y;
+    uint32_t x;
+
+    if ((u32W * (uint32_t)(psBox->m_i32Y1 - psBox->m_i32Y0)) >= CONFIG_DISP_SCENE_DMA_MIN_PIXELS)
+    {
+        S_DISP_RECT sRect = { (uint32_t)psBox->m_i32X0, (uint32_t)psBox->m_i32Y0, u32W, (uint32_t)(psBox->m_i32Y1 - psBox->m_i32Y0) };
+
+        /* Write back what the CPU drew before and drop the lines, the DMA writes memory underneath. */
+        for (y = psBox->m_i32Y0; y < psBox->m_i32Y1; y++)
+            SCB_CleanInvalidateDCache_by_Addr(&pu16Buf[y * u32Stride + psBox->m_i32X0], (int32_t)(u32W * sizeof(uint16_t)));
+
+        if (disp_fill(pu16Buf, &sRect, u16Color) == 0)
+        {
+            scene_box_lines(pu16Buf, u32Stride, psBox, &s_u32FillLo, &s_u32FillHi);
+            s_sStats.m_u32DmaFills++;
+            return;
+        }
+    }
+
+    scene_cpu_wait(pu16Buf, u32Stride, psBox);
+
+    for (y = psBox->m_i32Y0; y < psBox->m_i32Y1; y++)
+    {
+        uint16_t *pu16Dst = &pu16Buf[y * u32Stride + psBox->m_i32X0];
+
+        for (x = 0; x < u32W; x++)
+            pu16Dst[x] = u16Color;
+    }
+
+    s_sStats.m_u32CpuDraws++;
+}
+
+// Function to draw the part of a node inside psArea
+static void scene_draw(uint16_t *pu16Buf, uint32_t u32Stride, int i32Node, const S_SCENE_BOX *psArea)
+{
+    const S_SCENE_NODE *psNode = &s_asNode[i32Node];
+    uint32_t u32W = (uint32_t)(psArea->m_i32X1 - psArea->m_i32X0);
+    int32_t i32OrgX, i32OrgY, y;
+
+    if ((psNode->m_u8Type == evSceneRect) && (psNode->m_u8Alpha == DISP_SCENE_ALPHA_MAX))
+    {
+        scene_fill(pu16Buf, u32Stride, psArea, psNode->m_u16Color);
+        return;
+    }
+    else if ((psNode->m_u8Type == evSceneRect) && (psNode->m_u8Alpha == 0))
+    {
+        return;
+    }
+
+    scene_cpu_wait(pu16Buf, u32Stride, psArea);
+    scene_origin(i32Node, &i32OrgX, &i32OrgY);
+    s_sStats.m_u32CpuDraws++;
+
+    if (psNode->m_u8Type == evSceneRect)
+    {
+        uint32_t x;
+
+        for (x = 0; x < u32W; x++)
+            s_au16ColorLine[x] = psNode->m_u16Color;
+
+        for (y = psArea->m_i32Y0; y < psArea->m_i32Y1; y++)
+        {
+            uint16_t *pu16Dst = &pu16Buf[y * u32Stride + psArea->m_i32X0];
+
+            disp_transition_blend(pu16Dst, pu16Dst, s_au16ColorLine, u32W, psNode->m_u8Alpha);
+        }
+    }
+    else if (psNode->m_u8Type == evSceneImage)
+    {
+        const uint16_t *pu16Src = (const uint16_t *)psNode->m_pvData;
+
+        for (y = psArea->m_i32Y0; y < psArea->m_i32Y1; y++)
+        {
+            memcpy(&pu16Buf[y * u32Stride + psArea->m_i32X0],
+                   &pu16Src[(y - i32OrgY) * psNode->m_u32Stride + (psArea->m_i32X0 - i32OrgX)],
+                   u32W * sizeof(uint16_t));
+        }
+    }
+    else
+    {
+        const S_DISP_FONT *psFont = psNode->m_psFont;
+        const char *pcText = (const char *)psNode->m_pvData;
+        uint32_t u32RowBytes = ((uint32_t)psFont->m_u8W + 7) / 8;
+        int32_t i32First = (psArea->m_i32X0 - i32OrgX) / psFont->m_u8W;
+        int32_t i32Last = (psArea->m_i32X1 - 1 - i32OrgX) / psFont->m_u8W;
+        int32_t c, x;
+
+        for (c = i32First; c <= i32Last; c++)
+        {
+            uint32_t u32Glyph = (uint8_t)pcText[c] - psFont->m_u8First;
+            const uint8_t *pu8Glyph;
+            int32_t i32GX = i32OrgX + c * psFont->m_u8W;
+            int32_t x0 = (psArea->m_i32X0 > i32GX) ? psArea->m_i32X0 : i32GX;
+            int32_t x1 = (psArea->m_i32X1 < (i32GX + psFont->m_u8W)) ? psArea->m_i32X1 : (i32GX + psFont->m_u8W);
+
+            if (u32Glyph >= psFont->m_u8Num)
+                continue;
+
+            pu8Glyph = &psFont->m_pu8Glyphs[u32Glyph * psFont->m_u8H * u32RowBytes];
+
+            for (y = psArea->m_i32Y0; y < psArea->m_i32Y1; y++)
+            {
+                const uint8_t *pu8Row = &pu8Glyph[(y - i32OrgY) * u32RowBytes];
+                uint16_t *pu16Dst = &pu16Buf[y * u32Stride];
+
+                for (x = x0; x < x1; x++)
+                {
+                    uint32_t u32Bit = (uint32_t)(x - i32GX);
+
+                    if (pu8Row[u32Bit >> 3] & (0x80 >> (u32Bit & 7)))
+                        pu16Dst[x] = psNode->m_u16Color;
+                }
+            }
+        }
+    }
+}
+
+// Function to check whether a node hides everything below it
+static int scene_opaque(int i32Node)
+{
+    return (s_asNode[i32Node].m_u8Type == evSceneImage) ||
+           ((s_asNode[i32Node].m_u8Type == evSceneRect) && (s_asNode[i32Node].m_u8Alpha == DISP_SCENE_ALPHA_MAX));
+}
+
+// Function to redraw one damage box, returns its pixels
+static uint32_t scene_render_box(uint16_t *pu16Buf, uint32_t u32Stride, const S_SCENE_BOX *psBox)
+{
+    uint32_t n = 0, u32First = 0, i, j;
+    int i32Cover = 0, i32Node;
+
+    /* Draw list in painter's order, each node cut to its clips and the box. */
+    for (i32Node = s_i16Top; i32Node >= 0; i32Node = scene_next(i32Node, DISP_SCENE_ROOT))
+    {
+        S_SCENE_BOX sBounds;
+
+        if ((s_asNode[i32Node].m_u8Type == evSceneClip) || !scene_bounds(i32Node, &sBounds))
+            continue;
+
+        if (scene_box_and(&sBounds, psBox, &s_asDrawArea[n]))
+            s_ai16Draw[n++] = (int16_t)i32Node;
+    }
+
+    /* Nothing below the topmost opaque node covering the whole box shows. */
+    for (i = n; i-- > 0;)
+    {
+        if (scene_opaque(s_ai16Draw[i]) && scene_box_contains(&s_asDrawArea[i], psBox))
+        {
+            u32First = i;
+            i32Cover = 1;
+            break;
+        }
+    }
+
+    s_sStats.m_u32Culled += u32First;
+
+    if (!i32Cover)
+        scene_fill(pu16Buf, u32Stride, psBox, s_u16Background);
+
+    for (i = u32First; i < n; i++)
+    {
+        for (j = i + 1; j < n; j++)
+        {
+            if (scene_opaque(s_ai16Draw[j]) && scene_box_contains(&s_asDrawArea[j], &s_asDrawArea[i]))
+                break;
+        }
+
+        if (j < n)
+        {
+            s_sStats.m_u32Culled++;
+            continue;
+        }
+
+        scene_draw(pu16Buf, u32Stride, s_ai16Draw[i], &s_asDrawArea[i]);
+    }
+
+    return scene_box_area(psBox);
+}
+
+// Function to get the damage list of a buffer, a buffer seen the first time is damaged whole
+static S_SCENE_BUF *scene_buf(void *pvBuf)
+{
+    uint32_t i;
+
+    for (i = 0; i < CONFIG_VRAM_BUF_NUM; i++)
+    {
+        if (s_asBuf[i].m_pvBuf == pvBuf)
+            return &s_asBuf[i];
+    }
+
+    for (i = 0; i < CONFIG_VRAM_BUF_NUM; i++)
+    {
+        if (!s_asBuf[i].m_pvBuf)
+        {
+            s_asBuf[i].m_pvBuf = pvBuf;
+            s_asBuf[i].m_u32Num = 1;
+            scene_screen(&s_asBuf[i].m_asDamage[0]);
+            return &s_asBuf[i];
+        }
+    }
+
+    return NULL;
+}
+
+int disp_scene_render(void *pvBuf)
+{
+    S_SCENE_BUF *psBuf = scene_buf(pvBuf);
+    S_SCENE_BOX sScreen, sBox;
+    uint16_t *pu16Buf = (uint16_t *)pvBuf;
+    uint32_t u32Start = DWT->CYCCNT, u32Pixels = 0, u32Stride, i;
+    int32_t y;
+
+    if (!pvBuf || !psBuf)
+        return -1;
+    else if (psBuf->m_u32Num == 0)
+        return 0;
+
+    scene_screen(&sScreen);
+    u32Stride = (uint32_t)sScreen.m_i32X1;
+    disp_mem_acquire(pvBuf);
+
+    for (i = 0; i < psBuf->m_u32Num; i++)
+    {
+        if (scene_box_and(&psBuf->m_asDamage[i], &sScreen, &sBox))
+            u32Pixels += scene_render_box(pu16Buf, u32Stride, &sBox);
+    }
+
+    disp_fill_wait();
+    s_u32FillHi = 0;
+
+    /* Only the damage goes to memory, or to the panel for the buffer on screen. */
+    for (i = 0; i < psBuf->m_u32Num; i++)
+    {
+        if (!scene_box_and(&psBuf->m_asDamage[i], &sScreen, &sBox))
+            continue;
+
+        if (pvBuf == disp_get_vrambufaddr())
+        {
+            S_DISP_RECT sRect = { (uint32_t)sBox.m_i32X0, (uint32_t)sBox.m_i32Y0,
+                                  (uint32_t)(sBox.m_i32X1 - sBox.m_i32X0), (uint32_t)(sBox.m_i32Y1 - sBox.m_i32Y0)
+                                };
+
+            disp_flush(&sRect);
+        }
+        else
+        {
+            for (y = sBox.m_i32Y0; y < sBox.m_i32Y1; y++)
+                SCB_CleanDCache_by_Addr(&pu16Buf[y * u32Stride + sBox.m_i32X0], (sBox.m_i32X1 - sBox.m_i32X0) * (int32_t)sizeof(uint16_t));
+        }
+    }
+
+    i = psBuf->m_u32Num;
+    psBuf->m_u32Num = 0;
+
+    s_sStats.m_u32Renders++;
+    s_sStats.m_u32LastPixels = u32Pixels;
+    s_sStats.m_u32LastUs = (DWT->CYCCNT - u32Start) / ((SystemCoreClock / 1000000UL) ? (SystemCoreClock / 1000000UL) : 1);
+
+    return (int)i;
+}
+
+void disp_scene_get_stats(S_DISP_SCENE_STATS *psStats)
+{
+    *psStats = s_sStats;
+}
+
+// Function to initialize the scene graph
+static int disp_scene_init(void)
+{
+    memset(s_asNode, 0, sizeof(s_asNode));
+    memset(s_asBuf, 0, sizeof(s_asBuf));
+    memset(&s_sStats, 0, sizeof(s_sStats));
+    s_i16Top = -1;
+    s_u16Background = 0;
+    s_u32FillHi = 0;
+
+    /* Render times are counted in core cycles. */
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return 0;
+}
+
+// Function to deinitialize the scene graph
+static int disp_scene_fini(void)
+{
+    disp_fill_wait();
+    s_i16Top = -1;
+
+    return 0;
+}
+
+COMPONENT_EXPORT("DISP_SCENE", disp_scene_init, disp_scene_fini);
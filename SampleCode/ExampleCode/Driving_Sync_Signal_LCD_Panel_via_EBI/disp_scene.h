@@ -0,0 +1,92 @@
+/**************************************************************************//**
+ * @file     disp_scene.h
+ * @brief    Retained scene graph redrawing only the damaged part of VRAM.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_SCENE_H__
+#define __DISP_SCENE_H__
+
+#include "disp.h"
+
+#define CONFIG_DISP_SCENE_NODE_NUM          64   /*!< Nodes in the scene */
+#define CONFIG_DISP_SCENE_DAMAGE_NUM         8   /*!< Damage rectangles kept per buffer, more are merged */
+#define CONFIG_DISP_SCENE_DMA_MIN_PIXELS   512   /*!< Smaller opaque fills are done by the CPU, below the DMA setup cost */
+
+#define DISP_SCENE_ROOT                     (-1) /*!< Parent of top level nodes */
+#define DISP_SCENE_ALPHA_MAX                32   /*!< Alpha of an opaque rectangle, see disp_transition_blend */
+
+/* Fixed-size 1bpp font. Every glyph is m_u8H rows of (m_u8W + 7) / 8 bytes, MSB is the left pixel. */
+typedef struct
+{
+    uint8_t m_u8W;                  /*!< Glyph width in pixels */
+    uint8_t m_u8H;                  /*!< Glyph height in lines */
+    uint8_t m_u8First;              /*!< Character of the first glyph */
+    uint8_t m_u8Num;                /*!< Glyphs in m_pu8Glyphs */
+    const uint8_t *m_pu8Glyphs;     /*!< Glyph bitmaps */
+} S_DISP_FONT;
+
+typedef struct
+{
+    uint32_t m_u32Renders;          /*!< disp_scene_render calls that drew something */
+    uint32_t m_u32LastPixels;       /*!< Damaged pixels redrawn by the last render */
+    uint32_t m_u32LastUs;           /*!< Time of the last render including the cache clean */
+    uint32_t m_u32Culled;           /*!< Node draws skipped as fully occluded */
+    uint32_t m_u32DmaFills;         /*!< Fills done by disp_fill */
+    uint32_t m_u32CpuDraws;         /*!< Fills, blends, image copies and text drawn by the CPU */
+} S_DISP_SCENE_STATS;
+
+/* Nodes are placed relative to their parent and drawn in order of creation, children over
+   their parent. Only clip nodes limit their children. Images and text are referenced, not
+   copied, and must stay valid while the node exists. */
+
+// Function to add a rectangle filled with u16Color, u32Alpha in 0~DISP_SCENE_ALPHA_MAX, returns node ID or -1
+int disp_scene_add_rect(int i32Parent, const S_DISP_RECT *psRect, uint16_t u16Color, uint32_t u32Alpha);
+
+// Function to add an RGB565 image with u32Stride pixels per line, returns node ID or -1
+int disp_scene_add_image(int i32Parent, const S_DISP_RECT *psRect, const uint16_t *pu16Pixels, uint32_t u32Stride);
+
+// Function to add a line of text drawn in u16Color over what is below it, returns node ID or -1
+int disp_scene_add_text(int i32Parent, uint32_t u32X, uint32_t u32Y, const S_DISP_FONT *psFont, const char *pcText, uint16_t u16Color);
+
+// Function to add a clip node cutting its children to psRect, returns node ID or -1
+int disp_scene_add_clip(int i32Parent, const S_DISP_RECT *psRect);
+
+// Function to remove a node with its children
+int disp_scene_remove(int i32Node);
+
+// Function to move a node with its children relative to its parent
+int disp_scene_set_pos(int i32Node, int32_t i32X, int32_t i32Y);
+
+// Function to resize a rectangle, image or clip node
+int disp_scene_set_size(int i32Node, uint32_t u32W, uint32_t u32H);
+
+// Function to change the color of a rectangle or text node
+int disp_scene_set_color(int i32Node, uint16_t u16Color, uint32_t u32Alpha);
+
+// Function to point an image node at new pixels
+int disp_scene_set_image(int i32Node, const uint16_t *pu16Pixels);
+
+// Function to change the string of a text node
+int disp_scene_set_text(int i32Node, const char *pcText);
+
+// Function to show or hide a node with its children
+int disp_scene_set_visible(int i32Node, int i32Visible);
+
+// Function to mark a node dirty after the pixels or string it references changed in place
+int disp_scene_invalidate(int i32Node);
+
+// Function to set the color shown where no node is drawn
+void disp_scene_set_background(uint16_t u16Color);
+
+// Function to redraw the damage of pvBuf, returns the damage rectangles redrawn or -1
+// Damage is tracked per buffer, so each of the VRAM buffers catches up on the changes it missed; a
+// buffer rendered for the first time is drawn whole. The damage is cleaned to memory, or flushed by
+// disp_flush when pvBuf is the buffer being scanned out.
+int disp_scene_render(void *pvBuf);
+
+// Function to get the scene statistics
+void disp_scene_get_stats(S_DISP_SCENE_STATS *psStats);
+
+#endif /* __DISP_SCENE_H__ */
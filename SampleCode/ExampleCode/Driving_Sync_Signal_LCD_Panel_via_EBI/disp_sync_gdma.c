@@ -9,12 +9,28 @@
 #include "dma350_lib.h"
 #include "dma350_ch_drv.h"
 #include "disp.h"
+#include "disp_mem.h"
 #include "nu_bitutil.h"
+#include "nu_os.h"
+
+#if !defined(CONFIG_LCD_PANEL_USE_I80)
 
 /*---------------------------------------------------------------------------*/
 /* Define                                                                    */
 /*---------------------------------------------------------------------------*/
 
+/* XSIZE is programmed through dma350_cmdlink_set_xsize16, longer runs are repeated along Y. */
+#define DEF_GDMA_MAX_XSIZE    0xFFFF
+#define DEF_GDMA_MAX_YSIZE    0xFFFF
+
+/* Channel 1 runs the scanout command chain, disp_fill takes the other one. */
+#define DEF_GDMA_FILL_CH      0
+#define DEF_GDMA_EV_FILL_DONE (1UL << 0)
+
+#if ((CONFIG_TIMING_HPORCH_MAX + CONFIG_TIMING_HACT) > DEF_GDMA_MAX_XSIZE) || (CONFIG_TIMING_VPORCH_MAX > DEF_GDMA_MAX_YSIZE)
+    #error "Panel timing exceeds the DMA350 XSIZE16/YSIZE16 limits."
+#endif
+
 typedef struct
 {
 #define DEF_CMDBUF_SIZE   16
@@ -34,61 +50,62 @@ typedef struct
     S_DSC_HLINE    m_dscV[DEF_TOTAL_VLINES];
 } S_DSC_LCD;
 
+/* One arena is scanned out while the other one is rebuilt by disp_set_timing. */
+#define DEF_DSC_ARENA_NUM        2
+
+// Structure representing a command chain and the timing it was built for
+typedef struct
+{
+    S_DSC_LCD       *m_psDscLCD;
+    S_CMDBUF        *m_head;
+    S_CMDBUF        *m_end;
+    uint32_t         m_u32VActIdx;                  // Index of the first active line in m_dscV
+    uint32_t         m_au32HTiming[evHStageCNT];
+    uint32_t         m_au32VTiming[evVStageCNT];
+    S_DISP_TIMING    m_sTiming;
+} S_DSC_ARENA;
+
 /*---------------------------------------------------------------------------*/
 /* Global variables                                                          */
 /*---------------------------------------------------------------------------*/
 #if defined(NVT_NONCACHEABLE)
-    NVT_NONCACHEABLE static S_DSC_LCD s_sDscLCD;
+    NVT_NONCACHEABLE static S_DSC_LCD s_asDscLCD[DEF_DSC_ARENA_NUM];
 #else
-    static S_DSC_LCD s_sDscLCD;
+    static S_DSC_LCD s_asDscLCD[DEF_DSC_ARENA_NUM];
 #endif
 
 extern struct dma350_ch_dev_t *const GDMA_CH_DEV_S[];
 
 uint8_t g_au8FrameBuf[CONFIG_VRAM_TOTAL_ALLOCATED_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE))); // Declare VRAM instance.
 static uint32_t s_u32DummyData = 0xffffffff;
-static S_CMDBUF *s_head = (S_CMDBUF *) &s_sDscLCD;
-static S_CMDBUF *s_end  = (S_CMDBUF *) &s_sDscLCD + (sizeof(s_sDscLCD) / sizeof(S_CMDBUF) - 1);
 static volatile uint16_t *s_pu16BufAddr = NULL;
 static DispBlankCb s_DispBlankCb = NULL;
 
-static const uint32_t s_au32HTiming[evHStageCNT] =
-{
-#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
-    DEF_HACT_INDEX,
-    CONFIG_TIMING_HACT
-#else
-    CONFIG_TIMING_HFP,
-    CONFIG_TIMING_HPW,
-    CONFIG_TIMING_HBP,
-    CONFIG_TIMING_HACT
-#endif
-};
+static S_DSC_ARENA s_asArena[DEF_DSC_ARENA_NUM];
+static volatile int s_i32ArenaCur = 0;       // Arena being scanned out
+static volatile int s_i32ArenaNext = -1;     // Arena waiting for a frame boundary, -1 if none
+static volatile int s_i32ArenaLinked = 0;    // Tail of current arena already links to next arena
+static const uint32_t *volatile s_pu32LineTbl = NULL;  // Per-line source addresses, NULL for linear VRAM
+static volatile int s_i32LineTblReset = 0;   // Linear mapping must be rewritten after leaving the line table
+static DispCopyCb s_pfnCopyDone = NULL;      // Completion of the disp_copy in flight
+static void *s_pvCopyUserData = NULL;
+static nu_os_event_t s_sEvFill;               // Set when a command on the fill channel ends
+static volatile uint32_t s_u32FillStatus = 0; // Channel status latched by the interrupt
+
+static const S_DISP_TIMING s_sTimingDefault = DEF_DISP_TIMING_DEFAULT;
 
-static const uint32_t s_au32VTiming[evVStageCNT] =
-{
-#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
-    DEF_VACT_INDEX,
-    CONFIG_TIMING_VACT
-#else
-    CONFIG_TIMING_VFP,
-    CONFIG_TIMING_VPW,
-    CONFIG_TIMING_VBP,
-    CONFIG_TIMING_VACT
-#endif
-};
 /*---------------------------------------------------------------------------*/
 /* Functions                                                                 */
 /*---------------------------------------------------------------------------*/
 // Function to get the current V stage based on the line index
-static E_VSTAGE get_current_vstage(int i32LineIdx)
+static E_VSTAGE get_current_vstage(const uint32_t *pu32VTiming, int i32LineIdx)
 {
     int sum = 0;
     E_VSTAGE i;
 
     for (i = 0; i < evVStageCNT; i++)
     {
-        sum += s_au32VTiming[i];
+        sum += pu32VTiming[i];
 
         if (i32LineIdx < sum)
         {
@@ -99,28 +116,98 @@ static E_VSTAGE get_current_vstage(int i32LineIdx)
     return 0;
 }
 
+// Function to check a timing against the command arena capacity
+static int disp_timing_check(const S_DISP_TIMING *psTiming)
+{
+    uint32_t u32HPorch = psTiming->m_u32HFP + psTiming->m_u32HPW + psTiming->m_u32HBP;
+    uint32_t u32VPorch = psTiming->m_u32VFP + psTiming->m_u32VPW + psTiming->m_u32VBP;
+
+    if ((psTiming->m_u32HACT == 0) || (psTiming->m_u32HACT > CONFIG_TIMING_HACT))
+        return -1;
+    else if ((psTiming->m_u32VACT == 0) || (psTiming->m_u32VACT > CONFIG_TIMING_VACT))
+        return -1;
+    else if ((u32HPorch > CONFIG_TIMING_HPORCH_MAX) || (u32VPorch > CONFIG_TIMING_VPORCH_MAX))
+        return -1;
+
+#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
+
+    if ((u32HPorch == 0) || (u32VPorch == 0))
+        return -1;
+
+#else
+
+    /* Every stage owns a command, a zero-length stage cannot be expressed. */
+    if (!psTiming->m_u32HFP || !psTiming->m_u32HPW || !psTiming->m_u32HBP ||
+            !psTiming->m_u32VFP || !psTiming->m_u32VPW || !psTiming->m_u32VBP)
+        return -1;
+
+#endif
+
+    return 0;
+}
+
+// Function to derive the H/V stage lengths of an arena from its timing
+static void disp_arena_timing_fill(S_DSC_ARENA *psArena, const S_DISP_TIMING *psTiming)
+{
+    const S_DISP_TIMING *t = psTiming;
+
+    psArena->m_sTiming = *t;
+
+#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
+    psArena->m_au32HTiming[evHStageHFP_HSYNC_HBP] = t->m_u32HFP + t->m_u32HPW + t->m_u32HBP;
+    psArena->m_au32VTiming[evVStageVFP_VSYNC_VBP] = t->m_u32VFP + t->m_u32VPW + t->m_u32VBP;
+    psArena->m_u32VActIdx = 0;
+#else
+    psArena->m_au32HTiming[evHStageHFP]   = t->m_u32HFP;
+    psArena->m_au32HTiming[evHStageHSYNC] = t->m_u32HPW;
+    psArena->m_au32HTiming[evHStageHBP]   = t->m_u32HBP;
+    psArena->m_au32VTiming[evVStageVFP]   = t->m_u32VFP;
+    psArena->m_au32VTiming[evVStageVSYNC] = t->m_u32VPW;
+    psArena->m_au32VTiming[evVStageVBP]   = t->m_u32VBP;
+    psArena->m_u32VActIdx = t->m_u32VFP + t->m_u32VPW + t->m_u32VBP;
+#endif
+    psArena->m_au32HTiming[evHStageHACT]  = t->m_u32HACT;
+    psArena->m_au32VTiming[evVStageVACT]  = t->m_u32VACT;
+}
+
 // Function to initialize the GDMA descriptors for display synchronization
-static void disp_cmdlink_config(struct dma350_cmdlink_gencfg_t *cmdlink_cfg, uint32_t u32AddrSrc, uint32_t u32AddrDst, uint32_t u32XferCount, uint16_t u16AddrSrcInc, uint16_t u16AddrDstInc)
+// u32LineCount > 1 repeats the u32XferCount-unit run in place along Y, for transfers beyond XSIZE16.
+static void disp_cmdlink_config(struct dma350_cmdlink_gencfg_t *cmdlink_cfg, uint32_t u32AddrSrc, uint32_t u32AddrDst, uint32_t u32XferCount, uint32_t u32LineCount, uint16_t u16AddrSrcInc, uint16_t u16AddrDstInc)
 {
     dma350_cmdlink_init(cmdlink_cfg);
     dma350_cmdlink_set_regclear(cmdlink_cfg);
-    dma350_cmdlink_set_src_des(cmdlink_cfg, (const void *)u32AddrSrc, (void *)u32AddrDst, u32XferCount, u32XferCount);
+    dma350_cmdlink_set_src_des(cmdlink_cfg, (const void *)u32AddrSrc, (void *)u32AddrDst, u32XferCount * u32LineCount, u32XferCount * u32LineCount);
     dma350_cmdlink_set_xsize16(cmdlink_cfg, (uint16_t)u32XferCount, (uint16_t)u32XferCount);
     dma350_cmdlink_set_transize(cmdlink_cfg, DMA350_CH_TRANSIZE_16BITS);
     dma350_cmdlink_set_xtype(cmdlink_cfg, DMA350_CH_XTYPE_CONTINUE);
-    dma350_cmdlink_set_ytype(cmdlink_cfg, DMA350_CH_YTYPE_DISABLE);
+
+    if (u32LineCount > 1)
+    {
+        /* Source and destination are both fixed, so every line restarts at the same address. */
+        dma350_cmdlink_set_ysize16(cmdlink_cfg, (uint16_t)u32LineCount, (uint16_t)u32LineCount);
+        dma350_cmdlink_set_yaddrstride(cmdlink_cfg, 0, 0);
+        dma350_cmdlink_set_ytype(cmdlink_cfg, DMA350_CH_YTYPE_CONTINUE);
+    }
+    else
+    {
+        dma350_cmdlink_set_ytype(cmdlink_cfg, DMA350_CH_YTYPE_DISABLE);
+    }
+
     dma350_cmdlink_set_xaddrinc(cmdlink_cfg, u16AddrSrcInc, u16AddrDstInc);
     dma350_cmdlink_enable_linkaddr(cmdlink_cfg);
 }
 
-static void disp_gdma_dsc_init(void)
+// Function to initialize the GDMA command chain of an arena
+static void disp_gdma_dsc_init(S_DSC_ARENA *psArena, const S_DISP_TIMING *psTiming)
 {
-
     int i;
     uint16_t *pu16Buf = (uint16_t *)s_pu16BufAddr;
-    S_CMDBUF *next = s_head; // first descriptor.
+    S_DSC_LCD *psDscLCD = psArena->m_psDscLCD;
+    S_CMDBUF *next;
     struct dma350_cmdlink_gencfg_t cmdlink_cfg;
 
+    disp_arena_timing_fill(psArena, psTiming);
+
 #if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
     /* DE only */
     uint32_t u32AddrSrc;
@@ -129,46 +216,50 @@ static void disp_gdma_dsc_init(void)
     uint16_t u16AddrSrcInc;
     uint16_t u16AddrDstInc;
 
-    /* (CONFIG_TIMING_VFP+CONFIG_TIMING_VPW+CONFIG_TIMING_VBP) * (CONFIG_TIMING_HFP+CONFIG_TIMING_HPW+CONFIG_TIMING_HBP+CONFIG_TIMING_HACT) */
+    psArena->m_head = next = &psDscLCD->m_dscDummy; // first descriptor.
+    psArena->m_end = &psDscLCD->m_dscV[psTiming->m_u32VACT - 1].m_dscH[evHStageHACT];
+
+    /* (VFP+VPW+VBP) * (HFP+HPW+HBP+HACT) */
+    /* Issued as (VFP+VPW+VBP) lines of (HFP+HPW+HBP+HACT) units to stay within XSIZE16. */
     u32AddrSrc = (uint32_t)&s_u32DummyData;
     u32AddrDst = CONFIG_DISP_EBI_ADDR;
-    u32XferCount = (CONFIG_TIMING_VFP + CONFIG_TIMING_VPW + CONFIG_TIMING_VBP) * (CONFIG_TIMING_HFP + CONFIG_TIMING_HPW + CONFIG_TIMING_HBP + CONFIG_TIMING_HACT);
+    u32XferCount = psArena->m_au32HTiming[evHStageHFP_HSYNC_HBP] + psTiming->m_u32HACT;
     u16AddrSrcInc = 0;
     u16AddrDstInc = 0;
-    disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, u16AddrSrcInc, u16AddrDstInc);
+    disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, psArena->m_au32VTiming[evVStageVFP_VSYNC_VBP], u16AddrSrcInc, u16AddrDstInc);
     dma350_cmdlink_disable_intr(&cmdlink_cfg, DMA350_CH_INTREN_DONE);
     dma350_cmdlink_set_linkaddr32(&cmdlink_cfg, (uint32_t)(next + 1));
     dma350_cmdlink_generate(&cmdlink_cfg, (uint32_t *)next, (uint32_t *)((uint32_t)next + sizeof(S_CMDBUF) - sizeof(uint32_t)));
     next++;
 
-    for (i = 0; i < CONFIG_TIMING_VACT; i++)
+    for (i = 0; i < psTiming->m_u32VACT; i++)
     {
         /* Front descriptor */
         u32AddrSrc = (uint32_t)&s_u32DummyData;
         u32AddrDst = CONFIG_DISP_EBI_ADDR;
-        u32XferCount = CONFIG_TIMING_HFP + CONFIG_TIMING_HPW + CONFIG_TIMING_HBP;
+        u32XferCount = psArena->m_au32HTiming[evHStageHFP_HSYNC_HBP];
         u16AddrSrcInc = 0;
         u16AddrDstInc = 0;
 
-        disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, u16AddrSrcInc, u16AddrDstInc);
+        disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, 1, u16AddrSrcInc, u16AddrDstInc);
         dma350_cmdlink_disable_intr(&cmdlink_cfg, DMA350_CH_INTREN_DONE);
         dma350_cmdlink_set_linkaddr32(&cmdlink_cfg, (uint32_t)(next + 1));
         dma350_cmdlink_generate(&cmdlink_cfg, (uint32_t *)next, (uint32_t *)((uint32_t)next + sizeof(S_CMDBUF) - sizeof(uint32_t)));
         next++;
 
         /* Backend descriptor */
-        u32AddrSrc = (uint32_t)&pu16Buf[i * CONFIG_TIMING_HACT];
+        u32AddrSrc = (uint32_t)&pu16Buf[i * psTiming->m_u32HACT];
         u32AddrDst = CONFIG_DISP_EBI_ADDR + CONFIG_DISP_DE_ACTIVE;
-        u32XferCount = CONFIG_TIMING_HACT;
+        u32XferCount = psTiming->m_u32HACT;
         u16AddrSrcInc = 1;
         u16AddrDstInc = 0;
 
-        disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, u16AddrSrcInc, u16AddrDstInc);
+        disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, 1, u16AddrSrcInc, u16AddrDstInc);
 
-        if (i == (CONFIG_TIMING_VACT - 1))
+        if (next == psArena->m_end)
         {
             dma350_cmdlink_enable_intr(&cmdlink_cfg, DMA350_CH_INTREN_DONE);
-            dma350_cmdlink_set_linkaddr32(&cmdlink_cfg, (uint32_t)s_head);
+            dma350_cmdlink_set_linkaddr32(&cmdlink_cfg, (uint32_t)psArena->m_head);
         }
         else
         {
@@ -179,21 +270,24 @@ static void disp_gdma_dsc_init(void)
         dma350_cmdlink_generate(&cmdlink_cfg, (uint32_t *)next, (uint32_t *)((uint32_t)next + sizeof(S_CMDBUF) - sizeof(uint32_t)));
         next++;
 
-    } // for(i = 0; i < CONFIG_TIMING_VACT; i++)
+    } // for(i = 0; i < psTiming->m_u32VACT; i++)
 
 #else
 
-    for (i = 0; i < DEF_TOTAL_VLINES; i++)
+    psArena->m_head = next = &psDscLCD->m_dscV[0].m_dscH[0]; // first descriptor.
+    psArena->m_end = &psDscLCD->m_dscV[psArena->m_u32VActIdx + psTiming->m_u32VACT - 1].m_dscH[evHStageCNT - 1];
+
+    for (i = 0; i < (psArena->m_u32VActIdx + psTiming->m_u32VACT); i++)
     {
         E_HSTAGE evH;
-        E_VSTAGE evV = get_current_vstage(i);
+        E_VSTAGE evV = get_current_vstage(psArena->m_au32VTiming, i);
 
         /* Set each VSYNC lines. */
         for (evH = 0; evH < evHStageCNT; evH++)
         {
             uint32_t u32AddrSrc = (uint32_t)&s_u32DummyData;
             uint32_t u32AddrDst;
-            uint32_t u32XferCount = s_au32HTiming[evH];
+            uint32_t u32XferCount = psArena->m_au32HTiming[evH];
             uint16_t u16AddrSrcInc = 0;
             uint16_t u16AddrDstInc = 0;
 
@@ -220,7 +314,7 @@ static void disp_gdma_dsc_init(void)
                     if (evH == evHStageHACT)
                     {
                         u32AddrSrc = (uint32_t)pu16Buf;
-                        pu16Buf = pu16Buf + CONFIG_TIMING_HACT;
+                        pu16Buf = pu16Buf + psTiming->m_u32HACT;
                     }
 
                     u32AddrDst = (evH == evHStageHSYNC) ? (CONFIG_DISP_EBI_ADDR + CONFIG_DISP_HSYNC_ACTIVE) :
@@ -239,12 +333,12 @@ static void disp_gdma_dsc_init(void)
                     break;
             }
 
-            disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, u16AddrSrcInc, u16AddrDstInc);
+            disp_cmdlink_config(&cmdlink_cfg, u32AddrSrc, u32AddrDst, u32XferCount, 1, u16AddrSrcInc, u16AddrDstInc);
 
-            if (next == s_end)
+            if (next == psArena->m_end)
             {
                 dma350_cmdlink_enable_intr(&cmdlink_cfg, DMA350_CH_INTREN_DONE);
-                dma350_cmdlink_set_linkaddr32(&cmdlink_cfg, (uint32_t)s_head);
+                dma350_cmdlink_set_linkaddr32(&cmdlink_cfg, (uint32_t)psArena->m_head);
             }
             else
             {
@@ -258,7 +352,7 @@ static void disp_gdma_dsc_init(void)
 
         } // for (evH = 0; evH < evHStageCNT; evH++)
 
-    } // for (i = 0; i < DEF_TOTAL_VLINES; i++)
+    } // for (i = 0; i < (psArena->m_u32VActIdx + psTiming->m_u32VACT); i++)
 
 #endif
 
@@ -305,10 +399,11 @@ static const char *szGDMADscItemName[] =
 static void disp_gdma_dsc_dump(void)
 {
     int i;
-    S_CMDBUF *next = s_head;
+    S_DSC_ARENA *psArena = &s_asArena[s_i32ArenaCur];
+    S_CMDBUF *next = psArena->m_head;
     struct dma350_cmdlink_gencfg_t *cmdlink_cfg;
 
-    printf("s_head: %08X, s_end: %08X\n", (uint32_t)s_head, (uint32_t)s_end);
+    printf("s_head: %08X, s_end: %08X\n", (uint32_t)psArena->m_head, (uint32_t)psArena->m_end);
 
     do
     {
@@ -367,12 +462,12 @@ static void disp_gdma_dsc_dump(void)
 
         if (tmp_next)
             next = tmp_next;
-    } while (s_head != next);
+    } while (psArena->m_head != next);
 
 }
 
-// Function to find the source address index in the GDMA descriptor
-static uint32_t gdma_dsc_find_srcaddr_index(S_CMDBUF *psCmdBuf)
+// Function to find the index of a register item in the GDMA descriptor
+static uint32_t gdma_dsc_find_item_index(S_CMDBUF *psCmdBuf, uint32_t u32Item)
 {
     int i;
     int n = 0;
@@ -382,14 +477,8 @@ static uint32_t gdma_dsc_find_srcaddr_index(S_CMDBUF *psCmdBuf)
 
     while ((i = nu_ctz(u32HdrVal)) < 32)
     {
-        switch (1 << i)
-        {
-            case DMA350_CMDLINK_SRC_ADDR_SET:     //(0x1UL << 4)
-                return n;
-
-            default:
-                break;
-        }
+        if ((1UL << i) == u32Item)
+            return n;
 
         n++;
         u32HdrVal &= ~(1 << i);
@@ -398,6 +487,42 @@ static uint32_t gdma_dsc_find_srcaddr_index(S_CMDBUF *psCmdBuf)
     return 0xffffffff;
 }
 
+// Function to point the HACT commands of an arena to current VRAM buffer
+static void disp_gdma_dsc_update_vram(S_DSC_ARENA *psArena, int i32Force)
+{
+    S_DSC_LCD *psDscLCD = psArena->m_psDscLCD;
+    const uint32_t *pu32LineTbl = s_pu32LineTbl;
+    uint32_t u32SrcBufAddrIdx = gdma_dsc_find_item_index(&psDscLCD->m_dscV[psArena->m_u32VActIdx].m_dscH[evHStageHACT], DMA350_CMDLINK_SRC_ADDR_SET) + 1;
+
+    if (pu32LineTbl)
+    {
+        int i;
+
+        /* Take each line from the line table. */
+        for (i = 0; i < psArena->m_au32VTiming[evVStageVACT]; i++)
+            psDscLCD->m_dscV[psArena->m_u32VActIdx + i].m_dscH[evHStageHACT].m_cmdbuf[u32SrcBufAddrIdx] = pu32LineTbl[i];
+    }
+    else if (i32Force || (psDscLCD->m_dscV[psArena->m_u32VActIdx].m_dscH[evHStageHACT].m_cmdbuf[u32SrcBufAddrIdx] != (uint32_t)s_pu16BufAddr))
+    {
+        int i;
+
+        /* Switch new VRAM buffer address. */
+        for (i = 0; i < psArena->m_au32VTiming[evVStageVACT]; i++)
+        {
+            /* Update every lines. */
+            psDscLCD->m_dscV[psArena->m_u32VActIdx + i].m_dscH[evHStageHACT].m_cmdbuf[u32SrcBufAddrIdx] = (uint32_t)&s_pu16BufAddr[i * psArena->m_sTiming.m_u32HACT];
+        }
+    }
+}
+
+// Function to redirect the link address of the last command in an arena
+static void disp_gdma_dsc_relink(S_DSC_ARENA *psArena, S_CMDBUF *psNext)
+{
+    uint32_t u32LinkAddrIdx = gdma_dsc_find_item_index(psArena->m_end, DMA350_CMDLINK_LINKADDR_SET) + 1;
+
+    psArena->m_end->m_cmdbuf[u32LinkAddrIdx] = ((uint32_t)psNext & DMA_CH_LINKADDR_LINKADDR_Msk) | DMA_CH_LINKADDR_LINKADDREN_Msk;
+}
+
 // GDMA interrupt handler
 NVT_ITCM void GDMACH1_IRQHandler(void)
 {
@@ -407,37 +532,35 @@ NVT_ITCM void GDMACH1_IRQHandler(void)
     {
         GDMA_CH_DEV_S[1]->cfg.ch_base->CH_STATUS = DMA350_CH_STAT_DONE;
 
-#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
-        uint32_t u32SrcBufAddrIdx = gdma_dsc_find_srcaddr_index(&s_sDscLCD.m_dscV[0].m_dscH[evHStageHACT]) + 1;
-
-        if ((s_sDscLCD.m_dscV[0].m_dscH[evHStageHACT].m_cmdbuf[u32SrcBufAddrIdx] != (uint32_t)s_pu16BufAddr))
+        if (s_i32ArenaNext >= 0)
         {
-            int i;
-
-            /* Switch new VRAM buffer address. */
-            for (i = 0; i < s_au32VTiming[evVStageVACT]; i++)
+            if (!s_i32ArenaLinked)
+            {
+                /* The next frame is already running, so the tail can be relinked safely. */
+                /* The new arena takes over at the end of that frame. */
+                disp_gdma_dsc_relink(&s_asArena[s_i32ArenaCur], s_asArena[s_i32ArenaNext].m_head);
+                s_i32ArenaLinked = 1;
+            }
+            else
             {
-                /* Update every lines. */
-                s_sDscLCD.m_dscV[i].m_dscH[evHStageHACT].m_cmdbuf[u32SrcBufAddrIdx] = (uint32_t)&s_pu16BufAddr[i * CONFIG_TIMING_HACT];
+                /* Last frame of the old arena is done, release it. */
+                s_i32ArenaCur = s_i32ArenaNext;
+                s_i32ArenaNext = -1;
+                s_i32ArenaLinked = 0;
             }
         }
 
-#else
-        uint32_t u32SrcBufAddrIdx = gdma_dsc_find_srcaddr_index(&s_sDscLCD.m_dscV[DEF_VACT_INDEX].m_dscH[evHStageHACT]) + 1;
+        int i32Force = s_i32LineTblReset;
 
-        if ((s_sDscLCD.m_dscV[DEF_VACT_INDEX].m_dscH[evHStageHACT].m_cmdbuf[u32SrcBufAddrIdx] != (uint32_t)s_pu16BufAddr))
-        {
-            int i;
+        s_i32LineTblReset = 0;
 
-            /* Switch new VRAM buffer address. */
-            for (i = 0; i < s_au32VTiming[evVStageVACT]; i++)
-            {
-                /* Update every lines. */
-                s_sDscLCD.m_dscV[DEF_VACT_INDEX + i].m_dscH[evHStageHACT].m_cmdbuf[u32SrcBufAddrIdx] = (uint32_t)&s_pu16BufAddr[i * CONFIG_TIMING_HACT];
-            }
-        }
+        disp_gdma_dsc_update_vram(&s_asArena[s_i32ArenaCur], i32Force);
 
-#endif
+        /* Keep the incoming arena on the same VRAM buffer. */
+        if (s_i32ArenaLinked)
+            disp_gdma_dsc_update_vram(&s_asArena[s_i32ArenaNext], i32Force);
+
+        disp_mem_tick((void *)s_pu16BufAddr);
 
         if (s_DispBlankCb)
             s_DispBlankCb((void *)s_pu16BufAddr);
@@ -448,6 +571,59 @@ NVT_ITCM void GDMACH1_IRQHandler(void)
 
 }
 
+// GDMA interrupt handler of the disp_fill/disp_copy channel, wakes the waiters and runs the disp_copy callback
+NVT_ITCM void GDMACH0_IRQHandler(void)
+{
+    struct dma350_ch_dev_t *psCh = GDMA_CH_DEV_S[DEF_GDMA_FILL_CH];
+    union dma350_ch_status_t status = dma350_ch_get_status(psCh);
+
+    if (status.b.STAT_DONE || status.b.STAT_ERR)
+    {
+        DispCopyCb pfnDone = s_pfnCopyDone;
+
+        psCh->cfg.ch_base->CH_STATUS = DMA350_CH_STAT_DONE | DMA350_CH_STAT_ERR;
+        dma350_ch_disable_intr(psCh, DMA350_CH_INTREN_DONE);
+        dma350_ch_disable_intr(psCh, DMA350_CH_INTREN_ERR);
+        s_pfnCopyDone = NULL;
+        s_u32FillStatus = status.w;
+
+        nu_os_event_set(&s_sEvFill, DEF_GDMA_EV_FILL_DONE);
+
+        if (pfnDone)
+            pfnDone(s_pvCopyUserData);
+    }
+}
+
+// Function to wait for a command on a GDMA channel, the fill channel blocks on its interrupt
+// Overrides the busy-wait of the DMA350 driver used by its DMA350_LIB_EXEC_BLOCKING calls.
+union dma350_ch_status_t dma350_ch_wait_status(struct dma350_ch_dev_t *dev)
+{
+    union dma350_ch_status_t status;
+
+    /* Masked or in an interrupt the done interrupt cannot run. */
+    if ((dev != GDMA_CH_DEV_S[DEF_GDMA_FILL_CH]) || __get_PRIMASK() || __get_IPSR())
+    {
+        while (dma350_ch_is_busy(dev))
+            nu_os_yield();
+
+        return dma350_ch_get_status(dev);
+    }
+
+    s_u32FillStatus = 0;
+    nu_os_event_clear(&s_sEvFill, DEF_GDMA_EV_FILL_DONE);
+
+    /* A command already done still raises the interrupt, its status stays set until cleared. */
+    dma350_ch_enable_intr(dev, DMA350_CH_INTREN_DONE);
+    dma350_ch_enable_intr(dev, DMA350_CH_INTREN_ERR);
+
+    while (!s_u32FillStatus)
+        nu_os_event_wait(&s_sEvFill, DEF_GDMA_EV_FILL_DONE, 0, NU_OS_WAIT_FOREVER);
+
+    status.w = s_u32FillStatus;
+
+    return status;
+}
+
 // Function to initialize GDMA
 static void gdma_init(void)
 {
@@ -466,8 +642,9 @@ static void gdma_init(void)
     dma350_init(&GDMA_DEV_S);
     dma350_set_ch_privileged(&GDMA_DEV_S, 1);
 
-    /* Enable NVIC for GDMA CH1 */
+    /* Enable NVIC for GDMA CH1 and the disp_copy completion on CH0 */
     NVIC_EnableIRQ(GDMACH1_IRQn);
+    NVIC_EnableIRQ(GDMACH0_IRQn);
 
     /* Unlock protected registers */
     if (u32RegLocked)
@@ -483,8 +660,9 @@ static void gdma_fini(void)
     if (u32RegLocked)
         SYS_UnlockReg();
 
-    /* Disable NVIC for GDMA CH1 */
+    /* Disable NVIC for GDMA CH1 and CH0 */
     NVIC_DisableIRQ(GDMACH1_IRQn);
+    NVIC_DisableIRQ(GDMACH0_IRQn);
 
     /* Reset GDMA module */
     SYS_ResetModule(SYS_GDMA0RST);
@@ -500,21 +678,30 @@ static void gdma_fini(void)
 // Function to initialize EBI sync GDMA
 static int disp_sync_gdma_init(void)
 {
-    enum dma350_lib_error_t lib_err;
+    int i;
 
     /* Set the VRAM address by default. */
     s_pu16BufAddr = (uint16_t *)g_au8FrameBuf;
 
+    nu_os_event_init(&s_sEvFill);
+
     /* Enable GDMA module clock and un-mask interrupt. */
     gdma_init();
 
+    for (i = 0; i < DEF_DSC_ARENA_NUM; i++)
+        s_asArena[i].m_psDscLCD = &s_asDscLCD[i];
+
+    s_i32ArenaCur = 0;
+    s_i32ArenaNext = -1;
+    s_i32ArenaLinked = 0;
+
     /* Initial all Lines descriptor-link. */
-    disp_gdma_dsc_init();
+    disp_gdma_dsc_init(&s_asArena[s_i32ArenaCur], &s_sTimingDefault);
     //disp_gdma_dsc_dump();
 
     /* Link to external command */
     dma350_ch_enable_linkaddr(GDMA_CH_DEV_S[1]);
-    dma350_ch_set_linkaddr32(GDMA_CH_DEV_S[1], (uint32_t) s_head);
+    dma350_ch_set_linkaddr32(GDMA_CH_DEV_S[1], (uint32_t) s_asArena[s_i32ArenaCur].m_head);
     dma350_ch_disable_intr(GDMA_CH_DEV_S[1], DMA350_CH_INTREN_DONE);
     dma350_ch_cmd(GDMA_CH_DEV_S[1], DMA350_CH_CMD_ENABLECMD);
 
@@ -526,12 +713,19 @@ static int disp_sync_gdma_fini(void)
     /* Disable GDMA module clock and mask interrupt. */
     gdma_fini();
 
+    /* Mark arenas as unused, disp_set_timing is refused until next init. */
+    s_asArena[s_i32ArenaCur].m_head = NULL;
+    s_i32ArenaNext = -1;
+
     return 0;
 }
 
 // Function to set the VRAM buffer address
 void disp_set_vrambufaddr(void *pvBufAddr)
 {
+    /* Buffer must be powered before it is scanned. */
+    disp_mem_acquire(pvBufAddr);
+
     s_pu16BufAddr = (volatile uint16_t *)pvBufAddr;
 }
 
@@ -547,4 +741,226 @@ void disp_set_blankcb(DispBlankCb f)
     s_DispBlankCb = f;
 }
 
+// Function to set the per-line source address table
+void disp_set_linetbl(const uint32_t *pu32LineAddr)
+{
+    if (!pu32LineAddr && s_pu32LineTbl)
+        s_i32LineTblReset = 1;
+
+    s_pu32LineTbl = pu32LineAddr;
+}
+
+// Function to push a changed rectangle of VRAM to the panel, NULL means the full screen
+int disp_flush(const S_DISP_RECT *psRect)
+{
+    S_DISP_TIMING sTiming;
+    uint32_t y;
+    uint16_t *pu16Buf = (uint16_t *)s_pu16BufAddr;
+
+    disp_get_timing(&sTiming);
+
+    if (!psRect)
+    {
+        /* Flush all pixel data in DCache to memory. */
+        SCB_CleanDCache_by_Addr(pu16Buf, sTiming.m_u32HACT * sTiming.m_u32VACT * sizeof(uint16_t));
+        return 0;
+    }
+    else if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+             ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+    {
+        return -1;
+    }
+
+    /* Scanout picks the rectangle up on its own, only make it visible to DMA. */
+    for (y = psRect->m_u32Y; y < (psRect->m_u32Y + psRect->m_u32H); y++)
+        SCB_CleanDCache_by_Addr(&pu16Buf[y * sTiming.m_u32HACT + psRect->m_u32X], psRect->m_u32W * sizeof(uint16_t));
+
+    return 0;
+}
+
+// Function to fill a rectangle of a buffer with an RGB565 color, NULL rectangle means the whole buffer
+int disp_fill(void *pvBuf, const S_DISP_RECT *psRect, uint16_t u16Color)
+{
+    struct dma350_ch_dev_t *psCh = GDMA_CH_DEV_S[DEF_GDMA_FILL_CH];
+    S_DISP_TIMING sTiming;
+    S_DISP_RECT sRect;
+    uint16_t *pu16Buf = pvBuf ? (uint16_t *)pvBuf : (uint16_t *)s_pu16BufAddr;
+    uint16_t *pu16Dst;
+    enum dma350_ch_transize_t eTranSize;
+    uint32_t u32Shift;
+    uint32_t y;
+
+    if (!pu16Buf || (s_asArena[s_i32ArenaCur].m_head == NULL))
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (psRect)
+    {
+        if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+                ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+            return -1;
+
+        sRect = *psRect;
+    }
+    else
+    {
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = sTiming.m_u32HACT;
+        sRect.m_u32H = sTiming.m_u32VACT;
+    }
+
+    disp_fill_wait();
+
+    if (!sRect.m_u32W || !sRect.m_u32H)
+        return 0;
+
+    disp_mem_acquire(pu16Buf);
+
+    pu16Dst = &pu16Buf[sRect.m_u32Y * sTiming.m_u32HACT + sRect.m_u32X];
+
+    /* Dirty lines in the rectangle must not be written back over the fill. */
+    if (sRect.m_u32W == sTiming.m_u32HACT)
+    {
+        SCB_CleanInvalidateDCache_by_Addr(pu16Dst, sRect.m_u32W * sRect.m_u32H * sizeof(uint16_t));
+    }
+    else
+    {
+        for (y = 0; y < sRect.m_u32H; y++)
+            SCB_CleanInvalidateDCache_by_Addr(&pu16Dst[y * sTiming.m_u32HACT], sRect.m_u32W * sizeof(uint16_t));
+    }
+
+    /* Two pixels per 32-bit beat when every line starts and ends on a word. */
+    if (!((uint32_t)pu16Dst & 0x3) && !(sRect.m_u32W & 1) && !(sTiming.m_u32HACT & 1))
+    {
+        eTranSize = DMA350_CH_TRANSIZE_32BITS;
+        u32Shift = 1;
+    }
+    else
+    {
+        eTranSize = DMA350_CH_TRANSIZE_16BITS;
+        u32Shift = 0;
+    }
+
+    if ((dma350_lib_set_src(psCh, pu16Dst) != DMA350_LIB_ERR_NONE) ||
+            (dma350_lib_set_des(psCh, pu16Dst) != DMA350_LIB_ERR_NONE))
+        return -1;
+
+    /* Source size 0 with FILL type, nothing is read and every beat writes FILLVAL. */
+    dma350_ch_set_xaddr_inc(psCh, 0, 1);
+    dma350_ch_set_xsize16(psCh, 0, (uint16_t)(sRect.m_u32W >> u32Shift));
+    dma350_ch_set_ysize16(psCh, 0, (uint16_t)sRect.m_u32H);
+    dma350_ch_set_yaddrstride(psCh, 0, (uint16_t)(sTiming.m_u32HACT >> u32Shift));
+    dma350_ch_set_transize(psCh, eTranSize);
+    dma350_ch_set_xtype(psCh, DMA350_CH_XTYPE_FILL);
+    dma350_ch_set_ytype(psCh, DMA350_CH_YTYPE_FILL);
+    dma350_ch_set_fill_value(psCh, ((uint32_t)u16Color << 16) | u16Color);
+
+    /* The interrupt only wakes disp_fill_wait, s_pfnCopyDone is NULL between copies. */
+    dma350_ch_enable_intr(psCh, DMA350_CH_INTREN_DONE);
+    dma350_ch_enable_intr(psCh, DMA350_CH_INTREN_ERR);
+
+    dma350_ch_cmd(psCh, DMA350_CH_CMD_ENABLECMD);
+
+    return 0;
+}
+
+// Function to wait for the last disp_fill to finish
+void disp_fill_wait(void)
+{
+    while (dma350_ch_is_busy(GDMA_CH_DEV_S[DEF_GDMA_FILL_CH]))
+    {
+        /* Masked or in an interrupt the done interrupt cannot run, poll instead. */
+        if (!__get_PRIMASK() && !__get_IPSR())
+            nu_os_event_wait(&s_sEvFill, DEF_GDMA_EV_FILL_DONE, 0, NU_OS_WAIT_FOREVER);
+    }
+}
+
+// Function to copy an RGB565 area into a rectangle of a buffer by DMA, pfnDone runs in the DMA interrupt
+int disp_copy(void *pvBuf, const S_DISP_RECT *psRect, const void *pvSrc, uint32_t u32SrcStride, DispCopyCb pfnDone, void *pvUserData)
+{
+    struct dma350_ch_dev_t *psCh = GDMA_CH_DEV_S[DEF_GDMA_FILL_CH];
+    S_DISP_TIMING sTiming;
+    uint16_t *pu16Buf = pvBuf ? (uint16_t *)pvBuf : (uint16_t *)s_pu16BufAddr;
+    uint16_t *pu16Dst;
+    uint32_t y;
+
+    if (!pu16Buf || !psRect || !pvSrc || (u32SrcStride < psRect->m_u32W) || (u32SrcStride > DEF_GDMA_MAX_XSIZE) ||
+            (s_asArena[s_i32ArenaCur].m_head == NULL))
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+            ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+        return -1;
+
+    /* The channel is shared with disp_fill. */
+    disp_fill_wait();
+
+    if (!psRect->m_u32W || !psRect->m_u32H)
+    {
+        if (pfnDone)
+            pfnDone(pvUserData);
+
+        return 0;
+    }
+
+    disp_mem_acquire(pu16Buf);
+
+    pu16Dst = &pu16Buf[psRect->m_u32Y * sTiming.m_u32HACT + psRect->m_u32X];
+
+    /* Dirty lines in the rectangle must not be written back over the copy. */
+    for (y = 0; y < psRect->m_u32H; y++)
+        SCB_CleanInvalidateDCache_by_Addr(&pu16Dst[y * sTiming.m_u32HACT], psRect->m_u32W * sizeof(uint16_t));
+
+    s_pfnCopyDone = pfnDone;
+    s_pvCopyUserData = pvUserData;
+
+    /* One 2D command walks both strides, the done interrupt reports completion. */
+    if (dma350_draw_from_canvas(psCh, pvSrc, pu16Dst,
+                                psRect->m_u32W, (uint16_t)psRect->m_u32H, (uint16_t)u32SrcStride,
+                                psRect->m_u32W, (uint16_t)psRect->m_u32H, (uint16_t)sTiming.m_u32HACT,
+                                DMA350_CH_TRANSIZE_16BITS, DMA350_LIB_TRANSFORM_NONE, DMA350_LIB_EXEC_IRQ) != DMA350_LIB_ERR_NONE)
+    {
+        s_pfnCopyDone = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+// Function to switch the panel timing at a frame boundary without stopping the scanout
+int disp_set_timing(const S_DISP_TIMING *psTiming)
+{
+    int i32ArenaIdx;
+
+    if (!psTiming || (s_asArena[s_i32ArenaCur].m_head == NULL))
+        return -1;
+    else if (disp_timing_check(psTiming) < 0)
+        return -1;
+    else if (s_i32ArenaNext >= 0)
+        return -1;  // Previous switching is not finished yet.
+
+    /* Build the new chain in the idle arena while the current one keeps running. */
+    i32ArenaIdx = (s_i32ArenaCur + 1) % DEF_DSC_ARENA_NUM;
+    disp_gdma_dsc_init(&s_asArena[i32ArenaIdx], psTiming);
+
+    /* Commands must be visible to GDMA before they get linked. */
+    __DSB();
+
+    s_i32ArenaNext = i32ArenaIdx;
+
+    return 0;
+}
+
+// Function to get the panel timing being scanned out
+void disp_get_timing(S_DISP_TIMING *psTiming)
+{
+    if (psTiming)
+        *psTiming = s_asArena[s_i32ArenaCur].m_sTiming;
+}
+
 COMPONENT_EXPORT("DISP_SYNC_GDMA", disp_sync_gdma_init, disp_sync_gdma_fini);
+
+#endif /* !defined(CONFIG_LCD_PANEL_USE_I80) */
@@ -8,12 +8,38 @@
 
 #include "pdma_lib.h"
 #include "disp.h"
+#include "disp_mem.h"
+#include "nu_os.h"
 #include "nu_bitutil.h"
 
+#if !defined(CONFIG_LCD_PANEL_USE_I80)
+
 /*---------------------------------------------------------------------------*/
 /* Define                                                                    */
 /*---------------------------------------------------------------------------*/
 
+// Number of descriptors needed to move 'cnt' units within the TXCNT limit
+#define DEF_PDMA_DSC_NUM(cnt)    (((cnt) + NU_PDMA_MAX_TXCNT - 1) / NU_PDMA_MAX_TXCNT)
+
+#define DEF_PDMA_EV_FILL_DONE    (1UL << 0)
+
+#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
+    #define DEF_PORCH_DSC_NUM    DEF_PDMA_DSC_NUM(CONFIG_TIMING_VPORCH_MAX * (CONFIG_TIMING_HPORCH_MAX + CONFIG_TIMING_HACT))
+#endif
+
+/* The HACT descriptor of each line is patched in place on buffer switching, so it must not be split. */
+#if (CONFIG_TIMING_HACT > NU_PDMA_MAX_TXCNT) || (CONFIG_TIMING_HPORCH_MAX > NU_PDMA_MAX_TXCNT)
+    #error "A horizontal stage exceeds NU_PDMA_MAX_TXCNT."
+#endif
+
+/* disp_fill takes one descriptor per line, or a few for a contiguous full-width fill. */
+#if (((CONFIG_TIMING_HACT * CONFIG_TIMING_VACT / 2) + NU_PDMA_MAX_TXCNT - 1) / NU_PDMA_MAX_TXCNT) > CONFIG_TIMING_VACT
+    #error "s_asDscFill is too small for a full-screen fill."
+#endif
+
+/* One arena is scanned out while the other one is rebuilt by disp_set_timing. */
+#define DEF_DSC_ARENA_NUM        2
+
 // Structure representing the H stage descriptor
 typedef struct
 {
@@ -24,56 +50,56 @@ typedef struct
 typedef struct
 {
 #if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
-    DSCT_T         m_dscDummy;
+    DSCT_T         m_dscDummy[DEF_PORCH_DSC_NUM];
 #endif
     S_DSC_HLINE    m_dscV[DEF_TOTAL_VLINES];
 } S_DSC_LCD;
 
+// Structure representing a descriptor chain and the timing it was built for
+typedef struct
+{
+    S_DSC_LCD       *m_psDscLCD;
+    nu_pdma_desc_t   m_head;
+    nu_pdma_desc_t   m_end;
+    uint32_t         m_u32VActIdx;                  // Index of the first active line in m_dscV
+    uint32_t         m_au32HTiming[evHStageCNT];
+    uint32_t         m_au32VTiming[evVStageCNT];
+    S_DISP_TIMING    m_sTiming;
+} S_DSC_ARENA;
+
 /*---------------------------------------------------------------------------*/
 /* Global variables                                                          */
 /*---------------------------------------------------------------------------*/
 #if defined(NVT_NONCACHEABLE)
-    NVT_NONCACHEABLE static S_DSC_LCD s_sDscLCD;
+    NVT_NONCACHEABLE static S_DSC_LCD s_asDscLCD[DEF_DSC_ARENA_NUM];
+    NVT_NONCACHEABLE static DSCT_T s_asDscFill[CONFIG_TIMING_VACT];
+    NVT_NONCACHEABLE static uint32_t s_u32FillData;     // Fixed source of disp_fill, two RGB565 pixels
 #else
-    static S_DSC_LCD s_sDscLCD;
+    static S_DSC_LCD s_asDscLCD[DEF_DSC_ARENA_NUM];
+    static DSCT_T s_asDscFill[CONFIG_TIMING_VACT];
+    static uint32_t s_u32FillData;
 #endif
 
 uint8_t g_au8FrameBuf[CONFIG_VRAM_TOTAL_ALLOCATED_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE))); // Declare VRAM instance.
 static uint32_t s_u32DummyData = 0xffffffff;
-static nu_pdma_desc_t s_head = (nu_pdma_desc_t) &s_sDscLCD;
-static nu_pdma_desc_t s_end = (nu_pdma_desc_t) &s_sDscLCD + (sizeof(s_sDscLCD) / sizeof(DSCT_T) - 1);
 static volatile uint16_t *s_pu16BufAddr = NULL;
 static DispBlankCb s_DispBlankCb = NULL;
 
-// Array of H timing values
-static const uint32_t s_au32HTiming[evHStageCNT] =
-{
-#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
-    DEF_HACT_INDEX,
-    CONFIG_TIMING_HACT
-#else
-    CONFIG_TIMING_HFP,
-    CONFIG_TIMING_HPW,
-    CONFIG_TIMING_HBP,
-    CONFIG_TIMING_HACT
-#endif
-};
+static S_DSC_ARENA s_asArena[DEF_DSC_ARENA_NUM];
+static volatile int s_i32ArenaCur = 0;       // Arena being scanned out
+static volatile int s_i32ArenaNext = -1;     // Arena waiting for a frame boundary, -1 if none
+static volatile int s_i32ArenaLinked = 0;    // Tail of current arena already links to next arena
+static const uint32_t *volatile s_pu32LineTbl = NULL;  // Per-line source addresses, NULL for linear VRAM
+static volatile int s_i32LineTblReset = 0;   // Linear mapping must be rewritten after leaving the line table
 
-// Array of V timing values
-static const uint32_t s_au32VTiming[evVStageCNT] =
-{
-#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
-    (CONFIG_TIMING_VFP + CONFIG_TIMING_VPW + CONFIG_TIMING_VBP),
-    CONFIG_TIMING_VACT
-#else
-    CONFIG_TIMING_VFP,
-    CONFIG_TIMING_VPW,
-    CONFIG_TIMING_VBP,
-    CONFIG_TIMING_VACT
-#endif
-};
+static const S_DISP_TIMING s_sTimingDefault = DEF_DISP_TIMING_DEFAULT;
 
 static int s_i32Channel = -1;
+static int s_i32FillChannel = -1;
+static volatile int s_i32FillBusy = 0;
+static DispCopyCb s_pfnCopyDone = NULL;        // Completion of the disp_copy in flight
+static void *s_pvCopyUserData = NULL;
+static nu_os_event_t s_sEvFill;                // Set when a disp_fill or disp_copy ends
 
 /*---------------------------------------------------------------------------*/
 /* Functions                                                                 */
@@ -81,9 +107,10 @@ static int s_i32Channel = -1;
 // Function to dump the PDMA descriptors
 static void disp_pdma_dsc_dump(void)
 {
-    nu_pdma_desc_t next = s_head;
+    S_DSC_ARENA *psArena = &s_asArena[s_i32ArenaCur];
+    nu_pdma_desc_t next = psArena->m_head;
 
-    printf("s_head: %08X, s_end: %08X\n", (uint32_t)s_head, (uint32_t)s_end);
+    printf("s_head: %08X, s_end: %08X\n", (uint32_t)psArena->m_head, (uint32_t)psArena->m_end);
 
     do
     {
@@ -92,18 +119,18 @@ static void disp_pdma_dsc_dump(void)
 
         next = (nu_pdma_desc_t)next->NEXT;
 
-    } while (s_head != next);
+    } while (psArena->m_head != next);
 }
 
 // Function to get the current V stage based on the line index
-static E_VSTAGE get_current_vstage(int i32LineIdx)
+static E_VSTAGE get_current_vstage(const uint32_t *pu32VTiming, int i32LineIdx)
 {
     int sum = 0;
     E_VSTAGE i;
 
     for (i = 0; i < evVStageCNT; i++)
     {
-        sum += s_au32VTiming[i];
+        sum += pu32VTiming[i];
 
         if (i32LineIdx < sum)
         {
@@ -114,36 +141,122 @@ static E_VSTAGE get_current_vstage(int i32LineIdx)
     return 0;
 }
 
-// Function to initialize the PDMA descriptors
-static void disp_pdma_dsc_init(void)
+// Function to check a timing against the descriptor arena capacity
+static int disp_timing_check(const S_DISP_TIMING *psTiming)
+{
+    uint32_t u32HPorch = psTiming->m_u32HFP + psTiming->m_u32HPW + psTiming->m_u32HBP;
+    uint32_t u32VPorch = psTiming->m_u32VFP + psTiming->m_u32VPW + psTiming->m_u32VBP;
+
+    if ((psTiming->m_u32HACT == 0) || (psTiming->m_u32HACT > CONFIG_TIMING_HACT))
+        return -1;
+    else if ((psTiming->m_u32VACT == 0) || (psTiming->m_u32VACT > CONFIG_TIMING_VACT))
+        return -1;
+    else if ((u32HPorch > CONFIG_TIMING_HPORCH_MAX) || (u32VPorch > CONFIG_TIMING_VPORCH_MAX))
+        return -1;
+
+#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
+
+    if ((u32HPorch == 0) || (u32VPorch == 0))
+        return -1;
+
+#else
+
+    /* Every stage owns a descriptor, a zero-length stage cannot be expressed. */
+    if (!psTiming->m_u32HFP || !psTiming->m_u32HPW || !psTiming->m_u32HBP ||
+            !psTiming->m_u32VFP || !psTiming->m_u32VPW || !psTiming->m_u32VBP)
+        return -1;
+
+#endif
+
+    return 0;
+}
+
+// Function to derive the H/V stage lengths of an arena from its timing
+static void disp_arena_timing_fill(S_DSC_ARENA *psArena, const S_DISP_TIMING *psTiming)
+{
+    const S_DISP_TIMING *t = psTiming;
+
+    psArena->m_sTiming = *t;
+
+#if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
+    psArena->m_au32HTiming[evHStageHFP_HSYNC_HBP] = t->m_u32HFP + t->m_u32HPW + t->m_u32HBP;
+    psArena->m_au32VTiming[evVStageVFP_VSYNC_VBP] = t->m_u32VFP + t->m_u32VPW + t->m_u32VBP;
+    psArena->m_u32VActIdx = 0;
+#else
+    psArena->m_au32HTiming[evHStageHFP]   = t->m_u32HFP;
+    psArena->m_au32HTiming[evHStageHSYNC] = t->m_u32HPW;
+    psArena->m_au32HTiming[evHStageHBP]   = t->m_u32HBP;
+    psArena->m_au32VTiming[evVStageVFP]   = t->m_u32VFP;
+    psArena->m_au32VTiming[evVStageVSYNC] = t->m_u32VPW;
+    psArena->m_au32VTiming[evVStageVBP]   = t->m_u32VBP;
+    psArena->m_u32VActIdx = t->m_u32VFP + t->m_u32VPW + t->m_u32VBP;
+#endif
+    psArena->m_au32HTiming[evHStageHACT]  = t->m_u32HACT;
+    psArena->m_au32VTiming[evVStageVACT]  = t->m_u32VACT;
+}
+
+// Function to set up a transfer over consecutive descriptors, splitting it at NU_PDMA_MAX_TXCNT
+static nu_pdma_desc_t disp_pdma_dsc_setup_split(nu_pdma_desc_t next, uint32_t u32AddrSrc, uint32_t u32AddrDst, uint32_t u32XferCount, nu_pdma_memctrl_t evMemCtrl)
+{
+    while (u32XferCount > 0)
+    {
+        uint32_t u32TxCnt = (u32XferCount > NU_PDMA_MAX_TXCNT) ? NU_PDMA_MAX_TXCNT : u32XferCount;
+
+        nu_pdma_m2m_desc_setup(next,
+                               16,
+                               u32AddrSrc,
+                               u32AddrDst,
+                               u32TxCnt,
+                               evMemCtrl,
+                               next + 1,
+                               1);
+
+        /* Advance source address for incremented source only. */
+        if ((evMemCtrl == eMemCtl_SrcInc_DstFix) || (evMemCtrl == eMemCtl_SrcInc_DstInc))
+            u32AddrSrc += u32TxCnt * sizeof(uint16_t);
+
+        u32XferCount -= u32TxCnt;
+        next++;
+    }
+
+    return next;
+}
+
+// Function to initialize the PDMA descriptors of an arena
+static void disp_pdma_dsc_init(S_DSC_ARENA *psArena, const S_DISP_TIMING *psTiming)
 {
     int i;
     uint16_t *pu16Buf = (uint16_t *)s_pu16BufAddr;
-    nu_pdma_desc_t next = s_head; // first descriptor.
+    S_DSC_LCD *psDscLCD = psArena->m_psDscLCD;
+    nu_pdma_desc_t next;
+
+    disp_arena_timing_fill(psArena, psTiming);
 
 #if defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
 
     /* DE only */
+    psArena->m_head = next = &psDscLCD->m_dscDummy[0]; // first descriptor.
+
+    /* (VFP+VPW+VBP) * (HFP+HPW+HBP+HACT) */
+    /* Split into DEF_PORCH_DSC_NUM descriptors at most if over NU_PDMA_MAX_TXCNT. */
+    next = disp_pdma_dsc_setup_split(next,
+                                     (uint32_t)&s_u32DummyData,
+                                     CONFIG_DISP_EBI_ADDR,
+                                     psArena->m_au32VTiming[evVStageVFP_VSYNC_VBP] * (psArena->m_au32HTiming[evHStageHFP_HSYNC_HBP] + psTiming->m_u32HACT),
+                                     eMemCtl_SrcFix_DstFix);
+
+    /* Unused porch descriptors are skipped over. */
+    (next - 1)->NEXT = (uint32_t)&psDscLCD->m_dscV[0];
+    next = &psDscLCD->m_dscV[0].m_dscH[0];
 
-    /* (CONFIG_TIMING_VFP+CONFIG_TIMING_VPW+CONFIG_TIMING_VBP) * (CONFIG_TIMING_HFP+CONFIG_TIMING_HPW+CONFIG_TIMING_HBP+CONFIG_TIMING_HACT) */
-    nu_pdma_m2m_desc_setup(next,
-                           16,
-                           (uint32_t)&s_u32DummyData,
-                           CONFIG_DISP_EBI_ADDR,
-                           (CONFIG_TIMING_VFP + CONFIG_TIMING_VPW + CONFIG_TIMING_VBP) * (CONFIG_TIMING_HFP + CONFIG_TIMING_HPW + CONFIG_TIMING_HBP + CONFIG_TIMING_HACT),
-                           eMemCtl_SrcFix_DstFix,
-                           next + 1,
-                           1);
-    next++;
-
-    for (i = 0; i < CONFIG_TIMING_VACT; i++)
+    for (i = 0; i < psTiming->m_u32VACT; i++)
     {
         /* Front descriptor */
         nu_pdma_m2m_desc_setup(next,
                                16,
                                (uint32_t)&s_u32DummyData,
                                CONFIG_DISP_EBI_ADDR,
-                               (CONFIG_TIMING_HFP + CONFIG_TIMING_HPW + CONFIG_TIMING_HBP),
+                               psArena->m_au32HTiming[evHStageHFP_HSYNC_HBP],
                                eMemCtl_SrcFix_DstFix,
                                next + 1,
                                1);
@@ -152,22 +265,24 @@ static void disp_pdma_dsc_init(void)
         /* Backend descriptor */
         nu_pdma_m2m_desc_setup(next,
                                16,
-                               (uint32_t)&pu16Buf[i * CONFIG_TIMING_HACT],
+                               (uint32_t)&pu16Buf[i * psTiming->m_u32HACT],
                                CONFIG_DISP_EBI_ADDR + CONFIG_DISP_DE_ACTIVE,
-                               CONFIG_TIMING_HACT,
+                               psTiming->m_u32HACT,
                                eMemCtl_SrcInc_DstFix,
                                next + 1,
                                1);
         next++;
 
-    } // for(i = 0; i < CONFIG_TIMING_VACT; i++)
+    } // for(i = 0; i < psTiming->m_u32VACT; i++)
 
 #else
 
-    for (i = 0; i < DEF_TOTAL_VLINES; i++)
+    psArena->m_head = next = &psDscLCD->m_dscV[0].m_dscH[0]; // first descriptor.
+
+    for (i = 0; i < (psArena->m_u32VActIdx + psTiming->m_u32VACT); i++)
     {
         E_HSTAGE evH;
-        E_VSTAGE evV = get_current_vstage(i);
+        E_VSTAGE evV = get_current_vstage(psArena->m_au32VTiming, i);
 
         /* Set each VSYNC lines. */
         for (evH = 0; evH < evHStageCNT; evH++)
@@ -175,7 +290,7 @@ static void disp_pdma_dsc_init(void)
             uint32_t u32AddrSrc = (uint32_t)&s_u32DummyData;
             uint32_t u32AddrDst;
             uint32_t u32DataWidth = 16;
-            uint32_t u32XferCount = s_au32HTiming[evH];
+            uint32_t u32XferCount = psArena->m_au32HTiming[evH];
             nu_pdma_memctrl_t evMemCtrl = eMemCtl_SrcFix_DstFix;
 
             switch (evV)
@@ -201,7 +316,7 @@ static void disp_pdma_dsc_init(void)
                     if (evH == evHStageHACT)
                     {
                         u32AddrSrc = (uint32_t)pu16Buf;
-                        pu16Buf = pu16Buf + CONFIG_TIMING_HACT;
+                        pu16Buf = pu16Buf + psTiming->m_u32HACT;
                     }
 
                     u32AddrDst = (evH == evHStageHSYNC) ? (CONFIG_DISP_EBI_ADDR + CONFIG_DISP_HSYNC_ACTIVE) :
@@ -232,15 +347,44 @@ static void disp_pdma_dsc_init(void)
 
         } // for (evH = 0; evH < evHStageCNT; evH++)
 
-    } // for (i = 0; i < DEF_TOTAL_VLINES; i++)
+    } // for (i = 0; i < (psArena->m_u32VActIdx + psTiming->m_u32VACT); i++)
 
 #endif
 
+    psArena->m_end = next - 1;
+
     /* Update NEXT of last descriptor to link head. */
-    s_end->NEXT = (uint32_t)s_head;
+    psArena->m_end->NEXT = (uint32_t)psArena->m_head;
 
     /* Raise a blank-interrupt for switch data buffer if necessary. */
-    s_end->CTL &= ~PDMA_DSCT_CTL_TBINTDIS_Msk;
+    psArena->m_end->CTL &= ~PDMA_DSCT_CTL_TBINTDIS_Msk;
+}
+
+// Function to point the HACT descriptors of an arena to current VRAM buffer
+static void disp_pdma_dsc_update_vram(S_DSC_ARENA *psArena, int i32Force)
+{
+    S_DSC_LCD *psDscLCD = psArena->m_psDscLCD;
+    const uint32_t *pu32LineTbl = s_pu32LineTbl;
+
+    if (pu32LineTbl)
+    {
+        // Take each line from the line table.
+        int i;
+
+        for (i = 0; i < psArena->m_au32VTiming[evVStageVACT]; i++)
+            psDscLCD->m_dscV[psArena->m_u32VActIdx + i].m_dscH[evHStageHACT].SA = pu32LineTbl[i];
+    }
+    else if (i32Force || (psDscLCD->m_dscV[psArena->m_u32VActIdx].m_dscH[evHStageHACT].SA != (uint32_t)s_pu16BufAddr))
+    {
+        // Switch new VRAM buffer address.
+        int i;
+
+        for (i = 0; i < psArena->m_au32VTiming[evVStageVACT]; i++)
+        {
+            /* Update every lines. */
+            psDscLCD->m_dscV[psArena->m_u32VActIdx + i].m_dscH[evHStageHACT].SA = (uint32_t)&s_pu16BufAddr[i * psArena->m_sTiming.m_u32HACT];
+        }
+    }
 }
 
 // Callback function for PDMA transfer completion
@@ -248,26 +392,55 @@ static void nu_pdma_memfun_cb(void *pvUserData, uint32_t u32Events)
 {
     if ((u32Events == NU_PDMA_EVENT_TRANSFER_DONE))
     {
-        if (s_sDscLCD.m_dscV[DEF_VACT_INDEX].m_dscH[evHStageHACT].SA != (uint32_t)s_pu16BufAddr)
+        if (s_i32ArenaNext >= 0)
         {
-            // Switch new VRAM buffer address.
-            int i;
-
-            for (i = 0; i < s_au32VTiming[evVStageVACT]; i++)
+            if (!s_i32ArenaLinked)
             {
-                /* Update every lines. */
-                s_sDscLCD.m_dscV[DEF_VACT_INDEX + i].m_dscH[evHStageHACT].SA = (uint32_t)&s_pu16BufAddr[i * CONFIG_TIMING_HACT];
+                /* The next frame is already running, so the tail can be relinked safely. */
+                /* The new arena takes over at the end of that frame. */
+                s_asArena[s_i32ArenaCur].m_end->NEXT = (uint32_t)s_asArena[s_i32ArenaNext].m_head;
+                s_i32ArenaLinked = 1;
+            }
+            else
+            {
+                /* Last frame of the old arena is done, release it. */
+                s_i32ArenaCur = s_i32ArenaNext;
+                s_i32ArenaNext = -1;
+                s_i32ArenaLinked = 0;
             }
         }
-        else
-        {
-        }
+
+        int i32Force = s_i32LineTblReset;
+
+        s_i32LineTblReset = 0;
+
+        disp_pdma_dsc_update_vram(&s_asArena[s_i32ArenaCur], i32Force);
+
+        /* Keep the incoming arena on the same VRAM buffer. */
+        if (s_i32ArenaLinked)
+            disp_pdma_dsc_update_vram(&s_asArena[s_i32ArenaNext], i32Force);
+
+        disp_mem_tick((void *)s_pu16BufAddr);
 
         if (s_DispBlankCb)
             s_DispBlankCb((void *)s_pu16BufAddr);
     }
 }
 
+// Callback function for disp_fill and disp_copy completion
+static void nu_pdma_fill_cb(void *pvUserData, uint32_t u32Events)
+{
+    DispCopyCb pfnDone = s_pfnCopyDone;
+
+    s_pfnCopyDone = NULL;
+    s_i32FillBusy = 0;
+
+    nu_os_event_set(&s_sEvFill, DEF_PDMA_EV_FILL_DONE);
+
+    if (pfnDone)
+        pfnDone(s_pvCopyUserData);
+}
+
 // Function to initialize the PDMA module
 static void pdma_init(void)
 {
@@ -315,13 +488,19 @@ static void pdma_fini(void)
 // Function to initialize the EBI sync PDMA
 static int disp_sync_pdma_init(void)
 {
-    struct nu_pdma_chn_cb sChnCB;
+    int i;
 
     /* Set the VRAM address by default. */
     s_pu16BufAddr = (uint16_t *)g_au8FrameBuf;
 
     pdma_init();
 
+    /* The NEXT field is a 16-bit offset, all arenas must stay in the same 64KB window. */
+    PDMA_ASSERT(((uint32_t)&s_asDscLCD[0] & ~(NU_PDMA_SG_LIMITED_DISTANCE - 1)) ==
+                (((uint32_t)&s_asDscLCD[DEF_DSC_ARENA_NUM] - 1) & ~(NU_PDMA_SG_LIMITED_DISTANCE - 1)));
+    PDMA_ASSERT(((uint32_t)&s_asDscFill[0] & ~(NU_PDMA_SG_LIMITED_DISTANCE - 1)) ==
+                (((uint32_t)&s_asDscFill[CONFIG_TIMING_VACT] - 1) & ~(NU_PDMA_SG_LIMITED_DISTANCE - 1)));
+
     if (s_i32Channel < 0)
     {
         /* Allocate a PDMA channel resource. */
@@ -331,22 +510,39 @@ static int disp_sync_pdma_init(void)
             return -1;
     }
 
+    for (i = 0; i < DEF_DSC_ARENA_NUM; i++)
+        s_asArena[i].m_psDscLCD = &s_asDscLCD[i];
+
+    s_i32ArenaCur = 0;
+    s_i32ArenaNext = -1;
+    s_i32ArenaLinked = 0;
+
     /* Initial all Lines descriptor-link. */
-    disp_pdma_dsc_init();
+    disp_pdma_dsc_init(&s_asArena[s_i32ArenaCur], &s_sTimingDefault);
 
     /* Dump all Lines descriptor-link. */
     // disp_pdma_dsc_dump();
 
-    /* Register ISR callback function */
-    sChnCB.m_eCBType = eCBType_Event;
-    sChnCB.m_pfnCBHandler = nu_pdma_memfun_cb;
-    sChnCB.m_pvUserData = (void *)NULL;
+    /* Register a direct vector, the blanking work starts right from the PDMA ISR. */
+    nu_pdma_vector_register(s_i32Channel, nu_pdma_memfun_cb, NULL);
 
-    nu_pdma_filtering_set(s_i32Channel, NU_PDMA_EVENT_TRANSFER_DONE);
-    nu_pdma_callback_register(s_i32Channel, &sChnCB);
+    if (s_i32FillChannel < 0)
+    {
+        /* Second channel for disp_fill, so fills never wait for the scanout chain. */
+        s_i32FillChannel = nu_pdma_channel_allocate(PDMA_MEM);
+
+        if (s_i32FillChannel < 0)
+            return -1;
+
+        nu_pdma_channel_memctrl_set(s_i32FillChannel, eMemCtl_SrcFix_DstInc);
+        nu_pdma_vector_register(s_i32FillChannel, nu_pdma_fill_cb, NULL);
+    }
+
+    s_i32FillBusy = 0;
+    nu_os_event_init(&s_sEvFill);
 
     /* Trigger scatter-gather transferring. */
-    return nu_pdma_sg_transfer(s_i32Channel, s_head, 0);
+    return nu_pdma_sg_transfer(s_i32Channel, s_asArena[s_i32ArenaCur].m_head, 0);
 }
 
 // Function to deinitialize the EBI sync PDMA
@@ -360,6 +556,13 @@ static int disp_sync_pdma_fini(void)
         s_i32Channel = -1;
     }
 
+    if (s_i32FillChannel >= 0)
+    {
+        nu_pdma_channel_free(s_i32FillChannel);
+
+        s_i32FillChannel = -1;
+    }
+
     pdma_fini();
 
     return 0;
@@ -368,6 +571,9 @@ static int disp_sync_pdma_fini(void)
 // Function to set the VRAM buffer address
 void disp_set_vrambufaddr(void *pvBufAddr)
 {
+    /* Buffer must be powered before it is scanned. */
+    disp_mem_acquire(pvBufAddr);
+
     s_pu16BufAddr = (volatile uint16_t *)pvBufAddr;
 }
 
@@ -383,4 +589,267 @@ void disp_set_blankcb(DispBlankCb f)
     s_DispBlankCb = f;
 }
 
+// Function to set the per-line source address table
+void disp_set_linetbl(const uint32_t *pu32LineAddr)
+{
+    if (!pu32LineAddr && s_pu32LineTbl)
+        s_i32LineTblReset = 1;
+
+    s_pu32LineTbl = pu32LineAddr;
+}
+
+// Function to push a changed rectangle of VRAM to the panel, NULL means the full screen
+int disp_flush(const S_DISP_RECT *psRect)
+{
+    S_DISP_TIMING sTiming;
+    uint32_t y;
+    uint16_t *pu16Buf = (uint16_t *)s_pu16BufAddr;
+
+    disp_get_timing(&sTiming);
+
+    if (!psRect)
+    {
+        /* Flush all pixel data in DCache to memory. */
+        SCB_CleanDCache_by_Addr(pu16Buf, sTiming.m_u32HACT * sTiming.m_u32VACT * sizeof(uint16_t));
+        return 0;
+    }
+    else if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+             ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+    {
+        return -1;
+    }
+
+    /* Scanout picks the rectangle up on its own, only make it visible to DMA. */
+    for (y = psRect->m_u32Y; y < (psRect->m_u32Y + psRect->m_u32H); y++)
+        SCB_CleanDCache_by_Addr(&pu16Buf[y * sTiming.m_u32HACT + psRect->m_u32X], psRect->m_u32W * sizeof(uint16_t));
+
+    return 0;
+}
+
+// Function to queue one run of disp_fill, odd pixels at either end are written by CPU
+static nu_pdma_desc_t disp_fill_run(nu_pdma_desc_t next, uint16_t *pu16Dst, uint32_t u32Pixels, uint16_t u16Color)
+{
+    uint32_t u32Words;
+
+    if (((uint32_t)pu16Dst & 0x2) && u32Pixels)
+    {
+        *pu16Dst = u16Color;
+        SCB_CleanDCache_by_Addr(pu16Dst, sizeof(uint16_t));
+        pu16Dst++;
+        u32Pixels--;
+    }
+
+    if (u32Pixels & 1)
+    {
+        u32Pixels--;
+        pu16Dst[u32Pixels] = u16Color;
+        SCB_CleanDCache_by_Addr(&pu16Dst[u32Pixels], sizeof(uint16_t));
+    }
+
+    /* The rest goes as 32-bit beats of the doubled pattern. */
+    u32Words = u32Pixels / 2;
+
+    while (u32Words > 0)
+    {
+        uint32_t u32TxCnt = (u32Words > NU_PDMA_MAX_TXCNT) ? NU_PDMA_MAX_TXCNT : u32Words;
+
+        nu_pdma_m2m_desc_setup(next, 32, (uint32_t)&s_u32FillData, (uint32_t)pu16Dst, u32TxCnt, eMemCtl_SrcFix_DstInc, next + 1, 1);
+
+        pu16Dst += u32TxCnt * 2;
+        u32Words -= u32TxCnt;
+        next++;
+    }
+
+    return next;
+}
+
+// Function to fill a rectangle of a buffer with an RGB565 color, NULL rectangle means the whole buffer
+int disp_fill(void *pvBuf, const S_DISP_RECT *psRect, uint16_t u16Color)
+{
+    S_DISP_TIMING sTiming;
+    S_DISP_RECT sRect;
+    uint16_t *pu16Buf = pvBuf ? (uint16_t *)pvBuf : (uint16_t *)s_pu16BufAddr;
+    nu_pdma_desc_t next = &s_asDscFill[0];
+    uint32_t y;
+
+    if ((s_i32FillChannel < 0) || !pu16Buf)
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (psRect)
+    {
+        if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+                ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+            return -1;
+
+        sRect = *psRect;
+    }
+    else
+    {
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = sTiming.m_u32HACT;
+        sRect.m_u32H = sTiming.m_u32VACT;
+    }
+
+    /* Descriptors and pattern are shared with the previous fill. */
+    disp_fill_wait();
+
+    if (!sRect.m_u32W || !sRect.m_u32H)
+        return 0;
+
+    disp_mem_acquire(pu16Buf);
+
+    s_u32FillData = ((uint32_t)u16Color << 16) | u16Color;
+
+    if (sRect.m_u32W == sTiming.m_u32HACT)
+    {
+        /* Full-width lines are contiguous, split only at NU_PDMA_MAX_TXCNT. */
+        next = disp_fill_run(next, &pu16Buf[sRect.m_u32Y * sTiming.m_u32HACT], sRect.m_u32H * sTiming.m_u32HACT, u16Color);
+    }
+    else
+    {
+        for (y = sRect.m_u32Y; y < (sRect.m_u32Y + sRect.m_u32H); y++)
+            next = disp_fill_run(next, &pu16Buf[y * sTiming.m_u32HACT + sRect.m_u32X], sRect.m_u32W, u16Color);
+    }
+
+    if (next == &s_asDscFill[0])
+        return 0;   // CPU wrote the odd pixels, nothing left for DMA.
+
+    s_i32FillBusy = 1;
+
+    if (next == &s_asDscFill[1])
+    {
+        /* A single run is done in basic mode, the channel does not fetch a lone descriptor. */
+        nu_pdma_channel_memctrl_set(s_i32FillChannel, eMemCtl_SrcFix_DstInc);
+
+        return nu_pdma_transfer(s_i32FillChannel, 32, s_asDscFill[0].SA, s_asDscFill[0].DA,
+                                ((s_asDscFill[0].CTL & PDMA_DSCT_CTL_TXCNT_Msk) >> PDMA_DSCT_CTL_TXCNT_Pos) + 1, 0);
+    }
+
+    /* Last descriptor stops the chain and raises the done event. */
+    (next - 1)->CTL = ((next - 1)->CTL & ~PDMA_DSCT_CTL_OPMODE_Msk & ~PDMA_DSCT_CTL_TBINTDIS_Msk) | PDMA_OP_BASIC;
+    (next - 1)->NEXT = 0;
+
+    return nu_pdma_sg_transfer(s_i32FillChannel, &s_asDscFill[0], 0);
+}
+
+// Function to wait for the last disp_fill to finish
+void disp_fill_wait(void)
+{
+    while (s_i32FillBusy)
+    {
+        /* Masked or in an interrupt the done interrupt cannot run, poll instead. */
+        if (!__get_PRIMASK() && !__get_IPSR())
+            nu_os_event_wait(&s_sEvFill, DEF_PDMA_EV_FILL_DONE, 0, NU_OS_WAIT_FOREVER);
+    }
+}
+
+// Function to copy an RGB565 area into a rectangle of a buffer by DMA, pfnDone runs in the DMA interrupt
+int disp_copy(void *pvBuf, const S_DISP_RECT *psRect, const void *pvSrc, uint32_t u32SrcStride, DispCopyCb pfnDone, void *pvUserData)
+{
+    S_DISP_TIMING sTiming;
+    uint16_t *pu16Buf = pvBuf ? (uint16_t *)pvBuf : (uint16_t *)s_pu16BufAddr;
+    const uint16_t *pu16Src = (const uint16_t *)pvSrc;
+    uint16_t *pu16Dst;
+    nu_pdma_desc_t next = &s_asDscFill[0];
+    uint32_t u32DataWidth, u32Count, y;
+
+    if ((s_i32FillChannel < 0) || !pu16Buf || !psRect || !pu16Src || (u32SrcStride < psRect->m_u32W))
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+            ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+        return -1;
+
+    /* Descriptors and channel are shared with disp_fill. */
+    disp_fill_wait();
+
+    if (!psRect->m_u32W || !psRect->m_u32H)
+    {
+        if (pfnDone)
+            pfnDone(pvUserData);
+
+        return 0;
+    }
+
+    disp_mem_acquire(pu16Buf);
+
+    pu16Dst = &pu16Buf[psRect->m_u32Y * sTiming.m_u32HACT + psRect->m_u32X];
+
+    /* Two pixels per 32-bit beat when every line starts and ends on a word. */
+    if (!(((uint32_t)pu16Src | (uint32_t)pu16Dst) & 0x3) && !((psRect->m_u32W | u32SrcStride | sTiming.m_u32HACT) & 1))
+    {
+        u32DataWidth = 32;
+        u32Count = psRect->m_u32W / 2;
+    }
+    else
+    {
+        u32DataWidth = 16;
+        u32Count = psRect->m_u32W;
+    }
+
+    for (y = 0; y < psRect->m_u32H; y++, next++)
+    {
+        /* Dirty lines in the rectangle must not be written back over the copy. */
+        SCB_CleanInvalidateDCache_by_Addr(&pu16Dst[y * sTiming.m_u32HACT], psRect->m_u32W * sizeof(uint16_t));
+
+        nu_pdma_m2m_desc_setup(next, u32DataWidth, (uint32_t)&pu16Src[y * u32SrcStride], (uint32_t)&pu16Dst[y * sTiming.m_u32HACT],
+                               u32Count, eMemCtl_SrcInc_DstInc, next + 1, 1);
+    }
+
+    s_pfnCopyDone = pfnDone;
+    s_pvCopyUserData = pvUserData;
+    s_i32FillBusy = 1;
+
+    if (psRect->m_u32H == 1)
+    {
+        /* A single line is done in basic mode, the channel does not fetch a lone descriptor. */
+        nu_pdma_channel_memctrl_set(s_i32FillChannel, eMemCtl_SrcInc_DstInc);
+
+        return nu_pdma_transfer(s_i32FillChannel, u32DataWidth, s_asDscFill[0].SA, s_asDscFill[0].DA, u32Count, 0);
+    }
+
+    /* Last descriptor stops the chain and raises the done event. */
+    (next - 1)->CTL = ((next - 1)->CTL & ~PDMA_DSCT_CTL_OPMODE_Msk & ~PDMA_DSCT_CTL_TBINTDIS_Msk) | PDMA_OP_BASIC;
+    (next - 1)->NEXT = 0;
+
+    return nu_pdma_sg_transfer(s_i32FillChannel, &s_asDscFill[0], 0);
+}
+
+// Function to switch the panel timing at a frame boundary without stopping the scanout
+int disp_set_timing(const S_DISP_TIMING *psTiming)
+{
+    int i32ArenaIdx;
+
+    if (!psTiming || (s_i32Channel < 0))
+        return -1;
+    else if (disp_timing_check(psTiming) < 0)
+        return -1;
+    else if (s_i32ArenaNext >= 0)
+        return -1;  // Previous switching is not finished yet.
+
+    /* Build the new chain in the idle arena while the current one keeps running. */
+    i32ArenaIdx = (s_i32ArenaCur + 1) % DEF_DSC_ARENA_NUM;
+    disp_pdma_dsc_init(&s_asArena[i32ArenaIdx], psTiming);
+
+    /* Descriptors must be visible to PDMA before they get linked. */
+    __DSB();
+
+    s_i32ArenaNext = i32ArenaIdx;
+
+    return 0;
+}
+
+// Function to get the panel timing being scanned out
+void disp_get_timing(S_DISP_TIMING *psTiming)
+{
+    if (psTiming)
+        *psTiming = s_asArena[s_i32ArenaCur].m_sTiming;
+}
+
 COMPONENT_EXPORT("DISP_SYNC_PDMA", disp_sync_pdma_init, disp_sync_pdma_fini);
+
+#endif /* !defined(CONFIG_LCD_PANEL_USE_I80) */
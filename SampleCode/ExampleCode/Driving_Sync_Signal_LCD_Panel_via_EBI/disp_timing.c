@@ -0,0 +1,72 @@
+/**************************************************************************//**
+ * @file     disp_timing.c
+ * @brief    Panel timing helpers shared by the display backends and their users.
+ *
+ *           The frame period of a sync panel is its pixel slots times the
+ *           EBI write time, so a new period at the same clock, or the same
+ *           period at a new clock, is a matter of frame size. Only front
+ *           porches are changed for it: sync widths and back porches are
+ *           what the panel samples, and the active area is the picture.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <stdint.h>
+#include "disp.h"
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+int disp_timing_scale(const S_DISP_TIMING *psRef, uint32_t u32Num, uint32_t u32Den, uint32_t u32TolPermille, S_DISP_TIMING *psOut)
+{
+    uint32_t u32HFix = psRef->m_u32HACT + psRef->m_u32HPW + psRef->m_u32HBP;
+    uint32_t u32VFix = psRef->m_u32VACT + psRef->m_u32VPW + psRef->m_u32VBP;
+    uint32_t u32HFpMax, u32VFpMax, u32HFp, u32VTotal;
+    uint64_t u64Want, u64Got, u64Err, u64Best = UINT64_MAX;
+
+    *psOut = *psRef;
+
+    if (!u32Den)
+        return -1;
+
+    if (u32Num == u32Den)
+        return 0;
+
+    if (((psRef->m_u32HPW + psRef->m_u32HBP) >= CONFIG_TIMING_HPORCH_MAX) ||
+            ((psRef->m_u32VPW + psRef->m_u32VBP) >= CONFIG_TIMING_VPORCH_MAX))
+        return -1;
+
+    u32HFpMax = CONFIG_TIMING_HPORCH_MAX - psRef->m_u32HPW - psRef->m_u32HBP;
+    u32VFpMax = CONFIG_TIMING_VPORCH_MAX - psRef->m_u32VPW - psRef->m_u32VBP;
+
+    /* Pixel slots per frame wanted. */
+    u64Want = ((uint64_t)(u32HFix + psRef->m_u32HFP) * (u32VFix + psRef->m_u32VFP) * u32Num + u32Den / 2) / u32Den;
+
+    /* Every line length, with the line count closest to the wanted slots. */
+    for (u32HFp = 1; u32HFp <= u32HFpMax; u32HFp++)
+    {
+        u32VTotal = (uint32_t)((u64Want + (u32HFix + u32HFp) / 2) / (u32HFix + u32HFp));
+
+        if ((u32VTotal <= u32VFix) || ((u32VTotal - u32VFix) > u32VFpMax))
+            continue;
+
+        u64Got = (uint64_t)(u32HFix + u32HFp) * u32VTotal;
+        u64Err = (u64Got > u64Want) ? (u64Got - u64Want) : (u64Want - u64Got);
+
+        if (u64Err < u64Best)
+        {
+            u64Best = u64Err;
+            psOut->m_u32HFP = u32HFp;
+            psOut->m_u32VFP = u32VTotal - u32VFix;
+        }
+    }
+
+    if ((u64Best == UINT64_MAX) || ((u64Best * 1000) > (u64Want * u32TolPermille)))
+    {
+        *psOut = *psRef;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**************************************************************************//**
+ * @file     disp_transition.c
+ * @brief    Screen transitions driven by scanout line addresses.
+ *
+ *           Wipe, slide, cover and reveal only pick which VRAM line each
+ *           active line is fetched from, so a frame costs one line table
+ *           update during blanking. Crossfade has no such mapping and is
+ *           blended by the CPU (MVE when available) into a scratch buffer.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "disp_transition.h"
+#include "disp_mem.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_BLEND_BAND_LINES     16     /*!< Lines blended before cleaning them to memory */
+#define DEF_ALPHA_MAX            32     /*!< Alpha of a fully shown new screen */
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static volatile int s_i32Busy = 0;
+static E_DISP_TRANSITION s_evType;
+static const uint16_t *s_pu16From = NULL;
+static const uint16_t *s_pu16To = NULL;
+static uint16_t *s_pu16Scratch = NULL;
+static uint32_t s_u32Frames;
+static uint32_t s_u32FrameIdx;
+static S_DISP_TIMING s_sTiming;
+
+static uint32_t s_au32LineAddr[CONFIG_TIMING_VACT];
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to get the source address of line y in a buffer
+static uint32_t disp_transition_line(const uint16_t *pu16Buf, uint32_t y)
+{
+    return (uint32_t)&pu16Buf[y * s_sTiming.m_u32HACT];
+}
+
+// Function to get the eased progress of current frame in 0~u32Range
+static uint32_t disp_transition_progress(uint32_t u32Range)
+{
+    /* Smoothstep 3t^2 - 2t^3 in Q16. */
+    uint32_t t = (s_u32FrameIdx << 16) / s_u32Frames;
+    uint32_t e = (((t * t) >> 16) * ((3u << 16) - 2 * t)) >> 16;
+
+    return (uint32_t)(((uint64_t)e * u32Range) >> 16);
+}
+
+// Function to fill the line table for the progress p in 0~VACT
+static void disp_transition_linetbl_fill(uint32_t p)
+{
+    uint32_t y;
+    uint32_t u32VACT = s_sTiming.m_u32VACT;
+    uint32_t q = u32VACT - p;
+
+    for (y = 0; y < u32VACT; y++)
+    {
+        uint32_t u32Addr;
+
+        switch (s_evType)
+        {
+            case evTransWipeDown:
+                u32Addr = (y < p) ? disp_transition_line(s_pu16To, y) : disp_transition_line(s_pu16From, y);
+                break;
+
+            case evTransWipeUp:
+                u32Addr = (y >= q) ? disp_transition_line(s_pu16To, y) : disp_transition_line(s_pu16From, y);
+                break;
+
+            case evTransSlideDown:
+                u32Addr = (y < p) ? disp_transition_line(s_pu16To, q + y) : disp_transition_line(s_pu16From, y - p);
+                break;
+
+            case evTransSlideUp:
+                u32Addr = (y < q) ? disp_transition_line(s_pu16From, y + p) : disp_transition_line(s_pu16To, y - q);
+                break;
+
+            case evTransCoverDown:
+                u32Addr = (y < p) ? disp_transition_line(s_pu16To, q + y) : disp_transition_line(s_pu16From, y);
+                break;
+
+            case evTransCoverUp:
+                u32Addr = (y >= q) ? disp_transition_line(s_pu16To, y - q) : disp_transition_line(s_pu16From, y);
+                break;
+
+            case evTransRevealDown:
+                u32Addr = (y < p) ? disp_transition_line(s_pu16To, y) : disp_transition_line(s_pu16From, y - p);
+                break;
+
+            case evTransRevealUp:
+            default:
+                u32Addr = (y < q) ? disp_transition_line(s_pu16From, y + p) : disp_transition_line(s_pu16To, y);
+                break;
+        }
+
+        s_au32LineAddr[y] = u32Addr;
+    }
+}
+
+// Function to blend two RGB565 pixel runs, u32Alpha is the weight of pu16B in 0~32
+void disp_transition_blend(uint16_t *pu16Dst, const uint16_t *pu16A, const uint16_t *pu16B, uint32_t u32Pixels, uint32_t u32Alpha)
+{
+    uint16_t u16Alpha = (uint16_t)u32Alpha;
+    uint16_t u16InvAlpha = (uint16_t)(DEF_ALPHA_MAX - u32Alpha);
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    int32_t n = (int32_t)u32Pixels;
+
+    /* 8 pixels per beat, every channel times 32 still fits in 16-bit lanes. */
+    while (n > 0)
+    {
+        mve_pred16_t p = vctp16q(n);
+        uint16x8_t a = vld1q_z_u16(pu16A, p);
+        uint16x8_t b = vld1q_z_u16(pu16B, p);
+        uint16x8_t r, g, bl;
+
+        r  = vshrq_n_u16(vmlaq_n_u16(vmulq_n_u16(vshrq_n_u16(a, 11), u16InvAlpha), vshrq_n_u16(b, 11), u16Alpha), 5);
+        g  = vshrq_n_u16(vmlaq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(a, 5), vdupq_n_u16(0x3F)), u16InvAlpha),
+                                     vandq_u16(vshrq_n_u16(b, 5), vdupq_n_u16(0x3F)), u16Alpha), 5);
+        bl = vshrq_n_u16(vmlaq_n_u16(vmulq_n_u16(vandq_u16(a, vdupq_n_u16(0x1F)), u16InvAlpha),
+                                     vandq_u16(b, vdupq_n_u16(0x1F)), u16Alpha), 5);
+
+        vst1q_p_u16(pu16Dst, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), bl), p);
+
+        pu16A += 8;
+        pu16B += 8;
+        pu16Dst += 8;
+        n -= 8;
+    }
+
+#else
+    uint32_t i;
+
+    for (i = 0; i < u32Pixels; i++)
+    {
+        /* Spread RGB565 to 0x07E0F81F so the three channels scale in one multiply. */
+        uint32_t a = pu16A[i];
+        uint32_t b = pu16B[i];
+        uint32_t c;
+
+        a = (a | (a << 16)) & 0x07E0F81Fu;
+        b = (b | (b << 16)) & 0x07E0F81Fu;
+        c = ((a * u16InvAlpha + b * u16Alpha) >> 5) & 0x07E0F81Fu;
+
+        pu16Dst[i] = (uint16_t)(c | (c >> 16));
+    }
+
+#endif
+}
+
+// Function to blend current crossfade frame into the scratch buffer
+static void disp_transition_crossfade(uint32_t u32Alpha)
+{
+    uint32_t y;
+    uint32_t u32HACT = s_sTiming.m_u32HACT;
+
+    /* Started at blanking, the blend runs ahead of the beam band by band. */
+    for (y = 0; y < s_sTiming.m_u32VACT; y += DEF_BLEND_BAND_LINES)
+    {
+        uint32_t u32Lines = s_sTiming.m_u32VACT - y;
+        uint32_t u32Offset = y * u32HACT;
+
+        if (u32Lines > DEF_BLEND_BAND_LINES)
+            u32Lines = DEF_BLEND_BAND_LINES;
+
+        disp_transition_blend(&s_pu16Scratch[u32Offset], &s_pu16From[u32Offset], &s_pu16To[u32Offset], u32Lines * u32HACT, u32Alpha);
+
+        /* Flush pixel data in DCache to memory for DMA. */
+        SCB_CleanDCache_by_Addr(&s_pu16Scratch[u32Offset], u32Lines * u32HACT * sizeof(uint16_t));
+    }
+}
+
+// Function to finish current transition on the new screen
+static void disp_transition_finish(void)
+{
+    if (s_evType != evTransCrossfade)
+        disp_set_linetbl(NULL);
+
+    disp_set_vrambufaddr((void *)s_pu16To);
+
+    s_i32Busy = 0;
+}
+
+// Function to advance the running transition, called from the blank callback
+void disp_transition_tick(void)
+{
+    S_DISP_TIMING sTiming;
+
+    if (!s_i32Busy)
+        return;
+
+    /* Timing is switched under us, the latched line layout is stale. */
+    disp_get_timing(&sTiming);
+
+    if ((sTiming.m_u32HACT != s_sTiming.m_u32HACT) || (sTiming.m_u32VACT != s_sTiming.m_u32VACT))
+    {
+        disp_transition_finish();
+        return;
+    }
+
+    /* Both screens are scanned through the line table, keep them powered. */
+    disp_mem_acquire(s_pu16From);
+    disp_mem_acquire(s_pu16To);
+
+    s_u32FrameIdx++;
+
+    if (s_u32FrameIdx >= s_u32Frames)
+    {
+        disp_transition_finish();
+    }
+    else if (s_evType == evTransCrossfade)
+    {
+        disp_transition_crossfade(disp_transition_progress(DEF_ALPHA_MAX));
+    }
+    else
+    {
+        disp_transition_linetbl_fill(disp_transition_progress(s_sTiming.m_u32VACT));
+    }
+}
+
+// Function to set the scratch VRAM buffer used by evTransCrossfade
+void disp_transition_set_scratch(void *pvBuf)
+{
+    s_pu16Scratch = (uint16_t *)pvBuf;
+}
+
+// Function to start a transition from pvFrom to pvTo over u32Frames frames
+int disp_transition_start(E_DISP_TRANSITION evType, void *pvFrom, void *pvTo, uint32_t u32Frames)
+{
+    if (s_i32Busy || (evType >= evTransCNT) || !pvFrom || !pvTo || (u32Frames == 0))
+        return -1;
+    else if ((evType == evTransCrossfade) && !s_pu16Scratch)
+        return -1;
+
+    disp_get_timing(&s_sTiming);
+
+    disp_mem_acquire(pvFrom);
+    disp_mem_acquire(pvTo);
+
+    s_evType = evType;
+    s_pu16From = (const uint16_t *)pvFrom;
+    s_pu16To = (const uint16_t *)pvTo;
+    s_u32Frames = u32Frames;
+    s_u32FrameIdx = 0;
+
+    if (evType == evTransCrossfade)
+    {
+        disp_mem_acquire(s_pu16Scratch);
+        disp_transition_crossfade(0);
+        disp_set_vrambufaddr(s_pu16Scratch);
+    }
+    else
+    {
+        disp_transition_linetbl_fill(0);
+        disp_set_linetbl(s_au32LineAddr);
+    }
+
+    s_i32Busy = 1;
+
+    return 0;
+}
+
+// Function to check whether a transition is running
+int disp_transition_busy(void)
+{
+    return s_i32Busy;
+}
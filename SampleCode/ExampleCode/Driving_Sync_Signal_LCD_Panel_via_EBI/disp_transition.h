@@ -0,0 +1,42 @@
+/**************************************************************************//**
+ * @file     disp_transition.h
+ * @brief    Screen transitions driven by scanout line addresses.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_TRANSITION_H__
+#define __DISP_TRANSITION_H__
+
+#include "disp.h"
+
+typedef enum
+{
+    evTransWipeDown,         /*!< New screen is uncovered from top to bottom */
+    evTransWipeUp,           /*!< New screen is uncovered from bottom to top */
+    evTransSlideDown,        /*!< New screen pushes old screen out of the bottom */
+    evTransSlideUp,          /*!< New screen pushes old screen out of the top */
+    evTransCoverDown,        /*!< New screen slides in from the top over old screen */
+    evTransCoverUp,          /*!< New screen slides in from the bottom over old screen */
+    evTransRevealDown,       /*!< Old screen slides out of the bottom, revealing new screen */
+    evTransRevealUp,         /*!< Old screen slides out of the top, revealing new screen */
+    evTransCrossfade,        /*!< CPU blended crossfade, needs a scratch buffer */
+    evTransCNT               /*!< Number of transitions */
+} E_DISP_TRANSITION;
+
+// Function to set the scratch VRAM buffer used by evTransCrossfade
+void disp_transition_set_scratch(void *pvBuf);
+
+// Function to start a transition from pvFrom to pvTo over u32Frames frames
+int disp_transition_start(E_DISP_TRANSITION evType, void *pvFrom, void *pvTo, uint32_t u32Frames);
+
+// Function to advance the running transition, called from the blank callback
+void disp_transition_tick(void);
+
+// Function to check whether a transition is running
+int disp_transition_busy(void);
+
+// Function to blend two RGB565 pixel runs, u32Alpha is the weight of pu16B in 0~32
+void disp_transition_blend(uint16_t *pu16Dst, const uint16_t *pu16A, const uint16_t *pu16B, uint32_t u32Pixels, uint32_t u32Alpha);
+
+#endif /* __DISP_TRANSITION_H__ */
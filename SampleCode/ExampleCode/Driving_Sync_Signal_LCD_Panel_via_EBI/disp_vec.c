@@ -0,0 +1,873 @@
+/**************************************************************************//**
+ * @file     disp_vec.c
+ * @brief    Anti-aliased vector rasterizer for RGB565 targets.
+ *
+ *           Every primitive becomes one closed outline. Each outline edge
+ *           adds its exact signed area to the cells of a band of lines, and
+ *           a running sum along each line gives the coverage of every pixel.
+ *           Lines are then walked in spans: fully covered ones are filled,
+ *           and the widest such span of consecutive lines is merged into a
+ *           rectangle handed to disp_fill, while edge pixels are blended by
+ *           their coverage eight at a time with MVE.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <math.h>
+#include <string.h>
+#include "disp_vec.h"
+#include "disp_idle.h"
+#include "disp_mem.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_VEC_ACC_STRIDE        (CONFIG_TIMING_HACT + 2)   /* Cells of a line, the edge at the right border spills two */
+#define DEF_VEC_COV_ONE           256                        /* Full coverage */
+#define DEF_VEC_REF_SUBLINES      16                         /* Sub-lines sampled by the reference rasterizer */
+#define DEF_VEC_PI                3.14159265f
+
+typedef struct
+{
+    float m_fX;
+    float m_fY;
+} S_VEC_PT;
+
+typedef struct
+{
+    float m_fX;
+    int32_t m_i32Dir;
+} S_VEC_CROSS;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_VEC_PT s_asPt[CONFIG_DISP_VEC_POINT_NUM];
+static uint32_t s_u32PtNum = 0;
+
+static float s_afAcc[CONFIG_DISP_VEC_BAND_LINES * DEF_VEC_ACC_STRIDE];
+static uint16_t s_au16Cov[CONFIG_TIMING_HACT];
+static S_VEC_CROSS s_asCross[CONFIG_DISP_VEC_POINT_NUM];
+
+/* Solid area growing over consecutive lines, and the ones given to disp_fill. */
+static S_DISP_RECT s_sPend;
+static S_DISP_RECT s_asDma[CONFIG_DISP_VEC_DMA_NUM];
+static uint32_t s_u32DmaNum = 0;
+static int s_i32DmaOk = 0;
+
+static int s_i32Reference = 0;      // Draw through the reference rasterizer, set by disp_vec_bench
+
+static uint32_t s_u32EdgePixels, s_u32SolidPixels, s_u32DmaPixels;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to blend a color into one pixel by a weight in 0~DEF_VEC_COV_ONE
+static uint16_t disp_vec_blend_px(uint32_t u32Dst, uint32_t u32Color, int32_t i32A)
+{
+    int32_t r = (int32_t)(u32Dst >> 11);
+    int32_t g = (int32_t)((u32Dst >> 5) & 0x3F);
+    int32_t b = (int32_t)(u32Dst & 0x1F);
+
+    r += (((int32_t)(u32Color >> 11) - r) * i32A) >> 8;
+    g += (((int32_t)((u32Color >> 5) & 0x3F) - g) * i32A) >> 8;
+    b += (((int32_t)(u32Color & 0x1F) - b) * i32A) >> 8;
+
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Function to blend a color into a run of pixels by their weights
+static void disp_vec_blend(uint16_t *pu16Dst, const uint16_t *pu16A, uint32_t u32Pixels, uint16_t u16Color)
+{
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    int16x8_t cr = vdupq_n_s16((int16_t)(u16Color >> 11));
+    int16x8_t cg = vdupq_n_s16((int16_t)((u16Color >> 5) & 0x3F));
+    int16x8_t cb = vdupq_n_s16((int16_t)(u16Color & 0x1F));
+    int32_t n = (int32_t)u32Pixels;
+
+    /* Channel differences times a weight of at most 256 stay within 16 bits. */
+    while (n > 0)
+    {
+        mve_pred16_t p = vctp16q(n);
+        uint16x8_t px = vld1q_z_u16(pu16Dst, p);
+        int16x8_t a = vreinterpretq_s16_u16(vld1q_z_u16(pu16A, p));
+        int16x8_t r = vreinterpretq_s16_u16(vshrq_n_u16(px, 11));
+        int16x8_t g = vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(px, 5), vdupq_n_u16(0x3F)));
+        int16x8_t b = vreinterpretq_s16_u16(vandq_u16(px, vdupq_n_u16(0x1F)));
+
+        r = vaddq_s16(r, vshrq_n_s16(vmulq_s16(vsubq_s16(cr, r), a), 8));
+        g = vaddq_s16(g, vshrq_n_s16(vmulq_s16(vsubq_s16(cg, g), a), 8));
+        b = vaddq_s16(b, vshrq_n_s16(vmulq_s16(vsubq_s16(cb, b), a), 8));
+
+        px = vorrq_u16(vorrq_u16(vshlq_n_u16(vreinterpretq_u16_s16(r), 11), vshlq_n_u16(vreinterpretq_u16_s16(g), 5)),
+                       vreinterpretq_u16_s16(b));
+        vst1q_p_u16(pu16Dst, px, p);
+
+        pu16Dst += 8;
+        pu16A += 8;
+        n -= 8;
+    }
+
+#else
+    uint32_t i;
+
+    for (i = 0; i < u32Pixels; i++)
+        pu16Dst[i] = disp_vec_blend_px(pu16Dst[i], u16Color, pu16A[i]);
+
+#endif
+}
+
+// Function to fill a run of pixels with a color
+static void disp_vec_solid(uint16_t *pu16Dst, uint32_t u32Pixels, uint16_t u16Color)
+{
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    uint16x8_t c = vdupq_n_u16(u16Color);
+    int32_t n = (int32_t)u32Pixels;
+
+    while (n > 0)
+    {
+        vst1q_p_u16(pu16Dst, c, vctp16q(n));
+        pu16Dst += 8;
+        n -= 8;
+    }
+
+#else
+    uint32_t i;
+
+    for (i = 0; i < u32Pixels; i++)
+        pu16Dst[i] = u16Color;
+
+#endif
+}
+
+// Function to append an outline point in pixels, returns 0 or -1 when the outline is full
+static int disp_vec_point(float fX, float fY)
+{
+    if (s_u32PtNum >= CONFIG_DISP_VEC_POINT_NUM)
+        return -1;
+
+    s_asPt[s_u32PtNum].m_fX = fX;
+    s_asPt[s_u32PtNum].m_fY = fY;
+    s_u32PtNum++;
+
+    return 0;
+}
+
+// Function to get the segments flattening an arc of radius fR over fSweep radians
+static uint32_t disp_vec_arc_segments(float fR, float fSweep, uint32_t u32Max)
+{
+    float fTol = (float)CONFIG_DISP_VEC_FLATTEN_TOL / DISP_VEC_SUBPX;
+    float fStep = (fR > fTol) ? (2.0f * acosf(1.0f - fTol / fR)) : (DEF_VEC_PI / 2.0f);
+    uint32_t u32Seg = (uint32_t)ceilf(fabsf(fSweep) / fStep);
+
+    if (u32Seg < 1)
+        u32Seg = 1;
+
+    return (u32Seg > u32Max) ? u32Max : u32Seg;
+}
+
+// Function to append the points of an arc from fA0 to fA1 radians, both ends included
+static int disp_vec_arc_points(float fCx, float fCy, float fR, float fA0, float fA1, uint32_t u32Seg)
+{
+    uint32_t i;
+
+    for (i = 0; i <= u32Seg; i++)
+    {
+        float fA = fA0 + (fA1 - fA0) * (float)i / (float)u32Seg;
+
+        if (disp_vec_point(fCx + fR * cosf(fA), fCy + fR * sinf(fA)) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+// Function to accumulate the signed area of an edge into a band, x already within 0~u32W
+static void disp_vec_accumulate(float *pfAcc, uint32_t u32W, uint32_t u32H, float fX0, float fY0, float fX1, float fY1)
+{
+    float fDir = 1.0f;
+    float fDxDy, fX, fXNext, fDy, fD, fXa, fXb, fXaf, fXbf, fS, fA0, fA1, fA2, fAm, fXm, fT;
+    int32_t y, y0, y1, i0, i1, i;
+
+    if (fY0 == fY1)
+        return;
+
+    if (fY0 > fY1)
+    {
+        fT = fX0; fX0 = fX1; fX1 = fT;
+        fT = fY0; fY0 = fY1; fY1 = fT;
+        fDir = -1.0f;
+    }
+
+    if ((fY1 <= 0.0f) || (fY0 >= (float)u32H))
+        return;
+
+    fDxDy = (fX1 - fX0) / (fY1 - fY0);
+    fX = fX0;
+
+    if (fY0 < 0.0f)
+    {
+        fX -= fY0 * fDxDy;
+        fY0 = 0.0f;
+    }
+
+    y0 = (int32_t)fY0;
+    y1 = (int32_t)ceilf(fY1);
+
+    if (y1 > (int32_t)u32H)
+        y1 = (int32_t)u32H;
+
+    for (y = y0; y < y1; y++)
+    {
+        float *pfRow = &pfAcc[y * DEF_VEC_ACC_STRIDE];
+
+        fDy = (((float)(y + 1) < fY1) ? (float)(y + 1) : fY1) - (((float)y > fY0) ? (float)y : fY0);
+        fXNext = fX + fDxDy * fDy;
+        fD = fDy * fDir;
+
+        fXa = (fX < fXNext) ? fX : fXNext;
+        fXb = (fX < fXNext) ? fXNext : fX;
+
+        /* Rounding can step just outside the clipped range. */
+        fXa = (fXa < 0.0f) ? 0.0f : ((fXa > (float)u32W) ? (float)u32W : fXa);
+        fXb = (fXb < 0.0f) ? 0.0f : ((fXb > (float)u32W) ? (float)u32W : fXb);
+
+        i0 = (int32_t)fXa;
+        i1 = (int32_t)ceilf(fXb);
+
+        if (i1 <= (i0 + 1))
+        {
+            /* Edge within one cell, its area splits by where its middle is. */
+            fXm = 0.5f * (fXa + fXb) - (float)i0;
+            pfRow[i0] += fD - fD * fXm;
+            pfRow[i0 + 1] += fD * fXm;
+        }
+        else
+        {
+            /* Triangles at both ends, the area in between grows linearly. */
+            fS = 1.0f / (fXb - fXa);
+            fXaf = fXa - (float)i0;
+            fA0 = 0.5f * fS * (1.0f - fXaf) * (1.0f - fXaf);
+            fXbf = fXb - (float)i1 + 1.0f;
+            fAm = 0.5f * fS * fXbf * fXbf;
+
+            pfRow[i0] += fD * fA0;
+
+            if (i1 == (i0 + 2))
+            {
+                pfRow[i0 + 1] += fD * (1.0f - fA0 - fAm);
+            }
+            else
+            {
+                fA1 = fS * (1.5f - fXaf);
+                pfRow[i0 + 1] += fD * (fA1 - fA0);
+
+                for (i = i0 + 2; i < (i1 - 1); i++)
+                    pfRow[i] += fD * fS;
+
+                fA2 = fA1 + (float)(i1 - i0 - 3) * fS;
+                pfRow[i1 - 1] += fD * (1.0f - fA2 - fAm);
+            }
+
+            pfRow[i1] += fD * fAm;
+        }
+
+        fX = fXNext;
+    }
+}
+
+// Function to clip an edge to the columns of a band and accumulate it
+// Left of the band the edge runs down the border, so its cover still reaches every cell; right of it, it is dropped.
+static void disp_vec_edge(float *pfAcc, uint32_t u32W, uint32_t u32H, float fX0, float fY0, float fX1, float fY1)
+{
+    float fW = (float)u32W;
+    float fY;
+
+    if (((fX0 < 0.0f) && (fX1 > 0.0f)) || ((fX0 > 0.0f) && (fX1 < 0.0f)))
+    {
+        fY = fY0 + (fY1 - fY0) * (0.0f - fX0) / (fX1 - fX0);
+        disp_vec_edge(pfAcc, u32W, u32H, fX0, fY0, 0.0f, fY);
+        disp_vec_edge(pfAcc, u32W, u32H, 0.0f, fY, fX1, fY1);
+        return;
+    }
+
+    if ((fX0 <= 0.0f) && (fX1 <= 0.0f))
+        fX0 = fX1 = 0.0f;
+
+    if (((fX0 < fW) && (fX1 > fW)) || ((fX0 > fW) && (fX1 < fW)))
+    {
+        fY = fY0 + (fY1 - fY0) * (fW - fX0) / (fX1 - fX0);
+        disp_vec_edge(pfAcc, u32W, u32H, fX0, fY0, fW, fY);
+        disp_vec_edge(pfAcc, u32W, u32H, fW, fY, fX1, fY1);
+        return;
+    }
+
+    if ((fX0 >= fW) && (fX1 >= fW))
+        return;
+
+    disp_vec_accumulate(pfAcc, u32W, u32H, fX0, fY0, fX1, fY1);
+}
+
+// Function to fill a rectangle of the target by the CPU
+static void disp_vec_solid_rect(const S_DISP_VEC_TARGET *psTgt, const S_DISP_RECT *psRect, uint16_t u16Color)
+{
+    uint32_t y;
+
+    for (y = psRect->m_u32Y; y < (psRect->m_u32Y + psRect->m_u32H); y++)
+        disp_vec_solid(&psTgt->m_pu16Buf[y * psTgt->m_u32Stride + psRect->m_u32X], psRect->m_u32W, u16Color);
+
+    s_u32SolidPixels += psRect->m_u32W * psRect->m_u32H;
+}
+
+// Function to end the solid area growing over lines, large ones are kept for disp_fill
+static void disp_vec_pend_flush(const S_DISP_VEC_TARGET *psTgt, uint16_t u16Color)
+{
+    if (!s_sPend.m_u32H)
+        return;
+
+    if (s_i32DmaOk && ((s_sPend.m_u32W * s_sPend.m_u32H) >= CONFIG_DISP_VEC_DMA_MIN_PIXELS) && (s_u32DmaNum < CONFIG_DISP_VEC_DMA_NUM))
+        s_asDma[s_u32DmaNum++] = s_sPend;
+    else
+        disp_vec_solid_rect(psTgt, &s_sPend, u16Color);
+
+    s_sPend.m_u32H = 0;
+}
+
+// Function to hand the solid areas kept to disp_fill and wait for them
+static void disp_vec_dma_flush(const S_DISP_VEC_TARGET *psTgt, uint32_t u32Y0, uint32_t u32Y1, uint16_t u16Color)
+{
+    int ai32Failed[CONFIG_DISP_VEC_DMA_NUM];
+    uint32_t i, y;
+
+    if (!s_u32DmaNum)
+        return;
+
+    /* Lines the CPU wrote must not be evicted over the DMA data, nor read stale after it. */
+    SCB_CleanInvalidateDCache_by_Addr(&psTgt->m_pu16Buf[u32Y0 * psTgt->m_u32Stride], (int32_t)((u32Y1 - u32Y0) * psTgt->m_u32Stride * sizeof(uint16_t)));
+
+    for (i = 0; i < s_u32DmaNum; i++)
+    {
+        ai32Failed[i] = (disp_fill(psTgt->m_pu16Buf, &s_asDma[i], u16Color) != 0);
+
+        if (!ai32Failed[i])
+            s_u32DmaPixels += s_asDma[i].m_u32W * s_asDma[i].m_u32H;
+    }
+
+    disp_fill_wait();
+
+    for (i = 0; i < s_u32DmaNum; i++)
+    {
+        if (ai32Failed[i])
+            continue;
+
+        for (y = s_asDma[i].m_u32Y; y < (s_asDma[i].m_u32Y + s_asDma[i].m_u32H); y++)
+            SCB_InvalidateDCache_by_Addr(&psTgt->m_pu16Buf[y * psTgt->m_u32Stride + s_asDma[i].m_u32X], (int32_t)(s_asDma[i].m_u32W * sizeof(uint16_t)));
+    }
+
+    /* Not before the invalidation above, which would drop these pixels from the shared cache lines. */
+    for (i = 0; i < s_u32DmaNum; i++)
+    {
+        if (ai32Failed[i])
+            disp_vec_solid_rect(psTgt, &s_asDma[i], u16Color);
+    }
+
+    s_u32DmaNum = 0;
+}
+
+// Function to write one line of weights into the target, spans by coverage
+static void disp_vec_row(const S_DISP_VEC_TARGET *psTgt, uint32_t u32X0, uint32_t u32Y, uint32_t u32W, uint16_t u16Color)
+{
+    uint16_t *pu16Dst = &psTgt->m_pu16Buf[u32Y * psTgt->m_u32Stride + u32X0];
+    uint32_t x, u32Run, u32BestX = 0, u32BestW = 0;
+
+    /* The widest solid span is the one that may continue a rectangle. */
+    if (s_i32DmaOk)
+    {
+        for (x = 0; x < u32W; x += u32Run)
+        {
+            for (u32Run = 1; ((x + u32Run) < u32W) && ((s_au16Cov[x + u32Run] == DEF_VEC_COV_ONE) == (s_au16Cov[x] == DEF_VEC_COV_ONE)); u32Run++);
+
+            if ((s_au16Cov[x] == DEF_VEC_COV_ONE) && (u32Run > u32BestW))
+            {
+                u32BestX = x;
+                u32BestW = u32Run;
+            }
+        }
+
+        if (s_sPend.m_u32H && (s_sPend.m_u32X == (u32X0 + u32BestX)) && (s_sPend.m_u32W == u32BestW) &&
+                ((s_sPend.m_u32Y + s_sPend.m_u32H) == u32Y))
+        {
+            s_sPend.m_u32H++;
+        }
+        else
+        {
+            disp_vec_pend_flush(psTgt, u16Color);
+
+            if (u32BestW)
+            {
+                s_sPend.m_u32X = u32X0 + u32BestX;
+                s_sPend.m_u32Y = u32Y;
+                s_sPend.m_u32W = u32BestW;
+                s_sPend.m_u32H = 1;
+            }
+        }
+    }
+
+    for (x = 0; x < u32W; x += u32Run)
+    {
+        uint32_t u32Cov = s_au16Cov[x];
+
+        if (u32Cov == 0)
+        {
+            for (u32Run = 1; ((x + u32Run) < u32W) && (s_au16Cov[x + u32Run] == 0); u32Run++);
+        }
+        else if (u32Cov == DEF_VEC_COV_ONE)
+        {
+            for (u32Run = 1; ((x + u32Run) < u32W) && (s_au16Cov[x + u32Run] == DEF_VEC_COV_ONE); u32Run++);
+
+            if (!u32BestW || (x != u32BestX))
+            {
+                disp_vec_solid(&pu16Dst[x], u32Run, u16Color);
+                s_u32SolidPixels += u32Run;
+            }
+        }
+        else
+        {
+            for (u32Run = 1; ((x + u32Run) < u32W) && (s_au16Cov[x + u32Run] != 0) && (s_au16Cov[x + u32Run] != DEF_VEC_COV_ONE); u32Run++);
+
+            disp_vec_blend(&pu16Dst[x], &s_au16Cov[x], u32Run, u16Color);
+            s_u32EdgePixels += u32Run;
+        }
+    }
+}
+
+// Function to rasterize the outline with analytic coverage
+static void disp_vec_raster(const S_DISP_VEC_TARGET *psTgt, uint32_t u32X0, uint32_t u32Y0, uint32_t u32X1, uint32_t u32Y1,
+                            uint16_t u16Color, uint32_t u32Alpha)
+{
+    uint32_t u32W = u32X1 - u32X0;
+    uint32_t u32Band, u32Lines, r, x, i;
+
+    for (u32Band = u32Y0; u32Band < u32Y1; u32Band += CONFIG_DISP_VEC_BAND_LINES)
+    {
+        u32Lines = ((u32Y1 - u32Band) < CONFIG_DISP_VEC_BAND_LINES) ? (u32Y1 - u32Band) : CONFIG_DISP_VEC_BAND_LINES;
+
+        for (r = 0; r < u32Lines; r++)
+            memset(&s_afAcc[r * DEF_VEC_ACC_STRIDE], 0, (u32W + 2) * sizeof(float));
+
+        for (i = 0; i < s_u32PtNum; i++)
+        {
+            const S_VEC_PT *psA = &s_asPt[i];
+            const S_VEC_PT *psB = &s_asPt[((i + 1) < s_u32PtNum) ? (i + 1) : 0];
+
+            disp_vec_edge(s_afAcc, u32W, u32Lines, psA->m_fX - (float)u32X0, psA->m_fY - (float)u32Band,
+                          psB->m_fX - (float)u32X0, psB->m_fY - (float)u32Band);
+        }
+
+        for (r = 0; r < u32Lines; r++)
+        {
+            const float *pfRow = &s_afAcc[r * DEF_VEC_ACC_STRIDE];
+            float fSum = 0.0f;
+
+            /* Running sum of the signed areas is the winding-weighted coverage. */
+            for (x = 0; x < u32W; x++)
+            {
+                float fCov;
+
+                fSum += pfRow[x];
+                fCov = fabsf(fSum);
+
+                s_au16Cov[x] = (uint16_t)(((uint32_t)((fCov >= 1.0f) ? DEF_VEC_COV_ONE : (fCov * DEF_VEC_COV_ONE + 0.5f)) * u32Alpha) >> 8);
+            }
+
+            disp_vec_row(psTgt, u32X0, u32Band + r, u32W, u16Color);
+        }
+    }
+}
+
+// Function to rasterize the outline by sampling sub-lines, the reference for disp_vec_bench
+static void disp_vec_raster_ref(const S_DISP_VEC_TARGET *psTgt, uint32_t u32X0, uint32_t u32Y0, uint32_t u32X1, uint32_t u32Y1,
+                                uint16_t u16Color, uint32_t u32Alpha)
+{
+    uint32_t u32W = u32X1 - u32X0;
+    uint32_t y, s, i, j, x, u32Cross;
+    int32_t i32Wind;
+
+    for (y = u32Y0; y < u32Y1; y++)
+    {
+        float *pfCov = s_afAcc;
+
+        memset(pfCov, 0, u32W * sizeof(float));
+
+        for (s = 0; s < DEF_VEC_REF_SUBLINES; s++)
+        {
+            float fYs = (float)y + ((float)s + 0.5f) / DEF_VEC_REF_SUBLINES;
+
+            /* Crossings of the sub-line sorted by x. */
+            for (i = 0, u32Cross = 0; i < s_u32PtNum; i++)
+            {
+                const S_VEC_PT *psA = &s_asPt[i];
+                const S_VEC_PT *psB = &s_asPt[((i + 1) < s_u32PtNum) ? (i + 1) : 0];
+                S_VEC_CROSS sCross;
+
+                if ((psA->m_fY <= fYs) == (psB->m_fY <= fYs))
+                    continue;
+
+                sCross.m_fX = psA->m_fX + (fYs - psA->m_fY) * (psB->m_fX - psA->m_fX) / (psB->m_fY - psA->m_fY) - (float)u32X0;
+                sCross.m_i32Dir = (psB->m_fY > psA->m_fY) ? 1 : -1;
+
+                for (j = u32Cross; (j > 0) && (s_asCross[j - 1].m_fX > sCross.m_fX); j--)
+                    s_asCross[j] = s_asCross[j - 1];
+
+                s_asCross[j] = sCross;
+                u32Cross++;
+            }
+
+            for (i = 0, i32Wind = 0; i < u32Cross; i++)
+            {
+                float fXa, fXb;
+
+                if (i32Wind && i)
+                {
+                    fXa = (s_asCross[i - 1].m_fX < 0.0f) ? 0.0f : s_asCross[i - 1].m_fX;
+                    fXb = (s_asCross[i].m_fX > (float)u32W) ? (float)u32W : s_asCross[i].m_fX;
+
+                    for (x = (uint32_t)fXa; ((float)x < fXb) && (x < u32W); x++)
+                    {
+                        float fL = ((float)x > fXa) ? (float)x : fXa;
+                        float fR = ((float)(x + 1) < fXb) ? (float)(x + 1) : fXb;
+
+                        pfCov[x] += (fR - fL) / DEF_VEC_REF_SUBLINES;
+                    }
+                }
+
+                i32Wind += s_asCross[i].m_i32Dir;
+            }
+        }
+
+        for (x = 0; x < u32W; x++)
+        {
+            uint32_t u32Cov = (pfCov[x] >= 1.0f) ? DEF_VEC_COV_ONE : (uint32_t)(pfCov[x] * DEF_VEC_COV_ONE + 0.5f);
+            uint16_t *pu16Px = &psTgt->m_pu16Buf[y * psTgt->m_u32Stride + u32X0 + x];
+
+            *pu16Px = disp_vec_blend_px(*pu16Px, u16Color, (int32_t)((u32Cov * u32Alpha) >> 8));
+        }
+    }
+}
+
+// Function to fill the outline collected, clipped to the target and its dirty rectangle
+static int disp_vec_fill(const S_DISP_VEC_TARGET *psTgt, uint16_t u16Color, uint8_t u8Alpha)
+{
+    S_DISP_TIMING sTiming;
+    int32_t i32X0, i32Y0, i32X1, i32Y1;
+    uint32_t u32Alpha = (uint32_t)u8Alpha + (u8Alpha >> 7);     // 255 becomes 256
+    float fMinX, fMinY, fMaxX, fMaxY;
+    uint32_t i;
+
+    /* Coverage and accumulation lines are sized for HACT. */
+    if (psTgt->m_u32W > CONFIG_TIMING_HACT)
+        return -1;
+
+    if (s_u32PtNum < 3)
+        return 0;
+
+    fMinX = fMaxX = s_asPt[0].m_fX;
+    fMinY = fMaxY = s_asPt[0].m_fY;
+
+    for (i = 1; i < s_u32PtNum; i++)
+    {
+        fMinX = (s_asPt[i].m_fX < fMinX) ? s_asPt[i].m_fX : fMinX;
+        fMaxX = (s_asPt[i].m_fX > fMaxX) ? s_asPt[i].m_fX : fMaxX;
+        fMinY = (s_asPt[i].m_fY < fMinY) ? s_asPt[i].m_fY : fMinY;
+        fMaxY = (s_asPt[i].m_fY > fMaxY) ? s_asPt[i].m_fY : fMaxY;
+    }
+
+    /* Bounds of the outline within the target and the dirty rectangle. */
+    i32X0 = psTgt->m_psClip ? (int32_t)psTgt->m_psClip->m_u32X : 0;
+    i32Y0 = psTgt->m_psClip ? (int32_t)psTgt->m_psClip->m_u32Y : 0;
+    i32X1 = psTgt->m_psClip ? (int32_t)(psTgt->m_psClip->m_u32X + psTgt->m_psClip->m_u32W) : (int32_t)psTgt->m_u32W;
+    i32Y1 = psTgt->m_psClip ? (int32_t)(psTgt->m_psClip->m_u32Y + psTgt->m_psClip->m_u32H) : (int32_t)psTgt->m_u32H;
+
+    i32X1 = (i32X1 > (int32_t)psTgt->m_u32W) ? (int32_t)psTgt->m_u32W : i32X1;
+    i32Y1 = (i32Y1 > (int32_t)psTgt->m_u32H) ? (int32_t)psTgt->m_u32H : i32Y1;
+    i32X0 = (fMinX > (float)i32X0) ? (int32_t)floorf(fMinX) : i32X0;
+    i32Y0 = (fMinY > (float)i32Y0) ? (int32_t)floorf(fMinY) : i32Y0;
+    i32X1 = (fMaxX < (float)i32X1) ? (int32_t)ceilf(fMaxX) : i32X1;
+    i32Y1 = (fMaxY < (float)i32Y1) ? (int32_t)ceilf(fMaxY) : i32Y1;
+
+    if ((i32X0 >= i32X1) || (i32Y0 >= i32Y1) || !u32Alpha)
+        return 0;
+
+    /* The CPU writes the target, which may be a VRAM buffer in retention. */
+    disp_mem_acquire(psTgt->m_pu16Buf);
+
+    if (s_i32Reference)
+    {
+        disp_vec_raster_ref(psTgt, (uint32_t)i32X0, (uint32_t)i32Y0, (uint32_t)i32X1, (uint32_t)i32Y1, u16Color, u32Alpha);
+        return 0;
+    }
+
+    /* disp_fill works on VRAM-sized buffers and writes the color as it is. */
+    disp_get_timing(&sTiming);
+
+    s_i32DmaOk = psTgt->m_i32Dma && (u32Alpha == DEF_VEC_COV_ONE) && (psTgt->m_u32Stride == sTiming.m_u32HACT) &&
+                 (psTgt->m_u32W <= sTiming.m_u32HACT) && (psTgt->m_u32H <= sTiming.m_u32VACT);
+    s_sPend.m_u32H = 0;
+    s_u32DmaNum = 0;
+
+    disp_vec_raster(psTgt, (uint32_t)i32X0, (uint32_t)i32Y0, (uint32_t)i32X1, (uint32_t)i32Y1, u16Color, u32Alpha);
+
+    disp_vec_pend_flush(psTgt, u16Color);
+    disp_vec_dma_flush(psTgt, (uint32_t)i32Y0, (uint32_t)i32Y1, u16Color);
+
+    return 0;
+}
+
+int disp_vec_line(const S_DISP_VEC_TARGET *psTgt, int32_t i32X0, int32_t i32Y0, int32_t i32X1, int32_t i32Y1,
+                  int32_t i32Width, uint16_t u16Color, uint8_t u8Alpha)
+{
+    float fX0 = (float)i32X0 / DISP_VEC_SUBPX, fY0 = (float)i32Y0 / DISP_VEC_SUBPX;
+    float fX1 = (float)i32X1 / DISP_VEC_SUBPX, fY1 = (float)i32Y1 / DISP_VEC_SUBPX;
+    float fLen, fNx, fNy;
+
+    if (!psTgt || !psTgt->m_pu16Buf || (i32Width <= 0))
+        return -1;
+
+    fLen = sqrtf((fX1 - fX0) * (fX1 - fX0) + (fY1 - fY0) * (fY1 - fY0));
+
+    if (fLen == 0.0f)
+        return 0;
+
+    /* Half the width across the line. */
+    fNx = -(fY1 - fY0) / fLen * (float)i32Width / (2.0f * DISP_VEC_SUBPX);
+    fNy = (fX1 - fX0) / fLen * (float)i32Width / (2.0f * DISP_VEC_SUBPX);
+
+    s_u32PtNum = 0;
+    disp_vec_point(fX0 + fNx, fY0 + fNy);
+    disp_vec_point(fX1 + fNx, fY1 + fNy);
+    disp_vec_point(fX1 - fNx, fY1 - fNy);
+    disp_vec_point(fX0 - fNx, fY0 - fNy);
+
+    return disp_vec_fill(psTgt, u16Color, u8Alpha);
+}
+
+int disp_vec_arc(const S_DISP_VEC_TARGET *psTgt, int32_t i32Cx, int32_t i32Cy, int32_t i32R, int32_t i32Width,
+                 int32_t i32StartDeg10, int32_t i32EndDeg10, uint16_t u16Color, uint8_t u8Alpha)
+{
+    float fCx = (float)i32Cx / DISP_VEC_SUBPX, fCy = (float)i32Cy / DISP_VEC_SUBPX;
+    float fRo = (float)(i32R + i32Width / 2) / DISP_VEC_SUBPX;
+    float fRi = (float)(i32R - i32Width / 2) / DISP_VEC_SUBPX;
+    float fA0 = (float)i32StartDeg10 * DEF_VEC_PI / 1800.0f;
+    float fA1 = (float)i32EndDeg10 * DEF_VEC_PI / 1800.0f;
+    uint32_t u32Seg;
+
+    if (!psTgt || !psTgt->m_pu16Buf || (i32R <= 0) || (i32Width <= 0))
+        return -1;
+
+    if (i32EndDeg10 == i32StartDeg10)
+        return 0;
+
+    /* A full turn at most, so the outline never winds over itself. */
+    if ((fA1 - fA0) > (2.0f * DEF_VEC_PI))
+        fA1 = fA0 + 2.0f * DEF_VEC_PI;
+    else if ((fA0 - fA1) > (2.0f * DEF_VEC_PI))
+        fA1 = fA0 - 2.0f * DEF_VEC_PI;
+
+    /* Outer edge forward, inner edge back, both with the segments the outer one needs. */
+    u32Seg = disp_vec_arc_segments(fRo, fA1 - fA0, (CONFIG_DISP_VEC_POINT_NUM / 2) - 1);
+
+    s_u32PtNum = 0;
+
+    if (disp_vec_arc_points(fCx, fCy, fRo, fA0, fA1, u32Seg) < 0)
+        return -1;
+
+    if (fRi <= 0.0f)
+    {
+        if (disp_vec_point(fCx, fCy) < 0)
+            return -1;
+    }
+    else if (disp_vec_arc_points(fCx, fCy, fRi, fA1, fA0, u32Seg) < 0)
+    {
+        return -1;
+    }
+
+    return disp_vec_fill(psTgt, u16Color, u8Alpha);
+}
+
+int disp_vec_round_rect(const S_DISP_VEC_TARGET *psTgt, int32_t i32X, int32_t i32Y, int32_t i32W, int32_t i32H,
+                        int32_t i32R, uint16_t u16Color, uint8_t u8Alpha)
+{
+    float fX0 = (float)i32X / DISP_VEC_SUBPX, fY0 = (float)i32Y / DISP_VEC_SUBPX;
+    float fX1 = (float)(i32X + i32W) / DISP_VEC_SUBPX, fY1 = (float)(i32Y + i32H) / DISP_VEC_SUBPX;
+    float fR;
+    uint32_t u32Seg;
+
+    if (!psTgt || !psTgt->m_pu16Buf || (i32W <= 0) || (i32H <= 0) || (i32R < 0))
+        return -1;
+
+    i32R = (i32R > (i32W / 2)) ? (i32W / 2) : i32R;
+    i32R = (i32R > (i32H / 2)) ? (i32H / 2) : i32R;
+    fR = (float)i32R / DISP_VEC_SUBPX;
+
+    s_u32PtNum = 0;
+
+    if (i32R == 0)
+    {
+        disp_vec_point(fX0, fY0);
+        disp_vec_point(fX1, fY0);
+        disp_vec_point(fX1, fY1);
+        disp_vec_point(fX0, fY1);
+    }
+    else
+    {
+        /* Quarter turns clockwise from the top right corner. */
+        u32Seg = disp_vec_arc_segments(fR, DEF_VEC_PI / 2.0f, (CONFIG_DISP_VEC_POINT_NUM / 4) - 1);
+
+        if ((disp_vec_arc_points(fX1 - fR, fY0 + fR, fR, -DEF_VEC_PI / 2.0f, 0.0f, u32Seg) < 0) ||
+                (disp_vec_arc_points(fX1 - fR, fY1 - fR, fR, 0.0f, DEF_VEC_PI / 2.0f, u32Seg) < 0) ||
+                (disp_vec_arc_points(fX0 + fR, fY1 - fR, fR, DEF_VEC_PI / 2.0f, DEF_VEC_PI, u32Seg) < 0) ||
+                (disp_vec_arc_points(fX0 + fR, fY0 + fR, fR, DEF_VEC_PI, DEF_VEC_PI * 1.5f, u32Seg) < 0))
+            return -1;
+    }
+
+    return disp_vec_fill(psTgt, u16Color, u8Alpha);
+}
+
+int disp_vec_polygon(const S_DISP_VEC_TARGET *psTgt, const S_DISP_VEC_POINT *psPoints, uint32_t u32Num,
+                     uint16_t u16Color, uint8_t u8Alpha)
+{
+    uint32_t i;
+
+    if (!psTgt || !psTgt->m_pu16Buf || !psPoints || (u32Num > CONFIG_DISP_VEC_POINT_NUM))
+        return -1;
+
+    s_u32PtNum = 0;
+
+    for (i = 0; i < u32Num; i++)
+        disp_vec_point((float)psPoints[i].m_i32X / DISP_VEC_SUBPX, (float)psPoints[i].m_i32Y / DISP_VEC_SUBPX);
+
+    return disp_vec_fill(psTgt, u16Color, u8Alpha);
+}
+
+// Function to draw the benchmark gauge, returns the number of primitives
+static uint32_t disp_vec_bench_scene(const S_DISP_VEC_TARGET *psTgt)
+{
+    S_DISP_VEC_POINT asNeedle[3];
+    int32_t i32Cx = DISP_VEC_PX(psTgt->m_u32W) / 2;
+    int32_t i32Cy = DISP_VEC_PX(psTgt->m_u32H) / 2;
+    int32_t i32R = ((psTgt->m_u32W < psTgt->m_u32H) ? DISP_VEC_PX(psTgt->m_u32W) : DISP_VEC_PX(psTgt->m_u32H)) * 2 / 5;
+    uint32_t u32Prims = 0;
+    int32_t i;
+
+    disp_vec_round_rect(psTgt, DISP_VEC_PX(4), DISP_VEC_PX(4), DISP_VEC_PX(psTgt->m_u32W - 8), DISP_VEC_PX(psTgt->m_u32H - 8),
+                        DISP_VEC_PX(12), 0x2104, 255);
+    u32Prims++;
+
+    /* Track and value arcs over 270 degrees. */
+    disp_vec_arc(psTgt, i32Cx, i32Cy, i32R, DISP_VEC_PX(12), 1350, 4050, 0x4208, 255);
+    disp_vec_arc(psTgt, i32Cx, i32Cy, i32R, DISP_VEC_PX(12), 1350, 3300, 0xFD20, 255);
+    u32Prims += 2;
+
+    for (i = 0; i <= 27; i++)
+    {
+        float fA = (float)(1350 + i * 100) * DEF_VEC_PI / 1800.0f;
+        float fC = cosf(fA), fS = sinf(fA);
+        int32_t i32In = i32R - DISP_VEC_PX((i % 3) ? 18 : 26);
+        int32_t i32Out = i32R - DISP_VEC_PX(10);
+
+        disp_vec_line(psTgt, i32Cx + (int32_t)(fC * i32In), i32Cy + (int32_t)(fS * i32In),
+                      i32Cx + (int32_t)(fC * i32Out), i32Cy + (int32_t)(fS * i32Out), DISP_VEC_PX(2), 0xFFFF, 255);
+        u32Prims++;
+    }
+
+    /* Translucent needle over a hub. */
+    asNeedle[0].m_i32X = i32Cx + (int32_t)(cosf(1.0f) * (i32R - DISP_VEC_PX(20)));
+    asNeedle[0].m_i32Y = i32Cy + (int32_t)(sinf(1.0f) * (i32R - DISP_VEC_PX(20)));
+    asNeedle[1].m_i32X = i32Cx + (int32_t)(cosf(1.0f + DEF_VEC_PI / 2.0f) * DISP_VEC_PX(6));
+    asNeedle[1].m_i32Y = i32Cy + (int32_t)(sinf(1.0f + DEF_VEC_PI / 2.0f) * DISP_VEC_PX(6));
+    asNeedle[2].m_i32X = i32Cx - (int32_t)(cosf(1.0f + DEF_VEC_PI / 2.0f) * DISP_VEC_PX(6));
+    asNeedle[2].m_i32Y = i32Cy - (int32_t)(sinf(1.0f + DEF_VEC_PI / 2.0f) * DISP_VEC_PX(6));
+
+    disp_vec_polygon(psTgt, asNeedle, 3, 0xF800, 200);
+    disp_vec_round_rect(psTgt, i32Cx - DISP_VEC_PX(10), i32Cy - DISP_VEC_PX(10), DISP_VEC_PX(20), DISP_VEC_PX(20),
+                        DISP_VEC_PX(10), 0xC618, 255);
+    u32Prims += 2;
+
+    return u32Prims;
+}
+
+int disp_vec_bench(const S_DISP_VEC_TARGET *psTgt, uint16_t *pu16Scratch, S_DISP_VEC_BENCH *psBench)
+{
+    S_DISP_VEC_TARGET sRef;
+    S_DISP_IDLE_STATS sIdle;
+    uint32_t u32Start, u32FrameUs, x, y;
+
+    if (!psTgt || !psTgt->m_pu16Buf || !pu16Scratch || !psBench || (psTgt->m_u32W > CONFIG_TIMING_HACT) ||
+            (psTgt->m_u32W < 32) || (psTgt->m_u32H < 32))
+        return -1;
+
+    memset(psBench, 0, sizeof(S_DISP_VEC_BENCH));
+
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    s_u32EdgePixels = s_u32SolidPixels = s_u32DmaPixels = 0;
+
+    u32Start = DWT->CYCCNT;
+    psBench->m_u32Prims = disp_vec_bench_scene(psTgt);
+    psBench->m_u32Cycles = DWT->CYCCNT - u32Start;
+
+    psBench->m_u32EdgePixels = s_u32EdgePixels;
+    psBench->m_u32SolidPixels = s_u32SolidPixels;
+    psBench->m_u32DmaPixels = s_u32DmaPixels;
+
+    sRef = *psTgt;
+    sRef.m_pu16Buf = pu16Scratch;
+    sRef.m_i32Dma = 0;
+    s_i32Reference = 1;
+
+    u32Start = DWT->CYCCNT;
+    disp_vec_bench_scene(&sRef);
+    psBench->m_u32RefCycles = DWT->CYCCNT - u32Start;
+
+    s_i32Reference = 0;
+
+    /* Measured refresh period if the idle manager has one, else 60Hz. */
+    disp_idle_get_stats(&sIdle);
+    u32FrameUs = sIdle.m_u32FrameUs ? sIdle.m_u32FrameUs : 16667;
+
+    if (psBench->m_u32Cycles)
+        psBench->m_u32PrimsPerFrame = (uint32_t)(((uint64_t)psBench->m_u32Prims * (SystemCoreClock / 1000000UL) * u32FrameUs) / psBench->m_u32Cycles);
+
+    for (y = 0; y < psTgt->m_u32H; y++)
+    {
+        for (x = 0; x < psTgt->m_u32W; x++)
+        {
+            uint32_t a = psTgt->m_pu16Buf[y * psTgt->m_u32Stride + x];
+            uint32_t b = pu16Scratch[y * psTgt->m_u32Stride + x];
+            int32_t i32DR = ((int32_t)(a >> 11) - (int32_t)(b >> 11)) * 2;
+            int32_t i32DG = (int32_t)((a >> 5) & 0x3F) - (int32_t)((b >> 5) & 0x3F);
+            int32_t i32DB = ((int32_t)(a & 0x1F) - (int32_t)(b & 0x1F)) * 2;
+            uint32_t u32Diff;
+
+            i32DR = (i32DR < 0) ? -i32DR : i32DR;
+            i32DG = (i32DG < 0) ? -i32DG : i32DG;
+            i32DB = (i32DB < 0) ? -i32DB : i32DB;
+
+            u32Diff = (uint32_t)((i32DR > i32DG) ? ((i32DR > i32DB) ? i32DR : i32DB) : ((i32DG > i32DB) ? i32DG : i32DB));
+
+            if (u32Diff > psBench->m_u32MaxDiff)
+                psBench->m_u32MaxDiff = u32Diff;
+
+            if (u32Diff > 2)
+                psBench->m_u32Mismatches++;
+        }
+    }
+
+    return 0;
+}
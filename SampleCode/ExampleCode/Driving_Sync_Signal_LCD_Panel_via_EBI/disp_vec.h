@@ -0,0 +1,80 @@
+/**************************************************************************//**
+ * @file     disp_vec.h
+ * @brief    Anti-aliased vector rasterizer for RGB565 targets.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __DISP_VEC_H__
+#define __DISP_VEC_H__
+
+#include "disp.h"
+
+#define CONFIG_DISP_VEC_POINT_NUM          512   /*!< Outline points of one primitive, arcs are flattened to fit */
+#define CONFIG_DISP_VEC_BAND_LINES           8   /*!< Lines accumulated at once, the buffer holds (HACT+2) floats per line */
+#define CONFIG_DISP_VEC_FLATTEN_TOL          2   /*!< Largest distance of a flattened arc from the true one, in 1/16 pixel */
+#define CONFIG_DISP_VEC_DMA_MIN_PIXELS    2048   /*!< Solid areas from this size go to disp_fill, smaller ones to the CPU */
+#define CONFIG_DISP_VEC_DMA_NUM              8   /*!< Solid areas of one primitive given to disp_fill */
+
+#define DISP_VEC_SUBPX                      16   /*!< Coordinates are in 1/16 pixel */
+#define DISP_VEC_PX(v)                      ((int32_t)((v) * DISP_VEC_SUBPX))
+
+typedef struct
+{
+    int32_t m_i32X;                 /*!< Column in 1/DISP_VEC_SUBPX pixel */
+    int32_t m_i32Y;                 /*!< Line in 1/DISP_VEC_SUBPX pixel */
+} S_DISP_VEC_POINT;
+
+typedef struct
+{
+    uint16_t *m_pu16Buf;            /*!< RGB565 pixels */
+    uint32_t m_u32Stride;           /*!< Pixels per line */
+    uint32_t m_u32W;                /*!< Width, at most CONFIG_TIMING_HACT */
+    uint32_t m_u32H;                /*!< Height */
+    const S_DISP_RECT *m_psClip;    /*!< Dirty rectangle drawn into, NULL for the whole target */
+    int m_i32Dma;                   /*!< Opaque solid areas may go to disp_fill, the target then has to lie in a
+                                         VRAM-sized buffer with HACT stride and the fill engine must be free */
+} S_DISP_VEC_TARGET;
+
+typedef struct
+{
+    uint32_t m_u32Prims;            /*!< Primitives in the benchmark scene */
+    uint32_t m_u32Cycles;           /*!< Cycles of the scene */
+    uint32_t m_u32RefCycles;        /*!< Cycles of the scene through the reference rasterizer */
+    uint32_t m_u32PrimsPerFrame;    /*!< Primitives fitting in one refresh period */
+    uint32_t m_u32EdgePixels;       /*!< Pixels blended by coverage */
+    uint32_t m_u32SolidPixels;      /*!< Pixels filled by the CPU */
+    uint32_t m_u32DmaPixels;        /*!< Pixels filled by disp_fill */
+    uint32_t m_u32MaxDiff;          /*!< Largest channel difference to the reference, in G6 steps */
+    uint32_t m_u32Mismatches;       /*!< Pixels differing from the reference by more than one R5/B5 or two G6 steps */
+} S_DISP_VEC_BENCH;
+
+/* Primitives are filled with the non-zero rule and alpha 0~255 on top of the coverage, and return 0 or
+   -1 on bad arguments, a target wider than CONFIG_TIMING_HACT or too many outline points. The CPU writes the target, clean it before a DMA or
+   the scanout reads it. Pixels outside the clip rectangle are never touched, so a dirty rectangle
+   redrawn in pieces matches one drawn at once. Coverage is the winding-weighted area, which only exceeds
+   the non-zero one in pixels where an outline crossing itself winds twice next to the outside. */
+
+// Function to draw a line of i32Width with butt ends
+int disp_vec_line(const S_DISP_VEC_TARGET *psTgt, int32_t i32X0, int32_t i32Y0, int32_t i32X1, int32_t i32Y1,
+                  int32_t i32Width, uint16_t u16Color, uint8_t u8Alpha);
+
+// Function to draw an arc of radius i32R and i32Width around its center line
+// Angles are in 1/10 degree, 0 pointing right and growing clockwise on screen. A width of twice the radius draws a pie.
+int disp_vec_arc(const S_DISP_VEC_TARGET *psTgt, int32_t i32Cx, int32_t i32Cy, int32_t i32R, int32_t i32Width,
+                 int32_t i32StartDeg10, int32_t i32EndDeg10, uint16_t u16Color, uint8_t u8Alpha);
+
+// Function to fill a rectangle with corners rounded by i32R, a radius of half the size draws a circle
+int disp_vec_round_rect(const S_DISP_VEC_TARGET *psTgt, int32_t i32X, int32_t i32Y, int32_t i32W, int32_t i32H,
+                        int32_t i32R, uint16_t u16Color, uint8_t u8Alpha);
+
+// Function to fill a closed polygon
+int disp_vec_polygon(const S_DISP_VEC_TARGET *psTgt, const S_DISP_VEC_POINT *psPoints, uint32_t u32Num,
+                     uint16_t u16Color, uint8_t u8Alpha);
+
+// Function to time a gauge scene and compare it with the reference rasterizer, returns 0 or -1
+// The rasterizer draws into psTgt and the reference, which samples 16 sub-lines per line, into pu16Scratch
+// laid out the same way and holding the same pixels beforehand.
+int disp_vec_bench(const S_DISP_VEC_TARGET *psTgt, uint16_t *pu16Scratch, S_DISP_VEC_BENCH *psBench);
+
+#endif /* __DISP_VEC_H__ */
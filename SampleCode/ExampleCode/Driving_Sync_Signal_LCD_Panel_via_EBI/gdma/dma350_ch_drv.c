@@ -15,6 +15,7 @@
  */
 
 #include "dma350_ch_drv.h"
+#include "nu_os.h"
 
 #include <stddef.h>
 #include <stdint.h>
@@ -101,10 +102,12 @@ void dma350_cmdlink_init(struct dma350_cmdlink_gencfg_t *cmdlink_cfg)
     *cmdlink_cfg = default_cmdlink;
 }
 
-union dma350_ch_status_t dma350_ch_wait_status(struct dma350_ch_dev_t *dev)
+__WEAK union dma350_ch_status_t dma350_ch_wait_status(struct dma350_ch_dev_t *dev)
 {
-    /* Reference implementation with busy wait */
-    while (dma350_ch_is_busy(dev));
+    /* Reference implementation with busy wait, a driver owning the channel
+     * interrupt may override it to block instead */
+    while (dma350_ch_is_busy(dev))
+        nu_os_yield();
 
     return dma350_ch_get_status(dev);
 }
@@ -0,0 +1,1026 @@
+/**************************************************************************//**
+ * @file     jpeg_dec.c
+ * @brief    Baseline JPEG decoder writing RGB565 bands straight into VRAM.
+ *
+ *           One MCU row is decoded per band: huffman decode, islow IDCT
+ *           and YCbCr to RGB565 go MCU by MCU into the destination, so no
+ *           intermediate image is kept. All working state, tables and
+ *           sample buffers, is about 5 KB in DTCM. The IDCT and colour
+ *           conversion use MVE when available.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "jpeg_dec.h"
+#include "disp_mem.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+    #include <arm_mve.h>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_JPEG_MAX_COMP         3     /*!< Y, Cb and Cr */
+#define DEF_JPEG_MAX_HUFF         2     /*!< Baseline tables per class */
+
+/* islow IDCT in 13 bit fixed point with 2 extra bits between the passes. */
+#define DEF_IDCT_CONST_BITS      13
+#define DEF_IDCT_PASS1_BITS       2
+#define FIX_0_298631336        2446
+#define FIX_0_390180644        3196
+#define FIX_0_541196100        4433
+#define FIX_0_765366865        6270
+#define FIX_0_899976223        7373
+#define FIX_1_175875602        9633
+#define FIX_1_501321110       12299
+#define FIX_1_847759065       15137
+#define FIX_1_961570560       16069
+#define FIX_2_053119869       16819
+#define FIX_2_562915447       20995
+#define FIX_3_072711026       25172
+
+/* YCbCr to RGB in Q16. */
+#define FIX_CR_R              91881
+#define FIX_CB_G              22554
+#define FIX_CR_G              46802
+#define FIX_CB_B             116130
+
+#define DESCALE(x, n)          (((x) + (1 << ((n) - 1))) >> (n))
+
+typedef struct
+{
+    uint16_t m_au16Fast[256];       /*!< (length << 8) | symbol by the next 8 bits, 0 for longer codes */
+    int32_t  m_ai32MaxCode[17];     /*!< Largest code of each length, -1 for none */
+    int32_t  m_ai32ValOff[17];      /*!< Symbol index minus the first code of each length */
+    uint8_t  m_au8Val[256];         /*!< Symbols in code order */
+} S_JPEG_HUFF;
+
+typedef struct
+{
+    uint8_t m_u8Id;                 /*!< Component ID of the frame header */
+    uint8_t m_u8H;                  /*!< Horizontal sampling factor */
+    uint8_t m_u8V;                  /*!< Vertical sampling factor */
+    uint8_t m_u8Tq;                 /*!< Quantization table */
+    uint8_t m_u8Td;                 /*!< DC huffman table */
+    uint8_t m_u8Ta;                 /*!< AC huffman table */
+    int32_t m_i32Pred;              /*!< DC predictor */
+} S_JPEG_COMP;
+
+typedef struct
+{
+    S_JPEG_HUFF m_asDc[DEF_JPEG_MAX_HUFF];
+    S_JPEG_HUFF m_asAc[DEF_JPEG_MAX_HUFF];
+    uint16_t    m_au16Quant[4][64];         /*!< Natural order */
+    S_JPEG_COMP m_asComp[DEF_JPEG_MAX_COMP];
+    uint8_t     m_au8ScanComp[DEF_JPEG_MAX_COMP];   /*!< Frame component of each scan component */
+    int16_t     m_ai16Blk[64];
+    int32_t     m_ai32Work[64];
+    uint8_t     m_au8Y[16 * 16];
+    uint8_t     m_au8Cb[8 * 8];
+    uint8_t     m_au8Cr[8 * 8];
+
+    /* Entropy coded data, MSB aligned bit buffer. */
+    const uint8_t *m_pu8Pos;
+    const uint8_t *m_pu8End;
+    uint32_t m_u32Bits;
+    int32_t  m_i32BitCnt;
+    int32_t  m_i32Marker;
+
+    uint32_t m_u32Width;
+    uint32_t m_u32Height;
+    uint32_t m_u32Comps;
+    uint32_t m_u32McuW;
+    uint32_t m_u32McuH;
+    uint32_t m_u32McusX;
+    uint32_t m_u32McusY;
+    uint32_t m_u32Restart;
+    uint32_t m_u32RestartLeft;
+    uint32_t m_u32McuRow;
+
+    uint16_t *m_pu16Dst;
+    uint32_t m_u32Stride;
+    uint32_t m_u32ClipW;
+    uint32_t m_u32ClipH;
+    uint32_t m_u32Cycles;
+    int32_t  m_i32Active;
+} S_JPEG_DEC;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static const uint8_t s_au8Natural[64] =
+{
+    0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+NVT_DTCM static S_JPEG_DEC s_sDec;
+static S_JPEG_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to get the CPU cycles per microsecond
+static uint32_t jpeg_cycles_per_us(void)
+{
+    return (SystemCoreClock / 1000000UL) ? (SystemCoreClock / 1000000UL) : 1;
+}
+
+// Function to read a big-endian 16-bit value
+static uint32_t jpeg_be16(const uint8_t *pu8)
+{
+    return ((uint32_t)pu8[0] << 8) | pu8[1];
+}
+
+// Function to build the lookup tables of a huffman table, returns 0 or -1
+static int jpeg_huff_build(S_JPEG_HUFF *psHuff, const uint8_t *pu8Counts, const uint8_t *pu8Val, uint32_t u32Num)
+{
+    uint32_t u32Code = 0, k = 0, l, i, j;
+
+    memset(psHuff->m_au16Fast, 0, sizeof(psHuff->m_au16Fast));
+
+    for (l = 1; l <= 16; l++)
+    {
+        psHuff->m_ai32ValOff[l] = (int32_t)k - (int32_t)u32Code;
+
+        for (i = 0; i < pu8Counts[l - 1]; i++, k++, u32Code++)
+        {
+            /* Codes of a length must fit in it, checked before the fast table is indexed by one. */
+            if (u32Code >= (1UL << l))
+                return -1;
+
+            if (l <= 8)
+            {
+                uint32_t u32Base = u32Code << (8 - l);
+
+                for (j = 0; j < (1UL << (8 - l)); j++)
+                    psHuff->m_au16Fast[u32Base + j] = (uint16_t)((l << 8) | pu8Val[k]);
+            }
+        }
+
+        psHuff->m_ai32MaxCode[l] = pu8Counts[l - 1] ? (int32_t)u32Code - 1 : -1;
+
+        u32Code <<= 1;
+    }
+
+    memcpy(psHuff->m_au8Val, pu8Val, u32Num);
+
+    return 0;
+}
+
+// Function to parse the markers up to the start of the scan, returns 0 or -1
+static int jpeg_parse(S_JPEG_DEC *psDec, const uint8_t *pu8, uint32_t u32Len)
+{
+    const uint8_t *pu8End = pu8 + u32Len;
+    uint32_t u32Dqt = 0, u32Dht = 0, u32Sof = 0, i;
+
+    if ((u32Len < 4) || (pu8[0] != 0xFF) || (pu8[1] != 0xD8))
+        return -1;
+
+    pu8 += 2;
+    psDec->m_u32Restart = 0;
+
+    while ((pu8 + 4) <= pu8End)
+    {
+        const uint8_t *pu8Seg;
+        uint32_t u32Marker, u32SegLen;
+
+        if (pu8[0] != 0xFF)
+            return -1;
+
+        u32Marker = pu8[1];
+
+        /* Fill bytes in front of a marker. */
+        if (u32Marker == 0xFF)
+        {
+            pu8++;
+            continue;
+        }
+
+        u32SegLen = jpeg_be16(&pu8[2]);
+        pu8Seg = &pu8[4];
+
+        if ((u32SegLen < 2) || ((pu8 + 2 + u32SegLen) > pu8End))
+            return -1;
+
+        pu8 += 2 + u32SegLen;
+        u32SegLen -= 2;
+
+        switch (u32Marker)
+        {
+            case 0xDB:  /* DQT */
+                while (u32SegLen >= 65)
+                {
+                    uint32_t u32Pq = pu8Seg[0] >> 4, u32Tq = pu8Seg[0] & 0xF;
+
+                    if ((u32Tq > 3) || (u32Pq > 1) || (u32SegLen < (1 + 64 * (u32Pq + 1))))
+                        return -1;
+
+                    for (i = 0; i < 64; i++)
+                        psDec->m_au16Quant[u32Tq][s_au8Natural[i]] =
+                            u32Pq ? (uint16_t)jpeg_be16(&pu8Seg[1 + 2 * i]) : pu8Seg[1 + i];
+
+                    u32Dqt |= 1UL << u32Tq;
+                    pu8Seg += 1 + 64 * (u32Pq + 1);
+                    u32SegLen -= 1 + 64 * (u32Pq + 1);
+                }
+
+                break;
+
+            case 0xC4:  /* DHT */
+                while (u32SegLen >= 17)
+                {
+                    uint32_t u32Tc = pu8Seg[0] >> 4, u32Th = pu8Seg[0] & 0xF, u32Num = 0;
+
+                    for (i = 0; i < 16; i++)
+                        u32Num += pu8Seg[1 + i];
+
+                    if ((u32Tc > 1) || (u32Th >= DEF_JPEG_MAX_HUFF) || (u32Num > 256) || (u32SegLen < (17 + u32Num)))
+                        return -1;
+
+                    if (jpeg_huff_build(u32Tc ? &psDec->m_asAc[u32Th] : &psDec->m_asDc[u32Th], &pu8Seg[1], &pu8Seg[17], u32Num) != 0)
+                        return -1;
+
+                    u32Dht |= 1UL << (u32Tc * DEF_JPEG_MAX_HUFF + u32Th);
+                    pu8Seg += 17 + u32Num;
+                    u32SegLen -= 17 + u32Num;
+                }
+
+                break;
+
+            case 0xC0:  /* SOF0 baseline */
+            case 0xC1:  /* SOF1 extended huffman, 8-bit samples */
+                if ((u32SegLen < 6) || (pu8Seg[0] != 8))
+                    return -1;
+
+                psDec->m_u32Height = jpeg_be16(&pu8Seg[1]);
+                psDec->m_u32Width = jpeg_be16(&pu8Seg[3]);
+                psDec->m_u32Comps = pu8Seg[5];
+
+                if ((psDec->m_u32Width == 0) || (psDec->m_u32Height == 0) ||
+                        ((psDec->m_u32Comps != 1) && (psDec->m_u32Comps != 3)) ||
+                        (u32SegLen < (6 + 3 * psDec->m_u32Comps)))
+                    return -1;
+
+                for (i = 0; i < psDec->m_u32Comps; i++)
+                {
+                    S_JPEG_COMP *psComp = &psDec->m_asComp[i];
+
+                    psComp->m_u8Id = pu8Seg[6 + 3 * i];
+                    psComp->m_u8H = pu8Seg[7 + 3 * i] >> 4;
+                    psComp->m_u8V = pu8Seg[7 + 3 * i] & 0xF;
+                    psComp->m_u8Tq = pu8Seg[8 + 3 * i];
+
+                    if (psComp->m_u8Tq > 3)
+                        return -1;
+                }
+
+                /* A single component scan has one block per MCU whatever its sampling. */
+                if (psDec->m_u32Comps == 1)
+                {
+                    psDec->m_asComp[0].m_u8H = 1;
+                    psDec->m_asComp[0].m_u8V = 1;
+                }
+                else if ((psDec->m_asComp[0].m_u8H < 1) || (psDec->m_asComp[0].m_u8H > 2) ||
+                         (psDec->m_asComp[0].m_u8V < 1) || (psDec->m_asComp[0].m_u8V > 2) ||
+                         (psDec->m_asComp[1].m_u8H != 1) || (psDec->m_asComp[1].m_u8V != 1) ||
+                         (psDec->m_asComp[2].m_u8H != 1) || (psDec->m_asComp[2].m_u8V != 1))
+                {
+                    return -1;
+                }
+
+                psDec->m_u32McuW = 8 * psDec->m_asComp[0].m_u8H;
+                psDec->m_u32McuH = 8 * psDec->m_asComp[0].m_u8V;
+                psDec->m_u32McusX = (psDec->m_u32Width + psDec->m_u32McuW - 1) / psDec->m_u32McuW;
+                psDec->m_u32McusY = (psDec->m_u32Height + psDec->m_u32McuH - 1) / psDec->m_u32McuH;
+                u32Sof = 1;
+                break;
+
+            case 0xC2:  /* Progressive, lossless, hierarchical and arithmetic coding */
+            case 0xC3:
+            case 0xC5:
+            case 0xC6:
+            case 0xC7:
+            case 0xC9:
+            case 0xCA:
+            case 0xCB:
+            case 0xCD:
+            case 0xCE:
+            case 0xCF:
+                return -1;
+
+            case 0xDD:  /* DRI */
+                if (u32SegLen < 2)
+                    return -1;
+
+                psDec->m_u32Restart = jpeg_be16(pu8Seg);
+                break;
+
+            case 0xDA:  /* SOS */
+                if (!u32Sof || (u32SegLen < 1) || (pu8Seg[0] != psDec->m_u32Comps) ||
+                        (u32SegLen < (1 + 2 * psDec->m_u32Comps)))
+                    return -1;
+
+                for (i = 0; i < psDec->m_u32Comps; i++)
+                {
+                    uint32_t c;
+
+                    for (c = 0; c < psDec->m_u32Comps; c++)
+                    {
+                        if (psDec->m_asComp[c].m_u8Id == pu8Seg[1 + 2 * i])
+                            break;
+                    }
+
+                    if (c == psDec->m_u32Comps)
+                        return -1;
+
+                    psDec->m_asComp[c].m_u8Td = pu8Seg[2 + 2 * i] >> 4;
+                    psDec->m_asComp[c].m_u8Ta = pu8Seg[2 + 2 * i] & 0xF;
+                    psDec->m_au8ScanComp[i] = (uint8_t)c;
+
+                    if ((psDec->m_asComp[c].m_u8Td >= DEF_JPEG_MAX_HUFF) ||
+                            (psDec->m_asComp[c].m_u8Ta >= DEF_JPEG_MAX_HUFF) ||
+                            !(u32Dqt & (1UL << psDec->m_asComp[c].m_u8Tq)) ||
+                            !(u32Dht & (1UL << psDec->m_asComp[c].m_u8Td)) ||
+                            !(u32Dht & (1UL << (DEF_JPEG_MAX_HUFF + psDec->m_asComp[c].m_u8Ta))))
+                        return -1;
+                }
+
+                psDec->m_pu8Pos = pu8;
+                psDec->m_pu8End = pu8End;
+                return 0;
+
+            default:    /* APPn, COM and others */
+                break;
+        }
+    }
+
+    return -1;
+}
+
+// Function to reset the bit reader and the DC predictors at the start of the scan or a restart interval
+static void jpeg_reset(S_JPEG_DEC *psDec)
+{
+    uint32_t i;
+
+    psDec->m_u32Bits = 0;
+    psDec->m_i32BitCnt = 0;
+    psDec->m_i32Marker = 0;
+    psDec->m_u32RestartLeft = psDec->m_u32Restart;
+
+    for (i = 0; i < psDec->m_u32Comps; i++)
+        psDec->m_asComp[i].m_i32Pred = 0;
+}
+
+// Function to top up the bit buffer to more than 24 bits, zeros are fed once a marker is reached
+__STATIC_FORCEINLINE void jpeg_fill(S_JPEG_DEC *psDec)
+{
+    while (psDec->m_i32BitCnt <= 24)
+    {
+        uint32_t u32Byte = 0;
+
+        if (!psDec->m_i32Marker && (psDec->m_pu8Pos < psDec->m_pu8End))
+        {
+            u32Byte = psDec->m_pu8Pos[0];
+
+            if (u32Byte != 0xFF)
+            {
+                psDec->m_pu8Pos++;
+            }
+            else if (((psDec->m_pu8Pos + 1) < psDec->m_pu8End) && (psDec->m_pu8Pos[1] == 0x00))
+            {
+                /* Stuffed zero byte. */
+                psDec->m_pu8Pos += 2;
+            }
+            else
+            {
+                /* Leave the marker in place for the restart handling. */
+                psDec->m_i32Marker = 1;
+                u32Byte = 0;
+            }
+        }
+
+        psDec->m_u32Bits |= u32Byte << (24 - psDec->m_i32BitCnt);
+        psDec->m_i32BitCnt += 8;
+    }
+}
+
+// Function to decode one huffman symbol, returns it or -1 on an invalid code
+__STATIC_FORCEINLINE int32_t jpeg_huff_decode(S_JPEG_DEC *psDec, const S_JPEG_HUFF *psHuff)
+{
+    uint32_t u32Fast, u32Code16, l;
+
+    jpeg_fill(psDec);
+
+    u32Fast = psHuff->m_au16Fast[psDec->m_u32Bits >> 24];
+
+    if (u32Fast)
+    {
+        psDec->m_u32Bits <<= (u32Fast >> 8);
+        psDec->m_i32BitCnt -= (int32_t)(u32Fast >> 8);
+        return (int32_t)(u32Fast & 0xFF);
+    }
+
+    u32Code16 = psDec->m_u32Bits >> 16;
+
+    for (l = 9; l <= 16; l++)
+    {
+        int32_t i32Code = (int32_t)(u32Code16 >> (16 - l));
+
+        if (i32Code <= psHuff->m_ai32MaxCode[l])
+        {
+            psDec->m_u32Bits <<= l;
+            psDec->m_i32BitCnt -= (int32_t)l;
+            return psHuff->m_au8Val[(psHuff->m_ai32ValOff[l] + i32Code) & 0xFF];
+        }
+    }
+
+    return -1;
+}
+
+// Function to read u32Size (1~15) bits as a signed coefficient
+__STATIC_FORCEINLINE int32_t jpeg_get_signed(S_JPEG_DEC *psDec, uint32_t u32Size)
+{
+    uint32_t u32Val;
+
+    jpeg_fill(psDec);
+
+    u32Val = psDec->m_u32Bits >> (32 - u32Size);
+    psDec->m_u32Bits <<= u32Size;
+    psDec->m_i32BitCnt -= (int32_t)u32Size;
+
+    return (u32Val < (1UL << (u32Size - 1))) ? ((int32_t)u32Val - (int32_t)((1UL << u32Size) - 1)) : (int32_t)u32Val;
+}
+
+// Function to decode the quantized coefficients of one block in natural order, returns 0 or -1
+NVT_ITCM static int jpeg_decode_block(S_JPEG_DEC *psDec, S_JPEG_COMP *psComp)
+{
+    int16_t *pi16Blk = psDec->m_ai16Blk;
+    const S_JPEG_HUFF *psAc = &psDec->m_asAc[psComp->m_u8Ta];
+    int32_t i32Sym;
+    uint32_t k;
+
+    memset(pi16Blk, 0, sizeof(psDec->m_ai16Blk));
+
+    i32Sym = jpeg_huff_decode(psDec, &psDec->m_asDc[psComp->m_u8Td]);
+
+    if ((i32Sym < 0) || (i32Sym > 11))
+        return -1;
+
+    if (i32Sym)
+        psComp->m_i32Pred += jpeg_get_signed(psDec, (uint32_t)i32Sym);
+
+    pi16Blk[0] = (int16_t)psComp->m_i32Pred;
+
+    for (k = 1; k < 64; k++)
+    {
+        uint32_t u32Size;
+
+        i32Sym = jpeg_huff_decode(psDec, psAc);
+
+        if (i32Sym < 0)
+            return -1;
+
+        u32Size = (uint32_t)i32Sym & 0xF;
+
+        if (u32Size == 0)
+        {
+            /* EOB, or ZRL skipping 16 zeros. */
+            if ((i32Sym >> 4) != 15)
+                break;
+
+            k += 15;
+            continue;
+        }
+
+        k += (uint32_t)i32Sym >> 4;
+
+        if ((k > 63) || (u32Size > 10))
+            return -1;
+
+        pi16Blk[s_au8Natural[k]] = (int16_t)jpeg_get_signed(psDec, u32Size);
+    }
+
+    return 0;
+}
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+// Function to run the 1-D IDCT on 4 lanes in place, the outputs are left undescaled
+__STATIC_FORCEINLINE void jpeg_idct_1d_mve(int32x4_t *v)
+{
+    int32x4_t z1, z2, z3, z4, z5, tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13;
+
+    /* Even part */
+    z1 = vmulq_n_s32(vaddq_s32(v[2], v[6]), FIX_0_541196100);
+    tmp2 = vmlaq_n_s32(z1, v[6], -FIX_1_847759065);
+    tmp3 = vmlaq_n_s32(z1, v[2], FIX_0_765366865);
+    tmp0 = vshlq_n_s32(vaddq_s32(v[0], v[4]), DEF_IDCT_CONST_BITS);
+    tmp1 = vshlq_n_s32(vsubq_s32(v[0], v[4]), DEF_IDCT_CONST_BITS);
+    tmp10 = vaddq_s32(tmp0, tmp3);
+    tmp13 = vsubq_s32(tmp0, tmp3);
+    tmp11 = vaddq_s32(tmp1, tmp2);
+    tmp12 = vsubq_s32(tmp1, tmp2);
+
+    /* Odd part */
+    tmp0 = v[7];
+    tmp1 = v[5];
+    tmp2 = v[3];
+    tmp3 = v[1];
+    z1 = vaddq_s32(tmp0, tmp3);
+    z2 = vaddq_s32(tmp1, tmp2);
+    z3 = vaddq_s32(tmp0, tmp2);
+    z4 = vaddq_s32(tmp1, tmp3);
+    z5 = vmulq_n_s32(vaddq_s32(z3, z4), FIX_1_175875602);
+    tmp0 = vmulq_n_s32(tmp0, FIX_0_298631336);
+    tmp1 = vmulq_n_s32(tmp1, FIX_2_053119869);
+    tmp2 = vmulq_n_s32(tmp2, FIX_3_072711026);
+    tmp3 = vmulq_n_s32(tmp3, FIX_1_501321110);
+    z1 = vmulq_n_s32(z1, -FIX_0_899976223);
+    z2 = vmulq_n_s32(z2, -FIX_2_562915447);
+    z3 = vmlaq_n_s32(z5, z3, -FIX_1_961570560);
+    z4 = vmlaq_n_s32(z5, z4, -FIX_0_390180644);
+    tmp0 = vaddq_s32(tmp0, vaddq_s32(z1, z3));
+    tmp1 = vaddq_s32(tmp1, vaddq_s32(z2, z4));
+    tmp2 = vaddq_s32(tmp2, vaddq_s32(z2, z3));
+    tmp3 = vaddq_s32(tmp3, vaddq_s32(z1, z4));
+
+    v[0] = vaddq_s32(tmp10, tmp3);
+    v[7] = vsubq_s32(tmp10, tmp3);
+    v[1] = vaddq_s32(tmp11, tmp2);
+    v[6] = vsubq_s32(tmp11, tmp2);
+    v[2] = vaddq_s32(tmp12, tmp1);
+    v[5] = vsubq_s32(tmp12, tmp1);
+    v[3] = vaddq_s32(tmp13, tmp0);
+    v[4] = vsubq_s32(tmp13, tmp0);
+}
+
+// Function to dequantize and inverse transform the block into 8x8 samples at pu8Out
+NVT_ITCM static void jpeg_idct(S_JPEG_DEC *psDec, const uint16_t *pu16Quant, uint8_t *pu8Out, uint32_t u32Stride)
+{
+    int32_t *pi32Work = psDec->m_ai32Work;
+    const uint32x4_t u32x4Idx = vidupq_n_u32(0, 1);
+    const uint32x4_t u32x4WorkOff = vmulq_n_u32(u32x4Idx, 8);
+    const uint32x4_t u32x4OutOff = vmulq_n_u32(u32x4Idx, u32Stride);
+    int32x4_t v[8];
+    uint32_t h, i;
+
+    /* Columns, 4 per lane set. The result is stored transposed so the row pass loads it contiguously. */
+    for (h = 0; h < 8; h += 4)
+    {
+        for (i = 0; i < 8; i++)
+            v[i] = vmulq_s32(vldrhq_s32(&psDec->m_ai16Blk[i * 8 + h]),
+                             vreinterpretq_s32_u32(vldrhq_u32(&pu16Quant[i * 8 + h])));
+
+        jpeg_idct_1d_mve(v);
+
+        for (i = 0; i < 8; i++)
+            vstrwq_scatter_shifted_offset_s32(&pi32Work[h * 8 + i], u32x4WorkOff,
+                                              vrshrq_n_s32(v[i], DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS));
+    }
+
+    /* Rows, 4 per lane set, level shifted, clamped and scattered as bytes. */
+    for (h = 0; h < 8; h += 4)
+    {
+        for (i = 0; i < 8; i++)
+            v[i] = vld1q_s32(&pi32Work[i * 8 + h]);
+
+        jpeg_idct_1d_mve(v);
+
+        for (i = 0; i < 8; i++)
+        {
+            int32x4_t s32x4 = vaddq_n_s32(vrshrq_n_s32(v[i], DEF_IDCT_CONST_BITS + DEF_IDCT_PASS1_BITS + 3), 128);
+
+            s32x4 = vmaxq_s32(vminq_s32(s32x4, vdupq_n_s32(255)), vdupq_n_s32(0));
+            vstrbq_scatter_offset_u32(&pu8Out[h * u32Stride + i], u32x4OutOff, vreinterpretq_u32_s32(s32x4));
+        }
+    }
+}
+
+// Function to convert n pixels of a line to RGB565, u32HShift is 1 when chroma is horizontally halved
+static void jpeg_color_line(uint16_t *pu16Dst, const uint8_t *pu8Y, const uint8_t *pu8Cb, const uint8_t *pu8Cr,
+                            uint32_t n, uint32_t u32HShift)
+{
+    const uint32_t u32Comps = s_sDec.m_u32Comps;
+    uint32x4_t u32x4Idx = vidupq_n_u32(0, 1);
+    uint32_t x;
+
+    for (x = 0; x < n; x += 4)
+    {
+        mve_pred16_t p = vctp32q(n - x);
+        int32x4_t y = vreinterpretq_s32_u32(vldrbq_z_u32(&pu8Y[x], p));
+        int32x4_t r, g, b;
+        uint32x4_t rgb;
+
+        if (u32Comps == 3)
+        {
+            uint32x4_t off = u32HShift ? vshrq_n_u32(u32x4Idx, 1) : u32x4Idx;
+            int32x4_t cb = vsubq_n_s32(vreinterpretq_s32_u32(vldrbq_gather_offset_z_u32(pu8Cb, off, p)), 128);
+            int32x4_t cr = vsubq_n_s32(vreinterpretq_s32_u32(vldrbq_gather_offset_z_u32(pu8Cr, off, p)), 128);
+
+            r = vaddq_s32(y, vshrq_n_s32(vaddq_n_s32(vmulq_n_s32(cr, FIX_CR_R), 32768), 16));
+            g = vsubq_s32(y, vshrq_n_s32(vaddq_n_s32(vmlaq_n_s32(vmulq_n_s32(cb, FIX_CB_G), cr, FIX_CR_G), 32768), 16));
+            b = vaddq_s32(y, vshrq_n_s32(vaddq_n_s32(vmulq_n_s32(cb, FIX_CB_B), 32768), 16));
+            r = vmaxq_s32(vminq_s32(r, vdupq_n_s32(255)), vdupq_n_s32(0));
+            g = vmaxq_s32(vminq_s32(g, vdupq_n_s32(255)), vdupq_n_s32(0));
+            b = vmaxq_s32(vminq_s32(b, vdupq_n_s32(255)), vdupq_n_s32(0));
+        }
+        else
+        {
+            r = g = b = y;
+        }
+
+        rgb = vorrq_u32(vshlq_n_u32(vshrq_n_u32(vreinterpretq_u32_s32(r), 3), 11),
+                        vorrq_u32(vshlq_n_u32(vshrq_n_u32(vreinterpretq_u32_s32(g), 2), 5),
+                                  vshrq_n_u32(vreinterpretq_u32_s32(b), 3)));
+        vstrhq_p_u32(&pu16Dst[x], rgb, p);
+        u32x4Idx = vaddq_n_u32(u32x4Idx, 4);
+    }
+}
+#else
+// Function to dequantize and inverse transform the block into 8x8 samples at pu8Out
+NVT_ITCM static void jpeg_idct(S_JPEG_DEC *psDec, const uint16_t *pu16Quant, uint8_t *pu8Out, uint32_t u32Stride)
+{
+    const int16_t *pi16Blk = psDec->m_ai16Blk;
+    int32_t *pi32Work = psDec->m_ai32Work;
+    int32_t z1, z2, z3, z4, z5, tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13;
+    int32_t in[8];
+    uint32_t c, r, i;
+
+    /* Columns */
+    for (c = 0; c < 8; c++)
+    {
+        for (i = 0; i < 8; i++)
+            in[i] = pi16Blk[i * 8 + c] * (int32_t)pu16Quant[i * 8 + c];
+
+        if (!(in[1] | in[2] | in[3] | in[4] | in[5] | in[6] | in[7]))
+        {
+            /* AC terms all zero, the column is flat. */
+            for (i = 0; i < 8; i++)
+                pi32Work[i * 8 + c] = in[0] * (1 << DEF_IDCT_PASS1_BITS);
+
+            continue;
+        }
+
+        z1 = (in[2] + in[6]) * FIX_0_541196100;
+        tmp2 = z1 + in[6] * -FIX_1_847759065;
+        tmp3 = z1 + in[2] * FIX_0_765366865;
+        tmp0 = (in[0] + in[4]) * (1 << DEF_IDCT_CONST_BITS);
+        tmp1 = (in[0] - in[4]) * (1 << DEF_IDCT_CONST_BITS);
+        tmp10 = tmp0 + tmp3;
+        tmp13 = tmp0 - tmp3;
+        tmp11 = tmp1 + tmp2;
+        tmp12 = tmp1 - tmp2;
+
+        tmp0 = in[7];
+        tmp1 = in[5];
+        tmp2 = in[3];
+        tmp3 = in[1];
+        z1 = tmp0 + tmp3;
+        z2 = tmp1 + tmp2;
+        z3 = tmp0 + tmp2;
+        z4 = tmp1 + tmp3;
+        z5 = (z3 + z4) * FIX_1_175875602;
+        tmp0 *= FIX_0_298631336;
+        tmp1 *= FIX_2_053119869;
+        tmp2 *= FIX_3_072711026;
+        tmp3 *= FIX_1_501321110;
+        z1 *= -FIX_0_899976223;
+        z2 *= -FIX_2_562915447;
+        z3 = z3 * -FIX_1_961570560 + z5;
+        z4 = z4 * -FIX_0_390180644 + z5;
+        tmp0 += z1 + z3;
+        tmp1 += z2 + z4;
+        tmp2 += z2 + z3;
+        tmp3 += z1 + z4;
+
+        pi32Work[0 * 8 + c] = DESCALE(tmp10 + tmp3, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+        pi32Work[7 * 8 + c] = DESCALE(tmp10 - tmp3, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+        pi32Work[1 * 8 + c] = DESCALE(tmp11 + tmp2, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+        pi32Work[6 * 8 + c] = DESCALE(tmp11 - tmp2, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+        pi32Work[2 * 8 + c] = DESCALE(tmp12 + tmp1, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+        pi32Work[5 * 8 + c] = DESCALE(tmp12 - tmp1, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+        pi32Work[3 * 8 + c] = DESCALE(tmp13 + tmp0, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+        pi32Work[4 * 8 + c] = DESCALE(tmp13 - tmp0, DEF_IDCT_CONST_BITS - DEF_IDCT_PASS1_BITS);
+    }
+
+    /* Rows */
+    for (r = 0; r < 8; r++)
+    {
+        const int32_t *w = &pi32Work[r * 8];
+        int32_t o[8];
+
+        z1 = (w[2] + w[6]) * FIX_0_541196100;
+        tmp2 = z1 + w[6] * -FIX_1_847759065;
+        tmp3 = z1 + w[2] * FIX_0_765366865;
+        tmp0 = (w[0] + w[4]) * (1 << DEF_IDCT_CONST_BITS);
+        tmp1 = (w[0] - w[4]) * (1 << DEF_IDCT_CONST_BITS);
+        tmp10 = tmp0 + tmp3;
+        tmp13 = tmp0 - tmp3;
+        tmp11 = tmp1 + tmp2;
+        tmp12 = tmp1 - tmp2;
+
+        tmp0 = w[7];
+        tmp1 = w[5];
+        tmp2 = w[3];
+        tmp3 = w[1];
+        z1 = tmp0 + tmp3;
+        z2 = tmp1 + tmp2;
+        z3 = tmp0 + tmp2;
+        z4 = tmp1 + tmp3;
+        z5 = (z3 + z4) * FIX_1_175875602;
+        tmp0 *= FIX_0_298631336;
+        tmp1 *= FIX_2_053119869;
+        tmp2 *= FIX_3_072711026;
+        tmp3 *= FIX_1_501321110;
+        z1 *= -FIX_0_899976223;
+        z2 *= -FIX_2_562915447;
+        z3 = z3 * -FIX_1_961570560 + z5;
+        z4 = z4 * -FIX_0_390180644 + z5;
+        tmp0 += z1 + z3;
+        tmp1 += z2 + z4;
+        tmp2 += z2 + z3;
+        tmp3 += z1 + z4;
+
+        o[0] = tmp10 + tmp3;
+        o[7] = tmp10 - tmp3;
+        o[1] = tmp11 + tmp2;
+        o[6] = tmp11 - tmp2;
+        o[2] = tmp12 + tmp1;
+        o[5] = tmp12 - tmp1;
+        o[3] = tmp13 + tmp0;
+        o[4] = tmp13 - tmp0;
+
+        for (i = 0; i < 8; i++)
+        {
+            int32_t s = DESCALE(o[i], DEF_IDCT_CONST_BITS + DEF_IDCT_PASS1_BITS + 3) + 128;
+
+            pu8Out[r * u32Stride + i] = (uint8_t)((s < 0) ? 0 : ((s > 255) ? 255 : s));
+        }
+    }
+}
+
+// Function to clamp a colour channel to 0~255
+__STATIC_FORCEINLINE uint32_t jpeg_clamp(int32_t i32Val)
+{
+    return (i32Val < 0) ? 0 : ((i32Val > 255) ? 255 : (uint32_t)i32Val);
+}
+
+// Function to convert n pixels of a line to RGB565, u32HShift is 1 when chroma is horizontally halved
+static void jpeg_color_line(uint16_t *pu16Dst, const uint8_t *pu8Y, const uint8_t *pu8Cb, const uint8_t *pu8Cr,
+                            uint32_t n, uint32_t u32HShift)
+{
+    uint32_t x;
+
+    for (x = 0; x < n; x++)
+    {
+        int32_t y = pu8Y[x];
+        uint32_t r, g, b;
+
+        if (s_sDec.m_u32Comps == 3)
+        {
+            int32_t cb = (int32_t)pu8Cb[x >> u32HShift] - 128;
+            int32_t cr = (int32_t)pu8Cr[x >> u32HShift] - 128;
+
+            r = jpeg_clamp(y + ((cr * FIX_CR_R + 32768) >> 16));
+            g = jpeg_clamp(y - ((cb * FIX_CB_G + cr * FIX_CR_G + 32768) >> 16));
+            b = jpeg_clamp(y + ((cb * FIX_CB_B + 32768) >> 16));
+        }
+        else
+        {
+            r = g = b = (uint32_t)y;
+        }
+
+        pu16Dst[x] = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    }
+}
+#endif
+
+// Function to skip the RSTn marker ending a restart interval and restart the bit reader
+static void jpeg_restart(S_JPEG_DEC *psDec)
+{
+    const uint8_t *pu8 = psDec->m_pu8Pos;
+
+    /* Corrupt data may leave the marker further on, resync on the next RSTn. */
+    while ((pu8 + 1) < psDec->m_pu8End)
+    {
+        if ((pu8[0] == 0xFF) && (pu8[1] >= 0xD0) && (pu8[1] <= 0xD7))
+        {
+            psDec->m_pu8Pos = pu8 + 2;
+            break;
+        }
+
+        pu8++;
+    }
+
+    jpeg_reset(psDec);
+}
+
+// Function to decode one MCU into the sample buffers, returns 0 or -1
+static int jpeg_decode_mcu(S_JPEG_DEC *psDec)
+{
+    uint32_t i, bx, by;
+
+    if (psDec->m_u32Restart)
+    {
+        if (psDec->m_u32RestartLeft == 0)
+            jpeg_restart(psDec);
+
+        psDec->m_u32RestartLeft--;
+    }
+
+    for (i = 0; i < psDec->m_u32Comps; i++)
+    {
+        uint32_t c = psDec->m_au8ScanComp[i];
+        S_JPEG_COMP *psComp = &psDec->m_asComp[c];
+
+        for (by = 0; by < psComp->m_u8V; by++)
+        {
+            for (bx = 0; bx < psComp->m_u8H; bx++)
+            {
+                if (jpeg_decode_block(psDec, psComp) != 0)
+                    return -1;
+
+                if (c == 0)
+                    jpeg_idct(psDec, psDec->m_au16Quant[psComp->m_u8Tq], &psDec->m_au8Y[by * 8 * 16 + bx * 8], 16);
+                else
+                    jpeg_idct(psDec, psDec->m_au16Quant[psComp->m_u8Tq], (c == 1) ? psDec->m_au8Cb : psDec->m_au8Cr, 8);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int jpeg_dec_info(const void *pvJpeg, uint32_t u32Len, S_JPEG_INFO *psInfo)
+{
+    if ((pvJpeg == NULL) || (psInfo == NULL) || s_sDec.m_i32Active)
+        return -1;
+
+    if (jpeg_parse(&s_sDec, (const uint8_t *)pvJpeg, u32Len) != 0)
+        return -1;
+
+    psInfo->m_u32Width = s_sDec.m_u32Width;
+    psInfo->m_u32Height = s_sDec.m_u32Height;
+    psInfo->m_u32Components = s_sDec.m_u32Comps;
+    psInfo->m_u32BandHeight = s_sDec.m_u32McuH;
+
+    return 0;
+}
+
+int jpeg_dec_begin(const void *pvJpeg, uint32_t u32Len, uint16_t *pu16Dst, uint32_t u32Stride,
+                   uint32_t u32ClipW, uint32_t u32ClipH)
+{
+    uint32_t u32Start = DWT->CYCCNT;
+
+    if ((pvJpeg == NULL) || (pu16Dst == NULL) || (u32Stride < u32ClipW))
+        return -1;
+
+    s_sDec.m_i32Active = 0;
+
+    if (jpeg_parse(&s_sDec, (const uint8_t *)pvJpeg, u32Len) != 0)
+    {
+        s_sStats.m_u32Errors++;
+        return -1;
+    }
+
+    /* The destination may be a VRAM buffer in retention. */
+    disp_mem_acquire(pu16Dst);
+
+    jpeg_reset(&s_sDec);
+    s_sDec.m_u32McuRow = 0;
+    s_sDec.m_pu16Dst = pu16Dst;
+    s_sDec.m_u32Stride = u32Stride;
+    s_sDec.m_u32ClipW = (u32ClipW < s_sDec.m_u32Width) ? u32ClipW : s_sDec.m_u32Width;
+    s_sDec.m_u32ClipH = (u32ClipH < s_sDec.m_u32Height) ? u32ClipH : s_sDec.m_u32Height;
+    s_sDec.m_u32Cycles = DWT->CYCCNT - u32Start;
+    s_sDec.m_i32Active = 1;
+
+    return 0;
+}
+
+int jpeg_dec_band(void)
+{
+    S_JPEG_DEC *psDec = &s_sDec;
+    uint32_t u32Start = DWT->CYCCNT;
+    uint32_t u32Y0, u32Lines, u32HShift, u32VShift, mx, y;
+
+    if (!psDec->m_i32Active)
+        return -1;
+
+    /* Bands may be frames apart, long enough for an unscanned buffer to age into retention again. */
+    disp_mem_acquire(psDec->m_pu16Dst);
+
+    u32Y0 = psDec->m_u32McuRow * psDec->m_u32McuH;
+
+    /* Rows below the clip are still decoded when the caller asks, but nothing is written. */
+    u32Lines = (u32Y0 < psDec->m_u32ClipH) ? (psDec->m_u32ClipH - u32Y0) : 0;
+
+    if (u32Lines > psDec->m_u32McuH)
+        u32Lines = psDec->m_u32McuH;
+
+    u32HShift = (psDec->m_u32McuW == 16) ? 1 : 0;
+    u32VShift = (psDec->m_u32McuH == 16) ? 1 : 0;
+
+    for (mx = 0; mx < psDec->m_u32McusX; mx++)
+    {
+        uint32_t u32X0 = mx * psDec->m_u32McuW;
+        uint32_t n;
+
+        if (jpeg_decode_mcu(psDec) != 0)
+        {
+            psDec->m_i32Active = 0;
+            s_sStats.m_u32Errors++;
+            return -1;
+        }
+
+        if (u32X0 >= psDec->m_u32ClipW)
+            continue;
+
+        n = psDec->m_u32ClipW - u32X0;
+
+        if (n > psDec->m_u32McuW)
+            n = psDec->m_u32McuW;
+
+        for (y = 0; y < u32Lines; y++)
+        {
+            jpeg_color_line(&psDec->m_pu16Dst[(u32Y0 + y) * psDec->m_u32Stride + u32X0],
+                            &psDec->m_au8Y[y * 16],
+                            &psDec->m_au8Cb[(y >> u32VShift) * 8],
+                            &psDec->m_au8Cr[(y >> u32VShift) * 8],
+                            n, u32HShift);
+        }
+    }
+
+    for (y = 0; y < u32Lines; y++)
+        SCB_CleanDCache_by_Addr(&psDec->m_pu16Dst[(u32Y0 + y) * psDec->m_u32Stride], (int32_t)(psDec->m_u32ClipW * sizeof(uint16_t)));
+
+    psDec->m_u32McuRow++;
+    u32Start = DWT->CYCCNT - u32Start;
+    psDec->m_u32Cycles += u32Start;
+
+    if ((u32Start / jpeg_cycles_per_us()) > s_sStats.m_u32MaxBandUs)
+        s_sStats.m_u32MaxBandUs = u32Start / jpeg_cycles_per_us();
+
+    if ((psDec->m_u32McuRow >= psDec->m_u32McusY) || ((u32Y0 + psDec->m_u32McuH) >= psDec->m_u32ClipH))
+    {
+        uint32_t u32Us = psDec->m_u32Cycles / jpeg_cycles_per_us();
+
+        psDec->m_i32Active = 0;
+        s_sStats.m_u32Images++;
+        s_sStats.m_u32LastUs = u32Us;
+        s_sStats.m_u32LastKPixPerSec = u32Us ? (uint32_t)(((uint64_t)psDec->m_u32ClipW * psDec->m_u32ClipH * 1000UL) / u32Us) : 0;
+
+        return (int)psDec->m_u32ClipH;
+    }
+
+    return (int)(u32Y0 + u32Lines);
+}
+
+int jpeg_dec_decode(const void *pvJpeg, uint32_t u32Len, uint16_t *pu16Dst, uint32_t u32Stride,
+                    uint32_t u32ClipW, uint32_t u32ClipH)
+{
+    int i32Lines;
+
+    if (jpeg_dec_begin(pvJpeg, u32Len, pu16Dst, u32Stride, u32ClipW, u32ClipH) != 0)
+        return -1;
+
+    do
+    {
+        i32Lines = jpeg_dec_band();
+    } while ((i32Lines >= 0) && s_sDec.m_i32Active);
+
+    return (i32Lines < 0) ? -1 : 0;
+}
+
+void jpeg_dec_get_stats(S_JPEG_STATS *psStats)
+{
+    *psStats = s_sStats;
+}
+
+// Function to initialize the JPEG decoder
+static int jpeg_dec_init(void)
+{
+    memset(&s_sStats, 0, sizeof(s_sStats));
+    s_sDec.m_i32Active = 0;
+
+    /* Decode times are counted in core cycles. */
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return 0;
+}
+
+// Function to deinitialize the JPEG decoder, a band decode in progress is dropped
+static int jpeg_dec_fini(void)
+{
+    s_sDec.m_i32Active = 0;
+
+    return 0;
+}
+
+COMPONENT_EXPORT("JPEG_DEC", jpeg_dec_init, jpeg_dec_fini);
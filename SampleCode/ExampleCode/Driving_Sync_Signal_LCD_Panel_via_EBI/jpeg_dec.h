@@ -0,0 +1,53 @@
+/**************************************************************************//**
+ * @file     jpeg_dec.h
+ * @brief    Baseline JPEG decoder writing RGB565 bands straight into VRAM.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __JPEG_DEC_H__
+#define __JPEG_DEC_H__
+
+#include "NuMicro.h"
+#include "component.h"
+
+typedef struct
+{
+    uint32_t m_u32Width;            /*!< Image width in pixels */
+    uint32_t m_u32Height;           /*!< Image height in pixels */
+    uint32_t m_u32Components;       /*!< 1 for grayscale, 3 for YCbCr */
+    uint32_t m_u32BandHeight;       /*!< Lines per band, the MCU height 8 or 16 */
+} S_JPEG_INFO;
+
+typedef struct
+{
+    uint32_t m_u32Images;           /*!< Images decoded */
+    uint32_t m_u32Errors;           /*!< Images failed on unsupported or corrupt data */
+    uint32_t m_u32LastUs;           /*!< Decode time of the last image */
+    uint32_t m_u32LastKPixPerSec;   /*!< Pixel rate of the last image in thousands per second */
+    uint32_t m_u32MaxBandUs;        /*!< Slowest band, the bound for chasing the scanout */
+} S_JPEG_STATS;
+
+// Function to read the frame header of a JPEG image, returns 0 or -1 if it is not a supported baseline JPEG
+int jpeg_dec_info(const void *pvJpeg, uint32_t u32Len, S_JPEG_INFO *psInfo);
+
+// Function to start decoding an image into pu16Dst, returns 0 or -1
+// pu16Dst is the top-left pixel in VRAM and u32Stride the VRAM line length in pixels. Pixels beyond
+// u32ClipW x u32ClipH are dropped. Only baseline huffman JPEGs with 1x1 chroma are supported, i.e.
+// grayscale, 4:4:4, 4:2:2 and 4:2:0.
+int jpeg_dec_begin(const void *pvJpeg, uint32_t u32Len, uint16_t *pu16Dst, uint32_t u32Stride,
+                   uint32_t u32ClipW, uint32_t u32ClipH);
+
+// Function to decode the next band of MCU rows, returns the lines finished so far or -1 on error
+// Each band is cleaned to memory, so it can be scanned out as soon as this returns; decoding bands
+// ahead of the scanout line chases the scanout with no back buffer.
+int jpeg_dec_band(void);
+
+// Function to decode a whole image into pu16Dst, returns 0 or -1, see jpeg_dec_begin
+int jpeg_dec_decode(const void *pvJpeg, uint32_t u32Len, uint16_t *pu16Dst, uint32_t u32Stride,
+                    uint32_t u32ClipW, uint32_t u32ClipH);
+
+// Function to get the decoder statistics
+void jpeg_dec_get_stats(S_JPEG_STATS *psStats);
+
+#endif /* __JPEG_DEC_H__ */
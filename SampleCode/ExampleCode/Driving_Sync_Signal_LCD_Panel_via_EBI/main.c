@@ -9,6 +9,7 @@
 #include "NuMicro.h"
 #include "component.h"
 #include "board.h"
+#include "disp_idle.h"
 
 /*---------------------------------------------------------------------------*/
 /* Functions                                                                 */
@@ -117,7 +118,7 @@ int main(void)
     /* Placeholder for your code */
     while (1)
     {
-        __WFI();  // Wait For Interrupt.
+        disp_idle_enter();  // Sleep until the next interrupt unless work was posted.
     }
 
     /* This will never execute due to the infinite loop. */
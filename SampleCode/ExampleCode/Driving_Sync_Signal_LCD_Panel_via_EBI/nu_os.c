@@ -0,0 +1,366 @@
+/**************************************************************************//**
+ * @file     nu_os.c
+ * @brief    Semaphores, event groups and yield for bare-metal or RTOS builds.
+ *
+ *           Drivers wait on a completion signalled by their interrupt instead
+ *           of spinning on a flag. Bare metal sleeps the core with WFE until
+ *           an interrupt arrives; FreeRTOS blocks the task so others run
+ *           while the transfer does.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "NuMicro.h"
+#include "nu_os.h"
+
+#if (CONFIG_NU_OS == NU_OS_FREERTOS)
+    #include "task.h"
+#endif
+
+#if defined(ETHOSU55) || defined(ETHOSU65)
+    #include "ethosu_driver.h"
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+#if defined(ETHOSU55) || defined(ETHOSU65)
+static nu_os_sem_t s_asEthosuSem[CONFIG_NU_OS_ETHOSU_SEM_NUM];
+static uint8_t s_au8EthosuSemUsed[CONFIG_NU_OS_ETHOSU_SEM_NUM];
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+#if (CONFIG_NU_OS == NU_OS_FREERTOS)
+
+// Function to check if waits can block, before the scheduler starts they poll
+static int nu_os_can_block(void)
+{
+    return (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+}
+
+// Function to convert a timeout to ticks
+static TickType_t nu_os_ticks(uint32_t u32TimeoutMs)
+{
+    return (u32TimeoutMs == NU_OS_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(u32TimeoutMs);
+}
+
+void nu_os_sem_init(nu_os_sem_t *psSem, uint32_t u32Count)
+{
+    psSem->m_hSem = xSemaphoreCreateCountingStatic(0xFFFF, u32Count, &psSem->m_sSem);
+}
+
+int nu_os_sem_take(nu_os_sem_t *psSem, uint32_t u32TimeoutMs)
+{
+    if (!nu_os_can_block())
+    {
+        while (xSemaphoreTake(psSem->m_hSem, 0) != pdTRUE)
+        {
+            if (u32TimeoutMs != NU_OS_WAIT_FOREVER)
+                return -1;
+        }
+
+        return 0;
+    }
+
+    return (xSemaphoreTake(psSem->m_hSem, nu_os_ticks(u32TimeoutMs)) == pdTRUE) ? 0 : -1;
+}
+
+void nu_os_sem_give(nu_os_sem_t *psSem)
+{
+    if (__get_IPSR())
+    {
+        BaseType_t xWoken = pdFALSE;
+
+        xSemaphoreGiveFromISR(psSem->m_hSem, &xWoken);
+        portYIELD_FROM_ISR(xWoken);
+    }
+    else
+    {
+        xSemaphoreGive(psSem->m_hSem);
+    }
+}
+
+void nu_os_event_init(nu_os_event_t *psEvent)
+{
+    psEvent->m_hEvent = xEventGroupCreateStatic(&psEvent->m_sEvent);
+}
+
+uint32_t nu_os_event_wait(nu_os_event_t *psEvent, uint32_t u32Bits, int i32All, uint32_t u32TimeoutMs)
+{
+    EventBits_t xBits;
+
+    xBits = xEventGroupWaitBits(psEvent->m_hEvent, (EventBits_t)u32Bits, pdTRUE, i32All ? pdTRUE : pdFALSE,
+                                nu_os_can_block() ? nu_os_ticks(u32TimeoutMs) : 0);
+
+    xBits &= (EventBits_t)u32Bits;
+
+    if (i32All ? (xBits != (EventBits_t)u32Bits) : (xBits == 0))
+        return 0;
+
+    return (uint32_t)xBits;
+}
+
+void nu_os_event_set(nu_os_event_t *psEvent, uint32_t u32Bits)
+{
+    if (__get_IPSR())
+    {
+        BaseType_t xWoken = pdFALSE;
+
+        /* Deferred to the timer task, which wakes the waiters. */
+        xEventGroupSetBitsFromISR(psEvent->m_hEvent, (EventBits_t)u32Bits, &xWoken);
+        portYIELD_FROM_ISR(xWoken);
+    }
+    else
+    {
+        xEventGroupSetBits(psEvent->m_hEvent, (EventBits_t)u32Bits);
+    }
+}
+
+void nu_os_event_clear(nu_os_event_t *psEvent, uint32_t u32Bits)
+{
+    xEventGroupClearBits(psEvent->m_hEvent, (EventBits_t)u32Bits);
+}
+
+void nu_os_yield(void)
+{
+    if (nu_os_can_block())
+        taskYIELD();
+}
+
+#else
+
+// Function to sleep until the next event, returns 1 once the timeout expired
+static int nu_os_sleep(uint32_t u32TimeoutMs, uint32_t *pu32Last, uint64_t *pu64Left)
+{
+    uint32_t u32Now, u32Cycles;
+
+    /* Interrupt entry wakes WFE and every give or set sends SEV. A timed wait without a running
+       tick would sleep past its timeout, so it polls instead. */
+    if ((u32TimeoutMs == NU_OS_WAIT_FOREVER) ||
+            ((SysTick->CTRL & (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk)) ==
+             (SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk)))
+        __WFE();
+
+    if (u32TimeoutMs == NU_OS_WAIT_FOREVER)
+        return 0;
+
+    u32Now = DWT->CYCCNT;
+    u32Cycles = u32Now - *pu32Last;
+    *pu32Last = u32Now;
+
+    if (*pu64Left <= u32Cycles)
+        return 1;
+
+    *pu64Left -= u32Cycles;
+
+    return 0;
+}
+
+void nu_os_sem_init(nu_os_sem_t *psSem, uint32_t u32Count)
+{
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    psSem->m_u32Count = u32Count;
+}
+
+int nu_os_sem_take(nu_os_sem_t *psSem, uint32_t u32TimeoutMs)
+{
+    uint32_t u32Last = DWT->CYCCNT, u32PriMask;
+    uint64_t u64Left = (uint64_t)u32TimeoutMs * (SystemCoreClock / 1000UL);
+
+    for (;;)
+    {
+        u32PriMask = __get_PRIMASK();
+        __disable_irq();
+
+        if (psSem->m_u32Count)
+        {
+            psSem->m_u32Count--;
+            __set_PRIMASK(u32PriMask);
+
+            return 0;
+        }
+
+        __set_PRIMASK(u32PriMask);
+
+        if (nu_os_sleep(u32TimeoutMs, &u32Last, &u64Left))
+            return -1;
+    }
+}
+
+void nu_os_sem_give(nu_os_sem_t *psSem)
+{
+    uint32_t u32PriMask = __get_PRIMASK();
+
+    __disable_irq();
+    psSem->m_u32Count++;
+    __set_PRIMASK(u32PriMask);
+
+    __SEV();
+}
+
+void nu_os_event_init(nu_os_event_t *psEvent)
+{
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    psEvent->m_u32Bits = 0;
+}
+
+uint32_t nu_os_event_wait(nu_os_event_t *psEvent, uint32_t u32Bits, int i32All, uint32_t u32TimeoutMs)
+{
+    uint32_t u32Last = DWT->CYCCNT, u32PriMask, u32Got;
+    uint64_t u64Left = (uint64_t)u32TimeoutMs * (SystemCoreClock / 1000UL);
+
+    for (;;)
+    {
+        u32PriMask = __get_PRIMASK();
+        __disable_irq();
+
+        u32Got = psEvent->m_u32Bits & u32Bits;
+
+        if (i32All ? (u32Got == u32Bits) : (u32Got != 0))
+        {
+            psEvent->m_u32Bits &= ~u32Got;
+            __set_PRIMASK(u32PriMask);
+
+            return u32Got;
+        }
+
+        __set_PRIMASK(u32PriMask);
+
+        if (nu_os_sleep(u32TimeoutMs, &u32Last, &u64Left))
+            return 0;
+    }
+}
+
+void nu_os_event_set(nu_os_event_t *psEvent, uint32_t u32Bits)
+{
+    uint32_t u32PriMask = __get_PRIMASK();
+
+    __disable_irq();
+    psEvent->m_u32Bits |= u32Bits;
+    __set_PRIMASK(u32PriMask);
+
+    __SEV();
+}
+
+void nu_os_event_clear(nu_os_event_t *psEvent, uint32_t u32Bits)
+{
+    uint32_t u32PriMask = __get_PRIMASK();
+
+    __disable_irq();
+    psEvent->m_u32Bits &= ~u32Bits;
+    __set_PRIMASK(u32PriMask);
+}
+
+void nu_os_yield(void)
+{
+}
+
+#endif
+
+#if defined(ETHOSU55) || defined(ETHOSU65)
+/* The Ethos-U driver defines its mutex and semaphore hooks weak, with a WFE spin for bare metal. These
+   put inference waits on nu_os, so under FreeRTOS the calling task blocks until the NPU interrupt gives. */
+
+// Function to take a free semaphore of the Ethos-U pool holding u32Count, returns NULL when all are used
+static void *nu_os_ethosu_alloc(uint32_t u32Count)
+{
+    uint32_t u32PriMask = __get_PRIMASK();
+    nu_os_sem_t *psSem = NULL;
+    int i;
+
+    __disable_irq();
+
+    for (i = 0; i < CONFIG_NU_OS_ETHOSU_SEM_NUM; i++)
+    {
+        if (!s_au8EthosuSemUsed[i])
+        {
+            s_au8EthosuSemUsed[i] = 1;
+            psSem = &s_asEthosuSem[i];
+            break;
+        }
+    }
+
+    __set_PRIMASK(u32PriMask);
+
+    if (psSem)
+        nu_os_sem_init(psSem, u32Count);
+
+    return psSem;
+}
+
+// Function to return a semaphore to the Ethos-U pool
+static void nu_os_ethosu_free(void *pvSem)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_NU_OS_ETHOSU_SEM_NUM; i++)
+    {
+        if (pvSem == &s_asEthosuSem[i])
+            s_au8EthosuSemUsed[i] = 0;
+    }
+}
+
+void *ethosu_mutex_create(void)
+{
+    /* A semaphore holding one, without priority inheritance. */
+    return nu_os_ethosu_alloc(1);
+}
+
+void ethosu_mutex_destroy(void *mutex)
+{
+    nu_os_ethosu_free(mutex);
+}
+
+int ethosu_mutex_lock(void *mutex)
+{
+    return mutex ? nu_os_sem_take((nu_os_sem_t *)mutex, NU_OS_WAIT_FOREVER) : -1;
+}
+
+int ethosu_mutex_unlock(void *mutex)
+{
+    if (!mutex)
+        return -1;
+
+    nu_os_sem_give((nu_os_sem_t *)mutex);
+
+    return 0;
+}
+
+void *ethosu_semaphore_create(void)
+{
+    return nu_os_ethosu_alloc(0);
+}
+
+void ethosu_semaphore_destroy(void *sem)
+{
+    nu_os_ethosu_free(sem);
+}
+
+int ethosu_semaphore_take(void *sem)
+{
+    return sem ? nu_os_sem_take((nu_os_sem_t *)sem, NU_OS_WAIT_FOREVER) : -1;
+}
+
+int ethosu_semaphore_give(void *sem)
+{
+    if (!sem)
+        return -1;
+
+    nu_os_sem_give((nu_os_sem_t *)sem);
+
+    return 0;
+}
+
+int ethosu_semaphore_give_from_ISR(void *sem)
+{
+    /* nu_os_sem_give picks the FromISR call itself. */
+    return ethosu_semaphore_give(sem);
+}
+#endif
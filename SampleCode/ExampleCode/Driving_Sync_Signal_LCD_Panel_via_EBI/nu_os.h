@@ -0,0 +1,95 @@
+/**************************************************************************//**
+ * @file     nu_os.h
+ * @brief    Semaphores, event groups and yield for bare-metal or RTOS builds.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __NU_OS_H__
+#define __NU_OS_H__
+
+#include <stdint.h>
+
+#define NU_OS_BAREMETAL                      0   /*!< Waits sleep the core with WFE until an interrupt signals */
+#define NU_OS_FREERTOS                       1   /*!< Waits block the calling task */
+
+#ifndef CONFIG_NU_OS
+    #define CONFIG_NU_OS         NU_OS_BAREMETAL /*!< Implementation below the nu_os calls */
+#endif
+
+#define NU_OS_WAIT_FOREVER          0xFFFFFFFFUL /*!< Timeout of a wait that only returns once signalled */
+
+#define CONFIG_NU_OS_ETHOSU_SEM_NUM          4   /*!< Ethos-U driver mutexes and semaphores, one each plus one per NPU */
+
+#if (CONFIG_NU_OS == NU_OS_FREERTOS)
+    #include "FreeRTOS.h"
+    #include "semphr.h"
+    #include "event_groups.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CONFIG_NU_OS == NU_OS_FREERTOS)
+
+typedef struct
+{
+    SemaphoreHandle_t m_hSem;
+    StaticSemaphore_t m_sSem;
+} nu_os_sem_t;
+
+typedef struct
+{
+    EventGroupHandle_t m_hEvent;
+    StaticEventGroup_t m_sEvent;
+} nu_os_event_t;
+
+#else
+
+typedef struct
+{
+    volatile uint32_t m_u32Count;
+} nu_os_sem_t;
+
+typedef struct
+{
+    volatile uint32_t m_u32Bits;
+} nu_os_event_t;
+
+#endif
+
+/* Give and set may be called from interrupts, everything else only from thread mode with interrupts
+   enabled. Under FreeRTOS the interrupts signalling must sit at or below
+   configMAX_SYSCALL_INTERRUPT_PRIORITY, and setting event bits from them needs the timer task. */
+
+// Function to initialize a counting semaphore holding u32Count
+void nu_os_sem_init(nu_os_sem_t *psSem, uint32_t u32Count);
+
+// Function to take a semaphore, returns 0 or -1 on timeout
+int nu_os_sem_take(nu_os_sem_t *psSem, uint32_t u32TimeoutMs);
+
+// Function to give a semaphore, from a thread or an interrupt
+void nu_os_sem_give(nu_os_sem_t *psSem);
+
+// Function to initialize an event group with no bit set
+void nu_os_event_init(nu_os_event_t *psEvent);
+
+// Function to wait for any or, with i32All, every bit of u32Bits, returns the bits waited for or 0 on timeout
+// The bits returned are cleared.
+uint32_t nu_os_event_wait(nu_os_event_t *psEvent, uint32_t u32Bits, int i32All, uint32_t u32TimeoutMs);
+
+// Function to set event bits, from a thread or an interrupt
+void nu_os_event_set(nu_os_event_t *psEvent, uint32_t u32Bits);
+
+// Function to clear event bits
+void nu_os_event_clear(nu_os_event_t *psEvent, uint32_t u32Bits);
+
+// Function to give the CPU to other tasks inside a polling loop, nothing on bare metal
+void nu_os_yield(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NU_OS_H__ */
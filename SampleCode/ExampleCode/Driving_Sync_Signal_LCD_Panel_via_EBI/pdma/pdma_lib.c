@@ -9,6 +9,7 @@
 #include "pdma_lib.h"
 #include "component.h"
 #include "nu_bitutil.h"
+#include "nu_os.h"
 #include "string.h"
 #include "stdlib.h"
 
@@ -61,11 +62,17 @@ struct nu_pdma_chn
 };
 typedef struct nu_pdma_chn nu_pdma_chn_t;
 
+struct nu_pdma_vector
+{
+    nu_pdma_cb_handler_t   m_pfnHandler;
+    void                  *m_pvUserData;
+};
+
 struct nu_pdma_memfun_actor
 {
     int         m_i32ChannID;
     uint32_t    m_u32Result;
-    volatile uint32_t m_psSemMemFun;
+    nu_os_sem_t m_psSemMemFun;
 } ;
 typedef struct nu_pdma_memfun_actor *nu_pdma_memfun_actor_t;
 
@@ -98,6 +105,22 @@ static const nu_pdma_periph_ctl_t g_nu_pdma_peripheral_ctl_pool[ ] =
 {
     // M2M
     { PDMA_MEM, eMemCtl_SrcInc_DstInc },
+
+    // P2M
+    { PDMA_UART0_RX, eMemCtl_SrcFix_DstInc },
+    { PDMA_UART1_RX, eMemCtl_SrcFix_DstInc },
+    { PDMA_SPI0_RX, eMemCtl_SrcFix_DstInc },
+    { PDMA_I2S0_RX, eMemCtl_SrcFix_DstInc },
+    { PDMA_I2S1_RX, eMemCtl_SrcFix_DstInc },
+    { PDMA_EADC0_RX, eMemCtl_SrcFix_DstInc },
+    { PDMA_EADC1_RX, eMemCtl_SrcFix_DstInc },
+
+    // M2P
+    { PDMA_UART0_TX, eMemCtl_SrcInc_DstFix },
+    { PDMA_UART1_TX, eMemCtl_SrcInc_DstFix },
+    { PDMA_SPI0_TX, eMemCtl_SrcInc_DstFix },
+    { PDMA_I2S0_TX, eMemCtl_SrcInc_DstFix },
+    { PDMA_I2S1_TX, eMemCtl_SrcInc_DstFix },
 };
 #define NU_PERIPHERAL_SIZE ( sizeof(g_nu_pdma_peripheral_ctl_pool) / sizeof(g_nu_pdma_peripheral_ctl_pool[0]) )
 
@@ -107,6 +130,13 @@ static struct nu_pdma_memfun_actor nu_pdma_memfun_actor_arr[NU_PDMA_MEMFUN_ACTOR
 static DSCT_T nu_pdma_sgtbl_arr[NU_PDMA_SGTBL_POOL_SIZE] = { 0 };
 static uint32_t nu_pdma_sgtbl_token[NVT_ALIGN(NU_PDMA_SGTBL_POOL_SIZE, 32) / 32];
 
+/* Per-channel direct vectors, checked before the generic callbacks. */
+static struct nu_pdma_vector nu_pdma_vector_arr[NU_PDMA_CH_MAX];
+
+#if (NU_PDMA_ISR_STATS == 1)
+static struct nu_pdma_isr_stats nu_pdma_isr_stats = { .m_u32MinCycles = UINT32_MAX };
+#endif
+
 /*---------------------------------------------------------------------------*/
 /* Functions                                                                 */
 /*---------------------------------------------------------------------------*/
@@ -182,6 +212,12 @@ static void nu_pdma_init(void)
 
     }
 
+#if (NU_PDMA_ISR_STATS == 1)
+    /* Dispatch latency is counted in core cycles. */
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
     /* Initialize token pool. */
     memset(&nu_pdma_sgtbl_token[0], 0xff, sizeof(nu_pdma_sgtbl_token));
 
@@ -340,6 +376,7 @@ int nu_pdma_channel_free(int i32ChannID)
     {
         nu_pdma_chn_mask_arr[NU_PDMA_GET_MOD_IDX(i32ChannID)] &= ~(1 << NU_PDMA_GET_MOD_CHIDX(i32ChannID));
         nu_pdma_channel_disable(i32ChannID);
+        nu_pdma_vector_arr[i32ChannID - NU_PDMA_CH_Pos].m_pfnHandler = NULL;
         ret =  0;
     }
 
@@ -970,109 +1007,395 @@ exit_nu_pdma_sg_transfer:
     return -(ret);
 }
 
-void PDMA_IRQHandler(PDMA_T *PDMA)
+static void nu_pdma_ring_cb(void *pvUserData, uint32_t u32Events)
 {
-    int i;
+    nu_pdma_ring_t psRing = (nu_pdma_ring_t)pvUserData;
+    uint32_t u32SegIdx = psRing->m_u32SegDone % psRing->m_u32SegNum;
+    uint8_t *pu8Seg = psRing->m_pu8Buf + u32SegIdx * psRing->m_u32SegBytes;
 
-    uint32_t intsts = PDMA_GET_INT_STATUS(PDMA);
-    uint32_t abtsts = PDMA_GET_ABORT_STS(PDMA);
-    uint32_t tdsts  = PDMA_GET_TD_STS(PDMA);
-    uint32_t unalignsts  = PDMA_GET_ALIGN_STS(PDMA);
-    uint32_t reqto  = intsts & PDMA_INTSTS_REQTOFn_Msk;
-    uint32_t reqto_ch = (reqto >> PDMA_INTSTS_REQTOFn_Pos);
+    if (u32Events & NU_PDMA_EVENT_TRANSFER_DONE)
+    {
+        uint32_t u32RingEvents = NU_PDMA_EVENT_TRANSFER_DONE;
 
-    int allch_sts = (reqto_ch | tdsts | abtsts | unalignsts);
+        psRing->m_u32SegDone++;
 
-    // Abort
-    if (intsts & PDMA_INTSTS_ABTIF_Msk)
+        if (psRing->m_u32IsRx)
+        {
+            /* PDMA is filling the oldest segment again, the user did not give it back in time. */
+            if ((psRing->m_u32SegDone - psRing->m_u32SegReleased) >= psRing->m_u32SegNum)
+            {
+                psRing->m_u32SegReleased = psRing->m_u32SegDone - psRing->m_u32SegNum + 1;
+                psRing->m_u32Overruns++;
+                u32RingEvents |= NU_PDMA_EVENT_OVERRUN;
+            }
+
+#if (NVT_DCACHE_ON == 1)
+            SCB_InvalidateDCache_by_Addr((volatile void *)pu8Seg, (int32_t)psRing->m_u32SegBytes);
+#endif
+        }
+        else
+        {
+            /* PDMA is sending a segment the user did not refill. */
+            if ((int32_t)(psRing->m_u32SegReleased - psRing->m_u32SegDone) <= 0)
+            {
+                psRing->m_u32SegReleased = psRing->m_u32SegDone + 1;
+                psRing->m_u32Overruns++;
+                u32RingEvents |= NU_PDMA_EVENT_OVERRUN;
+            }
+        }
+
+        if (psRing->m_pfnCBHandler)
+            psRing->m_pfnCBHandler(psRing->m_pvUserData, u32SegIdx, psRing->m_u32SegBytes, u32RingEvents);
+
+        u32SegIdx = psRing->m_u32SegDone % psRing->m_u32SegNum;
+        pu8Seg = psRing->m_pu8Buf + u32SegIdx * psRing->m_u32SegBytes;
+    }
+
+    /* Peripheral went idle in the middle of a segment, hand over what arrived so far. */
+    if ((u32Events & NU_PDMA_EVENT_TIMEOUT) && psRing->m_u32IsRx)
     {
-        // Clear all Abort flags
-        PDMA_CLR_ABORT_FLAG(PDMA, abtsts);
+        int i32Bytes = nu_pdma_transferred_byte_get(psRing->m_i32ChannID, psRing->m_u32SegBytes);
+
+        if (i32Bytes > 0)
+        {
+#if (NVT_DCACHE_ON == 1)
+            SCB_InvalidateDCache_by_Addr((volatile void *)pu8Seg, i32Bytes);
+#endif
+
+            if (psRing->m_pfnCBHandler)
+                psRing->m_pfnCBHandler(psRing->m_pvUserData, u32SegIdx, i32Bytes, NU_PDMA_EVENT_TIMEOUT);
+        }
+    }
+
+    if (u32Events & NU_PDMA_EVENT_ABORT)
+    {
+        if (psRing->m_pfnCBHandler)
+            psRing->m_pfnCBHandler(psRing->m_pvUserData, u32SegIdx, 0, NU_PDMA_EVENT_ABORT);
+    }
+}
+
+int nu_pdma_ring_setup(nu_pdma_ring_t psRing, int i32ChannID, uint32_t u32DataWidth, uint32_t u32PeriphAddr,
+                       void *pvBuf, uint32_t u32SegTxCnt, uint32_t u32SegNum, nu_pdma_ring_cb_t pfnCBHandler, void *pvUserData)
+{
+    int i, ret = 1;
+    uint32_t u32SegBytes = u32SegTxCnt * (u32DataWidth / 8);
+    nu_pdma_memctrl_t eMemCtl;
+    struct nu_pdma_chn_cb sChnCB;
+
+    if (!psRing || !pvBuf)
+        goto exit_nu_pdma_ring_setup;
+    else if (nu_pdma_check_is_nonallocated(i32ChannID))
+        goto exit_nu_pdma_ring_setup;
+    else if ((u32SegNum < 2) || (u32SegNum > NU_PDMA_RING_SEG_MAX))
+        goto exit_nu_pdma_ring_setup;
+    else if (!u32SegTxCnt || (u32SegTxCnt > NU_PDMA_MAX_TXCNT))
+        goto exit_nu_pdma_ring_setup;
+    /* Segments are invalidated or cleaned one by one, they must not share a cache line. */
+    else if (((uint32_t)pvBuf & (DCACHE_LINE_SIZE - 1)) || (u32SegBytes & (DCACHE_LINE_SIZE - 1)))
+        goto exit_nu_pdma_ring_setup;
+
+    eMemCtl = nu_pdma_channel_memctrl_get(i32ChannID);
+
+    if ((eMemCtl != eMemCtl_SrcFix_DstInc) && (eMemCtl != eMemCtl_SrcInc_DstFix))
+        goto exit_nu_pdma_ring_setup;
+
+    memset(psRing, 0, sizeof(struct nu_pdma_ring));
+
+    psRing->m_i32ChannID   = i32ChannID;
+    psRing->m_pu8Buf       = (uint8_t *)pvBuf;
+    psRing->m_u32SegBytes  = u32SegBytes;
+    psRing->m_u32SegNum    = u32SegNum;
+    psRing->m_u32IsRx      = (eMemCtl == eMemCtl_SrcFix_DstInc) ? 1 : 0;
+    psRing->m_pfnCBHandler = pfnCBHandler;
+    psRing->m_pvUserData   = pvUserData;
+
+    /* Ring nodes come from the shared table pool, so NEXT offsets stay inside one window. */
+    if (nu_pdma_sgtbls_allocate(psRing->m_apsDesc, u32SegNum) != 0)
+        goto exit_nu_pdma_ring_setup;
+
+    for (i = 0; i < u32SegNum; i++)
+    {
+        uint32_t u32SegAddr = (uint32_t)psRing->m_pu8Buf + i * u32SegBytes;
+
+        /* Every node raises its own TD interrupt, the last one links back to the first. */
+        ret = nu_pdma_desc_setup(i32ChannID,
+                                 psRing->m_apsDesc[i],
+                                 u32DataWidth,
+                                 psRing->m_u32IsRx ? u32PeriphAddr : u32SegAddr,
+                                 psRing->m_u32IsRx ? u32SegAddr : u32PeriphAddr,
+                                 u32SegTxCnt,
+                                 psRing->m_apsDesc[(i + 1) % u32SegNum],
+                                 0);
+
+        if (ret != 0)
+            goto fail_nu_pdma_ring_setup;
+    }
+
+    sChnCB.m_eCBType = eCBType_Event;
+    sChnCB.m_pfnCBHandler = nu_pdma_ring_cb;
+    sChnCB.m_pvUserData = (void *)psRing;
+
+    nu_pdma_filtering_set(i32ChannID, NU_PDMA_EVENT_ALL);
+    nu_pdma_callback_register(i32ChannID, &sChnCB);
+
+    return 0;
+
+fail_nu_pdma_ring_setup:
+
+    nu_pdma_sgtbls_free(psRing->m_apsDesc, u32SegNum);
+    ret = 1;
+
+exit_nu_pdma_ring_setup:
+
+    return -(ret);
+}
+
+int nu_pdma_ring_start(nu_pdma_ring_t psRing, uint32_t u32IdleTimeout_us)
+{
+    int ret = 1;
+    nu_pdma_periph_ctl_t *psPeriphCtl = NULL;
+
+    if (!psRing || !psRing->m_apsDesc[0])
+        goto exit_nu_pdma_ring_start;
+    else if (nu_pdma_check_is_nonallocated(psRing->m_i32ChannID))
+        goto exit_nu_pdma_ring_start;
+
+    psPeriphCtl = &nu_pdma_chn_arr[psRing->m_i32ChannID - NU_PDMA_CH_Pos].m_spPeripCtl;
+
+    /* A TX ring keeps the segments filled before start, a RX ring begins empty. */
+    psRing->m_u32SegDone = 0;
+    psRing->m_u32Overruns = 0;
+
+    if (psRing->m_u32IsRx)
+        psRing->m_u32SegReleased = 0;
+
+    _nu_pdma_transfer(psRing->m_i32ChannID, psPeriphCtl->m_u32Peripheral, psRing->m_apsDesc[0], u32IdleTimeout_us);
+
+    ret = 0;
+
+exit_nu_pdma_ring_start:
+
+    return -(ret);
+}
+
+int nu_pdma_ring_release(nu_pdma_ring_t psRing, uint32_t u32SegCnt)
+{
+    int ret = 1;
+
+    if (!psRing || !psRing->m_apsDesc[0])
+        goto exit_nu_pdma_ring_release;
+    else if (u32SegCnt > psRing->m_u32SegNum)
+        goto exit_nu_pdma_ring_release;
+
+    if (psRing->m_u32IsRx)
+    {
+        /* Never run ahead of PDMA, a late release after an overrun is dropped. */
+        uint32_t u32Held = psRing->m_u32SegDone - psRing->m_u32SegReleased;
+
+        psRing->m_u32SegReleased += (u32SegCnt < u32Held) ? u32SegCnt : u32Held;
+    }
+    else
+    {
+#if (NVT_DCACHE_ON == 1)
+        uint32_t i;
+
+        for (i = 0; i < u32SegCnt; i++)
+        {
+            uint32_t u32SegIdx = (psRing->m_u32SegReleased + i) % psRing->m_u32SegNum;
+
+            SCB_CleanDCache_by_Addr((volatile void *)(psRing->m_pu8Buf + u32SegIdx * psRing->m_u32SegBytes), (int32_t)psRing->m_u32SegBytes);
+        }
+#endif
+
+        psRing->m_u32SegReleased += u32SegCnt;
     }
 
-    // Transfer done
+    ret = 0;
+
+exit_nu_pdma_ring_release:
+
+    return -(ret);
+}
+
+void *nu_pdma_ring_segment_get(nu_pdma_ring_t psRing, uint32_t u32SegIdx)
+{
+    if (!psRing || (u32SegIdx >= psRing->m_u32SegNum))
+        return NULL;
+
+    return (void *)(psRing->m_pu8Buf + u32SegIdx * psRing->m_u32SegBytes);
+}
+
+void nu_pdma_ring_stop(nu_pdma_ring_t psRing)
+{
+    struct nu_pdma_chn_cb sChnCB;
+
+    if (!psRing || !psRing->m_apsDesc[0])
+        goto exit_nu_pdma_ring_stop;
+
+    nu_pdma_timeout_set(psRing->m_i32ChannID, 0);
+    nu_pdma_channel_terminate(psRing->m_i32ChannID);
+
+    sChnCB.m_eCBType = eCBType_Event;
+    sChnCB.m_pfnCBHandler = NULL;
+    sChnCB.m_pvUserData = NULL;
+    nu_pdma_callback_register(psRing->m_i32ChannID, &sChnCB);
+
+    nu_pdma_sgtbls_free(psRing->m_apsDesc, psRing->m_u32SegNum);
+
+exit_nu_pdma_ring_stop:
+
+    return;
+}
+
+int nu_pdma_vector_register(int i32ChannID, nu_pdma_cb_handler_t pfnHandler, void *pvUserData)
+{
+    int ret = 1;
+    struct nu_pdma_vector *psVector;
+
+    if (nu_pdma_check_is_nonallocated(i32ChannID))
+        goto exit_nu_pdma_vector_register;
+
+    psVector = &nu_pdma_vector_arr[i32ChannID - NU_PDMA_CH_Pos];
+
+    /* Clear the handler first, the ISR never sees a new handler with old user data. */
+    psVector->m_pfnHandler = NULL;
+    psVector->m_pvUserData = pvUserData;
+    psVector->m_pfnHandler = pfnHandler;
+
+    ret = 0;
+
+exit_nu_pdma_vector_register:
+
+    return -(ret);
+}
+
+#if (NU_PDMA_ISR_STATS == 1)
+void nu_pdma_isr_stats_get(struct nu_pdma_isr_stats *psStats)
+{
+    PDMA_ASSERT(psStats != NULL);
+
+    *psStats = nu_pdma_isr_stats;
+    psStats->m_u32AvgCycles = nu_pdma_isr_stats.m_u32Count ? (uint32_t)(nu_pdma_isr_stats.m_u64SumCycles / nu_pdma_isr_stats.m_u32Count) : 0;
+}
+
+void nu_pdma_isr_stats_reset(void)
+{
+    memset(&nu_pdma_isr_stats, 0, sizeof(nu_pdma_isr_stats));
+    nu_pdma_isr_stats.m_u32MinCycles = UINT32_MAX;
+}
+#endif
+
+__STATIC_FORCEINLINE void nu_pdma_isr_dispatch(PDMA_T *PDMA, int module_id)
+{
+#if (NU_PDMA_ISR_STATS == 1)
+    uint32_t u32Entry = DWT->CYCCNT;
+#endif
+    uint32_t intsts = PDMA_GET_INT_STATUS(PDMA);
+    uint32_t abtsts = 0;
+    uint32_t tdsts = 0;
+    uint32_t unalignsts = 0;
+    uint32_t reqto_ch = (intsts & PDMA_INTSTS_REQTOFn_Msk) >> PDMA_INTSTS_REQTOFn_Pos;
+    uint32_t allch_sts;
+
+    /* Only read and clear the status registers flagged in INTSTS. */
     if (intsts & PDMA_INTSTS_TDIF_Msk)
     {
-        // Clear all transfer done flags
+        tdsts = PDMA_GET_TD_STS(PDMA);
         PDMA_CLR_TD_FLAG(PDMA, tdsts);
     }
 
-    // Unaligned
+    if (intsts & PDMA_INTSTS_ABTIF_Msk)
+    {
+        abtsts = PDMA_GET_ABORT_STS(PDMA);
+        PDMA_CLR_ABORT_FLAG(PDMA, abtsts);
+    }
+
     if (intsts & PDMA_INTSTS_ALIGNF_Msk)
     {
-        // Clear all Unaligned flags
+        unalignsts = PDMA_GET_ALIGN_STS(PDMA);
         PDMA_CLR_ALIGN_FLAG(PDMA, unalignsts);
     }
 
-    // Timeout
-    if (reqto)
+    if (reqto_ch)
     {
-        // Clear all Timeout flags
-        PDMA->INTSTS = reqto;
+        PDMA->INTSTS = reqto_ch << PDMA_INTSTS_REQTOFn_Pos;
+        PDMA_DisableTimeout(PDMA, reqto_ch);
     }
 
-    // Find the position of first '1' in allch_sts.
-    while ((i = nu_ctz(allch_sts)) < PDMA_CH_MAX)
+    /* Visit pending and allocated channels only. */
+    allch_sts = (reqto_ch | tdsts | abtsts | unalignsts) & nu_pdma_chn_mask_arr[module_id];
+
+    while (allch_sts)
     {
-        int module_id = ((uint32_t)PDMA - PDMA0_BASE) / 0x10000UL;
+        int i = nu_ctz(allch_sts);
         int j = i + (module_id * PDMA_CH_MAX);
-        int ch_mask = (1 << i);
+        uint32_t ch_mask = (1ul << i);
+        uint32_t ch_event = 0;
+        struct nu_pdma_vector *psVector = &nu_pdma_vector_arr[j - NU_PDMA_CH_Pos];
+        nu_pdma_cb_handler_t pfnHandler = psVector->m_pfnHandler;
 
-        if (nu_pdma_chn_mask_arr[module_id] & ch_mask)
+        if (tdsts & ch_mask)
+            ch_event |= NU_PDMA_EVENT_TRANSFER_DONE;
+
+        if (abtsts & ch_mask)
+            ch_event |= NU_PDMA_EVENT_ABORT;
+
+        if (unalignsts & ch_mask)
+            ch_event |= NU_PDMA_EVENT_ALIGNMENT;
+
+        if (reqto_ch & ch_mask)
+            ch_event |= NU_PDMA_EVENT_TIMEOUT;
+
+#if (NU_PDMA_ISR_STATS == 1)
         {
-            int ch_event = 0;
-            nu_pdma_chn_t *dma_chn = nu_pdma_chn_arr + j - NU_PDMA_CH_Pos;
+            uint32_t u32Cycles = DWT->CYCCNT - u32Entry;
 
-            if (dma_chn->m_sCB_Event.m_pfnCBHandler)
-            {
-                if (abtsts & ch_mask)
-                {
-                    ch_event |= NU_PDMA_EVENT_ABORT;
-                }
+            nu_pdma_isr_stats.m_u32Count++;
+            nu_pdma_isr_stats.m_u64SumCycles += u32Cycles;
 
-                if (tdsts & ch_mask)
-                {
-                    ch_event |= NU_PDMA_EVENT_TRANSFER_DONE;
-                }
+            if (u32Cycles < nu_pdma_isr_stats.m_u32MinCycles)
+                nu_pdma_isr_stats.m_u32MinCycles = u32Cycles;
 
-                if (unalignsts & ch_mask)
-                {
-                    ch_event |= NU_PDMA_EVENT_ALIGNMENT;
-                }
+            if (u32Cycles > nu_pdma_isr_stats.m_u32MaxCycles)
+                nu_pdma_isr_stats.m_u32MaxCycles = u32Cycles;
+        }
+#endif
 
-                if (reqto_ch & ch_mask)
-                {
-                    PDMA_DisableTimeout(PDMA,  ch_mask);
-                    ch_event |= NU_PDMA_EVENT_TIMEOUT;
-                }
+        if (pfnHandler)
+        {
+            /* Direct vector: raw events, no filter and no disable hook. */
+            pfnHandler(psVector->m_pvUserData, ch_event);
+        }
+        else
+        {
+            nu_pdma_chn_t *dma_chn = nu_pdma_chn_arr + j - NU_PDMA_CH_Pos;
 
+            if (dma_chn->m_sCB_Event.m_pfnCBHandler)
+            {
                 if (dma_chn->m_sCB_Disable.m_pfnCBHandler)
                     dma_chn->m_sCB_Disable.m_pfnCBHandler(dma_chn->m_sCB_Disable.m_pvUserData, dma_chn->m_sCB_Disable.m_u32Reserved);
 
                 if (dma_chn->m_u32EventFilter & ch_event)
                     dma_chn->m_sCB_Event.m_pfnCBHandler(dma_chn->m_sCB_Event.m_pvUserData, ch_event);
+            }
+        }
 
-                if (reqto_ch & ch_mask)
-                    nu_pdma_timeout_set(j, nu_pdma_chn_arr[j - NU_PDMA_CH_Pos].m_u32IdleTimeout_us);
-
-            }//if(dma_chn->handler)
-
-        } //if (nu_pdma_chn_mask & ch_mask)
+        if (reqto_ch & ch_mask)
+            nu_pdma_timeout_set(j, nu_pdma_chn_arr[j - NU_PDMA_CH_Pos].m_u32IdleTimeout_us);
 
         // Clear the served bit.
         allch_sts &= ~ch_mask;
-
-    } //while
+    }
 }
 
-void PDMA0_IRQHandler(void)
+NVT_ITCM void PDMA0_IRQHandler(void)
 {
-    PDMA_IRQHandler(PDMA0);
+    nu_pdma_isr_dispatch(PDMA0, 0);
 }
 
-void PDMA1_IRQHandler(void)
+NVT_ITCM void PDMA1_IRQHandler(void)
 {
-    PDMA_IRQHandler(PDMA1);
+    nu_pdma_isr_dispatch(PDMA1, 1);
 }
 
 static void nu_pdma_memfun_actor_init(void)
@@ -1086,7 +1409,7 @@ static void nu_pdma_memfun_actor_init(void)
 
         if (-(1) != (nu_pdma_memfun_actor_arr[i].m_i32ChannID = nu_pdma_channel_allocate(PDMA_MEM)))
         {
-            nu_pdma_memfun_actor_arr[i].m_psSemMemFun = 0;
+            nu_os_sem_init(&nu_pdma_memfun_actor_arr[i].m_psSemMemFun, 0);
         }
         else
             break;
@@ -1104,12 +1427,16 @@ static void nu_pdma_memfun_cb(void *pvUserData, uint32_t u32Events)
     nu_pdma_memfun_actor_t psMemFunActor = (nu_pdma_memfun_actor_t)pvUserData;
     psMemFunActor->m_u32Result = u32Events;
 
-    psMemFunActor->m_psSemMemFun = 1;
+    nu_os_sem_give(&psMemFunActor->m_psSemMemFun);
 }
 
 static int nu_pdma_memfun_employ(void)
 {
     int idx = -1;
+    uint32_t u32PriMask = __get_PRIMASK();
+
+    /* Tasks may employ actors concurrently. */
+    __disable_irq();
 
     /* Headhunter */
     {
@@ -1126,6 +1453,8 @@ static int nu_pdma_memfun_employ(void)
         }
     }
 
+    __set_PRIMASK(u32PriMask);
+
     return idx;
 }
 
@@ -1135,6 +1464,7 @@ static int nu_pdma_memfun(void *dest, void *src, uint32_t u32DataWidth, unsigned
 
     nu_pdma_memfun_actor_t psMemFunActor = NULL;
     struct nu_pdma_chn_cb sChnCB;
+    uint32_t u32PriMask;
     int idx, ret = 0;
 
     if (!i32memActorInited)
@@ -1144,7 +1474,8 @@ static int nu_pdma_memfun(void *dest, void *src, uint32_t u32DataWidth, unsigned
     }
 
     /* Employ actor */
-    while ((idx = nu_pdma_memfun_employ()) < 0);
+    while ((idx = nu_pdma_memfun_employ()) < 0)
+        nu_os_yield();
 
     psMemFunActor = &nu_pdma_memfun_actor_arr[idx];
 
@@ -1169,10 +1500,8 @@ static int nu_pdma_memfun(void *dest, void *src, uint32_t u32DataWidth, unsigned
                      u32TransferCnt,
                      0);
 
-    /* Wait it done. */
-    while (psMemFunActor->m_psSemMemFun == 0);
-
-    psMemFunActor->m_psSemMemFun = 0;
+    /* Wait it done, the CPU is free for other work until the event interrupt gives it. */
+    nu_os_sem_take(&psMemFunActor->m_psSemMemFun, NU_OS_WAIT_FOREVER);
 
     /* Give result if get NU_PDMA_EVENT_TRANSFER_DONE.*/
     if (psMemFunActor->m_u32Result & NU_PDMA_EVENT_TRANSFER_DONE)
@@ -1190,7 +1519,10 @@ static int nu_pdma_memfun(void *dest, void *src, uint32_t u32DataWidth, unsigned
         nu_pdma_channel_terminate(psMemFunActor->m_i32ChannID);
     }
 
+    u32PriMask = __get_PRIMASK();
+    __disable_irq();
     nu_pdma_memfun_actor_mask &= ~(1 << idx);
+    __set_PRIMASK(u32PriMask);
 
     return ret;
 }
@@ -15,6 +15,14 @@
     #define NU_PDMA_SGTBL_POOL_SIZE     (16)
 #endif
 
+#ifndef NU_PDMA_ISR_STATS
+    #define NU_PDMA_ISR_STATS           (1)     /* Measure ISR entry to dispatch cycles */
+#endif
+
+#ifndef NU_PDMA_RING_SEG_MAX
+    #define NU_PDMA_RING_SEG_MAX        (8)
+#endif
+
 #define NU_PDMA_CAP_NONE                (0 << 0)
 
 #define NU_PDMA_EVENT_ABORT             (1 << 0)
@@ -23,6 +31,7 @@
 #define NU_PDMA_EVENT_TIMEOUT           (1 << 3)
 #define NU_PDMA_EVENT_ALL               (NU_PDMA_EVENT_ABORT | NU_PDMA_EVENT_TRANSFER_DONE | NU_PDMA_EVENT_TIMEOUT)
 #define NU_PDMA_EVENT_MASK              NU_PDMA_EVENT_ALL
+#define NU_PDMA_EVENT_OVERRUN           (1 << 4)    /* Ring only: a segment was reused before nu_pdma_ring_release */
 #define NU_PDMA_UNUSED                  (-1)
 
 #define NU_PDMA_SG_LIMITED_DISTANCE     ((PDMA_DSCT_NEXT_NEXT_Msk>>PDMA_DSCT_NEXT_NEXT_Pos)+1)
@@ -76,6 +85,36 @@ struct nu_module
 } ;
 typedef struct nu_module *nu_module_t;
 
+struct nu_pdma_isr_stats
+{
+    uint32_t               m_u32Count;
+    uint32_t               m_u32MinCycles;
+    uint32_t               m_u32AvgCycles;
+    uint32_t               m_u32MaxCycles;
+    uint64_t               m_u64SumCycles;
+};
+
+/* Segment callback of a ring, u32Bytes is the valid length of the segment so far. */
+typedef void (*nu_pdma_ring_cb_t)(void *pvUserData, uint32_t u32SegIdx, uint32_t u32Bytes, uint32_t u32Events);
+
+struct nu_pdma_ring
+{
+    int                    m_i32ChannID;
+    nu_pdma_desc_t         m_apsDesc[NU_PDMA_RING_SEG_MAX];
+    uint8_t               *m_pu8Buf;
+    uint32_t               m_u32SegBytes;
+    uint32_t               m_u32SegNum;
+    uint32_t               m_u32IsRx;
+
+    volatile uint32_t      m_u32SegDone;        /* Segments finished by PDMA */
+    volatile uint32_t      m_u32SegReleased;    /* Segments handed back (RX) or filled (TX) by user */
+    volatile uint32_t      m_u32Overruns;
+
+    nu_pdma_ring_cb_t      m_pfnCBHandler;
+    void                  *m_pvUserData;
+};
+typedef struct nu_pdma_ring *nu_pdma_ring_t;
+
 int nu_pdma_channel_allocate(int32_t i32PeripType);
 int nu_pdma_channel_free(int i32ChannID);
 int nu_pdma_callback_register(int i32ChannID, nu_pdma_chn_cb_t psChnCb);
@@ -87,6 +126,7 @@ int nu_pdma_channel_memctrl_set(int i32ChannID, nu_pdma_memctrl_t eMemCtrl);
 
 nu_pdma_cb_handler_t nu_pdma_callback_hijack(int i32ChannID, nu_pdma_cbtype_t eCBType, nu_pdma_chn_cb_t psChnCb_Hijack);
 int nu_pdma_filtering_set(int i32ChannID, uint32_t u32EventFilter);
+int nu_pdma_vector_register(int i32ChannID, nu_pdma_cb_handler_t pfnHandler, void *pvUserData);
 uint32_t nu_pdma_filtering_get(int i32ChannID);
 
 // For scatter-gather DMA
@@ -97,6 +137,19 @@ void nu_pdma_sgtbls_free(nu_pdma_desc_t *ppsSgtbls, int num);
 int nu_pdma_m2m_desc_setup(nu_pdma_desc_t dma_desc, uint32_t u32DataWidth, uint32_t u32AddrSrc,
                            uint32_t u32AddrDst, int32_t i32TransferCnt, nu_pdma_memctrl_t evMemCtrl, nu_pdma_desc_t next, uint32_t u32BeSilent);
 
+#if (NU_PDMA_ISR_STATS == 1)
+void nu_pdma_isr_stats_get(struct nu_pdma_isr_stats *psStats);
+void nu_pdma_isr_stats_reset(void);
+#endif
+
+// For circular scatter-gather DMA on EADC, I2S, UART and SPI
+int nu_pdma_ring_setup(nu_pdma_ring_t psRing, int i32ChannID, uint32_t u32DataWidth, uint32_t u32PeriphAddr,
+                       void *pvBuf, uint32_t u32SegTxCnt, uint32_t u32SegNum, nu_pdma_ring_cb_t pfnCBHandler, void *pvUserData);
+int nu_pdma_ring_start(nu_pdma_ring_t psRing, uint32_t u32IdleTimeout_us);
+int nu_pdma_ring_release(nu_pdma_ring_t psRing, uint32_t u32SegCnt);
+void *nu_pdma_ring_segment_get(nu_pdma_ring_t psRing, uint32_t u32SegIdx);
+void nu_pdma_ring_stop(nu_pdma_ring_t psRing);
+
 // For memory actor
 void *nu_pdma_memcpy(void *dest, void *src, unsigned int count);
 int nu_pdma_mempush(void *dest, void *src, uint32_t data_width, unsigned int transfer_count);
@@ -0,0 +1,458 @@
+/**************************************************************************//**
+ * @file     screenshot.c
+ * @brief    Encrypted screenshots of the presented frame through the AES DMA engine.
+ *
+ *           A capture walks the lines of a rectangle of the presented VRAM
+ *           buffer and lets the AES engine encrypt them in DMA cascade mode
+ *           straight into one of two staging buffers. A full staging buffer
+ *           is handed to the sink, by default an SD slot through sdh_async,
+ *           while the other one is being filled. All work happens in
+ *           screenshot_poll within the idle budget of the caller, so the
+ *           scan-out is never held up by a capture.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <string.h>
+#include "screenshot.h"
+#include "disp_mem.h"
+#include "sdh_async.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_SHOT_STAGE_NUM       2
+#define DEF_SHOT_COL_ALIGN       8UL            /*!< RGB565 pixels per AES block */
+
+/* One header sector, then the ciphertext of a whole frame. */
+#define DEF_SHOT_SLOT_SECTORS    (1UL + (NVT_ALIGN(CONFIG_VRAM_BUF_SIZE, CONFIG_SCREENSHOT_CHUNK_SIZE) / SDH_BLOCK_SIZE))
+
+#if (CONFIG_SCREENSHOT_CHUNK_SIZE % SDH_BLOCK_SIZE) || (CONFIG_SCREENSHOT_CHUNK_SIZE % DCACHE_LINE_SIZE)
+    #error "CONFIG_SCREENSHOT_CHUNK_SIZE must be a multiple of SDH_BLOCK_SIZE and DCACHE_LINE_SIZE."
+#endif
+
+typedef enum
+{
+    evShotIdle,              /*!< No capture */
+    evShotCrypt,             /*!< Lines are being encrypted into the staging buffers */
+    evShotFlush,             /*!< Waiting for the last staging buffers to be written */
+    evShotHeader,            /*!< Header written, waiting for it to finish */
+} E_SHOT_STATE;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+#if defined(NVT_NONCACHEABLE)
+    NVT_NONCACHEABLE static uint8_t s_au8Stage[DEF_SHOT_STAGE_NUM][CONFIG_SCREENSHOT_CHUNK_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE)));
+    NVT_NONCACHEABLE static uint8_t s_au8HdrSec[SDH_BLOCK_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE)));
+#else
+    static uint8_t s_au8Stage[DEF_SHOT_STAGE_NUM][CONFIG_SCREENSHOT_CHUNK_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE)));
+    static uint8_t s_au8HdrSec[SDH_BLOCK_SIZE] __attribute__((aligned(DCACHE_LINE_SIZE)));
+#endif
+
+static uint32_t s_au32Key[8];
+static uint32_t s_u32KeySize;
+static uint32_t s_u32Nonce;
+static int s_i32KeySet = 0;
+static int s_i32RngOk = 0;                   // PRNG seeded from the TRNG is ready
+
+static SCREENSHOT_SINK s_pfnSink = NULL;
+static void *s_pvSinkUserData = NULL;
+
+static E_SHOT_STATE s_evState = evShotIdle;
+static S_SCREENSHOT_HDR s_sHdr;
+static volatile uint32_t s_u32Flags;         // Also set by SD callbacks
+static uint32_t s_u32Seq = 0;
+static uint32_t s_u32SlotSec;
+
+static const uint8_t *s_pu8Frame;            // Presented buffer when the capture started
+static uint32_t s_u32Stride;                 // Bytes per frame line
+static uint32_t s_u32LineBytes;              // Bytes per rectangle line
+static uint32_t s_u32Done;                   // Ciphertext bytes produced, rectangle lines back to back
+static uint32_t s_u32RunBytes;               // Bytes of the AES run in flight, 0 if none
+
+static int s_i32Stage;                       // Staging buffer being filled
+static uint32_t s_u32Fill;                   // Bytes in the staging buffer being filled
+static int s_ai32StageId[DEF_SHOT_STAGE_NUM];    // SD request writing each staging buffer, -1 if none
+static int s_i32HdrId;
+
+static uint32_t s_u32StartCycles;
+static uint32_t s_u32BudgetUs;
+static uint32_t s_u32CyclesPerUs = 1;
+
+static S_SCREENSHOT_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Callback function for SD writes of staging buffers and header
+static void screenshot_sd_cb(void *pvUserData, int i32Status)
+{
+    (void)pvUserData;
+
+    if (i32Status)
+        s_u32Flags |= SCREENSHOT_FLAG_ERROR;
+}
+
+// Function to check whether an SD request of the capture is still running
+static int screenshot_sd_pending(int i32Id)
+{
+    return (i32Id >= 0) && sdh_async_pending(i32Id);
+}
+
+// Function to hand u32Len bytes at byte offset u32Offset of the capture image to the sink, returns request id, -1 if done at once
+static int screenshot_emit(uint32_t u32Offset, const void *pvData, uint32_t u32Len)
+{
+    int i32Id = -1;
+
+    if (s_pfnSink)
+    {
+        if (s_pfnSink(s_pvSinkUserData, u32Offset, pvData, u32Len) != 0)
+            s_u32Flags |= SCREENSHOT_FLAG_ERROR;
+    }
+    else
+    {
+        i32Id = sdh_async_write(s_u32SlotSec + (u32Offset / SDH_BLOCK_SIZE), pvData,
+                                NVT_ALIGN(u32Len, SDH_BLOCK_SIZE) / SDH_BLOCK_SIZE, screenshot_sd_cb, NULL);
+
+        if (i32Id < 0)
+            s_u32Flags |= SCREENSHOT_FLAG_ERROR;
+    }
+
+    return i32Id;
+}
+
+// Function to write out the staging buffer being filled and switch to the other one
+static void screenshot_stage_submit(void)
+{
+    uint8_t *pu8Stage = s_au8Stage[s_i32Stage];
+    uint32_t u32Len = NVT_ALIGN(s_u32Fill, SDH_BLOCK_SIZE);
+
+    /* Pad the tail of the last buffer to a whole sector. */
+    if (u32Len > s_u32Fill)
+        memset(&pu8Stage[s_u32Fill], 0, u32Len - s_u32Fill);
+
+    s_ai32StageId[s_i32Stage] = screenshot_emit(SDH_BLOCK_SIZE + s_u32Done - s_u32Fill, pu8Stage, u32Len);
+
+    s_i32Stage = (s_i32Stage + 1) % DEF_SHOT_STAGE_NUM;
+    s_u32Fill = 0;
+}
+
+// Function to get the time since screenshot_capture in microseconds
+static uint32_t screenshot_elapsed_us(void)
+{
+    return (DWT->CYCCNT - s_u32StartCycles) / s_u32CyclesPerUs;
+}
+
+// Function to advance the capture by one step, returns 1 to go on or 0 while waiting on the sink
+static int screenshot_step(uint32_t *pu32Bytes)
+{
+    CRYPTO_T *crypto = CONFIG_SCREENSHOT_CRYPTO;
+    uint32_t u32Total = s_sHdr.m_u32Bytes;
+    const uint8_t *pu8Src;
+    uint32_t u32Len, u32DMAMode;
+
+    switch (s_evState)
+    {
+    case evShotCrypt:
+        if (s_u32RunBytes)
+        {
+            uint32_t u32IntSts = AES_GET_INT_FLAG(crypto);
+
+            if (!u32IntSts)
+                return 1;
+
+            AES_CLR_INT_FLAG(crypto);
+
+            if (u32IntSts & CRYPTO_INTSTS_AESEIF_Msk)
+            {
+                s_u32Flags |= SCREENSHOT_FLAG_ERROR;
+                s_u32RunBytes = 0;
+                s_evState = evShotFlush;
+                return 1;
+            }
+
+            s_u32Fill += s_u32RunBytes;
+            s_u32Done += s_u32RunBytes;
+            s_u32RunBytes = 0;
+
+            if ((s_u32Fill == CONFIG_SCREENSHOT_CHUNK_SIZE) || (s_u32Done == u32Total))
+                screenshot_stage_submit();
+
+            if ((s_u32Done == u32Total) || (s_u32Flags & SCREENSHOT_FLAG_ERROR))
+                s_evState = evShotFlush;
+
+            return 1;
+        }
+
+        /* A staging buffer is refilled only after the sink let go of it. */
+        if (screenshot_sd_pending(s_ai32StageId[s_i32Stage]))
+            return 0;
+
+        s_ai32StageId[s_i32Stage] = -1;
+
+        /* The presented buffer is no longer the one this capture started on, e.g. after a page flip. */
+        if (disp_get_vrambufaddr() != (void *)s_pu8Frame)
+            s_u32Flags |= SCREENSHOT_FLAG_TORN;
+
+        pu8Src = s_pu8Frame + ((s_sHdr.m_sRect.m_u32Y + (s_u32Done / s_u32LineBytes)) * s_u32Stride) +
+                 (s_sHdr.m_sRect.m_u32X * sizeof(uint16_t)) + (s_u32Done % s_u32LineBytes);
+
+        /* Full-width rectangles are contiguous, a run may then span lines. */
+        if (s_u32LineBytes == s_u32Stride)
+            u32Len = u32Total - s_u32Done;
+        else
+            u32Len = s_u32LineBytes - (s_u32Done % s_u32LineBytes);
+
+        if (u32Len > (CONFIG_SCREENSHOT_CHUNK_SIZE - s_u32Fill))
+            u32Len = CONFIG_SCREENSHOT_CHUNK_SIZE - s_u32Fill;
+
+        if (s_u32Done == 0)
+            u32DMAMode = (u32Len == u32Total) ? CRYPTO_DMA_ONE_SHOT : CRYPTO_DMA_FIRST;
+        else
+            u32DMAMode = ((s_u32Done + u32Len) == u32Total) ? CRYPTO_DMA_LAST : CRYPTO_DMA_CONTINUE;
+
+        disp_mem_acquire(pu8Src);
+
+        /* The engine reads memory, not the D-cache. */
+        SCB_CleanDCache_by_Addr((void *)pu8Src, (int32_t)u32Len);
+
+        AES_SetDMATransfer(crypto, CONFIG_SCREENSHOT_AES_CH, (uint32_t)pu8Src,
+                           (uint32_t)&s_au8Stage[s_i32Stage][s_u32Fill], u32Len);
+        AES_Start(crypto, CONFIG_SCREENSHOT_AES_CH, u32DMAMode);
+
+        s_u32RunBytes = u32Len;
+        *pu32Bytes += u32Len;
+
+        return 1;
+
+    case evShotFlush:
+        if (screenshot_sd_pending(s_ai32StageId[0]) || screenshot_sd_pending(s_ai32StageId[1]))
+            return 0;
+
+        s_ai32StageId[0] = s_ai32StageId[1] = -1;
+
+        s_sHdr.m_u32LatencyUs = screenshot_elapsed_us();
+
+        if (s_sHdr.m_u32LatencyUs > s_u32BudgetUs)
+            s_u32Flags |= SCREENSHOT_FLAG_OVER_BUDGET;
+
+        s_sHdr.m_u32Bytes = s_u32Done;
+        s_sHdr.m_u32Flags = s_u32Flags;
+
+        memset(s_au8HdrSec, 0, sizeof(s_au8HdrSec));
+        memcpy(s_au8HdrSec, &s_sHdr, sizeof(s_sHdr));
+
+        s_i32HdrId = screenshot_emit(0, s_au8HdrSec, sizeof(s_au8HdrSec));
+        s_evState = evShotHeader;
+
+        return 1;
+
+    case evShotHeader:
+        if (screenshot_sd_pending(s_i32HdrId))
+            return 0;
+
+        s_i32HdrId = -1;
+
+        s_sStats.m_u32Captures++;
+        s_sStats.m_u32Bytes += s_u32Done;
+        s_sStats.m_u32LastLatencyUs = s_sHdr.m_u32LatencyUs;
+
+        if (s_sHdr.m_u32LatencyUs > s_sStats.m_u32MaxLatencyUs)
+            s_sStats.m_u32MaxLatencyUs = s_sHdr.m_u32LatencyUs;
+
+        s_sStats.m_u32LastKBps = s_sHdr.m_u32LatencyUs ?
+                                 (uint32_t)(((uint64_t)s_u32Done * 1000ULL) / s_sHdr.m_u32LatencyUs) : 0;
+
+        /* Header flags were fixed before its own write, a failed header write counts here. */
+        if (s_sHdr.m_u32Flags & SCREENSHOT_FLAG_TORN)
+            s_sStats.m_u32Torn++;
+
+        if (s_sHdr.m_u32Flags & SCREENSHOT_FLAG_OVER_BUDGET)
+            s_sStats.m_u32OverBudget++;
+
+        if (s_u32Flags & SCREENSHOT_FLAG_ERROR)
+            s_sStats.m_u32Errors++;
+
+        s_evState = evShotIdle;
+
+        return 0;
+
+    default:
+        return 0;
+    }
+}
+
+// Function to load the AES key and the nonce prefix
+int screenshot_set_key(const uint32_t *pu32Key, uint32_t u32KeySize, uint32_t u32Nonce)
+{
+    if ((s_evState != evShotIdle) || !pu32Key || (u32KeySize > AES_KEY_SIZE_256))
+        return -1;
+
+    memcpy(s_au32Key, pu32Key, (4UL + u32KeySize * 2UL) * sizeof(uint32_t));
+    s_u32KeySize = u32KeySize;
+    s_u32Nonce = u32Nonce;
+    s_i32KeySet = 1;
+
+    return 0;
+}
+
+// Function to route the capture data to another sink than the SD slots
+int screenshot_set_sink(SCREENSHOT_SINK pfnSink, void *pvUserData)
+{
+    if (s_evState != evShotIdle)
+        return -1;
+
+    s_pfnSink = pfnSink;
+    s_pvSinkUserData = pvUserData;
+
+    return 0;
+}
+
+// Function to start capturing a rectangle of the presented frame
+int screenshot_capture(const S_DISP_RECT *psRect, uint32_t u32BudgetMs)
+{
+    CRYPTO_T *crypto = CONFIG_SCREENSHOT_CRYPTO;
+    S_DISP_TIMING sTiming;
+    S_DISP_RECT sRect;
+    uint32_t u32X1, u32Rnd;
+
+    if ((s_evState != evShotIdle) || !s_i32KeySet || !disp_get_vrambufaddr())
+        return -1;
+
+    disp_get_timing(&sTiming);
+
+    if (psRect)
+    {
+        if (((psRect->m_u32X + psRect->m_u32W) > sTiming.m_u32HACT) ||
+                ((psRect->m_u32Y + psRect->m_u32H) > sTiming.m_u32VACT))
+            return -1;
+
+        sRect = *psRect;
+    }
+    else
+    {
+        sRect.m_u32X = sRect.m_u32Y = 0;
+        sRect.m_u32W = sTiming.m_u32HACT;
+        sRect.m_u32H = sTiming.m_u32VACT;
+    }
+
+    if (!sRect.m_u32W || !sRect.m_u32H)
+        return -1;
+
+    /* Whole AES blocks per line, so every run of the cascade is a multiple of 16 bytes. */
+    u32X1 = sRect.m_u32X + sRect.m_u32W;
+    sRect.m_u32X &= ~(DEF_SHOT_COL_ALIGN - 1);
+    sRect.m_u32W = NVT_ALIGN(u32X1 - sRect.m_u32X, DEF_SHOT_COL_ALIGN);
+
+    if ((sRect.m_u32X + sRect.m_u32W) > sTiming.m_u32HACT)
+        return -1;
+
+    /* The sequence restarts with every boot, a fresh random word keeps the counter blocks unique. */
+    if (!s_i32RngOk || (RNG_Random(&u32Rnd, 1) != 1))
+        return -1;
+
+    s_u32Seq++;
+
+    s_sHdr.m_u32Magic = SCREENSHOT_MAGIC;
+    s_sHdr.m_u32Seq = s_u32Seq;
+    s_sHdr.m_sRect = sRect;
+    s_sHdr.m_u32Format = 0;
+    s_sHdr.m_u32Bytes = sRect.m_u32W * sRect.m_u32H * sizeof(uint16_t);
+    s_sHdr.m_au32Nonce[0] = s_u32Nonce;
+    s_sHdr.m_au32Nonce[1] = s_u32Seq;
+    s_sHdr.m_au32Nonce[2] = u32Rnd;
+    s_sHdr.m_au32Nonce[3] = 0;
+    s_sHdr.m_u32Flags = 0;
+    s_sHdr.m_u32LatencyUs = 0;
+
+    s_pu8Frame = (const uint8_t *)disp_get_vrambufaddr();
+    s_u32Stride = sTiming.m_u32HACT * sizeof(uint16_t);
+    s_u32LineBytes = sRect.m_u32W * sizeof(uint16_t);
+    s_u32Done = 0;
+    s_u32RunBytes = 0;
+    s_u32Flags = 0;
+
+    s_i32Stage = 0;
+    s_u32Fill = 0;
+    s_ai32StageId[0] = s_ai32StageId[1] = -1;
+    s_i32HdrId = -1;
+
+    s_u32SlotSec = CONFIG_SCREENSHOT_SD_START_SEC + ((s_u32Seq % CONFIG_SCREENSHOT_SD_SLOT_NUM) * DEF_SHOT_SLOT_SECTORS);
+
+    s_u32BudgetUs = (u32BudgetMs ? u32BudgetMs : CONFIG_SCREENSHOT_BUDGET_MS) * 1000UL;
+    s_u32CyclesPerUs = (SystemCoreClock / 1000000UL) ? (SystemCoreClock / 1000000UL) : 1;
+    s_u32StartCycles = DWT->CYCCNT;
+
+    /* Counter mode, the cascade carries the counter from one run to the next. */
+    AES_CLR_INT_FLAG(crypto);
+    AES_Open(crypto, CONFIG_SCREENSHOT_AES_CH, 1, AES_MODE_CTR, s_u32KeySize, AES_IN_OUT_SWAP);
+    AES_SetKey(crypto, CONFIG_SCREENSHOT_AES_CH, s_au32Key, s_u32KeySize);
+    AES_SetInitVect(crypto, CONFIG_SCREENSHOT_AES_CH, s_sHdr.m_au32Nonce);
+
+    s_evState = evShotCrypt;
+
+    return (int)s_u32Seq;
+}
+
+// Function to advance the running capture within u32BudgetUs
+int screenshot_poll(uint32_t u32BudgetUs)
+{
+    uint32_t u32Start = DWT->CYCCNT;
+    uint32_t u32Budget = (u32BudgetUs > (0xFFFFFFFFUL / s_u32CyclesPerUs)) ? 0xFFFFFFFFUL : (u32BudgetUs * s_u32CyclesPerUs);
+    uint32_t u32Bytes = 0;
+
+    if (s_evState == evShotIdle)
+        return 0;
+
+    if (!s_pfnSink)
+        sdh_async_poll();
+
+    while (screenshot_step(&u32Bytes))
+    {
+        if (((DWT->CYCCNT - u32Start) >= u32Budget) || (u32Bytes >= CONFIG_SCREENSHOT_POLL_BYTES))
+            break;
+    }
+
+    return (s_evState != evShotIdle);
+}
+
+// Function to get the screenshot statistics
+void screenshot_get_stats(S_SCREENSHOT_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to initialize the screenshot component
+static int screenshot_init(void)
+{
+    memset(&s_sStats, 0, sizeof(s_sStats));
+
+    /* Latency and idle budgets are counted in core cycles. */
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* The TRNG clock is enabled by board_init along with the crypto engine. */
+    s_i32RngOk = (RNG_Open() == 0);
+
+    s_evState = evShotIdle;
+
+    return 0;
+}
+
+// Function to deinitialize the screenshot component
+static int screenshot_fini(void)
+{
+    while (screenshot_poll(0xFFFFFFFFUL))
+        ;
+
+    /* Do not leave the key behind in RAM. */
+    memset(s_au32Key, 0, sizeof(s_au32Key));
+    s_i32KeySet = 0;
+
+    return 0;
+}
+
+COMPONENT_EXPORT("SCREENSHOT", screenshot_init, screenshot_fini);
@@ -0,0 +1,80 @@
+/**************************************************************************//**
+ * @file     screenshot.h
+ * @brief    Encrypted screenshots of the presented frame through the AES DMA engine.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __SCREENSHOT_H__
+#define __SCREENSHOT_H__
+
+#include "NuMicro.h"
+#include "component.h"
+#include "disp.h"
+
+#define CONFIG_SCREENSHOT_CRYPTO          CRYPTO   /*!< Crypto engine running the AES DMA */
+#define CONFIG_SCREENSHOT_AES_CH               0   /*!< AES channel, 0~3 */
+#define CONFIG_SCREENSHOT_CHUNK_SIZE        4096   /*!< Ciphertext bytes per staging buffer, multiple of SDH_BLOCK_SIZE */
+#define CONFIG_SCREENSHOT_POLL_BYTES        8192   /*!< Throughput budget, most bytes encrypted per screenshot_poll */
+#define CONFIG_SCREENSHOT_BUDGET_MS          500   /*!< Default latency budget of one capture */
+#define CONFIG_SCREENSHOT_SD_START_SEC  0x100000   /*!< First SD sector of the capture slots */
+#define CONFIG_SCREENSHOT_SD_SLOT_NUM         16   /*!< Capture slots on SD, reused round robin */
+
+#define SCREENSHOT_MAGIC                0x544F4853UL   /*!< "SHOT" */
+
+#define SCREENSHOT_FLAG_TORN            (1UL << 0)     /*!< Presented buffer changed while capturing */
+#define SCREENSHOT_FLAG_OVER_BUDGET     (1UL << 1)     /*!< Capture finished after its latency budget */
+#define SCREENSHOT_FLAG_ERROR           (1UL << 2)     /*!< AES or sink error, ciphertext is incomplete */
+
+/* Plaintext header written in front of the ciphertext. The rectangle lines follow back to back as
+   AES-CTR ciphertext with m_au32Nonce as initial counter block, which the decryptor takes from here. */
+typedef struct
+{
+    uint32_t    m_u32Magic;         /*!< SCREENSHOT_MAGIC */
+    uint32_t    m_u32Seq;           /*!< Capture sequence number */
+    S_DISP_RECT m_sRect;            /*!< Captured rectangle of the frame */
+    uint32_t    m_u32Format;        /*!< Pixel format, 0 for RGB565 */
+    uint32_t    m_u32Bytes;         /*!< Ciphertext bytes following the header */
+    uint32_t    m_au32Nonce[4];     /*!< Initial counter block */
+    uint32_t    m_u32Flags;         /*!< SCREENSHOT_FLAG_* */
+    uint32_t    m_u32LatencyUs;     /*!< Time from screenshot_capture to the last ciphertext byte */
+} S_SCREENSHOT_HDR;
+
+/* Called with every staging buffer at its byte offset in the capture image, and last with the header
+   at offset 0; ciphertext starts at offset SDH_BLOCK_SIZE. The buffer is reused after the call, so
+   return 0 once the data is taken, or -1 to fail the capture. */
+typedef int (*SCREENSHOT_SINK)(void *pvUserData, uint32_t u32Offset, const void *pvData, uint32_t u32Len);
+
+typedef struct
+{
+    uint32_t m_u32Captures;         /*!< Captures finished */
+    uint32_t m_u32Torn;             /*!< Captures flagged torn */
+    uint32_t m_u32OverBudget;       /*!< Captures over their latency budget */
+    uint32_t m_u32Errors;           /*!< Captures failed by AES or sink */
+    uint32_t m_u32Bytes;            /*!< Ciphertext bytes produced */
+    uint32_t m_u32LastLatencyUs;    /*!< Latency of the last capture */
+    uint32_t m_u32MaxLatencyUs;     /*!< Worst capture latency */
+    uint32_t m_u32LastKBps;         /*!< Throughput of the last capture */
+} S_SCREENSHOT_STATS;
+
+// Function to load the AES key and the nonce prefix, returns 0 or -1 while a capture runs
+// u32KeySize is AES_KEY_SIZE_128/192/256. The counter block is {u32Nonce, sequence, random, 0} with a
+// random word drawn for every capture, so counters stay unique when the sequence restarts at boot.
+int screenshot_set_key(const uint32_t *pu32Key, uint32_t u32KeySize, uint32_t u32Nonce);
+
+// Function to route the capture data to another sink than the SD slots, pfnSink NULL restores SD
+int screenshot_set_sink(SCREENSHOT_SINK pfnSink, void *pvUserData);
+
+// Function to start capturing a rectangle of the presented frame, returns the sequence number or -1
+// -1 also when the random generator fails. psRect NULL captures the whole frame. The rectangle is widened to 8 pixel columns so every line is
+// a whole number of AES blocks. u32BudgetMs 0 selects CONFIG_SCREENSHOT_BUDGET_MS.
+int screenshot_capture(const S_DISP_RECT *psRect, uint32_t u32BudgetMs);
+
+// Function to advance the running capture within u32BudgetUs, returns 1 while capturing or 0
+// Call from the idle part of the frame loop. Only the AES engine is waited on, never SD or the display.
+int screenshot_poll(uint32_t u32BudgetUs);
+
+// Function to get the screenshot statistics
+void screenshot_get_stats(S_SCREENSHOT_STATS *psStats);
+
+#endif /* __SCREENSHOT_H__ */
@@ -0,0 +1,460 @@
+/**************************************************************************//**
+ * @file     sdh_async.c
+ * @brief    Interrupt-driven multi-block SD card reads and writes.
+ *
+ *           _SDH_Read and _SDH_Write spin on DataReadyFlag for every batch
+ *           of 255 blocks. Here a request programs the first batch with
+ *           CMD18/CMD25 and the block-done interrupt chains the following
+ *           batches and sends CMD12, so the card streams into the caller
+ *           buffer without the CPU. The card stays selected while requests
+ *           are queued; the CMD12 response, write busy and retirement
+ *           are handled by sdh_async_poll.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "sdh_async.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_SDH_QUEUE_MASK       (CONFIG_SDH_ASYNC_QUEUE_NUM - 1)
+#define DEF_SDH_ID_MASK          0x7FFFFFFFUL
+#define DEF_SDH_BLKCNT_MAX       255UL          /*!< Largest SDH_CTL[BLKCNT] */
+#define DEF_SDH_CTL_KEEP_Msk     0xFF00C080UL   /*!< SDH_CTL bits kept across commands, as _SDH_Write does */
+
+#define DEF_SDH_CMD_SELECT       7UL
+#define DEF_SDH_CMD_STOP         12UL
+#define DEF_SDH_CMD_READ_MULTI   18UL
+#define DEF_SDH_CMD_WRITE_MULTI  25UL
+
+typedef enum
+{
+    evSdhIdle,               /*!< Nothing on the bus */
+    evSdhData,               /*!< Data batches of s_u32Run are running */
+    evSdhStopRsp,            /*!< CMD12 sent, waiting for its response */
+    evSdhStop,               /*!< CMD12 answered, waiting for the card to release DAT0 */
+} E_SDH_STATE;
+
+typedef struct
+{
+    uint32_t          m_u32StartSec;
+    uint8_t          *m_pu8Buf;
+    uint32_t          m_u32SecCount;
+    uint32_t          m_u32SecLeft;        // Sectors not yet programmed into BLKCNT
+    int               m_i32Write;
+    volatile int      m_i32Status;
+    SDH_ASYNC_CB      m_pfnCb;
+    void             *m_pvUserData;
+} S_SDH_REQ;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_SDH_REQ s_asReq[CONFIG_SDH_ASYNC_QUEUE_NUM];
+
+/* Free-running sequence numbers, s_u32Tail <= s_u32Run <= s_u32Head. */
+static volatile uint32_t s_u32Head = 0;     // Next request to queue
+static volatile uint32_t s_u32Run = 0;      // Request on the bus
+static volatile uint32_t s_u32Tail = 0;     // Oldest request not retired by poll
+
+static volatile E_SDH_STATE s_evState = evSdhIdle;
+static int s_i32Selected = 0;
+static int s_i32Inited = 0;
+
+static S_SDH_ASYNC_STATS s_sStats;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to program the next batch of up to 255 blocks, u32Cmd 0 continues the running command
+static void sdh_async_batch(S_SDH_REQ *psReq, uint32_t u32Cmd)
+{
+    SDH_T *sdh = CONFIG_SDH_ASYNC_PORT;
+    uint32_t u32Blks = (psReq->m_u32SecLeft > DEF_SDH_BLKCNT_MAX) ? DEF_SDH_BLKCNT_MAX : psReq->m_u32SecLeft;
+    uint32_t u32Ctl = (sdh->CTL & DEF_SDH_CTL_KEEP_Msk) | (u32Blks << SDH_CTL_BLKCNT_Pos);
+
+    psReq->m_u32SecLeft -= u32Blks;
+
+    u32Ctl |= psReq->m_i32Write ? SDH_CTL_DOEN_Msk : SDH_CTL_DIEN_Msk;
+
+    if (u32Cmd)
+        u32Ctl |= (u32Cmd << SDH_CTL_CMDCODE_Pos) | SDH_CTL_COEN_Msk | SDH_CTL_RIEN_Msk;
+
+    /* DMASA carries on from the previous batch. */
+    sdh->CTL = u32Ctl;
+}
+
+// Function to select the card and start a request, called with SDH interrupt masked
+static int sdh_async_start(S_SDH_REQ *psReq)
+{
+    SDH_T *sdh = CONFIG_SDH_ASYNC_PORT;
+    SDH_INFO_T *pSD = &CONFIG_SDH_ASYNC_INFO;
+
+    if (!pSD->IsCardInsert)
+        return -1;
+
+    if (!s_i32Selected)
+    {
+        if (SDH_SDCmdAndRsp(sdh, DEF_SDH_CMD_SELECT, pSD->RCA, 0ul) != Successful)
+            return -1;
+
+        s_i32Selected = 1;
+    }
+
+    sdh->BLEN = SDH_BLOCK_SIZE - 1ul;
+
+    if ((pSD->CardType == SDH_TYPE_SD_HIGH) || (pSD->CardType == SDH_TYPE_EMMC))
+        sdh->CMDARG = psReq->m_u32StartSec;
+    else
+        sdh->CMDARG = psReq->m_u32StartSec * SDH_BLOCK_SIZE;
+
+    sdh->DMASA = (uint32_t)psReq->m_pu8Buf;
+    sdh->INTSTS = SDH_INTSTS_CRCIF_Msk | SDH_INTSTS_DITOIF_Msk;
+
+    psReq->m_u32SecLeft = psReq->m_u32SecCount;
+    s_evState = evSdhData;
+
+    sdh_async_batch(psReq, psReq->m_i32Write ? DEF_SDH_CMD_WRITE_MULTI : DEF_SDH_CMD_READ_MULTI);
+
+    return 0;
+}
+
+// Function to end the data phase of the running request, called in IRQ
+static void sdh_async_stop(int i32Status)
+{
+    SDH_T *sdh = CONFIG_SDH_ASYNC_PORT;
+    S_SDH_REQ *psReq = &s_asReq[s_u32Run & DEF_SDH_QUEUE_MASK];
+
+    psReq->m_i32Status = i32Status;
+
+    /* Only issue CMD12 here, sdh_async_kick collects the response. */
+    sdh->CMDARG = 0ul;
+    sdh->CTL = (sdh->CTL & ~SDH_CTL_CMDCODE_Msk) | (DEF_SDH_CMD_STOP << SDH_CTL_CMDCODE_Pos) | SDH_CTL_COEN_Msk | SDH_CTL_RIEN_Msk;
+
+    s_evState = evSdhStopRsp;
+}
+
+// Function to check the CMD12 response, returns 0 while it is still outstanding
+static int sdh_async_stop_done(void)
+{
+    SDH_T *sdh = CONFIG_SDH_ASYNC_PORT;
+    S_SDH_REQ *psReq = &s_asReq[s_u32Run & DEF_SDH_QUEUE_MASK];
+
+    if (sdh->CTL & SDH_CTL_RIEN_Msk)
+    {
+        if (CONFIG_SDH_ASYNC_INFO.IsCardInsert)
+            return 0;
+
+        /* No card to answer, reset the engine as the blocking driver does on a timeout. */
+        sdh->CTL |= SDH_CTL_CTLRST_Msk;
+        psReq->m_i32Status = -1;
+    }
+    else if (!(sdh->INTSTS & SDH_INTSTS_CRC7_Msk))
+    {
+        psReq->m_i32Status = -1;
+    }
+
+    /* Clock the card once so DAT0 busy is sampled fresh. */
+    sdh->CTL |= SDH_CTL_CLK8OEN_Msk;
+
+    s_evState = evSdhStop;
+    s_u32Run++;
+
+    return 1;
+}
+
+// Function to wait out write busy and start the next request, called with SDH interrupt masked
+static void sdh_async_kick(void)
+{
+    SDH_T *sdh = CONFIG_SDH_ASYNC_PORT;
+
+    /* Eight clocks still being sent. */
+    if (sdh->CTL & SDH_CTL_CLK8OEN_Msk)
+        return;
+
+    if ((s_evState == evSdhStopRsp) && !sdh_async_stop_done())
+        return;
+
+    if (s_evState == evSdhStop)
+    {
+        /* The card holds DAT0 low while programming, keep clocking it without spinning here. */
+        if (!(sdh->INTSTS & SDH_INTSTS_DAT0STS_Msk))
+        {
+            sdh->CTL |= SDH_CTL_CLK8OEN_Msk;
+            return;
+        }
+
+        s_evState = evSdhIdle;
+    }
+
+    if (s_evState != evSdhIdle)
+        return;
+
+    while (s_u32Run != s_u32Head)
+    {
+        S_SDH_REQ *psReq = &s_asReq[s_u32Run & DEF_SDH_QUEUE_MASK];
+
+        if (sdh_async_start(psReq) == 0)
+            return;
+
+        psReq->m_i32Status = -1;
+        s_u32Run++;
+    }
+
+    /* Queue drained, deselect as the blocking driver does. */
+    if (s_i32Selected)
+    {
+        SDH_SDCommand(sdh, DEF_SDH_CMD_SELECT, 0ul);
+        sdh->CTL |= SDH_CTL_CLK8OEN_Msk;
+        s_i32Selected = 0;
+    }
+}
+
+// SDH interrupt handler
+NVT_ITCM void CONFIG_SDH_ASYNC_IRQHandler(void)
+{
+    SDH_T *sdh = CONFIG_SDH_ASYNC_PORT;
+    SDH_INFO_T *pSD = &CONFIG_SDH_ASYNC_INFO;
+    uint32_t u32Isr;
+
+    /* DMA target abort, reset the engine and fail the running request. */
+    if (sdh->GINTSTS & SDH_GINTSTS_DTAIF_Msk)
+    {
+        sdh->GCTL |= SDH_GCTL_GCTLRST_Msk;
+
+        if (s_evState == evSdhData)
+            sdh_async_stop(-1);
+    }
+
+    u32Isr = sdh->INTSTS;
+
+    if (u32Isr & SDH_INTSTS_CDIF_Msk)
+    {
+        /* CDSTS high means the card is removed for GPIO detection. */
+        pSD->IsCardInsert = (u32Isr & SDH_INTSTS_CDSTS_Msk) ? FALSE : TRUE;
+        sdh->INTSTS = SDH_INTSTS_CDIF_Msk;
+    }
+
+    if (u32Isr & SDH_INTSTS_BLKDIF_Msk)
+    {
+        sdh->INTSTS = SDH_INTSTS_BLKDIF_Msk;
+
+        if (s_evState != evSdhData)
+        {
+            /* Blocking driver calls, e.g. SDH_Probe. */
+            pSD->DataReadyFlag = TRUE;
+        }
+        else
+        {
+            S_SDH_REQ *psReq = &s_asReq[s_u32Run & DEF_SDH_QUEUE_MASK];
+            int i32CrcErr = psReq->m_i32Write ? ((u32Isr & SDH_INTSTS_CRCIF_Msk) != 0) :
+                            ((u32Isr & (SDH_INTSTS_CRC7_Msk | SDH_INTSTS_CRC16_Msk)) != (SDH_INTSTS_CRC7_Msk | SDH_INTSTS_CRC16_Msk));
+
+            if (i32CrcErr || !pSD->IsCardInsert)
+                sdh_async_stop(-1);
+            else if (psReq->m_u32SecLeft)
+                sdh_async_batch(psReq, 0);
+            else
+                sdh_async_stop(0);
+        }
+    }
+
+    if (u32Isr & SDH_INTSTS_DITOIF_Msk)
+    {
+        sdh->INTSTS = SDH_INTSTS_DITOIF_Msk;
+
+        if (s_evState == evSdhData)
+            sdh_async_stop(-1);
+    }
+
+    if (u32Isr & SDH_INTSTS_RTOIF_Msk)
+    {
+        sdh->INTSTS = SDH_INTSTS_RTOIF_Msk;
+
+        /* CMD12 got no response, the reset ends the wait in sdh_async_stop_done. */
+        if (s_evState == evSdhStopRsp)
+        {
+            s_asReq[s_u32Run & DEF_SDH_QUEUE_MASK].m_i32Status = -1;
+            sdh->CTL |= SDH_CTL_CTLRST_Msk;
+        }
+    }
+
+    if (u32Isr & SDH_INTSTS_CRCIF_Msk)
+        sdh->INTSTS = SDH_INTSTS_CRCIF_Msk;
+}
+
+// Function to queue a request, returns request id or -1
+static int sdh_async_queue(uint32_t u32StartSec, uint8_t *pu8Buf, uint32_t u32SecCount, int i32Write, SDH_ASYNC_CB pfnCb, void *pvUserData)
+{
+    S_SDH_REQ *psReq;
+    uint32_t u32Seq;
+
+    if (!s_i32Inited || !pu8Buf || !u32SecCount)
+        return -1;
+
+    /* Per request cache maintenance, the card DMA bypasses DCache. */
+    if (i32Write)
+        SCB_CleanDCache_by_Addr(pu8Buf, u32SecCount * SDH_BLOCK_SIZE);
+    else
+        SCB_InvalidateDCache_by_Addr(pu8Buf, u32SecCount * SDH_BLOCK_SIZE);
+
+    NVIC_DisableIRQ(CONFIG_SDH_ASYNC_IRQn);
+
+    if ((s_u32Head - s_u32Tail) >= CONFIG_SDH_ASYNC_QUEUE_NUM)
+    {
+        s_sStats.m_u32QueueFull++;
+        NVIC_EnableIRQ(CONFIG_SDH_ASYNC_IRQn);
+        return -1;
+    }
+
+    u32Seq = s_u32Head;
+    psReq = &s_asReq[u32Seq & DEF_SDH_QUEUE_MASK];
+
+    psReq->m_u32StartSec = u32StartSec;
+    psReq->m_pu8Buf = pu8Buf;
+    psReq->m_u32SecCount = u32SecCount;
+    psReq->m_u32SecLeft = 0;
+    psReq->m_i32Write = i32Write;
+    psReq->m_i32Status = 0;
+    psReq->m_pfnCb = pfnCb;
+    psReq->m_pvUserData = pvUserData;
+
+    s_u32Head = u32Seq + 1;
+
+    sdh_async_kick();
+
+    NVIC_EnableIRQ(CONFIG_SDH_ASYNC_IRQn);
+
+    return (int)(u32Seq & DEF_SDH_ID_MASK);
+}
+
+// Function to queue a read of u32SecCount sectors from u32StartSec into pvBuf, returns request id or -1
+int sdh_async_read(uint32_t u32StartSec, void *pvBuf, uint32_t u32SecCount, SDH_ASYNC_CB pfnCb, void *pvUserData)
+{
+    if ((uint32_t)pvBuf & (DCACHE_LINE_SIZE - 1))
+        return -1;
+
+    return sdh_async_queue(u32StartSec, (uint8_t *)pvBuf, u32SecCount, 0, pfnCb, pvUserData);
+}
+
+// Function to queue a write of u32SecCount sectors from pvBuf to u32StartSec, returns request id or -1
+int sdh_async_write(uint32_t u32StartSec, const void *pvBuf, uint32_t u32SecCount, SDH_ASYNC_CB pfnCb, void *pvUserData)
+{
+    if ((uint32_t)pvBuf & 0x3)
+        return -1;
+
+    return sdh_async_queue(u32StartSec, (uint8_t *)pvBuf, u32SecCount, 1, pfnCb, pvUserData);
+}
+
+// Function to retire finished requests and start queued ones, returns the number of requests retired
+int sdh_async_poll(void)
+{
+    int i32Count = 0;
+
+    NVIC_DisableIRQ(CONFIG_SDH_ASYNC_IRQn);
+    sdh_async_kick();
+    NVIC_EnableIRQ(CONFIG_SDH_ASYNC_IRQn);
+
+    while (s_u32Tail != s_u32Run)
+    {
+        S_SDH_REQ *psReq = &s_asReq[s_u32Tail & DEF_SDH_QUEUE_MASK];
+
+        /* Drop lines speculatively fetched while the card was writing memory. */
+        if (!psReq->m_i32Write)
+            SCB_InvalidateDCache_by_Addr(psReq->m_pu8Buf, psReq->m_u32SecCount * SDH_BLOCK_SIZE);
+
+        if (psReq->m_i32Status)
+        {
+            s_sStats.m_u32Errors++;
+        }
+        else
+        {
+            if (psReq->m_i32Write)
+                s_sStats.m_u32Writes++;
+            else
+                s_sStats.m_u32Reads++;
+
+            s_sStats.m_u32Sectors += psReq->m_u32SecCount;
+        }
+
+        if (psReq->m_pfnCb)
+            psReq->m_pfnCb(psReq->m_pvUserData, psReq->m_i32Status);
+
+        s_u32Tail++;
+        i32Count++;
+    }
+
+    return i32Count;
+}
+
+// Function to check whether a request is still queued or running
+int sdh_async_pending(int i32Id)
+{
+    uint32_t u32Tail = s_u32Tail;
+
+    if (i32Id < 0)
+        return 0;
+
+    return ((((uint32_t)i32Id - u32Tail) & DEF_SDH_ID_MASK) < (s_u32Head - u32Tail));
+}
+
+// Function to wait until a request and its callback are finished
+void sdh_async_wait(int i32Id)
+{
+    while (sdh_async_pending(i32Id))
+        sdh_async_poll();
+}
+
+// Function to get the card capacity in sectors
+uint32_t sdh_async_get_sectors(void)
+{
+    return s_i32Inited ? CONFIG_SDH_ASYNC_INFO.totalSectorN : 0;
+}
+
+// Function to get the SDH engine statistics
+void sdh_async_get_stats(S_SDH_ASYNC_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to open the SDH port and probe the card
+static int sdh_async_init(void)
+{
+    SDH_T *sdh = CONFIG_SDH_ASYNC_PORT;
+
+    s_u32Head = s_u32Run = s_u32Tail = 0;
+    s_evState = evSdhIdle;
+    s_i32Selected = 0;
+    s_i32Inited = 0;
+
+    /* SDH_Open enables the SDH interrupt, the probe relies on it for DataReadyFlag. */
+    SDH_Open(sdh, CONFIG_SDH_ASYNC_CARD_DETECT);
+
+    if (SDH_Probe(sdh) != Successful)
+        return -1;
+
+    s_i32Inited = 1;
+
+    return 0;
+}
+
+// Function to drain the queue and close the SDH port
+static int sdh_async_fini(void)
+{
+    if (s_i32Inited)
+    {
+        while ((s_u32Tail != s_u32Head) || (s_evState != evSdhIdle) || s_i32Selected)
+            sdh_async_poll();
+
+        s_i32Inited = 0;
+    }
+
+    SDH_Close(CONFIG_SDH_ASYNC_PORT);
+
+    return 0;
+}
+
+COMPONENT_EXPORT("SDH_ASYNC", sdh_async_init, sdh_async_fini);
@@ -0,0 +1,56 @@
+/**************************************************************************//**
+ * @file     sdh_async.h
+ * @brief    Interrupt-driven multi-block SD card reads and writes.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __SDH_ASYNC_H__
+#define __SDH_ASYNC_H__
+
+#include "NuMicro.h"
+#include "component.h"
+
+#define CONFIG_SDH_ASYNC_PORT              SDH0    /*!< SDH port holding the card, pins are set in board.c */
+#define CONFIG_SDH_ASYNC_INFO              SD0     /*!< Card information of the SDH port */
+#define CONFIG_SDH_ASYNC_IRQn          SDH0_IRQn   /*!< SDH port interrupt */
+#define CONFIG_SDH_ASYNC_IRQHandler  SDH0_IRQHandler   /*!< SDH port interrupt handler */
+#define CONFIG_SDH_ASYNC_CARD_DETECT  CardDetect_From_GPIO   /*!< Card detection source */
+#define CONFIG_SDH_ASYNC_QUEUE_NUM             8   /*!< Outstanding requests, power of 2 */
+
+/* Called once per request. i32Status is 0, or -1 on a CRC, timeout or card removal error. */
+typedef void (*SDH_ASYNC_CB)(void *pvUserData, int i32Status);
+
+typedef struct
+{
+    uint32_t m_u32Reads;            /*!< Read requests finished */
+    uint32_t m_u32Writes;           /*!< Write requests finished */
+    uint32_t m_u32Sectors;          /*!< Sectors transferred */
+    uint32_t m_u32Errors;           /*!< Requests finished with an error */
+    uint32_t m_u32QueueFull;        /*!< Requests rejected on a full queue */
+} S_SDH_ASYNC_STATS;
+
+// Function to queue a read of u32SecCount sectors from u32StartSec into pvBuf, returns request id or -1
+// pvBuf must be DCACHE_LINE_SIZE aligned, the card transfers straight into it.
+int sdh_async_read(uint32_t u32StartSec, void *pvBuf, uint32_t u32SecCount, SDH_ASYNC_CB pfnCb, void *pvUserData);
+
+// Function to queue a write of u32SecCount sectors from pvBuf to u32StartSec, returns request id or -1
+// pvBuf must be word aligned and left untouched until the request finishes.
+int sdh_async_write(uint32_t u32StartSec, const void *pvBuf, uint32_t u32SecCount, SDH_ASYNC_CB pfnCb, void *pvUserData);
+
+// Function to retire finished requests and start queued ones, returns the number of requests retired
+int sdh_async_poll(void);
+
+// Function to check whether a request is still queued or running
+int sdh_async_pending(int i32Id);
+
+// Function to wait until a request and its callback are finished
+void sdh_async_wait(int i32Id);
+
+// Function to get the card capacity in sectors
+uint32_t sdh_async_get_sectors(void);
+
+// Function to get the SDH engine statistics
+void sdh_async_get_stats(S_SDH_ASYNC_STATS *psStats);
+
+#endif /* __SDH_ASYNC_H__ */
@@ -0,0 +1,350 @@
+/**************************************************************************//**
+ * @file     spim_async.c
+ * @brief    Non-blocking SPIM flash reads with a request queue.
+ *
+ *           SPIM_DMA_Read busy-waits until the page read is done. Here a
+ *           read is split into chunks and only the chunk on the bus is
+ *           programmed; the SPIM interrupt starts the next chunk at once,
+ *           so the flash keeps streaming while spim_async_poll hands the
+ *           finished chunks to their callbacks.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "spim_async.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_SPIM_QUEUE_MASK      (CONFIG_SPIM_ASYNC_QUEUE_NUM - 1)
+#define DEF_SPIM_ID_MASK         0x7FFFFFFFUL
+
+typedef struct
+{
+    uint32_t          m_u32Addr;
+    uint8_t          *m_pu8Buf;
+    uint32_t          m_u32Len;
+    uint32_t          m_u32ChunkSize;
+    uint32_t          m_u32Issued;         // Bytes started on the bus, owned by IRQ
+    volatile uint32_t m_u32Done;           // Bytes landed in memory, owned by IRQ
+    uint32_t          m_u32Reported;       // Bytes handed to the callback, owned by poll
+    volatile int      m_i32Cancelled;
+    SPIM_ASYNC_CB     m_pfnCb;
+    void             *m_pvUserData;
+} S_SPIM_REQ;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static S_SPIM_REQ s_asReq[CONFIG_SPIM_ASYNC_QUEUE_NUM];
+
+/* Free-running sequence numbers, s_u32Tail <= s_u32Run <= s_u32Head. */
+static volatile uint32_t s_u32Head = 0;     // Next request to queue
+static volatile uint32_t s_u32Run = 0;      // Request on the bus
+static volatile uint32_t s_u32Tail = 0;     // Oldest request not retired by poll
+
+static volatile int s_i32Running = 0;
+static volatile uint32_t s_u32ChunkLen;     // Length of the chunk on the bus
+static uint32_t s_u32RdCmd;
+static uint32_t s_u32Is4ByteAddr;
+
+static S_SPIM_ASYNC_STATS s_sStats;
+
+/* 1-1-4 fast read output, quad enable is set by SPIM_DMADMM_InitPhase. */
+static SPIM_PHASE_T s_sPhaseRead =
+{
+    CMD_DMA_FAST_READ_QUAD_OUTPUT,                              // Command Code
+    PHASE_NORMAL_MODE, PHASE_WIDTH_8,  PHASE_DISABLE_DTR,       // Command Phase
+    PHASE_NORMAL_MODE, PHASE_WIDTH_24, PHASE_DISABLE_DTR,       // Address Phase
+    PHASE_QUAD_MODE,   PHASE_ORDER_MODE0, PHASE_DISABLE_DTR, PHASE_DISABLE_RDQS,  // Data Phase
+    8,                                                          // Dummy Cycle Phase
+    PHASE_DISABLE_CONT_READM, PHASE_NORMAL_MODE, PHASE_WIDTH_8, PHASE_DISABLE_DTR, // Read Mode Phase
+};
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to program one page read and return without waiting
+static void spim_async_start(uint32_t u32Addr, uint8_t *pu8Buf, uint32_t u32Len)
+{
+    SPIM_T *spim = CONFIG_SPIM_ASYNC_PORT;
+
+    /* Same programming as SPIM_DMA_Read, completion is left to the interrupt. */
+    SPIM_SET_OPMODE(spim, SPIM_CTL0_OPMODE_PAGEREAD);
+    SPIM_SET_CMD_CODE(spim, s_u32RdCmd);
+    SPIM_SET_4BYTE_ADDR(spim, s_u32Is4ByteAddr);
+
+    spim->SRAMADDR = (uint32_t)pu8Buf;
+    spim->DMACNT = u32Len;
+    spim->FADDR = u32Addr;
+
+    SPIM_SET_GO(spim);
+}
+
+// Function to drop the cache lines of a DMA buffer, a partial last line is written back first
+static void spim_async_dcache_drop(uint8_t *pu8Buf, uint32_t u32Len)
+{
+    uint32_t u32Full = u32Len & ~(DCACHE_LINE_SIZE - 1);
+
+    if (u32Full)
+        SCB_InvalidateDCache_by_Addr(pu8Buf, (int32_t)u32Full);
+
+    /* The bytes after the buffer in its last line belong to the caller, invalidating alone would lose them. */
+    if (u32Len != u32Full)
+        SCB_CleanInvalidateDCache_by_Addr(pu8Buf + u32Full, DCACHE_LINE_SIZE);
+}
+
+// Function to put the next chunk on the bus, called with SPIM interrupt masked or in IRQ
+static void spim_async_kick(void)
+{
+    while (s_u32Run != s_u32Head)
+    {
+        S_SPIM_REQ *psReq = &s_asReq[s_u32Run & DEF_SPIM_QUEUE_MASK];
+
+        if (!psReq->m_i32Cancelled && (psReq->m_u32Issued < psReq->m_u32Len))
+        {
+            uint32_t u32Len = psReq->m_u32Len - psReq->m_u32Issued;
+
+            if (u32Len > psReq->m_u32ChunkSize)
+                u32Len = psReq->m_u32ChunkSize;
+
+            s_u32ChunkLen = u32Len;
+            s_i32Running = 1;
+
+            spim_async_start(psReq->m_u32Addr + psReq->m_u32Issued, psReq->m_pu8Buf + psReq->m_u32Issued, u32Len);
+
+            psReq->m_u32Issued += u32Len;
+
+            return;
+        }
+
+        /* Fully issued and landed, or cancelled: leave it to poll. */
+        if (psReq->m_i32Cancelled || (psReq->m_u32Done == psReq->m_u32Len))
+            s_u32Run++;
+        else
+            break;
+    }
+
+    s_i32Running = 0;
+}
+
+// SPIM interrupt handler
+NVT_ITCM void CONFIG_SPIM_ASYNC_IRQHandler(void)
+{
+    SPIM_T *spim = CONFIG_SPIM_ASYNC_PORT;
+
+    if (SPIM_IS_IF_ON(spim))
+    {
+        SPIM_CLR_INT(spim);
+
+        if (s_i32Running)
+        {
+            S_SPIM_REQ *psReq = &s_asReq[s_u32Run & DEF_SPIM_QUEUE_MASK];
+
+            psReq->m_u32Done += s_u32ChunkLen;
+
+            /* Start the next chunk before anyone looks at this one. */
+            spim_async_kick();
+        }
+    }
+}
+
+// Function to queue a read of u32Len bytes at flash u32Addr into pvBuf, returns request id or -1
+int spim_async_read(uint32_t u32Addr, void *pvBuf, uint32_t u32Len, uint32_t u32ChunkSize, SPIM_ASYNC_CB pfnCb, void *pvUserData)
+{
+    S_SPIM_REQ *psReq;
+    uint32_t u32Seq;
+
+    if (u32ChunkSize == 0)
+        u32ChunkSize = CONFIG_SPIM_ASYNC_CHUNK_SIZE;
+
+    if (!pvBuf || !u32Len)
+        return -1;
+    else if (((uint32_t)pvBuf & (DCACHE_LINE_SIZE - 1)) || (u32ChunkSize & (DCACHE_LINE_SIZE - 1)))
+        return -1;
+
+    /* Stale lines must not be written back over the DMA data. */
+    spim_async_dcache_drop((uint8_t *)pvBuf, u32Len);
+
+    NVIC_DisableIRQ(CONFIG_SPIM_ASYNC_IRQn);
+
+    if ((s_u32Head - s_u32Tail) >= CONFIG_SPIM_ASYNC_QUEUE_NUM)
+    {
+        s_sStats.m_u32QueueFull++;
+        NVIC_EnableIRQ(CONFIG_SPIM_ASYNC_IRQn);
+        return -1;
+    }
+
+    u32Seq = s_u32Head;
+    psReq = &s_asReq[u32Seq & DEF_SPIM_QUEUE_MASK];
+
+    psReq->m_u32Addr = u32Addr;
+    psReq->m_pu8Buf = (uint8_t *)pvBuf;
+    psReq->m_u32Len = u32Len;
+    psReq->m_u32ChunkSize = u32ChunkSize;
+    psReq->m_u32Issued = 0;
+    psReq->m_u32Done = 0;
+    psReq->m_u32Reported = 0;
+    psReq->m_i32Cancelled = 0;
+    psReq->m_pfnCb = pfnCb;
+    psReq->m_pvUserData = pvUserData;
+
+    s_u32Head = u32Seq + 1;
+
+    if (!s_i32Running)
+        spim_async_kick();
+
+    NVIC_EnableIRQ(CONFIG_SPIM_ASYNC_IRQn);
+
+    return (int)(u32Seq & DEF_SPIM_ID_MASK);
+}
+
+// Function to run the callbacks of finished chunks, returns the number of callbacks run
+int spim_async_poll(void)
+{
+    int i32Count = 0;
+
+    while (s_u32Tail != s_u32Head)
+    {
+        S_SPIM_REQ *psReq = &s_asReq[s_u32Tail & DEF_SPIM_QUEUE_MASK];
+        uint32_t u32Done = psReq->m_u32Done;
+
+        while (psReq->m_u32Reported < u32Done)
+        {
+            uint32_t u32Len = u32Done - psReq->m_u32Reported;
+            uint8_t *pu8Chunk = psReq->m_pu8Buf + psReq->m_u32Reported;
+
+            if (u32Len > psReq->m_u32ChunkSize)
+                u32Len = psReq->m_u32ChunkSize;
+
+            /* Drop lines speculatively fetched while the DMA was writing. */
+            spim_async_dcache_drop(pu8Chunk, u32Len);
+
+            if (psReq->m_pfnCb)
+                psReq->m_pfnCb(psReq->m_pvUserData, pu8Chunk, psReq->m_u32Reported, u32Len, 0);
+
+            psReq->m_u32Reported += u32Len;
+
+            s_sStats.m_u32Chunks++;
+            s_sStats.m_u32Bytes += u32Len;
+            i32Count++;
+        }
+
+        /* Not retired until the interrupt is done with it. */
+        if ((int32_t)(s_u32Run - s_u32Tail) <= 0)
+            break;
+        else if (psReq->m_u32Reported != psReq->m_u32Done)
+            continue;
+
+        if (psReq->m_u32Reported == psReq->m_u32Len)
+        {
+            s_sStats.m_u32Reads++;
+        }
+        else if (psReq->m_pfnCb)
+        {
+            psReq->m_pfnCb(psReq->m_pvUserData, NULL, psReq->m_u32Reported, 0, -1);
+            i32Count++;
+        }
+
+        s_u32Tail++;
+    }
+
+    return i32Count;
+}
+
+// Function to check whether a request is still queued or running
+int spim_async_pending(int i32Id)
+{
+    uint32_t u32Tail = s_u32Tail;
+
+    if (i32Id < 0)
+        return 0;
+
+    return ((((uint32_t)i32Id - u32Tail) & DEF_SPIM_ID_MASK) < (s_u32Head - u32Tail));
+}
+
+// Function to wait until a request and its callbacks are finished
+void spim_async_wait(int i32Id)
+{
+    while (spim_async_pending(i32Id))
+        spim_async_poll();
+}
+
+// Function to cancel all queued requests, the running chunk is finished first
+void spim_async_cancel(void)
+{
+    uint32_t u32Seq;
+
+    NVIC_DisableIRQ(CONFIG_SPIM_ASYNC_IRQn);
+
+    for (u32Seq = s_u32Tail; u32Seq != s_u32Head; u32Seq++)
+        s_asReq[u32Seq & DEF_SPIM_QUEUE_MASK].m_i32Cancelled = 1;
+
+    /* Nothing on the bus, retire them here instead of in the interrupt. */
+    if (!s_i32Running)
+        spim_async_kick();
+
+    NVIC_EnableIRQ(CONFIG_SPIM_ASYNC_IRQn);
+
+    spim_async_poll();
+}
+
+// Function to get the SPIM read statistics
+void spim_async_get_stats(S_SPIM_ASYNC_STATS *psStats)
+{
+    if (psStats)
+        *psStats = s_sStats;
+}
+
+// Function to initialize the SPIM flash and the read queue
+static int spim_async_init(void)
+{
+    SPIM_T *spim = CONFIG_SPIM_ASYNC_PORT;
+
+    s_u32Head = s_u32Run = s_u32Tail = 0;
+    s_i32Running = 0;
+
+    SPIM_SET_CLOCK_DIVIDER(spim, CONFIG_SPIM_ASYNC_DIVIDER);
+    SPIM_DISABLE_CIPHER(spim);
+
+    if (SPIM_InitFlash(spim, 1) != SPIM_OK)
+        return -1;
+
+    SPIM_DMADMM_InitPhase(spim, &s_sPhaseRead, SPIM_CTL0_OPMODE_PAGEREAD);
+
+    /* Resolve once what SPIM_DMA_Read works out on every call. */
+    s_u32Is4ByteAddr = (SPIM_GET_PHDMAR_ADDR_WIDTH(spim) == PHASE_WIDTH_32) ? SPIM_OP_ENABLE : SPIM_OP_DISABLE;
+    s_u32RdCmd = (((SPIM_GET_PHDMAR_CMD_DTR(spim) == SPIM_OP_ENABLE) &&
+                   (SPIM_GET_PHDMAR_CMD_WIDTH(spim) == PHASE_WIDTH_16)) ?
+                  ((s_sPhaseRead.u32CMDCode << 8) | s_sPhaseRead.u32CMDCode) :
+                  s_sPhaseRead.u32CMDCode);
+
+    SPIM_CLR_INT(spim);
+    SPIM_ENABLE_INT(spim);
+    NVIC_EnableIRQ(CONFIG_SPIM_ASYNC_IRQn);
+
+    return 0;
+}
+
+// Function to deinitialize the read queue
+static int spim_async_fini(void)
+{
+    SPIM_T *spim = CONFIG_SPIM_ASYNC_PORT;
+
+    spim_async_cancel();
+
+    /* Let the chunk on the bus land before releasing its buffer. */
+    while (s_i32Running)
+        spim_async_poll();
+
+    spim_async_poll();
+
+    NVIC_DisableIRQ(CONFIG_SPIM_ASYNC_IRQn);
+    SPIM_DISABLE_INT(spim);
+    SPIM_CLR_INT(spim);
+
+    return 0;
+}
+
+COMPONENT_EXPORT("SPIM_ASYNC", spim_async_init, spim_async_fini);
@@ -0,0 +1,53 @@
+/**************************************************************************//**
+ * @file     spim_async.h
+ * @brief    Non-blocking SPIM flash reads with a request queue.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __SPIM_ASYNC_H__
+#define __SPIM_ASYNC_H__
+
+#include "NuMicro.h"
+#include "component.h"
+
+#define CONFIG_SPIM_ASYNC_PORT             SPIM0   /*!< SPIM port holding the asset flash, pins are set in board.c */
+#define CONFIG_SPIM_ASYNC_IRQn         SPIM0_IRQn  /*!< SPIM port interrupt */
+#define CONFIG_SPIM_ASYNC_IRQHandler  SPIM0_IRQHandler   /*!< SPIM port interrupt handler */
+#define CONFIG_SPIM_ASYNC_DIVIDER              1   /*!< SPIM bus clock is HCLK/(2*DIVIDER) */
+#define CONFIG_SPIM_ASYNC_QUEUE_NUM            8   /*!< Outstanding read requests, power of 2 */
+#define CONFIG_SPIM_ASYNC_CHUNK_SIZE        8192   /*!< Default chunk size in bytes, multiple of DCACHE_LINE_SIZE */
+
+/* Called for every finished chunk. i32Status is 0, or -1 when the request was cancelled. */
+typedef void (*SPIM_ASYNC_CB)(void *pvUserData, uint8_t *pu8Chunk, uint32_t u32Offset, uint32_t u32Len, int i32Status);
+
+typedef struct
+{
+    uint32_t m_u32Reads;            /*!< Requests finished */
+    uint32_t m_u32Chunks;           /*!< Chunks finished */
+    uint32_t m_u32Bytes;            /*!< Bytes read */
+    uint32_t m_u32QueueFull;        /*!< Requests rejected on a full queue */
+} S_SPIM_ASYNC_STATS;
+
+// Function to queue a read of u32Len bytes at flash u32Addr into pvBuf, returns request id or -1
+// pvBuf must be DCACHE_LINE_SIZE aligned. When u32Len is not a multiple of it, the bytes after pvBuf in its last
+// cache line must not be written until the request is finished. u32ChunkSize 0 selects CONFIG_SPIM_ASYNC_CHUNK_SIZE.
+int spim_async_read(uint32_t u32Addr, void *pvBuf, uint32_t u32Len, uint32_t u32ChunkSize, SPIM_ASYNC_CB pfnCb, void *pvUserData);
+
+// Function to run the callbacks of finished chunks, returns the number of callbacks run
+// The next chunk is already on the bus while a callback runs, so decode overlaps the read.
+int spim_async_poll(void);
+
+// Function to check whether a request is still queued or running
+int spim_async_pending(int i32Id);
+
+// Function to wait until a request and its callbacks are finished
+void spim_async_wait(int i32Id);
+
+// Function to cancel all queued requests, the running chunk is finished first
+void spim_async_cancel(void);
+
+// Function to get the SPIM read statistics
+void spim_async_get_stats(S_SPIM_ASYNC_STATS *psStats);
+
+#endif /* __SPIM_ASYNC_H__ */
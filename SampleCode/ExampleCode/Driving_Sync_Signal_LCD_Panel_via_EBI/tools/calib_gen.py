@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+# Copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+"""Build a disp_calib record from panel luminance measurements.
+
+The input is a CSV of "channel,code,luminance" rows, channel R, G or B and code
+the RGB565 channel value (0~31 for R and B, 0~63 for G) shown with the other
+channels at 0. Codes in between are interpolated, so a handful per channel
+will do, but 0 and the maximum must be measured.
+
+Each LUT maps an input code to the smallest code reaching the target response:
+the gamma curve scaled so the three channels at full input mix to the white
+point given by --shares, the luminance share of R, G and B in white.
+
+The record is written as binary for OTP or flash programming, and with --c
+as a C initializer for disp_calib_set.
+"""
+
+import argparse
+import binascii
+import csv
+import struct
+import sys
+
+MAGIC = 0x424C4143  # "CALB"
+VERSION = 1
+CODES = {'R': 32, 'G': 64, 'B': 32}
+
+
+def load(path):
+    points = {ch: {} for ch in CODES}
+
+    with open(path, newline='') as f:
+        for row in csv.reader(f):
+            if not row or row[0].strip().startswith('#'):
+                continue
+
+            ch, code, lum = row[0].strip().upper(), int(row[1]), float(row[2])
+
+            if ch not in CODES or not 0 <= code < CODES[ch]:
+                sys.exit('bad row: %s' % ','.join(row))
+
+            points[ch][code] = lum
+
+    for ch, n in CODES.items():
+        if 0 not in points[ch] or (n - 1) not in points[ch]:
+            sys.exit('%s needs codes 0 and %d measured' % (ch, n - 1))
+
+    return points
+
+
+def response(points, n):
+    """Luminance of every code, interpolated and forced non-decreasing."""
+    codes = sorted(points)
+    out = []
+
+    for c in range(n):
+        lo = max(k for k in codes if k <= c)
+        hi = min(k for k in codes if k >= c)
+        y = points[lo] if hi == lo else points[lo] + (points[hi] - points[lo]) * (c - lo) / (hi - lo)
+        out.append(max(y, out[-1]) if out else y)
+
+    return out
+
+
+def build(points, gamma, shares):
+    resp = {ch: response(points[ch], n) for ch, n in CODES.items()}
+
+    # Brightest white every channel can still reach at its share.
+    black = {ch: resp[ch][0] for ch in CODES}
+    white = min((resp[ch][-1] - black[ch]) / shares[ch] for ch in CODES)
+    luts = {}
+
+    for ch, n in CODES.items():
+        lut = []
+
+        for c in range(n):
+            target = black[ch] + shares[ch] * white * (c / (n - 1)) ** gamma
+            lut.append(next((k for k in range(n) if resp[ch][k] >= target - 1e-9), n - 1))
+
+        luts[ch] = lut
+
+    return luts
+
+
+def record(luts, panel_id):
+    body = struct.pack('<IHH32s64s32sI', MAGIC, VERSION, panel_id,
+                       bytes(luts['R']), bytes(luts['G']), bytes(luts['B']), 0)
+
+    return body + struct.pack('<I', binascii.crc32(body) & 0xFFFFFFFF)
+
+
+def c_initializer(luts, panel_id, crc):
+    def arr(v):
+        return '{ ' + ', '.join('%2d' % x for x in v) + ' }'
+
+    return ('const S_DISP_CALIB_RECORD g_sDispCalib =\n{\n'
+            '    0x%08XUL, %d, 0x%04X,\n'
+            '    %s,\n    %s,\n    %s,\n'
+            '    0, 0x%08XUL\n};\n') % (MAGIC, VERSION, panel_id, arr(luts['R']), arr(luts['G']), arr(luts['B']), crc)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('csv', help='measurements, channel,code,luminance')
+    ap.add_argument('-o', '--output', default='calib.bin', help='binary record')
+    ap.add_argument('--c', help='also write a C initializer to this file')
+    ap.add_argument('--gamma', type=float, default=2.2, help='target gamma (default 2.2)')
+    ap.add_argument('--shares', default='0.2126,0.7152,0.0722',
+                    help='R,G,B luminance shares of white (default D65 with sRGB primaries)')
+    ap.add_argument('--panel-id', type=lambda s: int(s, 0), default=0, help='m_u16PanelId of the record')
+    args = ap.parse_args()
+
+    shares = dict(zip('RGB', (float(x) for x in args.shares.split(','))))
+    luts = build(load(args.csv), args.gamma, shares)
+    rec = record(luts, args.panel_id & 0xFFFF)
+
+    with open(args.output, 'wb') as f:
+        f.write(rec)
+
+    if args.c:
+        with open(args.c, 'w') as f:
+            f.write(c_initializer(luts, args.panel_id & 0xFFFF, struct.unpack('<I', rec[-4:])[0]))
+
+    print('%s: %d bytes, %d OTP entries' % (args.output, len(rec), len(rec) // 8))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,68 @@
+/**************************************************************************//**
+ * @file     host.c
+ * @brief    Common helpers of the host tests.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <time.h>
+#include "host.h"
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+uint32_t SystemCoreClock = CONFIG_HOST_CORE_CLOCK;
+DCB_Type g_sHostDcb;
+int g_i32HostFails = 0;
+
+static DWT_Type s_sHostDwt;
+
+/* The linker bounds the CompInitTab section with these on the host, a test without components has none. */
+extern const struct component_export __start_CompInitTab[] __WEAK;
+extern const struct component_export __stop_CompInitTab[] __WEAK;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+DWT_Type *host_dwt(void)
+{
+    struct timespec sTs;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTs);
+    s_sHostDwt.CYCCNT = (uint32_t)(((uint64_t)sTs.tv_sec * 1000000000ULL + (uint64_t)sTs.tv_nsec) * (SystemCoreClock / 1000000UL) / 1000UL);
+
+    return &s_sHostDwt;
+}
+
+void host_comp_init(void)
+{
+    const struct component_export *psComp;
+
+    for (psComp = __start_CompInitTab; psComp < __stop_CompInitTab; psComp++)
+    {
+        if (psComp->initialize && (psComp->initialize() < 0))
+        {
+            printf("Initialize %s failure.\n", psComp->name);
+            g_i32HostFails++;
+        }
+    }
+}
+
+void host_comp_fini(void)
+{
+    const struct component_export *psComp;
+
+    for (psComp = __start_CompInitTab; psComp < __stop_CompInitTab; psComp++)
+    {
+        if (psComp->finalize)
+            psComp->finalize();
+    }
+}
+
+int host_result(const char *pcName)
+{
+    printf("%s: %s\n", pcName, g_i32HostFails ? "FAILED" : "passed");
+
+    return g_i32HostFails ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+/**************************************************************************//**
+ * @file     host.h
+ * @brief    Common helpers of the host tests.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include <stdio.h>
+#include "NuMicro.h"
+#include "component.h"
+
+#define CONFIG_HOST_CORE_CLOCK      220000000UL   /*!< Clock DWT->CYCCNT is scaled to, the M55M1 core clock */
+
+extern int g_i32HostFails;
+
+/* Records a failed check and goes on, so one run reports every failure. */
+#define HOST_CHECK(cond, ...)                                   \
+    do                                                          \
+    {                                                           \
+        if (!(cond))                                            \
+        {                                                       \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);         \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            g_i32HostFails++;                                   \
+        }                                                       \
+    } while (0)
+
+// Function to call the initialize method of every exported component, as main.c does
+void host_comp_init(void);
+
+// Function to call the finalize method of every exported component
+void host_comp_fini(void);
+
+// Function to print the result line and return the process exit code
+int host_result(const char *pcName);
+
+#endif /* __HOST_H__ */
@@ -0,0 +1,243 @@
+/**************************************************************************//**
+ * @file     host_aes.c
+ * @brief    Software AES behind the CRYPTO AES driver calls, for the host tests.
+ *
+ *           Covers the AES-CTR DMA cascade used by screenshot.c on channel
+ *           registers kept in memory. A run is encrypted right in AES_Start
+ *           and raises AESIF at once. Keys and counter blocks are taken as
+ *           big-endian words like the engine registers, the data in memory
+ *           byte order as with AES_IN_OUT_SWAP. The cipher follows FIPS-197.
+ *           RNG_Random takes its words from the host random generator.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <sys/random.h>
+#include "host.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_AES_CH_NUM           4
+#define DEF_AES_RK_WORDS        60   /*!< Round keys of AES-256 */
+
+typedef struct
+{
+    uint32_t m_u32Mode;
+    uint32_t m_u32KeySize;
+    uint32_t m_au32Key[8];
+    uint32_t m_au32IV[4];
+    uint32_t m_u32Src;
+    uint32_t m_u32Dst;
+    uint32_t m_u32Cnt;
+    uint8_t  m_au8Ctr[16];          /*!< Counter block carried through the cascade */
+} S_HOST_AES_CH;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+CRYPTO_T g_sHostCrypto;
+uint32_t g_u32HostAesBytes = 0;
+int g_i32HostRngFail = 0;
+
+static S_HOST_AES_CH s_asCh[DEF_AES_CH_NUM];
+
+static const uint8_t s_au8Sbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to multiply by x in GF(2^8)
+static uint8_t host_aes_xtime(uint8_t u8V)
+{
+    return (uint8_t)((u8V << 1) ^ ((u8V & 0x80) ? 0x1B : 0x00));
+}
+
+// Function to expand a key of u32Nk words, returns the number of rounds
+static int host_aes_expand(const uint32_t *pu32Key, uint32_t u32Nk, uint32_t *pu32Rk)
+{
+    uint32_t u32Rcon = 0x01000000UL;
+    int i32Rounds = u32Nk + 6;
+    uint32_t i;
+
+    for (i = 0; i < u32Nk; i++)
+        pu32Rk[i] = pu32Key[i];
+
+    for (i = u32Nk; i < 4UL * (i32Rounds + 1); i++)
+    {
+        uint32_t t = pu32Rk[i - 1];
+
+        if ((i % u32Nk) == 0)
+        {
+            t = (t << 8) | (t >> 24);
+            t = ((uint32_t)s_au8Sbox[t >> 24] << 24) | ((uint32_t)s_au8Sbox[(t >> 16) & 0xFF] << 16) |
+                ((uint32_t)s_au8Sbox[(t >> 8) & 0xFF] << 8) | s_au8Sbox[t & 0xFF];
+            t ^= u32Rcon;
+            u32Rcon = (uint32_t)host_aes_xtime((uint8_t)(u32Rcon >> 24)) << 24;
+        }
+        else if ((u32Nk > 6) && ((i % u32Nk) == 4))
+        {
+            t = ((uint32_t)s_au8Sbox[t >> 24] << 24) | ((uint32_t)s_au8Sbox[(t >> 16) & 0xFF] << 16) |
+                ((uint32_t)s_au8Sbox[(t >> 8) & 0xFF] << 8) | s_au8Sbox[t & 0xFF];
+        }
+
+        pu32Rk[i] = pu32Rk[i - u32Nk] ^ t;
+    }
+
+    return i32Rounds;
+}
+
+// Function to encrypt one block in place
+static void host_aes_block(const uint32_t *pu32Rk, int i32Rounds, uint8_t *pu8S)
+{
+    uint8_t au8T[16];
+    int r, c, i;
+
+    for (r = 0; r <= i32Rounds; r++)
+    {
+        if (r > 0)
+        {
+            /* SubBytes and ShiftRows, the state is column major. */
+            for (c = 0; c < 4; c++)
+                for (i = 0; i < 4; i++)
+                    au8T[c * 4 + i] = s_au8Sbox[pu8S[((c + i) % 4) * 4 + i]];
+
+            /* MixColumns, all but the last round. */
+            for (c = 0; (c < 4) && (r < i32Rounds); c++)
+            {
+                uint8_t *p = &au8T[c * 4];
+                uint8_t a0 = p[0], a1 = p[1], a2 = p[2], a3 = p[3];
+
+                p[0] = host_aes_xtime(a0) ^ host_aes_xtime(a1) ^ a1 ^ a2 ^ a3;
+                p[1] = a0 ^ host_aes_xtime(a1) ^ host_aes_xtime(a2) ^ a2 ^ a3;
+                p[2] = a0 ^ a1 ^ host_aes_xtime(a2) ^ host_aes_xtime(a3) ^ a3;
+                p[3] = host_aes_xtime(a0) ^ a0 ^ a1 ^ a2 ^ host_aes_xtime(a3);
+            }
+
+            memcpy(pu8S, au8T, sizeof(au8T));
+        }
+
+        /* AddRoundKey */
+        for (c = 0; c < 4; c++)
+        {
+            uint32_t k = pu32Rk[r * 4 + c];
+
+            pu8S[c * 4 + 0] ^= (uint8_t)(k >> 24);
+            pu8S[c * 4 + 1] ^= (uint8_t)(k >> 16);
+            pu8S[c * 4 + 2] ^= (uint8_t)(k >> 8);
+            pu8S[c * 4 + 3] ^= (uint8_t)k;
+        }
+    }
+}
+
+void AES_Open(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t u32EncDec, uint32_t u32OpMode, uint32_t u32KeySize, uint32_t u32SwapType)
+{
+    (void)crypto;
+    (void)u32EncDec;
+    (void)u32SwapType;
+
+    s_asCh[u32Channel].m_u32Mode = u32OpMode;
+    s_asCh[u32Channel].m_u32KeySize = u32KeySize;
+}
+
+void AES_SetKey(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t au32Keys[], uint32_t u32KeySize)
+{
+    (void)crypto;
+
+    memcpy(s_asCh[u32Channel].m_au32Key, au32Keys, (4UL + u32KeySize * 2UL) * sizeof(uint32_t));
+}
+
+void AES_SetInitVect(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t au32IV[])
+{
+    (void)crypto;
+
+    memcpy(s_asCh[u32Channel].m_au32IV, au32IV, sizeof(s_asCh[u32Channel].m_au32IV));
+}
+
+void AES_SetDMATransfer(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t u32SrcAddr, uint32_t u32DstAddr, uint32_t u32TransCnt)
+{
+    (void)crypto;
+
+    s_asCh[u32Channel].m_u32Src = u32SrcAddr;
+    s_asCh[u32Channel].m_u32Dst = u32DstAddr;
+    s_asCh[u32Channel].m_u32Cnt = u32TransCnt;
+}
+
+void AES_Start(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t u32DMAMode)
+{
+    S_HOST_AES_CH *psCh = &s_asCh[u32Channel];
+    const uint8_t *pu8Src = (const uint8_t *)(uintptr_t)psCh->m_u32Src;
+    uint8_t *pu8Dst = (uint8_t *)(uintptr_t)psCh->m_u32Dst;
+    uint32_t au32Rk[DEF_AES_RK_WORDS];
+    int i32Rounds, i;
+    uint32_t n;
+
+    /* Only the counter mode cascade on whole blocks is modelled, anything else is an engine error. */
+    if ((psCh->m_u32Mode != AES_MODE_CTR) || (psCh->m_u32KeySize > AES_KEY_SIZE_256) || (psCh->m_u32Cnt % 16))
+    {
+        crypto->INTSTS |= CRYPTO_INTSTS_AESEIF_Msk;
+        return;
+    }
+
+    i32Rounds = host_aes_expand(psCh->m_au32Key, 4 + psCh->m_u32KeySize * 2, au32Rk);
+
+    /* A new cascade starts from the IV, the others go on from the last counter. */
+    if ((u32DMAMode == CRYPTO_DMA_FIRST) || (u32DMAMode == CRYPTO_DMA_ONE_SHOT))
+    {
+        for (i = 0; i < 16; i++)
+            psCh->m_au8Ctr[i] = (uint8_t)(psCh->m_au32IV[i / 4] >> (24 - 8 * (i % 4)));
+    }
+
+    for (n = 0; n < psCh->m_u32Cnt; n += 16)
+    {
+        uint8_t au8Ks[16];
+
+        memcpy(au8Ks, psCh->m_au8Ctr, sizeof(au8Ks));
+        host_aes_block(au32Rk, i32Rounds, au8Ks);
+
+        for (i = 0; i < 16; i++)
+            pu8Dst[n + i] = pu8Src[n + i] ^ au8Ks[i];
+
+        /* The whole block counts up as one big-endian number. */
+        for (i = 15; (i >= 0) && (++psCh->m_au8Ctr[i] == 0); i--)
+            ;
+    }
+
+    g_u32HostAesBytes += psCh->m_u32Cnt;
+    crypto->INTSTS |= CRYPTO_INTSTS_AESIF_Msk;
+}
+
+int32_t RNG_Open(void)
+{
+    return 0;
+}
+
+int32_t RNG_Random(uint32_t *pu32Buf, int32_t nWords)
+{
+    nWords = (nWords > 8) ? 8 : nWords;
+
+    /* The driver returns the words generated, none on a timeout. */
+    if (g_i32HostRngFail || (getrandom(pu32Buf, (size_t)nWords * sizeof(uint32_t), 0) != (ssize_t)(nWords * sizeof(uint32_t))))
+        return 0;
+
+    return nWords;
+}
@@ -0,0 +1,166 @@
+/**************************************************************************//**
+ * @file     NuMicro.h
+ * @brief    Host stand-in for the device header, for the host tests only.
+ *
+ *           Declares the few core registers and intrinsics the portable
+ *           sample sources use. Cache maintenance and interrupt masking are
+ *           no-ops, DWT->CYCCNT counts host time in SystemCoreClock cycles.
+ *           PDMA descriptors and EBI addresses keep their device layout, so
+ *           descriptor chains built on the host can be walked and checked;
+ *           clock and reset calls do nothing. The AES calls of the crypto
+ *           engine are served by the software AES in host_aes.c, its random
+ *           numbers by the host generator.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+#ifndef __NUMICRO_H__
+#define __NUMICRO_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NVT_ITCM
+#define NVT_DTCM
+#define NVT_DTCM_INIT
+/* Descriptor arenas are non-cacheable data, each within one 64 KB NEXT-offset window. */
+#define NVT_NONCACHEABLE            __attribute__((aligned(0x10000)))
+
+#define __STATIC_INLINE             static inline
+#define __STATIC_FORCEINLINE        static inline __attribute__((always_inline))
+#define __WEAK                      __attribute__((weak))
+#define __ALIGNED(x)                __attribute__((aligned(x)))
+
+#define DCACHE_LINE_SIZE            32
+#define SDH_BLOCK_SIZE              (512ul)
+
+typedef struct
+{
+    uint32_t DEMCR;
+} DCB_Type;
+
+typedef struct
+{
+    uint32_t CTRL;
+    uint32_t CYCCNT;
+} DWT_Type;
+
+#define DCB_DEMCR_TRCENA_Msk        (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+
+extern uint32_t SystemCoreClock;
+extern DCB_Type g_sHostDcb;
+
+// Function to sample the host clock into the cycle counter
+DWT_Type *host_dwt(void);
+
+#define DCB                         (&g_sHostDcb)
+#define DWT                         (host_dwt())
+
+/* PDMA descriptor, as in pdma_reg.h */
+typedef struct
+{
+    volatile uint32_t CTL;
+    volatile uint32_t SA;
+    volatile uint32_t DA;
+    volatile uint32_t NEXT;
+} DSCT_T;
+
+#define PDMA_DSCT_CTL_OPMODE_Pos    (0)
+#define PDMA_DSCT_CTL_OPMODE_Msk    (0x3ul << PDMA_DSCT_CTL_OPMODE_Pos)
+#define PDMA_DSCT_CTL_TBINTDIS_Pos  (7)
+#define PDMA_DSCT_CTL_TBINTDIS_Msk  (0x1ul << PDMA_DSCT_CTL_TBINTDIS_Pos)
+#define PDMA_DSCT_CTL_TXCNT_Pos     (16)
+#define PDMA_DSCT_CTL_TXCNT_Msk     (0xfffful << PDMA_DSCT_CTL_TXCNT_Pos)
+#define PDMA_DSCT_NEXT_NEXT_Pos     (0)
+#define PDMA_DSCT_NEXT_NEXT_Msk     (0xfffful << PDMA_DSCT_NEXT_NEXT_Pos)
+
+#define PDMA_OP_STOP                0x00000000UL
+#define PDMA_OP_BASIC               0x00000001UL
+#define PDMA_OP_SCATTER             0x00000002UL
+#define PDMA_WIDTH_8                0x00000000UL
+#define PDMA_WIDTH_16               0x00001000UL
+#define PDMA_WIDTH_32               0x00002000UL
+#define PDMA_SAR_INC                0x00000000UL
+#define PDMA_SAR_FIX                0x00000300UL
+#define PDMA_DAR_INC                0x00000000UL
+#define PDMA_DAR_FIX                0x00000C00UL
+#define PDMA_REQ_BURST              0x00000000UL
+#define PDMA_BURST_32               0x00000020UL
+#define PDMA_MEM                    0UL
+
+#define EBI_BANK0_BASE_ADDR         0x60000000UL
+#define EBI_MAX_SIZE                0x00100000UL
+#define EBI_BANK0                   0UL
+
+#define PDMA0_MODULE                0UL
+#define PDMA1_MODULE                1UL
+#define SYS_PDMA0RST                0UL
+#define SYS_PDMA1RST                1UL
+
+/* Crypto engine, the AES calls run in software in host_aes.c */
+typedef struct
+{
+    volatile uint32_t INTSTS;
+} CRYPTO_T;
+
+#define CRYPTO_INTSTS_AESIF_Msk     (0x1ul << 0)
+#define CRYPTO_INTSTS_AESEIF_Msk    (0x1ul << 1)
+
+#define AES_KEY_SIZE_128            0UL
+#define AES_KEY_SIZE_192            1UL
+#define AES_KEY_SIZE_256            2UL
+#define AES_MODE_CTR                4UL
+#define AES_IN_OUT_SWAP             3UL
+#define CRYPTO_DMA_FIRST            0x4UL
+#define CRYPTO_DMA_ONE_SHOT         0x5UL
+#define CRYPTO_DMA_CONTINUE         0x6UL
+#define CRYPTO_DMA_LAST             0x7UL
+
+extern CRYPTO_T g_sHostCrypto;
+extern uint32_t g_u32HostAesBytes;        /* Bytes run through the AES, for budget checks */
+extern int g_i32HostRngFail;              /* RNG_Random fails while set */
+
+#define CRYPTO                      (&g_sHostCrypto)
+#define AES_GET_INT_FLAG(crypto)    ((crypto)->INTSTS & (CRYPTO_INTSTS_AESIF_Msk | CRYPTO_INTSTS_AESEIF_Msk))
+#define AES_CLR_INT_FLAG(crypto)    ((crypto)->INTSTS &= ~(CRYPTO_INTSTS_AESIF_Msk | CRYPTO_INTSTS_AESEIF_Msk))
+
+void AES_Open(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t u32EncDec, uint32_t u32OpMode, uint32_t u32KeySize, uint32_t u32SwapType);
+void AES_Start(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t u32DMAMode);
+void AES_SetKey(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t au32Keys[], uint32_t u32KeySize);
+void AES_SetInitVect(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t au32IV[]);
+void AES_SetDMATransfer(CRYPTO_T *crypto, uint32_t u32Channel, uint32_t u32SrcAddr, uint32_t u32DstAddr, uint32_t u32TransCnt);
+int32_t RNG_Open(void);
+int32_t RNG_Random(uint32_t *pu32Buf, int32_t nWords);
+
+__STATIC_INLINE uint32_t SYS_IsRegLocked(void) { return 0; }
+__STATIC_INLINE void SYS_UnlockReg(void) { }
+__STATIC_INLINE void SYS_LockReg(void) { }
+__STATIC_INLINE void SYS_ResetModule(uint32_t u32ModuleIndex) { (void)u32ModuleIndex; }
+__STATIC_INLINE void CLK_EnableModuleClock(uint32_t u32ModuleIdx) { (void)u32ModuleIdx; }
+__STATIC_INLINE void CLK_DisableModuleClock(uint32_t u32ModuleIdx) { (void)u32ModuleIdx; }
+
+__STATIC_INLINE void SCB_CleanDCache_by_Addr(volatile void *pvAddr, int32_t i32Size) { (void)pvAddr; (void)i32Size; }
+__STATIC_INLINE void SCB_InvalidateDCache_by_Addr(volatile void *pvAddr, int32_t i32Size) { (void)pvAddr; (void)i32Size; }
+__STATIC_INLINE void SCB_CleanInvalidateDCache_by_Addr(volatile void *pvAddr, int32_t i32Size) { (void)pvAddr; (void)i32Size; }
+
+__STATIC_INLINE uint32_t __get_PRIMASK(void) { return 0; }
+__STATIC_INLINE uint32_t __get_IPSR(void) { return 0; }
+__STATIC_INLINE void __set_PRIMASK(uint32_t u32PriMask) { (void)u32PriMask; }
+__STATIC_INLINE void __disable_irq(void) { }
+__STATIC_INLINE void __enable_irq(void) { }
+__STATIC_INLINE void __DSB(void) { __sync_synchronize(); }
+__STATIC_INLINE void __DMB(void) { __sync_synchronize(); }
+__STATIC_INLINE void __ISB(void) { }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NUMICRO_H__ */
@@ -0,0 +1,429 @@
+/**************************************************************************//**
+ * @file     test_blk_cache.c
+ * @brief    Host trace benchmark of blk_cache over simulated SPIM and SD.
+ *
+ *           A UI session trace, the asset reads of four screens visited in
+ *           turn, is replayed three times: straight from the devices, through
+ *           the cache, and through the cache with prefetch hints issued for
+ *           the next screen while the current one is shown. The devices are
+ *           simulated with a per-request latency and a transfer rate and run
+ *           their queues in the background of a simulated clock, so the
+ *           time a screen waits for its assets can be compared. Data read
+ *           through the cache is checked against the device content.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "host.h"
+#include "blk_cache.h"
+#include "spim_async.h"
+#include "sdh_async.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_TEST_SCREEN_NUM        4
+#define DEF_TEST_READ_MAX        128     /*!< Reads of one screen visit */
+#define DEF_TEST_REQ_MAX          16
+#define DEF_TEST_DWELL_NS   200000000ULL /*!< Time a screen is shown before the next one */
+#define DEF_TEST_STEP_NS      1000000ULL /*!< Main loop period while a screen is shown */
+
+/* Device timing, per request latency and nanoseconds per byte. */
+#define DEF_TEST_SPIM_LAT_NS       2000ULL
+#define DEF_TEST_SPIM_BYTE_NS        20ULL   /*!< 50 MB/s */
+#define DEF_TEST_SD_LAT_NS       400000ULL
+#define DEF_TEST_SD_BYTE_NS          40ULL   /*!< 25 MB/s */
+
+typedef enum
+{
+    evTestDirect,
+    evTestCache,
+    evTestHints,
+    evTestCNT
+} E_TEST_RUN;
+
+typedef struct
+{
+    uint8_t m_u8Dev;
+    uint32_t m_u32Offset;
+    uint32_t m_u32Len;
+} S_TEST_READ;
+
+typedef struct
+{
+    uint8_t m_u8Dev;
+    uint64_t m_u64DoneNs;
+    uint32_t m_u32Offset;
+    uint32_t m_u32Len;
+    uint8_t *m_pu8Buf;
+    void *m_pfnCb;
+    void *m_pvUserData;
+} S_TEST_REQ;
+
+typedef struct
+{
+    uint64_t m_au64FirstNs[DEF_TEST_SCREEN_NUM];    /*!< Waiting of the first visit */
+    uint64_t m_au64RepeatNs[DEF_TEST_SCREEN_NUM];   /*!< Waiting of the repeat visits */
+    uint32_t m_au32Repeat[DEF_TEST_SCREEN_NUM];
+    uint32_t m_u32Blocks;           /*!< Block lookups of the reads */
+    S_BLK_CACHE_STATS m_sStats;
+} S_TEST_RESULT;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static const char *const s_apcScreen[DEF_TEST_SCREEN_NUM] = { "home", "gauge", "settings", "media" };
+static const char *const s_apcRun[evTestCNT] = { "direct", "cache", "cache+hints" };
+
+/* Order the screens are visited in by the recorded session. */
+static const uint8_t s_au8Visit[] = { 0, 1, 0, 2, 0, 1, 3, 0, 2, 1, 0, 3, 0, 1, 2, 0 };
+
+static S_TEST_READ s_aasRead[DEF_TEST_SCREEN_NUM][DEF_TEST_READ_MAX];
+static uint32_t s_au32ReadNum[DEF_TEST_SCREEN_NUM];
+
+static S_TEST_REQ s_asReq[DEF_TEST_REQ_MAX];
+static int s_i32ReqNum = 0;
+static uint64_t s_u64NowNs = 0;
+static uint64_t s_au64BusyNs[evBlkDevCNT];
+static int s_i32Waiting = 0;        // Reader blocks in blk_cache, polling moves the clock
+
+static uint8_t s_au8Dst[64 * 1024];
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to get the byte a device holds at an offset
+static uint8_t test_dev_byte(uint32_t u32Dev, uint32_t u32Offset)
+{
+    return (uint8_t)((u32Offset * 7) ^ (u32Offset >> 9) ^ (u32Dev * 0x5A));
+}
+
+// Function to get the time a device takes for one request
+static uint64_t test_dev_ns(uint32_t u32Dev, uint32_t u32Len)
+{
+    if (u32Dev == evBlkDevSpim)
+        return DEF_TEST_SPIM_LAT_NS + u32Len * DEF_TEST_SPIM_BYTE_NS;
+
+    /* The card moves whole sectors. */
+    return DEF_TEST_SD_LAT_NS + NVT_ALIGN(u32Len, SDH_BLOCK_SIZE) * DEF_TEST_SD_BYTE_NS;
+}
+
+// Function to queue a request behind the ones already on its device, returns request id or -1
+static int test_dev_queue(uint32_t u32Dev, uint32_t u32Offset, void *pvBuf, uint32_t u32Len, void *pfnCb, void *pvUserData)
+{
+    S_TEST_REQ *psReq;
+    int i, i32Num = 0;
+
+    for (i = 0; i < s_i32ReqNum; i++)
+        i32Num += (s_asReq[i].m_u8Dev == u32Dev);
+
+    if ((i32Num >= CONFIG_SPIM_ASYNC_QUEUE_NUM) || (s_i32ReqNum >= DEF_TEST_REQ_MAX))
+        return -1;
+
+    if (s_au64BusyNs[u32Dev] < s_u64NowNs)
+        s_au64BusyNs[u32Dev] = s_u64NowNs;
+
+    s_au64BusyNs[u32Dev] += test_dev_ns(u32Dev, u32Len);
+
+    psReq = &s_asReq[s_i32ReqNum++];
+    psReq->m_u8Dev = (uint8_t)u32Dev;
+    psReq->m_u64DoneNs = s_au64BusyNs[u32Dev];
+    psReq->m_u32Offset = u32Offset;
+    psReq->m_u32Len = u32Len;
+    psReq->m_pu8Buf = (uint8_t *)pvBuf;
+    psReq->m_pfnCb = pfnCb;
+    psReq->m_pvUserData = pvUserData;
+
+    return s_i32ReqNum - 1;
+}
+
+// Function to finish the requests of a device done by now, returns the number finished
+static int test_dev_poll(uint32_t u32Dev)
+{
+    int i, i32Done = 0;
+
+    /* A blocked reader spins until the next request ends. */
+    if (s_i32Waiting && s_i32ReqNum)
+    {
+        uint64_t u64Next = ~0ULL;
+
+        for (i = 0; i < s_i32ReqNum; i++)
+            u64Next = (s_asReq[i].m_u64DoneNs < u64Next) ? s_asReq[i].m_u64DoneNs : u64Next;
+
+        if (u64Next > s_u64NowNs)
+            s_u64NowNs = u64Next;
+    }
+
+    for (i = 0; i < s_i32ReqNum;)
+    {
+        S_TEST_REQ sReq = s_asReq[i];
+        uint32_t j;
+
+        if ((sReq.m_u8Dev != u32Dev) || (sReq.m_u64DoneNs > s_u64NowNs))
+        {
+            i++;
+            continue;
+        }
+
+        s_asReq[i] = s_asReq[--s_i32ReqNum];
+
+        for (j = 0; j < sReq.m_u32Len; j++)
+            sReq.m_pu8Buf[j] = test_dev_byte(u32Dev, sReq.m_u32Offset + j);
+
+        if (u32Dev == evBlkDevSpim)
+            ((SPIM_ASYNC_CB)sReq.m_pfnCb)(sReq.m_pvUserData, sReq.m_pu8Buf, sReq.m_u32Offset, sReq.m_u32Len, 0);
+        else
+            ((SDH_ASYNC_CB)sReq.m_pfnCb)(sReq.m_pvUserData, 0);
+
+        i32Done++;
+    }
+
+    return i32Done;
+}
+
+int spim_async_read(uint32_t u32Addr, void *pvBuf, uint32_t u32Len, uint32_t u32ChunkSize, SPIM_ASYNC_CB pfnCb, void *pvUserData)
+{
+    (void)u32ChunkSize;
+
+    return test_dev_queue(evBlkDevSpim, u32Addr, pvBuf, u32Len, (void *)pfnCb, pvUserData);
+}
+
+int spim_async_poll(void)
+{
+    return test_dev_poll(evBlkDevSpim);
+}
+
+int sdh_async_read(uint32_t u32StartSec, void *pvBuf, uint32_t u32SecCount, SDH_ASYNC_CB pfnCb, void *pvUserData)
+{
+    return test_dev_queue(evBlkDevSd, u32StartSec * SDH_BLOCK_SIZE, pvBuf, u32SecCount * SDH_BLOCK_SIZE, (void *)pfnCb, pvUserData);
+}
+
+int sdh_async_poll(void)
+{
+    return test_dev_poll(evBlkDevSd);
+}
+
+// Function to add the reads of an asset in the chunks an asset loader uses
+static void test_asset(uint32_t u32Screen, uint32_t u32Dev, uint32_t u32Offset, uint32_t u32Len, uint32_t u32Chunk)
+{
+    while (u32Len && (s_au32ReadNum[u32Screen] < DEF_TEST_READ_MAX))
+    {
+        S_TEST_READ *psRead = &s_aasRead[u32Screen][s_au32ReadNum[u32Screen]++];
+
+        psRead->m_u8Dev = (uint8_t)u32Dev;
+        psRead->m_u32Offset = u32Offset;
+        psRead->m_u32Len = (u32Len < u32Chunk) ? u32Len : u32Chunk;
+
+        u32Offset += psRead->m_u32Len;
+        u32Len -= psRead->m_u32Len;
+    }
+}
+
+// Function to add the glyph reads of a screen's text, the same glyphs on every visit
+static void test_glyphs(uint32_t u32Screen, uint32_t u32Num, uint32_t u32Seed)
+{
+    while (u32Num--)
+    {
+        u32Seed = u32Seed * 1103515245UL + 12345UL;
+        /* 96-byte glyphs of a 48 KB font, most text uses the first third of it. */
+        test_asset(u32Screen, evBlkDevSpim, 0x40000 + ((u32Seed >> 16) % ((u32Seed & 3) ? 170 : 512)) * 96, 96, 96);
+    }
+}
+
+// Function to build the asset reads of every screen
+static void test_trace_build(void)
+{
+    /* home: background, six icons and a status line */
+    test_asset(0, evBlkDevSd, 0x200000, 24 * 1024, 2048);
+    test_asset(0, evBlkDevSd, 0x100000, 6 * 4608, 4608);
+    test_glyphs(0, 30, 1);
+
+    /* gauge: dial background, needle sprites in flash and the readouts */
+    test_asset(1, evBlkDevSd, 0x300000, 32 * 1024, 2048);
+    test_asset(1, evBlkDevSpim, 0x80000, 12 * 1024, 1024);
+    test_glyphs(1, 20, 2);
+
+    /* settings: the first icon of home, five row icons and a lot of text */
+    test_asset(2, evBlkDevSd, 0x100000, 4608, 4608);
+    test_asset(2, evBlkDevSd, 0x108000, 5 * 4608, 4608);
+    test_glyphs(2, 60, 3);
+
+    /* media: album art, a home icon, the transport icons and titles */
+    test_asset(3, evBlkDevSd, 0x400000, 24 * 1024, 4096);
+    test_asset(3, evBlkDevSd, 0x101200, 4608, 4608);
+    test_asset(3, evBlkDevSd, 0x110000, 3 * 4608, 4608);
+    test_glyphs(3, 20, 4);
+}
+
+// Function to let the UI show a screen for the dwell time, the main loop polls the cache
+static void test_dwell(E_TEST_RUN evRun)
+{
+    uint64_t u64End = s_u64NowNs + DEF_TEST_DWELL_NS;
+
+    while (s_u64NowNs < u64End)
+    {
+        s_u64NowNs += DEF_TEST_STEP_NS;
+
+        if (evRun != evTestDirect)
+            blk_cache_poll();
+    }
+}
+
+// Function to replay the session, returns the total waiting time
+static uint64_t test_run(E_TEST_RUN evRun, S_TEST_RESULT *psResult)
+{
+    uint8_t au8Seen[DEF_TEST_SCREEN_NUM] = { 0 };
+    uint64_t u64Total = 0;
+    uint32_t u32Bad = 0;
+    uint32_t i, j, k;
+
+    memset(psResult, 0, sizeof(*psResult));
+    memset(s_au64BusyNs, 0, sizeof(s_au64BusyNs));
+    s_u64NowNs = 0;
+
+    host_comp_init();
+
+    for (i = 0; i < sizeof(s_au8Visit); i++)
+    {
+        uint32_t u32Screen = s_au8Visit[i];
+        uint64_t u64Wait = 0;
+
+        for (j = 0; j < s_au32ReadNum[u32Screen]; j++)
+        {
+            const S_TEST_READ *psRead = &s_aasRead[u32Screen][j];
+            uint64_t u64Start = s_u64NowNs;
+
+            if (evRun == evTestDirect)
+            {
+                for (k = 0; k < psRead->m_u32Len; k++)
+                    s_au8Dst[k] = test_dev_byte(psRead->m_u8Dev, psRead->m_u32Offset + k);
+
+                s_u64NowNs += test_dev_ns(psRead->m_u8Dev, psRead->m_u32Len);
+            }
+            else
+            {
+                memset(s_au8Dst, 0, psRead->m_u32Len);
+
+                s_i32Waiting = 1;
+                HOST_CHECK(blk_cache_read((E_BLK_DEV)psRead->m_u8Dev, psRead->m_u32Offset, s_au8Dst, psRead->m_u32Len) == 0,
+                           "%s: read of %u bytes at %X failed", s_apcRun[evRun], psRead->m_u32Len, psRead->m_u32Offset);
+                s_i32Waiting = 0;
+
+                for (k = 0; k < psRead->m_u32Len; k++)
+                    u32Bad += (s_au8Dst[k] != test_dev_byte(psRead->m_u8Dev, psRead->m_u32Offset + k));
+            }
+
+            psResult->m_u32Blocks += (psRead->m_u32Offset + psRead->m_u32Len - 1) / CONFIG_BLK_CACHE_BLOCK_SIZE -
+                                     psRead->m_u32Offset / CONFIG_BLK_CACHE_BLOCK_SIZE + 1;
+            u64Wait += s_u64NowNs - u64Start;
+        }
+
+        if (au8Seen[u32Screen]++)
+        {
+            psResult->m_au64RepeatNs[u32Screen] += u64Wait;
+            psResult->m_au32Repeat[u32Screen]++;
+        }
+        else
+        {
+            psResult->m_au64FirstNs[u32Screen] = u64Wait;
+        }
+
+        u64Total += u64Wait;
+
+        /* The UI hints the assets of the screen it expects next. */
+        if ((evRun == evTestHints) && ((i + 1) < sizeof(s_au8Visit)))
+        {
+            uint32_t u32Next = s_au8Visit[i + 1];
+
+            for (j = 0; j < s_au32ReadNum[u32Next]; j++)
+                blk_cache_prefetch((E_BLK_DEV)s_aasRead[u32Next][j].m_u8Dev, s_aasRead[u32Next][j].m_u32Offset, s_aasRead[u32Next][j].m_u32Len);
+        }
+
+        test_dwell(evRun);
+    }
+
+    blk_cache_get_stats(&psResult->m_sStats);
+
+    s_i32Waiting = 1;
+    host_comp_fini();
+    s_i32Waiting = 0;
+
+    HOST_CHECK(u32Bad == 0, "%s: %u bytes differ from the device", s_apcRun[evRun], u32Bad);
+    HOST_CHECK(s_i32ReqNum == 0, "%s: %d loads left running", s_apcRun[evRun], s_i32ReqNum);
+
+    return u64Total;
+}
+
+// Function to sum the waiting of all repeat visits
+static uint64_t test_repeat_ns(const S_TEST_RESULT *psResult)
+{
+    uint64_t u64Sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < DEF_TEST_SCREEN_NUM; i++)
+        u64Sum += psResult->m_au64RepeatNs[i];
+
+    return u64Sum;
+}
+
+int main(void)
+{
+    S_TEST_RESULT asResult[evTestCNT];
+    uint64_t au64Total[evTestCNT];
+    uint32_t i, j;
+
+    test_trace_build();
+
+    for (i = 0; i < evTestCNT; i++)
+        au64Total[i] = test_run((E_TEST_RUN)i, &asResult[i]);
+
+    printf("  %u visits of %u screens, cache of %u blocks of %u bytes, waits in ms of first/repeat visits\n",
+           (unsigned)sizeof(s_au8Visit), DEF_TEST_SCREEN_NUM,
+           (unsigned)(CONFIG_BLK_CACHE_POOL_SIZE / CONFIG_BLK_CACHE_BLOCK_SIZE), CONFIG_BLK_CACHE_BLOCK_SIZE);
+    printf("  %-10s", "screen");
+
+    for (i = 0; i < evTestCNT; i++)
+        printf(" %15s", s_apcRun[i]);
+
+    printf("\n");
+
+    for (j = 0; j < DEF_TEST_SCREEN_NUM; j++)
+    {
+        printf("  %-10s", s_apcScreen[j]);
+
+        for (i = 0; i < evTestCNT; i++)
+            printf("    %5.2f/%5.2f", asResult[i].m_au64FirstNs[j] / 1e6, asResult[i].m_au64RepeatNs[j] / 1e6 / asResult[i].m_au32Repeat[j]);
+
+        printf("\n");
+    }
+
+    printf("  %-10s", "total");
+
+    for (i = 0; i < evTestCNT; i++)
+        printf(" %15.2f", au64Total[i] / 1e6);
+
+    printf("\n");
+
+    for (i = evTestCache; i < evTestCNT; i++)
+    {
+        S_TEST_RESULT *psR = &asResult[i];
+        S_BLK_CACHE_STATS *psS = &psR->m_sStats;
+
+        printf("  %-12s hits %u, misses %u, prefetch hits %u of %u, evictions %u\n", s_apcRun[i],
+               psS->m_u32Hits, psS->m_u32Misses, psS->m_u32PrefetchHits, psS->m_u32Prefetches, psS->m_u32Evictions);
+
+        HOST_CHECK(psS->m_u32Hits + psS->m_u32Misses == psR->m_u32Blocks, "%s: %u lookups for %u blocks read",
+                   s_apcRun[i], psS->m_u32Hits + psS->m_u32Misses, psR->m_u32Blocks);
+        HOST_CHECK(psS->m_u32PrefetchHits <= psS->m_u32Prefetches, "%s: more prefetch hits than prefetches", s_apcRun[i]);
+        HOST_CHECK(psS->m_u32Errors == 0, "%s: %u load errors", s_apcRun[i], psS->m_u32Errors);
+
+        /* Switching back to screens seen before must be faster than reading their assets again. */
+        HOST_CHECK(test_repeat_ns(psR) < test_repeat_ns(&asResult[evTestDirect]), "%s: repeat visits not faster than direct reads", s_apcRun[i]);
+    }
+
+    HOST_CHECK(au64Total[evTestCache] < au64Total[evTestDirect], "cache waits longer than direct reads");
+    HOST_CHECK(au64Total[evTestHints] < au64Total[evTestCache], "hints do not shorten the waits");
+
+    return host_result("test_blk_cache");
+}
@@ -0,0 +1,400 @@
+/**************************************************************************//**
+ * @file     test_disp_vec.c
+ * @brief    Host test of disp_vec against a supersampling reference.
+ *
+ *           Every primitive is drawn over random pixels and compared with a
+ *           reference that samples the exact shape, true arcs and not their
+ *           flattened outline, 16x16 times per pixel and blends it with the
+ *           same RGB565 arithmetic. Straight outlines must agree within the
+ *           sampling error, curved ones within the flattening tolerance on
+ *           top of it. Pixels outside the primitive or its clip rectangle
+ *           must stay as they were, with or without disp_fill taking the
+ *           solid areas.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "disp_vec.h"
+#include "disp_idle.h"
+#include "disp_mem.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_TEST_W          CONFIG_TIMING_HACT
+#define DEF_TEST_H          CONFIG_TIMING_VACT
+#define DEF_TEST_SAMPLES    16      /*!< Reference samples per pixel side */
+#define DEF_TEST_PI         3.14159265358979
+
+/* Largest difference to the reference in G6 steps, R5/B5 ones count double. The sampling error
+   is within 1/32 of a pixel's coverage; flattened arcs may sit CONFIG_DISP_VEC_FLATTEN_TOL inside. */
+#define DEF_TEST_DIFF_STRAIGHT  3
+#define DEF_TEST_DIFF_CURVED    (DEF_TEST_DIFF_STRAIGHT + (63 * CONFIG_DISP_VEC_FLATTEN_TOL + DISP_VEC_SUBPX - 1) / DISP_VEC_SUBPX)
+
+typedef enum
+{
+    evTestLine,
+    evTestArc,
+    evTestRoundRect,
+    evTestPolygon,
+} E_TEST_PRIM;
+
+typedef struct
+{
+    const char *m_pcName;
+    E_TEST_PRIM m_evPrim;
+    int32_t m_ai32Arg[7];               /*!< Arguments of the disp_vec call in its order, coordinates in 1/16 pixel */
+    const S_DISP_VEC_POINT *m_psPoints;
+    uint32_t m_u32Num;
+    uint16_t m_u16Color;
+    uint8_t m_u8Alpha;
+} S_TEST_PRIM;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static const S_DISP_VEC_POINT s_asStar[] =
+{
+    /* Five-pointed star drawn in one stroke, its pentagon winds twice and is filled. */
+    { DISP_VEC_PX(240), DISP_VEC_PX(40) }, { DISP_VEC_PX(299), DISP_VEC_PX(221) },
+    { DISP_VEC_PX(145), DISP_VEC_PX(109) }, { DISP_VEC_PX(335), DISP_VEC_PX(109) },
+    { DISP_VEC_PX(181), DISP_VEC_PX(221) },
+};
+
+static const S_DISP_VEC_POINT s_asSliver[] =
+{
+    /* Off the top right corner, with sub-pixel vertices. */
+    { DISP_VEC_PX(430) + 5, DISP_VEC_PX(-30) }, { DISP_VEC_PX(530), DISP_VEC_PX(60) + 11 },
+    { DISP_VEC_PX(400) + 3, DISP_VEC_PX(90) + 7 },
+};
+
+static const S_TEST_PRIM s_asPrim[] =
+{
+    { "line",          evTestLine,      { DISP_VEC_PX(20) + 3, DISP_VEC_PX(30) + 9, DISP_VEC_PX(410) + 1, DISP_VEC_PX(250) + 6, DISP_VEC_PX(5) }, NULL, 0, 0xFFFF, 255 },
+    { "hairline",      evTestLine,      { DISP_VEC_PX(10), DISP_VEC_PX(100) + 4, DISP_VEC_PX(470), DISP_VEC_PX(107) + 12, DISP_VEC_PX(1) }, NULL, 0, 0x07E0, 255 },
+    { "line off left", evTestLine,      { DISP_VEC_PX(-50), DISP_VEC_PX(10), DISP_VEC_PX(600), DISP_VEC_PX(260), DISP_VEC_PX(7) }, NULL, 0, 0xF800, 160 },
+    { "arc",           evTestArc,       { DISP_VEC_PX(240) + 8, DISP_VEC_PX(136), DISP_VEC_PX(100), DISP_VEC_PX(20), 1350, 4050 }, NULL, 0, 0xFD20, 255 },
+    { "arc backwards", evTestArc,       { DISP_VEC_PX(200), DISP_VEC_PX(150) + 5, DISP_VEC_PX(60) + 3, DISP_VEC_PX(9), 900, -450 }, NULL, 0, 0x001F, 128 },
+    { "pie",           evTestArc,       { DISP_VEC_PX(300), DISP_VEC_PX(120), DISP_VEC_PX(40), DISP_VEC_PX(80), -300, 2000 }, NULL, 0, 0xFFE0, 255 },
+    { "round rect",    evTestRoundRect, { DISP_VEC_PX(4), DISP_VEC_PX(4), DISP_VEC_PX(472), DISP_VEC_PX(264), DISP_VEC_PX(12) }, NULL, 0, 0x2104, 255 },
+    { "rect",          evTestRoundRect, { DISP_VEC_PX(33) + 7, DISP_VEC_PX(41) + 2, DISP_VEC_PX(101) + 5, DISP_VEC_PX(57) + 9, 0 }, NULL, 0, 0x7BEF, 90 },
+    { "circle",        evTestRoundRect, { DISP_VEC_PX(380), DISP_VEC_PX(160), DISP_VEC_PX(90), DISP_VEC_PX(90), DISP_VEC_PX(45) }, NULL, 0, 0xC618, 255 },
+    { "star",          evTestPolygon,   { 0 }, s_asStar, sizeof(s_asStar) / sizeof(s_asStar[0]), 0xF81F, 200 },
+    { "sliver",        evTestPolygon,   { 0 }, s_asSliver, sizeof(s_asSliver) / sizeof(s_asSliver[0]), 0x07FF, 255 },
+};
+
+static uint16_t s_au16Back[DEF_TEST_W * DEF_TEST_H];
+static uint16_t s_au16Out[DEF_TEST_W * DEF_TEST_H];
+static uint16_t s_au16Ref[DEF_TEST_W * DEF_TEST_H];
+static uint16_t s_au16Clip[DEF_TEST_W * DEF_TEST_H];
+
+static uint32_t s_u32FillPixels = 0;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+void disp_get_timing(S_DISP_TIMING *psTiming)
+{
+    memset(psTiming, 0, sizeof(S_DISP_TIMING));
+    psTiming->m_u32HACT = CONFIG_TIMING_HACT;
+    psTiming->m_u32VACT = CONFIG_TIMING_VACT;
+}
+
+int disp_fill(void *pvBuf, const S_DISP_RECT *psRect, uint16_t u16Color)
+{
+    uint16_t *pu16Buf = (uint16_t *)pvBuf;
+    uint32_t x, y;
+
+    for (y = psRect->m_u32Y; y < (psRect->m_u32Y + psRect->m_u32H); y++)
+    {
+        for (x = psRect->m_u32X; x < (psRect->m_u32X + psRect->m_u32W); x++)
+            pu16Buf[y * CONFIG_TIMING_HACT + x] = u16Color;
+    }
+
+    s_u32FillPixels += psRect->m_u32W * psRect->m_u32H;
+
+    return 0;
+}
+
+void disp_fill_wait(void)
+{
+}
+
+void disp_mem_acquire(const void *pvAddr)
+{
+    (void)pvAddr;
+}
+
+void disp_idle_get_stats(S_DISP_IDLE_STATS *psStats)
+{
+    memset(psStats, 0, sizeof(S_DISP_IDLE_STATS));
+}
+
+// Function to draw a primitive through disp_vec
+static int test_draw(const S_DISP_VEC_TARGET *psTgt, const S_TEST_PRIM *psPrim)
+{
+    const int32_t *a = psPrim->m_ai32Arg;
+
+    switch (psPrim->m_evPrim)
+    {
+    case evTestLine:
+        return disp_vec_line(psTgt, a[0], a[1], a[2], a[3], a[4], psPrim->m_u16Color, psPrim->m_u8Alpha);
+
+    case evTestArc:
+        return disp_vec_arc(psTgt, a[0], a[1], a[2], a[3], a[4], a[5], psPrim->m_u16Color, psPrim->m_u8Alpha);
+
+    case evTestRoundRect:
+        return disp_vec_round_rect(psTgt, a[0], a[1], a[2], a[3], a[4], psPrim->m_u16Color, psPrim->m_u8Alpha);
+
+    default:
+        return disp_vec_polygon(psTgt, psPrim->m_psPoints, psPrim->m_u32Num, psPrim->m_u16Color, psPrim->m_u8Alpha);
+    }
+}
+
+// Function to get the winding of the exact shape of a primitive around a point in pixels
+static int32_t test_winding(const S_TEST_PRIM *psPrim, double x, double y)
+{
+    const int32_t *a = psPrim->m_ai32Arg;
+    double s = DISP_VEC_SUBPX;
+
+    if (psPrim->m_evPrim == evTestLine)
+    {
+        double dx = (a[2] - a[0]) / s, dy = (a[3] - a[1]) / s;
+        double l = sqrt(dx * dx + dy * dy);
+        double t = ((x - a[0] / s) * dx + (y - a[1] / s) * dy) / l;
+        double n = ((x - a[0] / s) * dy - (y - a[1] / s) * dx) / l;
+
+        return (t >= 0.0) && (t <= l) && (fabs(n) <= a[4] / (2.0 * s));
+    }
+
+    if (psPrim->m_evPrim == evTestArc)
+    {
+        double ro = (a[2] + a[3] / 2) / s, ri = (a[2] - a[3] / 2) / s;
+        double dx = x - a[0] / s, dy = y - a[1] / s;
+        double r = sqrt(dx * dx + dy * dy);
+        double a0 = ((a[4] < a[5]) ? a[4] : a[5]) * DEF_TEST_PI / 1800.0;
+        double w = fabs((double)(a[5] - a[4])) * DEF_TEST_PI / 1800.0;
+        double d = fmod(atan2(dy, dx) - a0, 2.0 * DEF_TEST_PI);
+
+        d = (d < 0.0) ? (d + 2.0 * DEF_TEST_PI) : d;
+
+        return (r <= ro) && (r >= ri) && (d <= w);
+    }
+
+    if (psPrim->m_evPrim == evTestRoundRect)
+    {
+        double x0 = a[0] / s, y0 = a[1] / s, x1 = (a[0] + a[2]) / s, y1 = (a[1] + a[3]) / s, r = a[4] / s;
+        double cx = (x < (x0 + r)) ? (x0 + r) : ((x > (x1 - r)) ? (x1 - r) : x);
+        double cy = (y < (y0 + r)) ? (y0 + r) : ((y > (y1 - r)) ? (y1 - r) : y);
+
+        if ((x < x0) || (x > x1) || (y < y0) || (y > y1))
+            return 0;
+
+        return ((x - cx) * (x - cx) + (y - cy) * (y - cy)) <= (r * r);
+    }
+    else
+    {
+        int32_t i32Wind = 0;
+        uint32_t i;
+
+        /* Non-zero rule, the edges crossing the ray to the right add their direction. */
+        for (i = 0; i < psPrim->m_u32Num; i++)
+        {
+            const S_DISP_VEC_POINT *psA = &psPrim->m_psPoints[i];
+            const S_DISP_VEC_POINT *psB = &psPrim->m_psPoints[(i + 1) % psPrim->m_u32Num];
+            double ax = psA->m_i32X / s, ay = psA->m_i32Y / s, bx = psB->m_i32X / s, by = psB->m_i32Y / s;
+
+            if ((ay <= y) != (by <= y))
+            {
+                if ((ax + (y - ay) * (bx - ax) / (by - ay)) > x)
+                    i32Wind += (by > ay) ? 1 : -1;
+            }
+        }
+
+        return i32Wind;
+    }
+}
+
+// Function to blend a color into a pixel by a weight in 0~256, the RGB565 arithmetic of the target
+static uint16_t test_blend(uint32_t u32Dst, uint32_t u32Color, int32_t i32A)
+{
+    int32_t r = (int32_t)(u32Dst >> 11);
+    int32_t g = (int32_t)((u32Dst >> 5) & 0x3F);
+    int32_t b = (int32_t)(u32Dst & 0x1F);
+
+    r += (((int32_t)(u32Color >> 11) - r) * i32A) >> 8;
+    g += (((int32_t)((u32Color >> 5) & 0x3F) - g) * i32A) >> 8;
+    b += (((int32_t)(u32Color & 0x1F) - b) * i32A) >> 8;
+
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Function to draw a primitive by sampling its exact shape, within a clip rectangle
+static void test_reference(uint16_t *pu16Buf, const S_TEST_PRIM *psPrim, const S_DISP_RECT *psClip)
+{
+    uint32_t u32Alpha = (uint32_t)psPrim->m_u8Alpha + (psPrim->m_u8Alpha >> 7);
+    uint32_t x, y, i, j;
+
+    for (y = psClip->m_u32Y; y < (psClip->m_u32Y + psClip->m_u32H); y++)
+    {
+        for (x = psClip->m_u32X; x < (psClip->m_u32X + psClip->m_u32W); x++)
+        {
+            int32_t i32Wind = 0;
+            uint32_t u32Cov;
+
+            for (j = 0; j < DEF_TEST_SAMPLES; j++)
+            {
+                for (i = 0; i < DEF_TEST_SAMPLES; i++)
+                    i32Wind += test_winding(psPrim, x + (i + 0.5) / DEF_TEST_SAMPLES, y + (j + 0.5) / DEF_TEST_SAMPLES);
+            }
+
+            if (!i32Wind)
+                continue;
+
+            /* Winding-weighted like the rasterizer, which only differs from the non-zero coverage where
+               an outline crossing itself winds twice next to the outside, as at the star's inner corners. */
+            u32Cov = ((uint32_t)abs(i32Wind) * 256 + (DEF_TEST_SAMPLES * DEF_TEST_SAMPLES) / 2) / (DEF_TEST_SAMPLES * DEF_TEST_SAMPLES);
+            u32Cov = (u32Cov > 256) ? 256 : u32Cov;
+            pu16Buf[y * DEF_TEST_W + x] = test_blend(pu16Buf[y * DEF_TEST_W + x], psPrim->m_u16Color, (int32_t)((u32Cov * u32Alpha) >> 8));
+        }
+    }
+}
+
+// Function to get the difference of two pixels in G6 steps, R5/B5 steps count double
+static uint32_t test_diff(uint16_t u16A, uint16_t u16B)
+{
+    uint32_t u32R = (uint32_t)abs((int32_t)(u16A >> 11) - (int32_t)(u16B >> 11)) * 2;
+    uint32_t u32G = (uint32_t)abs((int32_t)((u16A >> 5) & 0x3F) - (int32_t)((u16B >> 5) & 0x3F));
+    uint32_t u32B = (uint32_t)abs((int32_t)(u16A & 0x1F) - (int32_t)(u16B & 0x1F)) * 2;
+    uint32_t u32Max = (u32R > u32G) ? u32R : u32G;
+
+    return (u32B > u32Max) ? u32B : u32Max;
+}
+
+// Function to fill the background with random pixels
+static void test_background(uint32_t u32Seed)
+{
+    uint32_t i;
+
+    for (i = 0; i < (DEF_TEST_W * DEF_TEST_H); i++)
+    {
+        u32Seed = u32Seed * 1664525UL + 1013904223UL;
+        s_au16Back[i] = (uint16_t)(u32Seed >> 16);
+    }
+}
+
+// Function to check one primitive against the reference, drawn with and without disp_fill
+static void test_prim(const S_TEST_PRIM *psPrim, int i32Dma)
+{
+    S_DISP_VEC_TARGET sTgt = { s_au16Out, DEF_TEST_W, DEF_TEST_W, DEF_TEST_H, NULL, i32Dma };
+    S_DISP_RECT sAll = { 0, 0, DEF_TEST_W, DEF_TEST_H };
+    uint32_t u32Limit = ((psPrim->m_evPrim == evTestArc) || ((psPrim->m_evPrim == evTestRoundRect) && psPrim->m_ai32Arg[4])) ?
+                        DEF_TEST_DIFF_CURVED : DEF_TEST_DIFF_STRAIGHT;
+    uint32_t u32MaxDiff = 0, u32Over = 0, u32Drawn = 0, i;
+
+    memcpy(s_au16Out, s_au16Back, sizeof(s_au16Out));
+    memcpy(s_au16Ref, s_au16Back, sizeof(s_au16Ref));
+    s_u32FillPixels = 0;
+
+    HOST_CHECK(test_draw(&sTgt, psPrim) == 0, "%s rejected", psPrim->m_pcName);
+    test_reference(s_au16Ref, psPrim, &sAll);
+
+    for (i = 0; i < (DEF_TEST_W * DEF_TEST_H); i++)
+    {
+        uint32_t u32Diff = test_diff(s_au16Out[i], s_au16Ref[i]);
+
+        u32MaxDiff = (u32Diff > u32MaxDiff) ? u32Diff : u32MaxDiff;
+        u32Over += (u32Diff > u32Limit);
+        u32Drawn += (s_au16Ref[i] != s_au16Back[i]);
+    }
+
+    printf("  %-14s dma %d  pixels %6u  max diff %2u (limit %2u)  over %u  disp_fill %6u\n", psPrim->m_pcName, i32Dma,
+           u32Drawn, u32MaxDiff, u32Limit, u32Over, s_u32FillPixels);
+
+    HOST_CHECK(u32Drawn > 0, "%s draws nothing", psPrim->m_pcName);
+    HOST_CHECK(u32Over == 0, "%s: %u pixels differ by more than %u", psPrim->m_pcName, u32Over, u32Limit);
+    HOST_CHECK(i32Dma || !s_u32FillPixels, "%s used disp_fill without DMA", psPrim->m_pcName);
+}
+
+// Function to check that a primitive drawn into a clip rectangle matches the unclipped one within it only
+static void test_clip(const S_TEST_PRIM *psPrim, const S_DISP_RECT *psClip)
+{
+    S_DISP_VEC_TARGET sAll = { s_au16Out, DEF_TEST_W, DEF_TEST_W, DEF_TEST_H, NULL, 1 };
+    S_DISP_VEC_TARGET sClip = { s_au16Clip, DEF_TEST_W, DEF_TEST_W, DEF_TEST_H, psClip, 1 };
+    uint32_t u32Bad = 0, x, y;
+
+    memcpy(s_au16Out, s_au16Back, sizeof(s_au16Out));
+    memcpy(s_au16Clip, s_au16Back, sizeof(s_au16Clip));
+
+    HOST_CHECK(test_draw(&sAll, psPrim) == 0, "%s rejected", psPrim->m_pcName);
+    HOST_CHECK(test_draw(&sClip, psPrim) == 0, "%s clipped rejected", psPrim->m_pcName);
+
+    for (y = 0; y < DEF_TEST_H; y++)
+    {
+        for (x = 0; x < DEF_TEST_W; x++)
+        {
+            int i32In = (x >= psClip->m_u32X) && (x < (psClip->m_u32X + psClip->m_u32W)) &&
+                        (y >= psClip->m_u32Y) && (y < (psClip->m_u32Y + psClip->m_u32H));
+            uint16_t u16Expect = i32In ? s_au16Out[y * DEF_TEST_W + x] : s_au16Back[y * DEF_TEST_W + x];
+
+            u32Bad += (s_au16Clip[y * DEF_TEST_W + x] != u16Expect);
+        }
+    }
+
+    HOST_CHECK(u32Bad == 0, "%s clipped to %u,%u %ux%u: %u pixels differ", psPrim->m_pcName, psClip->m_u32X, psClip->m_u32Y,
+               psClip->m_u32W, psClip->m_u32H, u32Bad);
+}
+
+int main(void)
+{
+    static const S_DISP_RECT asClip[] =
+    {
+        { 0, 0, DEF_TEST_W, 130 },
+        { 0, 130, DEF_TEST_W, DEF_TEST_H - 130 },
+        { 137, 61, 93, 150 },
+    };
+    S_DISP_VEC_TARGET sTgt = { s_au16Out, DEF_TEST_W, DEF_TEST_W, DEF_TEST_H, NULL, 0 };
+    S_DISP_VEC_BENCH sBench;
+    uint32_t i, j;
+    int i32Dma;
+
+    test_background(1);
+
+    for (i = 0; i < (sizeof(s_asPrim) / sizeof(s_asPrim[0])); i++)
+    {
+        for (i32Dma = 0; i32Dma < 2; i32Dma++)
+            test_prim(&s_asPrim[i], i32Dma);
+
+        for (j = 0; j < (sizeof(asClip) / sizeof(asClip[0])); j++)
+            test_clip(&s_asPrim[i], &asClip[j]);
+    }
+
+    /* Out of range arguments. */
+    HOST_CHECK(disp_vec_line(&sTgt, 0, 0, DISP_VEC_PX(10), 0, 0, 0xFFFF, 255) < 0, "zero width line accepted");
+    HOST_CHECK(disp_vec_arc(&sTgt, 0, 0, 0, DISP_VEC_PX(2), 0, 900, 0xFFFF, 255) < 0, "zero radius arc accepted");
+    HOST_CHECK(disp_vec_round_rect(&sTgt, 0, 0, DISP_VEC_PX(10), DISP_VEC_PX(10), -1, 0xFFFF, 255) < 0, "negative radius accepted");
+    HOST_CHECK(disp_vec_polygon(&sTgt, s_asStar, CONFIG_DISP_VEC_POINT_NUM + 1, 0xFFFF, 255) < 0, "too many points accepted");
+
+    /* The built-in scene against the rasterizer's own reference, as the firmware runs it. */
+    for (i32Dma = 0; i32Dma < 2; i32Dma++)
+    {
+        memcpy(s_au16Out, s_au16Back, sizeof(s_au16Out));
+        memcpy(s_au16Ref, s_au16Back, sizeof(s_au16Ref));
+        sTgt.m_i32Dma = i32Dma;
+
+        HOST_CHECK(disp_vec_bench(&sTgt, s_au16Ref, &sBench) == 0, "bench rejected");
+        HOST_CHECK(sBench.m_u32Mismatches == 0, "bench dma %d: %u mismatches", i32Dma, sBench.m_u32Mismatches);
+        HOST_CHECK(!i32Dma || sBench.m_u32DmaPixels, "bench gave nothing to disp_fill");
+
+        printf("  bench dma %d: %u prims, %u cycles, reference %u cycles, max diff %u, edge %u solid %u disp_fill %u pixels\n",
+               i32Dma, sBench.m_u32Prims, sBench.m_u32Cycles, sBench.m_u32RefCycles, sBench.m_u32MaxDiff,
+               sBench.m_u32EdgePixels, sBench.m_u32SolidPixels, sBench.m_u32DmaPixels);
+    }
+
+    return host_result("test_disp_vec");
+}
@@ -0,0 +1,279 @@
+/**************************************************************************//**
+ * @file     test_jpeg.c
+ * @brief    Host comparison of jpeg_dec with the libjpeg reference decoder.
+ *
+ *           Test images are encoded by libjpeg in every supported sampling
+ *           layout, with and without restart intervals, and decoded by both.
+ *           libjpeg runs the same islow IDCT and replicating chroma, so the
+ *           RGB565 results may differ by rounding only. Malformed huffman
+ *           tables must be rejected without writing past the tables, the
+ *           target is built with AddressSanitizer for that.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <jpeglib.h>
+#include "host.h"
+#include "jpeg_dec.h"
+#include "disp_mem.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_TEST_W          101     /*!< Not a multiple of any MCU width */
+#define DEF_TEST_H           75     /*!< Not a multiple of any MCU height */
+#define DEF_TEST_STRIDE     128     /*!< Destination line length in pixels */
+#define DEF_TEST_GUARD   0xA5A5     /*!< Pixel value outside the clip */
+
+typedef struct
+{
+    const char *m_pcName;
+    int m_i32Comps;
+    int m_i32H;                     /*!< Luma horizontal sampling factor */
+    int m_i32V;                     /*!< Luma vertical sampling factor */
+} S_TEST_LAYOUT;
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static const S_TEST_LAYOUT s_asLayout[] =
+{
+    { "gray",  1, 1, 1 },
+    { "4:4:4", 3, 1, 1 },
+    { "4:2:2", 3, 2, 1 },
+    { "4:2:0", 3, 2, 2 },
+};
+
+static uint8_t s_au8Rgb[DEF_TEST_W * DEF_TEST_H * 3];
+static uint16_t s_au16Dst[DEF_TEST_STRIDE * DEF_TEST_H];
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+// Function to keep VRAM powered, there is no power manager on the host
+void disp_mem_acquire(const void *pvAddr)
+{
+    (void)pvAddr;
+}
+
+// Function to draw gradients, sharp edges and noise into the test image
+static void test_make_image(void)
+{
+    uint32_t u32Seed = 1;
+    int x, y;
+
+    for (y = 0; y < DEF_TEST_H; y++)
+    {
+        for (x = 0; x < DEF_TEST_W; x++)
+        {
+            uint8_t *pu8 = &s_au8Rgb[(y * DEF_TEST_W + x) * 3];
+
+            u32Seed = u32Seed * 1103515245UL + 12345UL;
+
+            pu8[0] = (uint8_t)(x * 255 / DEF_TEST_W);
+            pu8[1] = (uint8_t)(((x / 8 + y / 8) & 1) ? 230 : 20);
+            pu8[2] = (uint8_t)((y * 255 / DEF_TEST_H) ^ ((u32Seed >> 16) & 0x1F));
+        }
+    }
+}
+
+// Function to encode the test image, returns the malloc'ed JPEG
+static uint8_t *test_encode(const S_TEST_LAYOUT *psLayout, int i32Quality, int i32Restart, unsigned long *pu32Len)
+{
+    struct jpeg_compress_struct sCinfo;
+    struct jpeg_error_mgr sErr;
+    uint8_t au8Gray[DEF_TEST_W];
+    unsigned char *pu8Out = NULL;
+    int y, x;
+
+    sCinfo.err = jpeg_std_error(&sErr);
+    jpeg_create_compress(&sCinfo);
+    jpeg_mem_dest(&sCinfo, &pu8Out, pu32Len);
+
+    sCinfo.image_width = DEF_TEST_W;
+    sCinfo.image_height = DEF_TEST_H;
+    sCinfo.input_components = psLayout->m_i32Comps;
+    sCinfo.in_color_space = (psLayout->m_i32Comps == 3) ? JCS_RGB : JCS_GRAYSCALE;
+    jpeg_set_defaults(&sCinfo);
+    jpeg_set_quality(&sCinfo, i32Quality, TRUE);
+    sCinfo.comp_info[0].h_samp_factor = psLayout->m_i32H;
+    sCinfo.comp_info[0].v_samp_factor = psLayout->m_i32V;
+    sCinfo.restart_interval = (unsigned int)i32Restart;
+    jpeg_start_compress(&sCinfo, TRUE);
+
+    for (y = 0; y < DEF_TEST_H; y++)
+    {
+        JSAMPROW pRow = &s_au8Rgb[y * DEF_TEST_W * 3];
+
+        if (psLayout->m_i32Comps == 1)
+        {
+            for (x = 0; x < DEF_TEST_W; x++)
+                au8Gray[x] = s_au8Rgb[(y * DEF_TEST_W + x) * 3 + 1];
+
+            pRow = au8Gray;
+        }
+
+        jpeg_write_scanlines(&sCinfo, &pRow, 1);
+    }
+
+    jpeg_finish_compress(&sCinfo);
+    jpeg_destroy_compress(&sCinfo);
+
+    return pu8Out;
+}
+
+// Function to decode with libjpeg into RGB888
+static void test_reference(const uint8_t *pu8Jpeg, unsigned long u32Len, uint8_t *pu8Rgb)
+{
+    struct jpeg_decompress_struct sDinfo;
+    struct jpeg_error_mgr sErr;
+
+    sDinfo.err = jpeg_std_error(&sErr);
+    jpeg_create_decompress(&sDinfo);
+    jpeg_mem_src(&sDinfo, pu8Jpeg, u32Len);
+    jpeg_read_header(&sDinfo, TRUE);
+
+    /* Match jpeg_dec: islow IDCT and chroma replicated, not interpolated. */
+    sDinfo.out_color_space = JCS_RGB;
+    sDinfo.dct_method = JDCT_ISLOW;
+    sDinfo.do_fancy_upsampling = FALSE;
+    jpeg_start_decompress(&sDinfo);
+
+    while (sDinfo.output_scanline < sDinfo.output_height)
+    {
+        JSAMPROW pRow = &pu8Rgb[sDinfo.output_scanline * DEF_TEST_W * 3];
+
+        jpeg_read_scanlines(&sDinfo, &pRow, 1);
+    }
+
+    jpeg_finish_decompress(&sDinfo);
+    jpeg_destroy_decompress(&sDinfo);
+}
+
+// Function to decode one layout with jpeg_dec and compare it with libjpeg
+static void test_compare(const S_TEST_LAYOUT *psLayout, int i32Quality, int i32Restart, uint32_t u32ClipW, uint32_t u32ClipH)
+{
+    static uint8_t au8Ref[DEF_TEST_W * DEF_TEST_H * 3];
+    unsigned long u32Len;
+    uint8_t *pu8Jpeg = test_encode(psLayout, i32Quality, i32Restart, &u32Len);
+    uint32_t u32MaxDiff = 0, u32Guard = 0, x, y, i;
+    S_JPEG_INFO sInfo;
+
+    test_reference(pu8Jpeg, u32Len, au8Ref);
+
+    for (i = 0; i < DEF_TEST_STRIDE * DEF_TEST_H; i++)
+        s_au16Dst[i] = DEF_TEST_GUARD;
+
+    HOST_CHECK(jpeg_dec_info(pu8Jpeg, (uint32_t)u32Len, &sInfo) == 0, "%s info", psLayout->m_pcName);
+    HOST_CHECK((sInfo.m_u32Width == DEF_TEST_W) && (sInfo.m_u32Height == DEF_TEST_H) &&
+               (sInfo.m_u32Components == (uint32_t)psLayout->m_i32Comps) &&
+               (sInfo.m_u32BandHeight == (uint32_t)(8 * psLayout->m_i32V)), "%s header", psLayout->m_pcName);
+    HOST_CHECK(jpeg_dec_decode(pu8Jpeg, (uint32_t)u32Len, s_au16Dst, DEF_TEST_STRIDE, u32ClipW, u32ClipH) == 0,
+               "%s q%d rst%d decode", psLayout->m_pcName, i32Quality, i32Restart);
+
+    for (y = 0; y < DEF_TEST_H; y++)
+    {
+        for (x = 0; x < DEF_TEST_STRIDE; x++)
+        {
+            uint16_t u16Px = s_au16Dst[y * DEF_TEST_STRIDE + x];
+            const uint8_t *pu8;
+            int32_t i32R, i32G, i32B;
+
+            if ((x >= u32ClipW) || (y >= u32ClipH))
+            {
+                u32Guard += (u16Px != DEF_TEST_GUARD);
+                continue;
+            }
+
+            pu8 = &au8Ref[(y * DEF_TEST_W + x) * 3];
+            i32R = abs((int32_t)(u16Px >> 11) - (pu8[0] >> 3));
+            i32G = abs((int32_t)((u16Px >> 5) & 0x3F) - (pu8[1] >> 2));
+            i32B = abs((int32_t)(u16Px & 0x1F) - (pu8[2] >> 3));
+
+            if ((uint32_t)i32R > u32MaxDiff) u32MaxDiff = (uint32_t)i32R;
+            if ((uint32_t)i32G > u32MaxDiff) u32MaxDiff = (uint32_t)i32G;
+            if ((uint32_t)i32B > u32MaxDiff) u32MaxDiff = (uint32_t)i32B;
+        }
+    }
+
+    printf("  %-5s q%-2d rst%d clip %3ux%-3u: max diff %u\n", psLayout->m_pcName, i32Quality, i32Restart,
+           u32ClipW, u32ClipH, u32MaxDiff);
+
+    /* A rounding step of the reference can move a channel across one RGB565 code. */
+    HOST_CHECK(u32MaxDiff <= 1, "%s q%d rst%d differs from libjpeg by %u", psLayout->m_pcName, i32Quality, i32Restart, u32MaxDiff);
+    HOST_CHECK(u32Guard == 0, "%s wrote %u pixels outside the clip", psLayout->m_pcName, u32Guard);
+
+    free(pu8Jpeg);
+}
+
+// Function to check a DHT segment with the given code counts put in front of a good image's own tables
+static void test_dht(const char *pcName, const uint8_t au8Counts[16], int i32Expect)
+{
+    unsigned long u32Len;
+    uint8_t *pu8Good = test_encode(&s_asLayout[0], 75, 0, &u32Len);
+    uint8_t *pu8Jpeg = malloc(u32Len + 4 + 17 + 256);
+    uint32_t u32Num = 0, u32Pos = 0, i;
+    S_JPEG_INFO sInfo;
+
+    for (i = 0; i < 16; i++)
+        u32Num += au8Counts[i];
+
+    pu8Jpeg[u32Pos++] = 0xFF;
+    pu8Jpeg[u32Pos++] = 0xD8;
+    pu8Jpeg[u32Pos++] = 0xFF;
+    pu8Jpeg[u32Pos++] = 0xC4;
+    pu8Jpeg[u32Pos++] = (uint8_t)((2 + 17 + u32Num) >> 8);
+    pu8Jpeg[u32Pos++] = (uint8_t)(2 + 17 + u32Num);
+    pu8Jpeg[u32Pos++] = 0x00;   /* DC table 0, redefined by the image afterwards */
+
+    for (i = 0; i < 16; i++)
+        pu8Jpeg[u32Pos++] = au8Counts[i];
+
+    for (i = 0; i < u32Num; i++)
+        pu8Jpeg[u32Pos++] = (uint8_t)i;
+
+    memcpy(&pu8Jpeg[u32Pos], &pu8Good[2], u32Len - 2);
+    u32Pos += (uint32_t)u32Len - 2;
+
+    HOST_CHECK(jpeg_dec_info(pu8Jpeg, u32Pos, &sInfo) == i32Expect, "DHT with %s not %s", pcName,
+               i32Expect ? "rejected" : "accepted");
+    HOST_CHECK(jpeg_dec_decode(pu8Jpeg, u32Pos, s_au16Dst, DEF_TEST_STRIDE, DEF_TEST_W, DEF_TEST_H) == i32Expect,
+               "decode with %s", pcName);
+
+    free(pu8Jpeg);
+    free(pu8Good);
+}
+
+int main(void)
+{
+    static const uint8_t au8Overfull1[16] = { 255 };
+    static const uint8_t au8Overfull2[16] = { 0, 5 };
+    static const uint8_t au8Overfull8[16] = { 1, 1, 1, 1, 1, 1, 1, 3 };
+    static const uint8_t au8Full1[16] = { 2 };
+    static const uint8_t au8Long16[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 255 };
+    uint32_t i;
+
+    host_comp_init();
+    test_make_image();
+
+    for (i = 0; i < sizeof(s_asLayout) / sizeof(s_asLayout[0]); i++)
+    {
+        test_compare(&s_asLayout[i], 75, 0, DEF_TEST_W, DEF_TEST_H);
+        test_compare(&s_asLayout[i], 95, 3, DEF_TEST_W, DEF_TEST_H);
+        test_compare(&s_asLayout[i], 50, 1, 37, 29);
+    }
+
+    /* 255 one-bit codes would index the fast table 127 x 128 entries past its end. */
+    test_dht("255 codes of length 1", au8Overfull1, -1);
+    test_dht("5 codes of length 2", au8Overfull2, -1);
+    test_dht("overfull at length 8", au8Overfull8, -1);
+    test_dht("both codes of length 1", au8Full1, 0);
+    test_dht("255 codes of length 16", au8Long16, 0);
+
+    host_comp_fini();
+
+    return host_result("test_jpeg");
+}
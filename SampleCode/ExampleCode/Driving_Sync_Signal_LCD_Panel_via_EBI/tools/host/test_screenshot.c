@@ -0,0 +1,291 @@
+/**************************************************************************//**
+ * @file     test_screenshot.c
+ * @brief    Host check of screenshot captures through the software AES path.
+ *
+ *           screenshot.c runs on host_aes.c in place of the crypto engine.
+ *           Captures of the whole frame and of a clipped rectangle, with
+ *           128 and 256-bit keys, to a memory sink and to simulated SD
+ *           slots are decrypted by OpenSSL and compared with the frame.
+ *           Every screenshot_poll must stay within the per-call byte budget,
+ *           and a page flip or a failing sink must be flagged in the header.
+ *           Counter blocks must carry a fresh random word every capture, and
+ *           no capture may start without one.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <openssl/evp.h>
+#include "host.h"
+#include "screenshot.h"
+#include "sdh_async.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_TEST_PIXELS          (CONFIG_TIMING_HACT * CONFIG_TIMING_VACT)
+#define DEF_TEST_IMAGE_SIZE      (SDH_BLOCK_SIZE + CONFIG_VRAM_BUF_SIZE + CONFIG_SCREENSHOT_CHUNK_SIZE)
+#define DEF_TEST_SD_SECTORS      (CONFIG_SCREENSHOT_SD_SLOT_NUM * (DEF_TEST_IMAGE_SIZE / SDH_BLOCK_SIZE + 1))
+#define DEF_TEST_SD_REQ_NUM      4
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+static uint16_t s_aau16Frame[2][DEF_TEST_PIXELS] __attribute__((aligned(DCACHE_LINE_SIZE)));
+static void *s_pvVram = s_aau16Frame[0];
+
+static uint8_t s_au8Image[DEF_TEST_IMAGE_SIZE];     // Capture image written by the memory sink
+static int s_i32SinkFailAt = -1;                     // Sink call failing, -1 for none
+static int s_i32SinkCalls;
+
+static uint8_t *s_pu8Sd;                             // Sectors from CONFIG_SCREENSHOT_SD_START_SEC on
+static int s_ai32SdBusy[DEF_TEST_SD_REQ_NUM];        // Writes finish on the next sdh_async_poll
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+void *disp_get_vrambufaddr(void)
+{
+    return s_pvVram;
+}
+
+void disp_get_timing(S_DISP_TIMING *psTiming)
+{
+    static const S_DISP_TIMING sTiming = DEF_DISP_TIMING_DEFAULT;
+
+    *psTiming = sTiming;
+}
+
+void disp_mem_acquire(const void *pvAddr)
+{
+    (void)pvAddr;
+}
+
+int sdh_async_write(uint32_t u32StartSec, const void *pvBuf, uint32_t u32SecCount, SDH_ASYNC_CB pfnCb, void *pvUserData)
+{
+    uint32_t u32Sec = u32StartSec - CONFIG_SCREENSHOT_SD_START_SEC;
+    int i;
+
+    HOST_CHECK((u32StartSec >= CONFIG_SCREENSHOT_SD_START_SEC) && ((u32Sec + u32SecCount) <= DEF_TEST_SD_SECTORS),
+               "SD write of %u sectors at %u outside the slots", u32SecCount, u32StartSec);
+
+    for (i = 0; i < DEF_TEST_SD_REQ_NUM; i++)
+    {
+        if (!s_ai32SdBusy[i])
+        {
+            memcpy(&s_pu8Sd[u32Sec * SDH_BLOCK_SIZE], pvBuf, u32SecCount * SDH_BLOCK_SIZE);
+            s_ai32SdBusy[i] = 1;
+            pfnCb(pvUserData, 0);
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int sdh_async_poll(void)
+{
+    int i, i32Done = 0;
+
+    for (i = 0; i < DEF_TEST_SD_REQ_NUM; i++)
+    {
+        i32Done += s_ai32SdBusy[i];
+        s_ai32SdBusy[i] = 0;
+    }
+
+    return i32Done;
+}
+
+int sdh_async_pending(int i32Id)
+{
+    return s_ai32SdBusy[i32Id];
+}
+
+// Sink keeping the capture image in memory
+static int test_sink(void *pvUserData, uint32_t u32Offset, const void *pvData, uint32_t u32Len)
+{
+    (void)pvUserData;
+
+    HOST_CHECK((u32Offset + u32Len) <= sizeof(s_au8Image), "sink write of %u bytes at %u outside the image", u32Len, u32Offset);
+    HOST_CHECK((u32Offset % SDH_BLOCK_SIZE) == 0, "sink write at %u not on a sector", u32Offset);
+
+    if (s_i32SinkCalls++ == s_i32SinkFailAt)
+        return -1;
+
+    memcpy(&s_au8Image[u32Offset], pvData, u32Len);
+
+    return 0;
+}
+
+// Function to fill both frame buffers with distinct pixels
+static void test_frame_fill(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < DEF_TEST_PIXELS; i++)
+    {
+        s_aau16Frame[0][i] = (uint16_t)(i * 2654435761UL >> 13);
+        s_aau16Frame[1][i] = (uint16_t)~s_aau16Frame[0][i];
+    }
+}
+
+// Function to run a capture to its end, returns the number of polls
+static int test_capture(const S_DISP_RECT *psRect, int i32FlipAfter)
+{
+    int i32Polls = 0;
+
+    s_i32SinkCalls = 0;
+
+    HOST_CHECK(screenshot_capture(psRect, 0) > 0, "capture not started");
+
+    while (1)
+    {
+        uint32_t u32Before = g_u32HostAesBytes;
+        int i32Busy = screenshot_poll(1000);
+
+        /* A poll stops once it went over the byte budget, so by less than one run. */
+        HOST_CHECK((g_u32HostAesBytes - u32Before) < (CONFIG_SCREENSHOT_POLL_BYTES + CONFIG_SCREENSHOT_CHUNK_SIZE),
+                   "poll encrypted %u bytes", g_u32HostAesBytes - u32Before);
+
+        if (++i32Polls == i32FlipAfter)
+            s_pvVram = s_aau16Frame[1];
+
+        if (!i32Busy)
+            break;
+    }
+
+    s_pvVram = s_aau16Frame[0];
+
+    return i32Polls;
+}
+
+// Function to decrypt a capture image with OpenSSL and compare it with the frame, returns the header flags
+static uint32_t test_check(const char *pcName, const uint8_t *pu8Image, const uint32_t *pu32Key, uint32_t u32KeySize, const S_DISP_RECT *psWant)
+{
+    S_SCREENSHOT_HDR sHdr;
+    uint8_t au8Key[32], au8Iv[16];
+    uint8_t *pu8Plain;
+    EVP_CIPHER_CTX *psCtx = EVP_CIPHER_CTX_new();
+    const EVP_CIPHER *psCipher = (u32KeySize == AES_KEY_SIZE_256) ? EVP_aes_256_ctr() :
+                                 (u32KeySize == AES_KEY_SIZE_192) ? EVP_aes_192_ctr() : EVP_aes_128_ctr();
+    uint32_t i, u32Bad = 0;
+    int i32Len;
+
+    memcpy(&sHdr, pu8Image, sizeof(sHdr));
+
+    HOST_CHECK(sHdr.m_u32Magic == SCREENSHOT_MAGIC, "%s: magic %08X", pcName, sHdr.m_u32Magic);
+    HOST_CHECK(!memcmp(&sHdr.m_sRect, psWant, sizeof(*psWant)), "%s: rectangle %u,%u %ux%u", pcName,
+               sHdr.m_sRect.m_u32X, sHdr.m_sRect.m_u32Y, sHdr.m_sRect.m_u32W, sHdr.m_sRect.m_u32H);
+    HOST_CHECK(sHdr.m_u32Bytes == psWant->m_u32W * psWant->m_u32H * sizeof(uint16_t), "%s: %u bytes", pcName, sHdr.m_u32Bytes);
+
+    if (sHdr.m_u32Bytes > CONFIG_VRAM_BUF_SIZE)
+        return 0xFFFFFFFFUL;
+
+    /* Key and counter words go to the engine registers most significant byte first. */
+    for (i = 0; i < 32; i++)
+        au8Key[i] = (uint8_t)(pu32Key[i / 4] >> (24 - 8 * (i % 4)));
+
+    for (i = 0; i < 16; i++)
+        au8Iv[i] = (uint8_t)(sHdr.m_au32Nonce[i / 4] >> (24 - 8 * (i % 4)));
+
+    pu8Plain = malloc(sHdr.m_u32Bytes + 16);
+    EVP_EncryptInit_ex(psCtx, psCipher, NULL, au8Key, au8Iv);
+    EVP_EncryptUpdate(psCtx, pu8Plain, &i32Len, pu8Image + SDH_BLOCK_SIZE, (int)sHdr.m_u32Bytes);
+    EVP_CIPHER_CTX_free(psCtx);
+
+    for (i = 0; i < psWant->m_u32H; i++)
+    {
+        const uint16_t *pu16Line = &s_aau16Frame[0][(psWant->m_u32Y + i) * CONFIG_TIMING_HACT + psWant->m_u32X];
+
+        u32Bad += (memcmp(&pu8Plain[i * psWant->m_u32W * sizeof(uint16_t)], pu16Line, psWant->m_u32W * sizeof(uint16_t)) != 0);
+    }
+
+    free(pu8Plain);
+
+    printf("  %-24s %3ux%-3u at %3u,%-3u %6u bytes, %u us, flags %X\n", pcName, sHdr.m_sRect.m_u32W, sHdr.m_sRect.m_u32H,
+           sHdr.m_sRect.m_u32X, sHdr.m_sRect.m_u32Y, sHdr.m_u32Bytes, sHdr.m_u32LatencyUs, sHdr.m_u32Flags);
+
+    HOST_CHECK(u32Bad == 0, "%s: %u lines differ from the frame", pcName, u32Bad);
+
+    return sHdr.m_u32Flags;
+}
+
+int main(void)
+{
+    static const uint32_t au32Key128[8] = { 0x2B7E1516, 0x28AED2A6, 0xABF71588, 0x09CF4F3C };
+    static const uint32_t au32Key256[8] = { 0x603DEB10, 0x15CA71BE, 0x2B73AEF0, 0x857D7781,
+                                            0x1F352C07, 0x3B6108D7, 0x2D9810A3, 0x0914DFF4
+                                          };
+    const S_DISP_RECT sFull = { 0, 0, CONFIG_TIMING_HACT, CONFIG_TIMING_VACT };
+    const S_DISP_RECT sClip = { 13, 21, 50, 17 };
+    const S_DISP_RECT sClipWide = { 8, 21, 56, 17 };      /* Widened to whole AES blocks */
+    S_SCREENSHOT_STATS sStats;
+    uint32_t au32Nonce[4];
+    uint32_t u32Slot;
+    int i32Polls, i32Seq;
+
+    s_pu8Sd = calloc(DEF_TEST_SD_SECTORS, SDH_BLOCK_SIZE);
+
+    test_frame_fill();
+    host_comp_init();
+
+    HOST_CHECK(screenshot_capture(NULL, 0) < 0, "capture without a key started");
+
+    screenshot_set_key(au32Key128, AES_KEY_SIZE_128, 0x0B00710A);
+    screenshot_set_sink(test_sink, NULL);
+
+    i32Polls = test_capture(NULL, 0);
+    HOST_CHECK(test_check("full frame, AES-128", s_au8Image, au32Key128, AES_KEY_SIZE_128, &sFull) == 0, "full frame flagged");
+    HOST_CHECK(i32Polls >= (CONFIG_VRAM_BUF_SIZE / (CONFIG_SCREENSHOT_POLL_BYTES + CONFIG_SCREENSHOT_CHUNK_SIZE)),
+               "full frame done in %d polls", i32Polls);
+
+    test_capture(&sClip, 0);
+    HOST_CHECK(test_check("clipped, AES-128", s_au8Image, au32Key128, AES_KEY_SIZE_128, &sClipWide) == 0, "clip flagged");
+    memcpy(au32Nonce, ((S_SCREENSHOT_HDR *)s_au8Image)->m_au32Nonce, sizeof(au32Nonce));
+
+    /* Without a random word the counter block could repeat one of a previous boot. */
+    g_i32HostRngFail = 1;
+    HOST_CHECK(screenshot_capture(NULL, 0) < 0, "capture started without a random word");
+    g_i32HostRngFail = 0;
+
+    screenshot_set_key(au32Key256, AES_KEY_SIZE_256, 0x0B00710A);
+    test_capture(&sClip, 0);
+    HOST_CHECK(test_check("clipped, AES-256", s_au8Image, au32Key256, AES_KEY_SIZE_256, &sClipWide) == 0, "AES-256 flagged");
+
+    HOST_CHECK(((S_SCREENSHOT_HDR *)s_au8Image)->m_au32Nonce[1] == (au32Nonce[1] + 1), "refused capture used a sequence number");
+    HOST_CHECK(((S_SCREENSHOT_HDR *)s_au8Image)->m_au32Nonce[2] != au32Nonce[2], "random word %08X repeated", au32Nonce[2]);
+    HOST_CHECK(((S_SCREENSHOT_HDR *)s_au8Image)->m_au32Nonce[3] == 0, "counter word does not start at 0");
+
+    test_capture(NULL, 2);
+    HOST_CHECK(test_check("page flip", s_au8Image, au32Key256, AES_KEY_SIZE_256, &sFull) & SCREENSHOT_FLAG_TORN, "page flip not flagged");
+
+    s_i32SinkFailAt = 3;
+    test_capture(NULL, 0);
+    s_i32SinkFailAt = -1;
+    HOST_CHECK(((S_SCREENSHOT_HDR *)s_au8Image)->m_u32Flags & SCREENSHOT_FLAG_ERROR, "sink failure not flagged");
+
+    /* The default sink writes the slot of the sequence number on SD. */
+    screenshot_set_sink(NULL, NULL);
+    i32Seq = screenshot_capture(NULL, 0);
+
+    while (screenshot_poll(1000))
+        ;
+
+    u32Slot = (uint32_t)i32Seq % CONFIG_SCREENSHOT_SD_SLOT_NUM;
+    test_check("full frame to SD", &s_pu8Sd[u32Slot * (1UL + NVT_ALIGN(CONFIG_VRAM_BUF_SIZE, CONFIG_SCREENSHOT_CHUNK_SIZE) / SDH_BLOCK_SIZE) * SDH_BLOCK_SIZE],
+               au32Key256, AES_KEY_SIZE_256, &sFull);
+
+    screenshot_get_stats(&sStats);
+    printf("  captures %u, torn %u, errors %u, %u bytes, max latency %u us\n", sStats.m_u32Captures, sStats.m_u32Torn,
+           sStats.m_u32Errors, sStats.m_u32Bytes, sStats.m_u32MaxLatencyUs);
+
+    HOST_CHECK(sStats.m_u32Captures == 6, "%u captures counted", sStats.m_u32Captures);
+    HOST_CHECK(sStats.m_u32Torn == 1, "%u torn captures counted", sStats.m_u32Torn);
+    HOST_CHECK(sStats.m_u32Errors == 1, "%u failed captures counted", sStats.m_u32Errors);
+
+    host_comp_fini();
+    free(s_pu8Sd);
+
+    return host_result("test_screenshot");
+}
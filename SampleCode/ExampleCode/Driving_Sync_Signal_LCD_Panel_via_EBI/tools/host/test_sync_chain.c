@@ -0,0 +1,285 @@
+/**************************************************************************//**
+ * @file     test_sync_chain.c
+ * @brief    Host check of the DE-only scanout chains built by disp_sync_pdma.
+ *
+ *           disp_sync_pdma.c is built for a 1280x800 panel whose vertical
+ *           porch exceeds NU_PDMA_MAX_TXCNT units, and the chains it builds
+ *           for the default timing and for timings switched to at runtime are
+ *           walked like the PDMA would. Every line must carry HPORCH blank and
+ *           HACT active units from the right VRAM line, the porch must add up
+ *           over its split descriptors, and each frame must end on the one
+ *           descriptor raising the blank interrupt.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ * @copyright (C) 2025 Nuvoton Technology Corp. All rights reserved.
+ *****************************************************************************/
+
+#include "host.h"
+#include "pdma_lib.h"
+#include "disp.h"
+#include "disp_mem.h"
+#include "nu_os.h"
+
+/*---------------------------------------------------------------------------*/
+/* Define                                                                    */
+/*---------------------------------------------------------------------------*/
+#define DEF_TEST_CH_NUM          2
+#define DEF_TEST_MAX_DSC      8192   /*!< Longest chain walked before giving up on a missing end */
+
+#if !defined(CONFIG_LCD_PANEL_USE_DE_ONLY)
+    #error "The chain walker expects the DE-only layout."
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* Global variables                                                          */
+/*---------------------------------------------------------------------------*/
+extern uint8_t g_au8FrameBuf[];
+
+static nu_pdma_cb_handler_t s_apfnVector[DEF_TEST_CH_NUM];
+static nu_pdma_desc_t s_apsHead[DEF_TEST_CH_NUM];
+static int s_i32ChNum = 0;
+
+/*---------------------------------------------------------------------------*/
+/* Functions                                                                 */
+/*---------------------------------------------------------------------------*/
+/* PDMA driver calls used by disp_sync_pdma. Descriptors are encoded as pdma_lib.c does, the
+   channels only remember what they were started with. */
+int nu_pdma_channel_allocate(int32_t i32PeripType)
+{
+    (void)i32PeripType;
+
+    return (s_i32ChNum < DEF_TEST_CH_NUM) ? s_i32ChNum++ : -1;
+}
+
+int nu_pdma_channel_free(int i32ChannID)
+{
+    (void)i32ChannID;
+
+    return 0;
+}
+
+int nu_pdma_channel_memctrl_set(int i32ChannID, nu_pdma_memctrl_t eMemCtrl)
+{
+    (void)i32ChannID;
+    (void)eMemCtrl;
+
+    return 0;
+}
+
+int nu_pdma_vector_register(int i32ChannID, nu_pdma_cb_handler_t pfnHandler, void *pvUserData)
+{
+    (void)pvUserData;
+    s_apfnVector[i32ChannID] = pfnHandler;
+
+    return 0;
+}
+
+int nu_pdma_sg_transfer(int i32ChannID, nu_pdma_desc_t head, uint32_t u32IdleTimeout_us)
+{
+    (void)u32IdleTimeout_us;
+    s_apsHead[i32ChannID] = head;
+
+    return 0;
+}
+
+int nu_pdma_transfer(int i32ChannID, uint32_t u32DataWidth, uint32_t u32AddrSrc, uint32_t u32AddrDst, uint32_t i32TransferCnt, uint32_t u32IdleTimeout_us)
+{
+    (void)i32ChannID;
+    (void)u32DataWidth;
+    (void)u32AddrSrc;
+    (void)u32AddrDst;
+    (void)i32TransferCnt;
+    (void)u32IdleTimeout_us;
+
+    return 0;
+}
+
+int nu_pdma_m2m_desc_setup(nu_pdma_desc_t dma_desc, uint32_t u32DataWidth, uint32_t u32AddrSrc,
+                           uint32_t u32AddrDst, int32_t i32TransferCnt, nu_pdma_memctrl_t evMemCtrl, nu_pdma_desc_t next, uint32_t u32BeSilent)
+{
+    static const uint32_t au32MemCtl[] = { PDMA_SAR_FIX | PDMA_DAR_FIX, PDMA_SAR_FIX | PDMA_DAR_INC,
+                                           PDMA_SAR_INC | PDMA_DAR_FIX, PDMA_SAR_INC | PDMA_DAR_INC
+                                         };
+
+    HOST_CHECK((i32TransferCnt > 0) && (i32TransferCnt <= NU_PDMA_MAX_TXCNT), "descriptor of %d units", (int)i32TransferCnt);
+
+    if ((i32TransferCnt <= 0) || (i32TransferCnt > NU_PDMA_MAX_TXCNT))
+        return -1;
+
+    dma_desc->CTL = ((uint32_t)(i32TransferCnt - 1) << PDMA_DSCT_CTL_TXCNT_Pos) |
+                    ((u32DataWidth == 8) ? PDMA_WIDTH_8 : (u32DataWidth == 16) ? PDMA_WIDTH_16 : PDMA_WIDTH_32) |
+                    au32MemCtl[evMemCtrl] | PDMA_REQ_BURST | PDMA_BURST_32 |
+                    (next ? PDMA_OP_SCATTER : PDMA_OP_BASIC) |
+                    (u32BeSilent ? PDMA_DSCT_CTL_TBINTDIS_Msk : 0);
+    dma_desc->SA = u32AddrSrc;
+    dma_desc->DA = u32AddrDst;
+    dma_desc->NEXT = (uint32_t)(uintptr_t)next;
+
+    return 0;
+}
+
+void disp_mem_acquire(const void *pvAddr)
+{
+    (void)pvAddr;
+}
+
+void disp_mem_tick(const void *pvScanAddr)
+{
+    (void)pvScanAddr;
+}
+
+void nu_os_event_init(nu_os_event_t *psEvent)
+{
+    psEvent->m_u32Bits = 0;
+}
+
+void nu_os_event_set(nu_os_event_t *psEvent, uint32_t u32Bits)
+{
+    psEvent->m_u32Bits |= u32Bits;
+}
+
+uint32_t nu_os_event_wait(nu_os_event_t *psEvent, uint32_t u32Bits, int i32All, uint32_t u32TimeoutMs)
+{
+    uint32_t u32Got = psEvent->m_u32Bits & u32Bits;
+
+    (void)i32All;
+    (void)u32TimeoutMs;
+    psEvent->m_u32Bits &= ~u32Got;
+
+    return u32Got;
+}
+
+// Function to get the units moved by a descriptor
+static uint32_t test_units(const DSCT_T *psDsc)
+{
+    return ((psDsc->CTL & PDMA_DSCT_CTL_TXCNT_Msk) >> PDMA_DSCT_CTL_TXCNT_Pos) + 1;
+}
+
+// Function to walk one frame from psHead like the PDMA does, returns the descriptor after the frame end
+static nu_pdma_desc_t test_walk_frame(const char *pcName, nu_pdma_desc_t psHead, const S_DISP_TIMING *psT, const uint16_t *pu16Buf)
+{
+    const uint32_t u32HPorch = psT->m_u32HFP + psT->m_u32HPW + psT->m_u32HBP;
+    const uint32_t u32VPorch = psT->m_u32VFP + psT->m_u32VPW + psT->m_u32VBP;
+    const uint32_t u32Active = CONFIG_DISP_EBI_ADDR + CONFIG_DISP_DE_ACTIVE;
+    uint32_t u32Blank = 0, u32Porch = 0, u32PorchDsc = 0, u32Lines = 0, u32LineErrs = 0, u32Frame = 0, u32Ends = 0;
+    nu_pdma_desc_t psDsc = psHead;
+    int i;
+
+    for (i = 0; i < DEF_TEST_MAX_DSC; i++)
+    {
+        uint32_t u32Units = test_units(psDsc);
+        int i32End = !(psDsc->CTL & PDMA_DSCT_CTL_TBINTDIS_Msk);
+
+        u32Frame += u32Units;
+        u32Ends += i32End;
+
+        if ((psDsc->CTL & PDMA_DSCT_CTL_OPMODE_Msk) != PDMA_OP_SCATTER)
+            HOST_CHECK(0, "%s: descriptor %d is not scatter-gather", pcName, i);
+
+        if (psDsc->DA == u32Active)
+        {
+            if (u32Lines == 0)
+            {
+                /* Everything before the first active line is the vertical porch and its first HPORCH. */
+                u32Porch = u32Blank - u32HPorch;
+                u32Blank = u32HPorch;
+            }
+
+            if ((u32Blank != u32HPorch) || (u32Units != psT->m_u32HACT) ||
+                    (psDsc->SA != (uint32_t)(uintptr_t)&pu16Buf[u32Lines * psT->m_u32HACT]))
+                u32LineErrs++;
+
+            u32Blank = 0;
+            u32Lines++;
+        }
+        else
+        {
+            HOST_CHECK(psDsc->DA == CONFIG_DISP_EBI_ADDR, "%s: blank descriptor %d drives %08X", pcName, i, (unsigned)psDsc->DA);
+            u32Blank += u32Units;
+
+            if (u32Lines == 0)
+                u32PorchDsc++;
+        }
+
+        psDsc = (nu_pdma_desc_t)(uintptr_t)psDsc->NEXT;
+
+        if (i32End)
+            break;
+    }
+
+    /* The front porch descriptor of the first line follows the split porch ones. */
+    u32PorchDsc--;
+
+    printf("  %-28s %4ux%-4u porch %6u units in %u descriptors, frame %7u units\n", pcName,
+           psT->m_u32HACT, psT->m_u32VACT, u32Porch, u32PorchDsc, u32Frame);
+
+    HOST_CHECK(u32Ends == 1, "%s: no frame end within %d descriptors", pcName, DEF_TEST_MAX_DSC);
+    HOST_CHECK(u32Lines == psT->m_u32VACT, "%s: %u active lines", pcName, u32Lines);
+    HOST_CHECK(u32LineErrs == 0, "%s: %u lines with wrong units or source", pcName, u32LineErrs);
+    HOST_CHECK(u32Blank == 0, "%s: %u blank units after the last line", pcName, u32Blank);
+    HOST_CHECK(u32Porch == u32VPorch * (u32HPorch + psT->m_u32HACT), "%s: porch of %u units", pcName, u32Porch);
+    HOST_CHECK(u32PorchDsc == (u32Porch + NU_PDMA_MAX_TXCNT - 1) / NU_PDMA_MAX_TXCNT, "%s: porch over %u descriptors", pcName, u32PorchDsc);
+    HOST_CHECK(u32Frame == (u32VPorch + psT->m_u32VACT) * (u32HPorch + psT->m_u32HACT), "%s: frame of %u units", pcName, u32Frame);
+
+    return psDsc;
+}
+
+// Function to switch to a timing and walk the chain that takes over, returns its head
+static nu_pdma_desc_t test_switch(const char *pcName, nu_pdma_desc_t psHead, const S_DISP_TIMING *psT)
+{
+    const uint16_t *pu16Buf = (const uint16_t *)disp_get_vrambufaddr();
+    S_DISP_TIMING sOld, sNow;
+    nu_pdma_desc_t psNext;
+
+    disp_get_timing(&sOld);
+
+    HOST_CHECK(disp_set_timing(psT) == 0, "%s: rejected", pcName);
+
+    /* Until the next frame starts the running chain still loops on itself. */
+    HOST_CHECK(test_walk_frame("  (running)", psHead, &sOld, pu16Buf) == psHead, "%s: old chain relinked early", pcName);
+
+    s_apfnVector[0](NULL, NU_PDMA_EVENT_TRANSFER_DONE);
+    psNext = test_walk_frame("  (last old frame)", psHead, &sOld, pu16Buf);
+    s_apfnVector[0](NULL, NU_PDMA_EVENT_TRANSFER_DONE);
+
+    disp_get_timing(&sNow);
+    HOST_CHECK(memcmp(&sNow, psT, sizeof(sNow)) == 0, "%s: timing not taken over", pcName);
+    HOST_CHECK(test_walk_frame(pcName, psNext, psT, pu16Buf) == psNext, "%s: new chain does not loop", pcName);
+
+    return psNext;
+}
+
+int main(void)
+{
+    static const S_DISP_TIMING sDefault = DEF_DISP_TIMING_DEFAULT;
+    /* HACT, VACT, HBP, HFP, HPW, VBP, VFP, VPW */
+    static const S_DISP_TIMING sShortPorch = { 1280, 800, 88, 72, 128, 23, 3, 6 };
+    static const S_DISP_TIMING sWvga = { 800, 480, 88, 40, 48, 32, 13, 3 };
+    static const S_DISP_TIMING sExact = { 768, 600, 128, 64, 64, 34, 20, 10 };       /* Porch of exactly 65536 units */
+    static const S_DISP_TIMING sExactPlus = { 768, 600, 128, 64, 64, 35, 20, 10 };   /* One line more */
+    static const S_DISP_TIMING sTooWide = { CONFIG_TIMING_HACT + 1, 800, 88, 72, 128, 23, 40, 10 };
+    static const S_DISP_TIMING sTooTall = { 1280, 800, 88, 72, 128, 24, 40, 10 };
+    nu_pdma_desc_t psHead;
+
+    host_comp_init();
+
+    HOST_CHECK((uintptr_t)g_au8FrameBuf <= 0xFFFFFFFFUL, "build without PIE, descriptors hold 32-bit addresses");
+    HOST_CHECK(s_apfnVector[0] && s_apsHead[0], "scanout chain not started");
+
+    psHead = s_apsHead[0];
+    printf("  NU_PDMA_MAX_TXCNT %u\n", (unsigned)NU_PDMA_MAX_TXCNT);
+    HOST_CHECK(test_walk_frame("default", psHead, &sDefault, (const uint16_t *)g_au8FrameBuf) == psHead, "default chain does not loop");
+
+    psHead = test_switch("short porch", psHead, &sShortPorch);
+    psHead = test_switch("800x480", psHead, &sWvga);
+    psHead = test_switch("porch of NU_PDMA_MAX_TXCNT", psHead, &sExact);
+    psHead = test_switch("porch one line over", psHead, &sExactPlus);
+    psHead = test_switch("back to default", psHead, &sDefault);
+
+    HOST_CHECK(disp_set_timing(&sTooWide) == -1, "HACT over CONFIG_TIMING_HACT accepted");
+    HOST_CHECK(disp_set_timing(&sTooTall) == -1, "porch over CONFIG_TIMING_VPORCH_MAX accepted");
+
+    host_comp_fini();
+
+    return host_result("test_sync_chain");
+}